@@ -197,8 +197,6 @@ static_assert(false,"missing impl");
 static_assert(false,"missing impl");
 #elif !USE_GPU_IMPL
 void Analyze(int nThreadIdx, litiv::IDataHandlerPtr pBatch) {
-    srand(0); // for now, assures that two consecutive runs on the same data return the same results
-    //srand((unsigned int)time(NULL));
     size_t nCurrIdx = 0;
     try {
         DatasetType::WorkBatch& oBatch = dynamic_cast<DatasetType::WorkBatch&>(*pBatch);
@@ -211,6 +209,7 @@ void Analyze(int nThreadIdx, litiv::IDataHandlerPtr pBatch) {
         CV_Assert(oCurrInput.isContinuous());
         cv::Mat oCurrFGMask(oBatch.getFrameSize(),CV_8UC1,cv::Scalar_<uchar>(0));
         std::shared_ptr<IBackgroundSubtractor> pAlgo = std::make_shared<BackgroundSubtractorType>();
+        pAlgo->setRandomSeed(0); // assures that two consecutive runs on the same data return the same results (regardless of thread count)
         const double dDefaultLearningRate = pAlgo->getDefaultLearningRate();
         pAlgo->initialize(oCurrInput,oROI);
 #if DISPLAY_OUTPUT>0
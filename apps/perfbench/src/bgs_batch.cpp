@@ -0,0 +1,76 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perfbench.hpp"
+
+// usage: perfbench bgs_batch [stream_count=8] [frame_count=30] [width=320] [height=240] [threads=hw_concurrency]
+// note: each stream is a separate SuBSENSE instance fed with its own synthetic sequence; the sequential run is used as reference
+
+namespace {
+
+    void bench_bgs_batch(int argc, char** argv) {
+        const size_t nStreamCount = perfbench::getArg(argc,argv,0,8);
+        const size_t nFrameCount = perfbench::getArg(argc,argv,1,30);
+        const cv::Size oSize((int)perfbench::getArg(argc,argv,2,320),(int)perfbench::getArg(argc,argv,3,240));
+        const size_t nThreads = perfbench::getArg(argc,argv,4,std::max((size_t)std::thread::hardware_concurrency(),(size_t)1));
+        lvAssert(nStreamCount>0 && nFrameCount>0 && oSize.area()>0 && nThreads>0);
+        std::vector<std::vector<cv::Mat>> vvoFrames(nStreamCount,std::vector<cv::Mat>(nFrameCount));
+        for(size_t nStreamIdx=0; nStreamIdx<nStreamCount; ++nStreamIdx)
+            for(size_t nFrameIdx=0; nFrameIdx<nFrameCount; ++nFrameIdx)
+                perfbench::genSyntheticFrame(oSize,3,nFrameIdx+nStreamIdx*7,vvoFrames[nStreamIdx][nFrameIdx]);
+        const std::string sConfigName = "SuBSENSE ["+std::to_string(nStreamCount)+" streams, "+std::to_string(oSize.width)+"x"+std::to_string(oSize.height)+"]";
+        std::vector<cv::Mat> voRefFGMasks(nStreamCount);
+        {
+            std::vector<std::unique_ptr<BackgroundSubtractorSuBSENSE>> vpAlgos(nStreamCount);
+            for(size_t nStreamIdx=0; nStreamIdx<nStreamCount; ++nStreamIdx) {
+                vpAlgos[nStreamIdx] = std::make_unique<BackgroundSubtractorSuBSENSE>();
+                vpAlgos[nStreamIdx]->initialize(vvoFrames[nStreamIdx][0],cv::Mat());
+            }
+            CxxUtils::StopWatch oStopWatch;
+            for(size_t nFrameIdx=0; nFrameIdx<nFrameCount; ++nFrameIdx)
+                for(size_t nStreamIdx=0; nStreamIdx<nStreamCount; ++nStreamIdx)
+                    vpAlgos[nStreamIdx]->apply(vvoFrames[nStreamIdx][nFrameIdx],voRefFGMasks[nStreamIdx]);
+            perfbench::printResult(sConfigName+" sequential apply",oStopWatch.tock(),nFrameCount*nStreamCount,"frame");
+        }
+        std::vector<std::unique_ptr<BackgroundSubtractorSuBSENSE>> vpAlgos(nStreamCount);
+        std::vector<IIBackgroundSubtractor::BatchEntry> voBatch;
+        for(size_t nStreamIdx=0; nStreamIdx<nStreamCount; ++nStreamIdx) {
+            vpAlgos[nStreamIdx] = std::make_unique<BackgroundSubtractorSuBSENSE>();
+            vpAlgos[nStreamIdx]->initialize(vvoFrames[nStreamIdx][0],cv::Mat());
+        }
+        // frames are interleaved across streams, as they would be when coming from live feeds
+        for(size_t nFrameIdx=0; nFrameIdx<nFrameCount; ++nFrameIdx)
+            for(size_t nStreamIdx=0; nStreamIdx<nStreamCount; ++nStreamIdx)
+                voBatch.push_back(IIBackgroundSubtractor::BatchEntry{vpAlgos[nStreamIdx].get(),vvoFrames[nStreamIdx][nFrameIdx],cv::Mat(),-1.0});
+        PlatformUtils::DynamicWorkerPool oPool(nThreads);
+        const IIBackgroundSubtractor::BatchStats oStats = IIBackgroundSubtractor::applyBatch(voBatch,oPool);
+        perfbench::printResult(sConfigName+" batch apply x"+std::to_string(nThreads),oStats.dWallTime_ms/1000,oStats.nTotFrames,"frame");
+        std::cout << std::fixed << std::setprecision(2);
+        for(size_t nStreamIdx=0; nStreamIdx<oStats.voStreams.size(); ++nStreamIdx) {
+            const IIBackgroundSubtractor::BatchStreamStats& oStreamStats = oStats.voStreams[nStreamIdx];
+            std::cout << "\t\tstream #" << nStreamIdx << " : " << oStreamStats.nFrames << " frames, latency mean = " << oStreamStats.dMeanLatency_ms
+                      << " ms, max = " << oStreamStats.dMaxLatency_ms << " ms, done at " << oStreamStats.dCompletionTime_ms << " ms" << std::endl;
+        }
+        std::cout << "\t\taggregate : " << oStats.dThroughput_fps << " fps, " << oStats.nSteals << " steals" << std::endl;
+        // the last entry of each stream holds its final mask
+        for(size_t nStreamIdx=0; nStreamIdx<nStreamCount; ++nStreamIdx)
+            lvAssert(cv::countNonZero(voBatch[voBatch.size()-nStreamCount+nStreamIdx].oFGMask!=voRefFGMasks[nStreamIdx])==0);
+    }
+
+} //anonymous namespace
+
+PERFBENCH_REGISTER("bgs_batch","multi-stream SuBSENSE batch throughput and per-stream latency on a shared worker pool",bench_bgs_batch);
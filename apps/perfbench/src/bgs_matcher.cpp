@@ -0,0 +1,53 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perfbench.hpp"
+
+// usage: perfbench bgs_matcher [frame_count=200] [width=640] [height=480]
+
+namespace {
+
+    void bench_bgs_matcher(int argc, char** argv) {
+        const size_t nFrameCount = perfbench::getArg(argc,argv,0,200);
+        const cv::Size oSize((int)perfbench::getArg(argc,argv,1,640),(int)perfbench::getArg(argc,argv,2,480));
+        lvAssert(nFrameCount>0 && oSize.area()>0);
+        std::cout << "\tAVX2 supported at runtime : " << (cv::checkHardwareSupport(CV_CPU_AVX2)?"yes":"no") << std::endl;
+        for(int nChannels : {1,3}) {
+            std::vector<cv::Mat> voFrames(nFrameCount);
+            for(size_t nFrameIdx=0; nFrameIdx<nFrameCount; ++nFrameIdx)
+                perfbench::genSyntheticFrame(oSize,nChannels,nFrameIdx,voFrames[nFrameIdx]);
+            for(eSampleModelLayout eLayout : {eSampleModelLayout_Planar,eSampleModelLayout_Interleaved}) {
+                for(bool bVectorized : {false,true}) {
+                    BackgroundSubtractorSuBSENSE oAlgo;
+                    oAlgo.setSampleModelLayout(eLayout);
+                    oAlgo.setVectorizedMatching(bVectorized);
+                    oAlgo.initialize(voFrames[0],cv::Mat());
+                    cv::Mat oFGMask;
+                    CxxUtils::StopWatch oStopWatch;
+                    for(size_t nFrameIdx=0; nFrameIdx<nFrameCount; ++nFrameIdx)
+                        oAlgo.apply(voFrames[nFrameIdx],oFGMask);
+                    const double dTotalTime_sec = oStopWatch.tock();
+                    const std::string sLayoutName = (eLayout==eSampleModelLayout_Planar)?"planar":"interleaved";
+                    perfbench::printResult("SuBSENSE ["+std::to_string(nChannels)+"ch, "+sLayoutName+", "+(bVectorized?"avx2":"scalar")+" matcher]",dTotalTime_sec,nFrameCount,"frame");
+                }
+            }
+        }
+    }
+
+} //anonymous namespace
+
+PERFBENCH_REGISTER("bgs_matcher","SuBSENSE throughput w/ scalar vs AVX2 sample matching",bench_bgs_matcher);
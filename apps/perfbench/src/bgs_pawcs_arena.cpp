@@ -0,0 +1,57 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perfbench.hpp"
+
+// usage: perfbench bgs_pawcs_arena [frame_count=100] [width=1280] [height=720]
+// note: model resets are timed separately since they should now only recycle words from the preallocated arena
+
+namespace {
+
+    void bench_bgs_pawcs_arena(int argc, char** argv) {
+        const size_t nFrameCount = perfbench::getArg(argc,argv,0,100);
+        const cv::Size oSize((int)perfbench::getArg(argc,argv,1,1280),(int)perfbench::getArg(argc,argv,2,720));
+        lvAssert(nFrameCount>0 && oSize.area()>0);
+        for(int nChannels : {1,3}) {
+            std::vector<cv::Mat> voFrames(nFrameCount);
+            for(size_t nFrameIdx=0; nFrameIdx<nFrameCount; ++nFrameIdx)
+                perfbench::genSyntheticFrame(oSize,nChannels,nFrameIdx,voFrames[nFrameIdx]);
+            const std::string sConfigName = "PAWCS ["+std::to_string(nChannels)+"ch, "+std::to_string(oSize.width)+"x"+std::to_string(oSize.height)+"]";
+            BackgroundSubtractorPAWCS oAlgo;
+            CxxUtils::StopWatch oStopWatch;
+            oAlgo.initialize(voFrames[0],cv::Mat());
+            perfbench::printResult(sConfigName+" initialize",oStopWatch.tock(),1,"init");
+            std::cout << "\t" << sConfigName << " word arena size : " << oAlgo.getWordArenaSize()/(1024*1024) << " MB" << std::endl;
+            cv::Mat oFGMask;
+            oStopWatch.tick();
+            for(size_t nFrameIdx=0; nFrameIdx<nFrameCount; ++nFrameIdx)
+                oAlgo.apply(voFrames[nFrameIdx],oFGMask);
+            perfbench::printResult(sConfigName+" apply",oStopWatch.tock(),nFrameCount,"frame");
+            const size_t nRefreshCount = 10;
+            oStopWatch.tick();
+            for(size_t nRefreshIdx=0; nRefreshIdx<nRefreshCount; ++nRefreshIdx)
+                oAlgo.refreshModel(1,0.5f,true);
+            perfbench::printResult(sConfigName+" refreshModel",oStopWatch.tock(),nRefreshCount,"refresh");
+            oStopWatch.tick();
+            oAlgo.initialize(voFrames[0],cv::Mat());
+            perfbench::printResult(sConfigName+" re-initialize",oStopWatch.tock(),1,"init");
+        }
+    }
+
+} //anonymous namespace
+
+PERFBENCH_REGISTER("bgs_pawcs_arena","PAWCS throughput, reset cost & word arena footprint (720p by default)",bench_bgs_pawcs_arena);
@@ -0,0 +1,65 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perfbench.hpp"
+
+// usage: perfbench bgs_pawcs_scaling [frame_count=50] [width=1280] [height=720] [tile_rows=32] [max_threads=hw_concurrency]
+// note: the tile layout is kept fixed across all runs, so the output masks must match the single-thread run exactly
+
+namespace {
+
+    void bench_bgs_pawcs_scaling(int argc, char** argv) {
+        const size_t nFrameCount = perfbench::getArg(argc,argv,0,50);
+        const cv::Size oSize((int)perfbench::getArg(argc,argv,1,1280),(int)perfbench::getArg(argc,argv,2,720));
+        const size_t nTileRows = perfbench::getArg(argc,argv,3,32);
+        const size_t nMaxThreads = perfbench::getArg(argc,argv,4,std::max((size_t)std::thread::hardware_concurrency(),(size_t)1));
+        lvAssert(nFrameCount>0 && oSize.area()>0 && nMaxThreads>0);
+        for(int nChannels : {1,3}) {
+            std::vector<cv::Mat> voFrames(nFrameCount);
+            for(size_t nFrameIdx=0; nFrameIdx<nFrameCount; ++nFrameIdx)
+                perfbench::genSyntheticFrame(oSize,nChannels,nFrameIdx,voFrames[nFrameIdx]);
+            const std::string sConfigName = "PAWCS ["+std::to_string(nChannels)+"ch, "+std::to_string(oSize.width)+"x"+std::to_string(oSize.height)+", "+std::to_string(nTileRows)+" rows/tile]";
+            cv::Mat oRefFGMask;
+            double dRefTime_sec = 0.0;
+            for(size_t nThreads=1; nThreads<=nMaxThreads; ++nThreads) {
+                BackgroundSubtractorPAWCS oAlgo;
+                oAlgo.setParallelTiling(nTileRows,nThreads);
+                CxxUtils::StopWatch oStopWatch;
+                oAlgo.initialize(voFrames[0],cv::Mat());
+                perfbench::printResult(sConfigName+" x"+std::to_string(nThreads)+" initialize",oStopWatch.tock(),1,"init");
+                cv::Mat oFGMask;
+                oStopWatch.tick();
+                for(size_t nFrameIdx=0; nFrameIdx<nFrameCount; ++nFrameIdx)
+                    oAlgo.apply(voFrames[nFrameIdx],oFGMask);
+                const double dApplyTime_sec = oStopWatch.tock();
+                perfbench::printResult(sConfigName+" x"+std::to_string(nThreads)+" apply",dApplyTime_sec,nFrameCount,"frame");
+                if(nThreads==1) {
+                    oFGMask.copyTo(oRefFGMask);
+                    dRefTime_sec = dApplyTime_sec;
+                }
+                else {
+                    const bool bIdentical = cv::countNonZero(oFGMask!=oRefFGMask)==0;
+                    std::cout << "\t\tspeedup vs. x1 : " << std::fixed << std::setprecision(2) << dRefTime_sec/dApplyTime_sec << "   (masks " << (bIdentical?"identical":"DIFFER") << ")" << std::endl;
+                    lvAssert(bIdentical);
+                }
+            }
+        }
+    }
+
+} //anonymous namespace
+
+PERFBENCH_REGISTER("bgs_pawcs_scaling","PAWCS tiled apply throughput for 1..N worker threads (720p by default)",bench_bgs_pawcs_scaling);
@@ -0,0 +1,60 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perfbench.hpp"
+
+// usage: perfbench bgs_samplemodel [frame_count=200] [width=640] [height=480]
+// note: cache behavior can be compared by running each layout under 'perf stat -e cache-references,cache-misses'
+
+namespace {
+
+    template<typename TAlgo>
+    void runSampleModelBench(const std::string& sAlgoName, eSampleModelLayout eLayout, size_t nSamples, const std::vector<cv::Mat>& voFrames) {
+        std::shared_ptr<TAlgo> pAlgo = std::make_shared<TAlgo>();
+        pAlgo->setSampleModelLayout(eLayout);
+        pAlgo->initialize(voFrames[0],cv::Mat());
+        cv::Mat oFGMask;
+        for(size_t nFrameIdx=0; nFrameIdx<std::min(voFrames.size(),size_t(10)); ++nFrameIdx)
+            pAlgo->apply(voFrames[nFrameIdx],oFGMask);
+        CxxUtils::StopWatch oStopWatch;
+        for(size_t nFrameIdx=0; nFrameIdx<voFrames.size(); ++nFrameIdx)
+            pAlgo->apply(voFrames[nFrameIdx],oFGMask);
+        const double dTotalTime_sec = oStopWatch.tock();
+        BackgroundSampleModel oModel(eLayout);
+        oModel.initialize(voFrames[0].size(),(size_t)voFrames[0].channels(),nSamples);
+        const std::string sLayoutName = (eLayout==eSampleModelLayout_Planar)?"planar":"interleaved";
+        perfbench::printResult(sAlgoName+" ["+std::to_string(voFrames[0].channels())+"ch, "+sLayoutName+", "+std::to_string(oModel.getTotalSize()/1024)+" KB]",dTotalTime_sec,voFrames.size(),"frame");
+    }
+
+    void bench_bgs_samplemodel(int argc, char** argv) {
+        const size_t nFrameCount = perfbench::getArg(argc,argv,0,200);
+        const cv::Size oSize((int)perfbench::getArg(argc,argv,1,640),(int)perfbench::getArg(argc,argv,2,480));
+        lvAssert(nFrameCount>0 && oSize.area()>0);
+        for(int nChannels : {1,3}) {
+            std::vector<cv::Mat> voFrames(nFrameCount);
+            for(size_t nFrameIdx=0; nFrameIdx<nFrameCount; ++nFrameIdx)
+                perfbench::genSyntheticFrame(oSize,nChannels,nFrameIdx,voFrames[nFrameIdx]);
+            for(eSampleModelLayout eLayout : {eSampleModelLayout_Planar,eSampleModelLayout_Interleaved}) {
+                runSampleModelBench<BackgroundSubtractorLOBSTER>("LOBSTER",eLayout,BGSLOBSTER_DEFAULT_NB_BG_SAMPLES,voFrames);
+                runSampleModelBench<BackgroundSubtractorSuBSENSE>("SuBSENSE",eLayout,BGSSUBSENSE_DEFAULT_NB_BG_SAMPLES,voFrames);
+            }
+        }
+    }
+
+} //anonymous namespace
+
+PERFBENCH_REGISTER("bgs_samplemodel","LOBSTER/SuBSENSE throughput w/ planar vs interleaved sample model layouts",bench_bgs_samplemodel);
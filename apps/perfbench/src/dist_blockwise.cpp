@@ -0,0 +1,124 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perfbench.hpp"
+
+// usage: perfbench dist_blockwise [iter_count=20] [width=1920] [height=1080]
+// note: every whole-array distance overload (8U/16U/32F, 1/3/4 channels, w/o mask, w/ ROI mask, w/ sparse mask) is compared to the per-element loop
+
+namespace {
+
+    //! per-element whole-array distance loop (i.e. the implementation used before the block-wise kernels)
+    template<typename T, typename TElemDist>
+    auto computePerElementDist(const T* a, const T* b, size_t nElements, size_t nChannels, const uchar* m, TElemDist lElemDist) -> decltype(lElemDist(a,b)) {
+        decltype(lElemDist(a,b)) tResult = 0;
+        for(size_t n=0; n<nElements; ++n)
+            if(!m || m[n])
+                tResult += lElemDist(a+n*nChannels,b+n*nChannels);
+        return tResult;
+    }
+
+    template<typename TPerElementDist, typename TBlockwiseDist>
+    void benchDistPair(const std::string& sConfigName, size_t nIterCount, bool bExact, TPerElementDist lPerElementDist, TBlockwiseDist lBlockwiseDist) {
+        double dPerElementResult = 0, dBlockwiseResult = 0;
+        CxxUtils::StopWatch oStopWatch;
+        for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx)
+            dPerElementResult += (double)lPerElementDist();
+        const double dPerElementTime_sec = oStopWatch.tock();
+        perfbench::printResult(sConfigName+" per-element",dPerElementTime_sec,nIterCount,"frame");
+        oStopWatch.tick();
+        for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx)
+            dBlockwiseResult += (double)lBlockwiseDist();
+        const double dBlockwiseTime_sec = oStopWatch.tock();
+        perfbench::printResult(sConfigName+" block-wise",dBlockwiseTime_sec,nIterCount,"frame");
+        // float sums are accumulated in a different order by the vector kernels, so only integer results must match exactly
+        const bool bMatch = bExact?(dPerElementResult==dBlockwiseResult):(std::abs(dPerElementResult-dBlockwiseResult)<=1e-3*std::max(1.0,std::abs(dPerElementResult)));
+        std::cout << "\t\tspeedup vs. per-element : " << std::fixed << std::setprecision(2) << dPerElementTime_sec/dBlockwiseTime_sec << "   (results " << (bMatch?"match":"DIFFER") << ")" << std::endl;
+        lvAssert(bMatch);
+    }
+
+    template<size_t nChannels, typename T>
+    void benchHammingDist(std::true_type, const std::string& sConfigSuffix, size_t nIterCount, const T* a, const T* b, size_t nElements, const uchar* m) {
+        benchDistPair("hdist "+sConfigSuffix,nIterCount,true,
+            [&](){return computePerElementDist(a,b,nElements,nChannels,m,[](const T* aElem, const T* bElem){return DistanceUtils::hdist<nChannels>(aElem,bElem);});},
+            [&](){return DistanceUtils::hdist(a,b,nElements,nChannels,m);});
+    }
+
+    template<size_t nChannels, typename T>
+    void benchHammingDist(std::false_type, const std::string&, size_t, const T*, const T*, size_t, const uchar*) {}
+
+    template<size_t nChannels, typename T>
+    void benchDistTypes(const std::string& sTypeName, const cv::Mat& oA, const cv::Mat& oB, const std::vector<std::pair<std::string,cv::Mat>>& voMasks, size_t nIterCount) {
+        lvAssert(oA.isContinuous() && oB.isContinuous() && oA.size()==oB.size() && oA.type()==oB.type() && oA.channels()==(int)nChannels);
+        const T* a = (const T*)oA.data;
+        const T* b = (const T*)oB.data;
+        const size_t nElements = oA.total();
+        const bool bExact = std::is_integral<T>::value;
+        for(const auto& oMask : voMasks) {
+            const uchar* m = oMask.second.empty()?nullptr:oMask.second.data;
+            const std::string sConfigSuffix = sTypeName+"C"+std::to_string(nChannels)+" ["+oMask.first+"]";
+            benchDistPair("L1dist "+sConfigSuffix,nIterCount,bExact,
+                [&](){return computePerElementDist(a,b,nElements,nChannels,m,[](const T* aElem, const T* bElem){return DistanceUtils::L1dist<nChannels>(aElem,bElem);});},
+                [&](){return DistanceUtils::L1dist(a,b,nElements,nChannels,m);});
+            benchDistPair("L2sqrdist "+sConfigSuffix,nIterCount,bExact,
+                [&](){return computePerElementDist(a,b,nElements,nChannels,m,[](const T* aElem, const T* bElem){return DistanceUtils::L2sqrdist<nChannels>(aElem,bElem);});},
+                [&](){return DistanceUtils::L2sqrdist(a,b,nElements,nChannels,m);});
+            benchDistPair("L2dist "+sConfigSuffix,nIterCount,false,
+                [&](){return std::sqrt((float)computePerElementDist(a,b,nElements,nChannels,m,[](const T* aElem, const T* bElem){return DistanceUtils::L2sqrdist<nChannels>(aElem,bElem);}));},
+                [&](){return DistanceUtils::L2dist(a,b,nElements,nChannels,m);});
+            if(nChannels>1) {
+                constexpr size_t nColorChannels = (nChannels>1)?nChannels:2; // cdist is only defined for multi-channel arrays
+                benchDistPair("cdist "+sConfigSuffix,nIterCount,bExact,
+                    [&](){return computePerElementDist(a,b,nElements,nChannels,m,[](const T* aElem, const T* bElem){return DistanceUtils::cdist<nColorChannels>(aElem,bElem);});},
+                    [&](){return DistanceUtils::cdist(a,b,nElements,nChannels,m);});
+            }
+            benchHammingDist<nChannels>(std::is_integral<T>(),sConfigSuffix,nIterCount,a,b,nElements,m);
+        }
+    }
+
+    template<size_t nChannels>
+    void benchDistChannels(const cv::Size& oSize, const std::vector<std::pair<std::string,cv::Mat>>& voMasks, size_t nIterCount) {
+        cv::Mat oA_8U, oB_8U, oA_16U, oB_16U, oA_32F, oB_32F;
+        perfbench::genSyntheticFrame(oSize,(int)nChannels,0,oA_8U);
+        perfbench::genSyntheticFrame(oSize,(int)nChannels,10,oB_8U);
+        oA_8U.convertTo(oA_16U,CV_16U,257);
+        oB_8U.convertTo(oB_16U,CV_16U,257);
+        oA_8U.convertTo(oA_32F,CV_32F,1.0/255);
+        oB_8U.convertTo(oB_32F,CV_32F,1.0/255);
+        benchDistTypes<nChannels,uchar>("8U",oA_8U,oB_8U,voMasks,nIterCount);
+        benchDistTypes<nChannels,ushort>("16U",oA_16U,oB_16U,voMasks,nIterCount);
+        benchDistTypes<nChannels,float>("32F",oA_32F,oB_32F,voMasks,nIterCount);
+    }
+
+    void bench_dist_blockwise(int argc, char** argv) {
+        const size_t nIterCount = perfbench::getArg(argc,argv,0,20);
+        const cv::Size oSize((int)perfbench::getArg(argc,argv,1,1920),(int)perfbench::getArg(argc,argv,2,1080));
+        lvAssert(nIterCount>0 && oSize.area()>0);
+        cv::Mat oROIMask(oSize,CV_8UC1,cv::Scalar_<uchar>(0));
+        cv::circle(oROIMask,cv::Point(oSize.width/2,oSize.height/2),std::min(oSize.width,oSize.height)/2,cv::Scalar_<uchar>(255),-1);
+        cv::Mat oSparseMask(oSize,CV_8UC1);
+        cv::RNG(0).fill(oSparseMask,cv::RNG::UNIFORM,cv::Scalar::all(0),cv::Scalar::all(2));
+        oSparseMask *= 255;
+        const std::vector<std::pair<std::string,cv::Mat>> voMasks = {{"no mask",cv::Mat()},{"ROI mask",oROIMask},{"sparse mask",oSparseMask}};
+        benchDistChannels<1>(oSize,voMasks,nIterCount);
+        benchDistChannels<3>(oSize,voMasks,nIterCount);
+        benchDistChannels<4>(oSize,voMasks,nIterCount);
+    }
+
+} //anonymous namespace
+
+PERFBENCH_REGISTER("dist_blockwise","DistanceUtils whole-array L1/L2/cdist/hdist throughput, per-element loops vs. block-wise kernels (8U/16U/32F, 1/3/4 ch, masks)",bench_dist_blockwise);
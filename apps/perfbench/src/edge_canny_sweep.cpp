@@ -0,0 +1,59 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perfbench.hpp"
+
+// usage: perfbench edge_canny_sweep [iter_count=10] [width=481] [height=321]
+// note: the default size matches BSDS500 images; the reference accumulates 'apply_threshold' over all thresholds (as 'apply' used to)
+
+namespace {
+
+    void bench_edge_canny_sweep(int argc, char** argv) {
+        const size_t nIterCount = perfbench::getArg(argc,argv,0,10);
+        const cv::Size oSize((int)perfbench::getArg(argc,argv,1,481),(int)perfbench::getArg(argc,argv,2,321));
+        lvAssert(nIterCount>0 && oSize.area()>0);
+        for(int nChannels : {1,3}) {
+            cv::Mat oImage;
+            perfbench::genSyntheticFrame(oSize,nChannels,0,oImage);
+            EdgeDetectorCanny oDetector;
+            const std::string sConfigName = "Canny soft edges ["+std::to_string(nChannels)+"ch, "+std::to_string(oSize.width)+"x"+std::to_string(oSize.height)+"]";
+            cv::Mat oRefEdgeMask(oSize,CV_8UC1), oTempEdgeMask, oSweepEdgeMask;
+            CxxUtils::StopWatch oStopWatch;
+            for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx) {
+                oRefEdgeMask = cv::Scalar_<uchar>(0);
+                for(size_t nCurrThreshold=0; nCurrThreshold<UCHAR_MAX; ++nCurrThreshold) {
+                    oDetector.apply_threshold(oImage,oTempEdgeMask,double(nCurrThreshold));
+                    oRefEdgeMask += oTempEdgeMask/UCHAR_MAX;
+                }
+                cv::normalize(oRefEdgeMask,oRefEdgeMask,0,UCHAR_MAX,cv::NORM_MINMAX);
+            }
+            const double dRefTime_sec = oStopWatch.tock();
+            perfbench::printResult(sConfigName+" per-threshold",dRefTime_sec,nIterCount,"frame");
+            oStopWatch.tick();
+            for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx)
+                oDetector.apply(oImage,oSweepEdgeMask);
+            const double dSweepTime_sec = oStopWatch.tock();
+            perfbench::printResult(sConfigName+" single sweep",dSweepTime_sec,nIterCount,"frame");
+            const int nMismatches = cv::countNonZero(oRefEdgeMask!=oSweepEdgeMask);
+            std::cout << "\t\tspeedup vs. per-threshold : " << std::fixed << std::setprecision(2) << dRefTime_sec/dSweepTime_sec << "   (edge maps " << (nMismatches?"DIFFER":"identical") << ")" << std::endl;
+            lvAssert(nMismatches==0);
+        }
+    }
+
+} //anonymous namespace
+
+PERFBENCH_REGISTER("edge_canny_sweep","Canny soft edge map throughput, 255 per-threshold passes vs. single union-find hysteresis sweep",bench_edge_canny_sweep);
@@ -0,0 +1,58 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perfbench.hpp"
+
+// usage: perfbench edge_lbsp_compact [iter_count=5] [width=3840] [height=2160]
+// note: the lookup map footprint is computed from the pyramid level sizes; both modes must produce the same edge masks
+
+namespace {
+
+    void bench_edge_lbsp_compact(int argc, char** argv) {
+        const size_t nIterCount = perfbench::getArg(argc,argv,0,5);
+        const cv::Size oSize((int)perfbench::getArg(argc,argv,1,3840),(int)perfbench::getArg(argc,argv,2,2160));
+        lvAssert(nIterCount>0 && oSize.width>(int)LBSP::PATCH_SIZE && oSize.height>(int)LBSP::PATCH_SIZE);
+        for(int nChannels : {1,3}) {
+            cv::Mat oImage;
+            perfbench::genSyntheticFrame(oSize,nChannels,0,oImage);
+            const std::string sConfigName = "LBSP edges ["+std::to_string(nChannels)+"ch, "+std::to_string(oSize.width)+"x"+std::to_string(oSize.height)+"]";
+            size_t nLookupMapBytes = 0;
+            for(size_t nLevelIdx=0; nLevelIdx<EDGLBSP_DEFAULT_LEVEL_COUNT; ++nLevelIdx)
+                nLookupMapBytes += size_t((oSize.width+(1<<nLevelIdx)-1)>>nLevelIdx)*size_t((oSize.height+(1<<nLevelIdx)-1)>>nLevelIdx)*LBSP::DESC_SIZE_BITS*nChannels;
+            std::cout << "\t" << sConfigName << " lookup maps : " << std::fixed << std::setprecision(1) << nLookupMapBytes/(1024.0*1024.0) << " MB (avoided in compact mode)" << std::endl;
+            cv::Mat aoSoftEdgeMasks[2], aoBinEdgeMasks[2];
+            double adTimes_sec[2];
+            for(bool bCompact : {false,true}) {
+                EdgeDetectorLBSP oDetector;
+                oDetector.setCompactLookup(bCompact);
+                CxxUtils::StopWatch oStopWatch;
+                for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx) {
+                    oDetector.apply(oImage,aoSoftEdgeMasks[bCompact]);
+                    oDetector.apply_threshold(oImage,aoBinEdgeMasks[bCompact]);
+                }
+                adTimes_sec[bCompact] = oStopWatch.tock();
+                perfbench::printResult(sConfigName+(bCompact?" compact lookup":" lookup maps"),adTimes_sec[bCompact],nIterCount,"frame");
+            }
+            const bool bIdentical = cv::countNonZero(aoSoftEdgeMasks[0]!=aoSoftEdgeMasks[1])==0 && cv::countNonZero(aoBinEdgeMasks[0]!=aoBinEdgeMasks[1])==0;
+            std::cout << "\t\tcompact speedup vs. lookup maps : " << std::fixed << std::setprecision(2) << adTimes_sec[0]/adTimes_sec[1] << "   (masks " << (bIdentical?"identical":"DIFFER") << ")" << std::endl;
+            lvAssert(bIdentical);
+        }
+    }
+
+} //anonymous namespace
+
+PERFBENCH_REGISTER("edge_lbsp_compact","LBSP edge detection throughput w/ stored lookup maps vs. on-the-fly lookups (compact memory mode, 4K by default)",bench_edge_lbsp_compact);
@@ -0,0 +1,69 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perfbench.hpp"
+
+// usage: perfbench edge_lbsp_scaling [iter_count=5] [width=3840] [height=2160] [band_rows=64] [max_threads=16]
+// note: the band layout does not change the results, so all outputs must match the single-thread run exactly
+
+namespace {
+
+    void bench_edge_lbsp_scaling(int argc, char** argv) {
+        const size_t nIterCount = perfbench::getArg(argc,argv,0,5);
+        const cv::Size oSize((int)perfbench::getArg(argc,argv,1,3840),(int)perfbench::getArg(argc,argv,2,2160));
+        const size_t nBandRows = perfbench::getArg(argc,argv,3,64);
+        const size_t nMaxThreads = perfbench::getArg(argc,argv,4,16);
+        lvAssert(nIterCount>0 && oSize.width>(int)LBSP::PATCH_SIZE && oSize.height>(int)LBSP::PATCH_SIZE && nMaxThreads>0);
+        for(int nChannels : {1,3}) {
+            cv::Mat oImage;
+            perfbench::genSyntheticFrame(oSize,nChannels,0,oImage);
+            const std::string sConfigName = "LBSP edges ["+std::to_string(nChannels)+"ch, "+std::to_string(oSize.width)+"x"+std::to_string(oSize.height)+", "+std::to_string(nBandRows)+" rows/band]";
+            cv::Mat oRefSoftEdgeMask, oRefBinEdgeMask;
+            double dRefSoftTime_sec = 0.0, dRefBinTime_sec = 0.0;
+            for(size_t nThreads=1; nThreads<=nMaxThreads; nThreads*=2) {
+                EdgeDetectorLBSP oDetector;
+                oDetector.setParallelBands(nBandRows,nThreads);
+                cv::Mat oSoftEdgeMask, oBinEdgeMask;
+                CxxUtils::StopWatch oStopWatch;
+                for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx)
+                    oDetector.apply(oImage,oSoftEdgeMask);
+                const double dSoftTime_sec = oStopWatch.tock();
+                perfbench::printResult(sConfigName+" x"+std::to_string(nThreads)+" apply",dSoftTime_sec,nIterCount,"frame");
+                oStopWatch.tick();
+                for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx)
+                    oDetector.apply_threshold(oImage,oBinEdgeMask);
+                const double dBinTime_sec = oStopWatch.tock();
+                perfbench::printResult(sConfigName+" x"+std::to_string(nThreads)+" apply_threshold",dBinTime_sec,nIterCount,"frame");
+                if(nThreads==1) {
+                    oSoftEdgeMask.copyTo(oRefSoftEdgeMask);
+                    oBinEdgeMask.copyTo(oRefBinEdgeMask);
+                    dRefSoftTime_sec = dSoftTime_sec;
+                    dRefBinTime_sec = dBinTime_sec;
+                }
+                else {
+                    const bool bIdentical = cv::countNonZero(oSoftEdgeMask!=oRefSoftEdgeMask)==0 && cv::countNonZero(oBinEdgeMask!=oRefBinEdgeMask)==0;
+                    std::cout << "\t\tspeedup vs. x1 : " << std::fixed << std::setprecision(2) << dRefSoftTime_sec/dSoftTime_sec << " (apply), "
+                              << dRefBinTime_sec/dBinTime_sec << " (apply_threshold)   (masks " << (bIdentical?"identical":"DIFFER") << ")" << std::endl;
+                    lvAssert(bIdentical);
+                }
+            }
+        }
+    }
+
+} //anonymous namespace
+
+PERFBENCH_REGISTER("edge_lbsp_scaling","LBSP edge detection throughput w/ pipelined pyramid bands for 1..16 worker threads (4K by default)",bench_edge_lbsp_scaling);
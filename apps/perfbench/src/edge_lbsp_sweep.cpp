@@ -0,0 +1,57 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perfbench.hpp"
+
+// usage: perfbench edge_lbsp_sweep [iter_count=20] [width=481] [height=321]
+// note: the default size matches BSDS500 images; both modes must produce the same soft edge map
+
+namespace {
+
+    void bench_edge_lbsp_sweep(int argc, char** argv) {
+        const size_t nIterCount = perfbench::getArg(argc,argv,0,20);
+        const cv::Size oSize((int)perfbench::getArg(argc,argv,1,481),(int)perfbench::getArg(argc,argv,2,321));
+        lvAssert(nIterCount>0 && oSize.width>(int)LBSP::PATCH_SIZE && oSize.height>(int)LBSP::PATCH_SIZE);
+        for(int nChannels : {1,3}) {
+            cv::Mat oImage;
+            perfbench::genSyntheticFrame(oSize,nChannels,0,oImage);
+            for(bool bNormalizeOutput : {false,true}) {
+                EdgeDetectorLBSP oDetector(EDGLBSP_DEFAULT_LEVEL_COUNT,EDGLBSP_DEFAULT_HYST_LOW_THRSH_FACT,bNormalizeOutput);
+                const std::string sConfigName = "LBSP soft edges ["+std::to_string(nChannels)+"ch, "+std::to_string(oSize.width)+"x"+std::to_string(oSize.height)+(bNormalizeOutput?", norm]":"]");
+                cv::Mat oRefEdgeMask, oSweepEdgeMask;
+                oDetector.setThresholdSweep(false);
+                CxxUtils::StopWatch oStopWatch;
+                for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx)
+                    oDetector.apply(oImage,oRefEdgeMask);
+                const double dRefTime_sec = oStopWatch.tock();
+                perfbench::printResult(sConfigName+" per-threshold",dRefTime_sec,nIterCount,"frame");
+                oDetector.setThresholdSweep(true);
+                oStopWatch.tick();
+                for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx)
+                    oDetector.apply(oImage,oSweepEdgeMask);
+                const double dSweepTime_sec = oStopWatch.tock();
+                perfbench::printResult(sConfigName+" single sweep",dSweepTime_sec,nIterCount,"frame");
+                const int nMismatches = cv::countNonZero(oRefEdgeMask!=oSweepEdgeMask);
+                std::cout << "\t\tspeedup vs. per-threshold : " << std::fixed << std::setprecision(2) << dRefTime_sec/dSweepTime_sec << "   (edge maps " << (nMismatches?"DIFFER":"identical") << ")" << std::endl;
+                lvAssert(nMismatches==0);
+            }
+        }
+    }
+
+} //anonymous namespace
+
+PERFBENCH_REGISTER("edge_lbsp_sweep","LBSP soft edge map throughput, per-threshold gradient+hysteresis passes vs. single threshold sweep",bench_edge_lbsp_sweep);
@@ -0,0 +1,80 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perfbench.hpp"
+
+// usage: perfbench edge_tiled [iter_count=3] [width=4096] [height=4096] [tile_size=1024] [max_threads=8]
+// note: tiled outputs must match whole-image outputs exactly (halos cover the detector support, and hysteresis is resolved across tile borders)
+
+namespace {
+
+    void bench_edge_tiled_impl(const std::string& sDetectorName, const EdgeDetectorTiled::DetectorFactory& lDetectorFactory,
+                               const cv::Mat& oImage, size_t nIterCount, size_t nTileSize, size_t nMaxThreads) {
+        const std::string sConfigName = sDetectorName+" edges ["+std::to_string(oImage.channels())+"ch, "+std::to_string(oImage.cols)+"x"+std::to_string(oImage.rows)+"]";
+        const std::shared_ptr<IIEdgeDetector> pDetector = lDetectorFactory();
+        cv::Mat oRefSoftEdgeMask, oRefBinEdgeMask;
+        CxxUtils::StopWatch oStopWatch;
+        for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx)
+            pDetector->apply(oImage,oRefSoftEdgeMask);
+        const double dRefSoftTime_sec = oStopWatch.tock();
+        perfbench::printResult(sConfigName+" whole-image apply",dRefSoftTime_sec,nIterCount,"frame");
+        oStopWatch.tick();
+        for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx)
+            pDetector->apply_threshold(oImage,oRefBinEdgeMask,pDetector->getDefaultThreshold());
+        const double dRefBinTime_sec = oStopWatch.tock();
+        perfbench::printResult(sConfigName+" whole-image apply_threshold",dRefBinTime_sec,nIterCount,"frame");
+        for(size_t nThreads=1; nThreads<=nMaxThreads; nThreads*=2) {
+            EdgeDetectorTiled oTiledDetector(lDetectorFactory,cv::Size((int)nTileSize,(int)nTileSize),nThreads);
+            const std::string sTiledConfigName = sConfigName+" tiled x"+std::to_string(nThreads);
+            cv::Mat oSoftEdgeMask, oBinEdgeMask;
+            oStopWatch.tick();
+            for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx)
+                oTiledDetector.apply(oImage,oSoftEdgeMask);
+            const double dSoftTime_sec = oStopWatch.tock();
+            perfbench::printResult(sTiledConfigName+" apply",dSoftTime_sec,nIterCount,"frame");
+            oStopWatch.tick();
+            for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx)
+                oTiledDetector.apply_threshold(oImage,oBinEdgeMask,-1);
+            const double dBinTime_sec = oStopWatch.tock();
+            perfbench::printResult(sTiledConfigName+" apply_threshold",dBinTime_sec,nIterCount,"frame");
+            const bool bIdentical = cv::countNonZero(oSoftEdgeMask!=oRefSoftEdgeMask)==0 && cv::countNonZero(oBinEdgeMask!=oRefBinEdgeMask)==0;
+            const cv::Size oTileSize = oTiledDetector.getTileSize();
+            const size_t nHaloSize = oTiledDetector.getHaloSize();
+            std::cout << "\t\tspeedup vs. whole-image : " << std::fixed << std::setprecision(2) << dRefSoftTime_sec/dSoftTime_sec << " (apply), "
+                      << dRefBinTime_sec/dBinTime_sec << " (apply_threshold), padded tiles : " << oTileSize.width+nHaloSize*2 << "x" << oTileSize.height+nHaloSize*2
+                      << "   (masks " << (bIdentical?"identical":"DIFFER") << ")" << std::endl;
+            lvAssert(bIdentical);
+        }
+    }
+
+    void bench_edge_tiled(int argc, char** argv) {
+        const size_t nIterCount = perfbench::getArg(argc,argv,0,3);
+        const cv::Size oSize((int)perfbench::getArg(argc,argv,1,4096),(int)perfbench::getArg(argc,argv,2,4096));
+        const size_t nTileSize = perfbench::getArg(argc,argv,3,1024);
+        const size_t nMaxThreads = perfbench::getArg(argc,argv,4,8);
+        lvAssert(nIterCount>0 && oSize.area()>0 && nTileSize>0 && nMaxThreads>0);
+        for(int nChannels : {1,3}) {
+            cv::Mat oImage;
+            perfbench::genSyntheticFrame(oSize,nChannels,0,oImage);
+            bench_edge_tiled_impl("Canny",[](){return std::make_shared<EdgeDetectorCanny>();},oImage,nIterCount,nTileSize,nMaxThreads);
+            bench_edge_tiled_impl("LBSP",[](){return std::make_shared<EdgeDetectorLBSP>();},oImage,nIterCount,nTileSize,nMaxThreads);
+        }
+    }
+
+} //anonymous namespace
+
+PERFBENCH_REGISTER("edge_tiled","tiled (haloed) edge detection throughput for 1..8 worker threads vs. whole-image detection (4096x4096 by default)",bench_edge_tiled);
@@ -0,0 +1,100 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perfbench.hpp"
+
+// usage: perfbench lbsp_dense [iter_count=20] [width=1920] [height=1080]
+// note: the per-point path uses one keypoint per valid pixel; both paths must produce the same descriptors
+// note: templated pattern sizes (LBSP_<8/16/32/64>) are also timed, and spot-checked against their own per-point functions
+
+namespace {
+
+    template<size_t nDescBits>
+    void bench_lbsp_pattern(const cv::Mat& oImage, size_t nIterCount) {
+        typedef typename LBSP_<nDescBits>::desc_t desc_t;
+        std::array<uchar,UCHAR_MAX+1> anThresholdLUT;
+        for(size_t t=0; t<=UCHAR_MAX; ++t)
+            anThresholdLUT[t] = cv::saturate_cast<uchar>(t*0.333f+3);
+        cv::Mat oDescs;
+        CxxUtils::StopWatch oStopWatch;
+        for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx)
+            LBSP_<nDescBits>::computeDescriptorImage(oImage,cv::Mat(),anThresholdLUT.data(),oDescs);
+        const double dTime_sec = oStopWatch.tock();
+        perfbench::printResult("LBSP_<"+std::to_string(nDescBits)+"> ["+std::to_string(oImage.channels())+"ch, "+std::to_string(LBSP_<nDescBits>::PATCH_SIZE)+"x"+std::to_string(LBSP_<nDescBits>::PATCH_SIZE)+" pattern] dense",dTime_sec,nIterCount,"frame");
+        const int nChannels = oImage.channels();
+        const int nBorderSize = (int)LBSP_<nDescBits>::PATCH_SIZE/2;
+        size_t nMismatches = 0;
+        for(int nRowIdx=nBorderSize; nRowIdx<oImage.rows-nBorderSize; nRowIdx+=7) {
+            for(int nColIdx=nBorderSize; nColIdx<oImage.cols-nBorderSize; nColIdx+=5) {
+                for(int c=0; c<nChannels; ++c) {
+                    const uchar nRef = oImage.ptr<uchar>(nRowIdx)[nColIdx*nChannels+c];
+                    desc_t nDesc;
+                    if(nChannels==1)
+                        LBSP_<nDescBits>::template computeDescriptor<1>(oImage,nRef,nColIdx,nRowIdx,(size_t)c,anThresholdLUT[nRef],nDesc);
+                    else
+                        LBSP_<nDescBits>::template computeDescriptor<3>(oImage,nRef,nColIdx,nRowIdx,(size_t)c,anThresholdLUT[nRef],nDesc);
+                    nMismatches += (nDesc!=oDescs.ptr<desc_t>(nRowIdx)[nColIdx*nChannels+c]);
+                }
+            }
+        }
+        std::cout << "\t\tper-point spot check : " << (nMismatches?"DIFFER":"identical") << std::endl;
+        lvAssert(nMismatches==0);
+    }
+
+    void bench_lbsp_dense(int argc, char** argv) {
+        const size_t nIterCount = perfbench::getArg(argc,argv,0,20);
+        const cv::Size oSize((int)perfbench::getArg(argc,argv,1,1920),(int)perfbench::getArg(argc,argv,2,1080));
+        lvAssert(nIterCount>0 && oSize.width>(int)LBSP::PATCH_SIZE && oSize.height>(int)LBSP::PATCH_SIZE);
+        std::cout << "\tAVX2 dense kernel used : " << (LBSP::isUsingVectorizedKernel()?"yes":"no") << std::endl;
+        std::vector<cv::KeyPoint> voAllKeyPoints;
+        for(int nRowIdx=0; nRowIdx<oSize.height; ++nRowIdx)
+            for(int nColIdx=0; nColIdx<oSize.width; ++nColIdx)
+                voAllKeyPoints.emplace_back(cv::Point2f((float)nColIdx,(float)nRowIdx),1.0f);
+        for(int nChannels : {1,3}) {
+            cv::Mat oImage;
+            perfbench::genSyntheticFrame(oSize,nChannels,0,oImage);
+            for(bool bRelThreshold : {false,true}) {
+                const std::unique_ptr<LBSP> pExtractor(bRelThreshold?new LBSP(0.333f,3):new LBSP((size_t)30));
+                const std::string sConfigName = "LBSP ["+std::to_string(nChannels)+"ch, "+std::to_string(oSize.width)+"x"+std::to_string(oSize.height)+", "+(bRelThreshold?"rel":"abs")+" threshold]";
+                cv::Mat oPointDescs, oDenseDescs;
+                CxxUtils::StopWatch oStopWatch;
+                for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx) {
+                    std::vector<cv::KeyPoint> voKeyPoints = voAllKeyPoints;
+                    pExtractor->compute2(oImage,voKeyPoints,oPointDescs);
+                }
+                const double dPointTime_sec = oStopWatch.tock();
+                perfbench::printResult(sConfigName+" per-point",dPointTime_sec,nIterCount,"frame");
+                oStopWatch.tick();
+                for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx)
+                    pExtractor->compute2(oImage,oDenseDescs);
+                const double dDenseTime_sec = oStopWatch.tock();
+                perfbench::printResult(sConfigName+" dense",dDenseTime_sec,nIterCount,"frame");
+                const cv::Rect oInnerRect((int)LBSP::PATCH_SIZE/2,(int)LBSP::PATCH_SIZE/2,oSize.width-(int)LBSP::PATCH_SIZE+1,oSize.height-(int)LBSP::PATCH_SIZE+1);
+                const bool bIdentical = cv::countNonZero((oPointDescs(oInnerRect)!=oDenseDescs(oInnerRect)).reshape(1))==0;
+                std::cout << "\t\tspeedup vs. per-point : " << std::fixed << std::setprecision(2) << dPointTime_sec/dDenseTime_sec << "   (descriptors " << (bIdentical?"identical":"DIFFER") << ")" << std::endl;
+                lvAssert(bIdentical);
+            }
+            bench_lbsp_pattern<8>(oImage,nIterCount);
+            bench_lbsp_pattern<16>(oImage,nIterCount);
+            bench_lbsp_pattern<32>(oImage,nIterCount);
+            bench_lbsp_pattern<64>(oImage,nIterCount);
+        }
+    }
+
+} //anonymous namespace
+
+PERFBENCH_REGISTER("lbsp_dense","LBSP descriptor extraction throughput, per-point vs. dense row-streaming kernel, and per pattern size (1080p by default)",bench_lbsp_dense);
@@ -0,0 +1,70 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perfbench.hpp"
+#include <random>
+
+// usage: perfbench lbsp_sparse [iter_count=50] [width=1920] [height=1080]
+// note: keypoints are uniformly scattered over the image (as for tracking/registration), and both orders must produce the same descriptors
+
+namespace {
+
+    void bench_lbsp_sparse(int argc, char** argv) {
+        const size_t nIterCount = perfbench::getArg(argc,argv,0,50);
+        const cv::Size oSize((int)perfbench::getArg(argc,argv,1,1920),(int)perfbench::getArg(argc,argv,2,1080));
+        lvAssert(nIterCount>0 && oSize.width>(int)LBSP::PATCH_SIZE && oSize.height>(int)LBSP::PATCH_SIZE);
+        const int nBorderSize = (int)LBSP::PATCH_SIZE/2;
+        for(int nChannels : {1,3}) {
+            cv::Mat oImage;
+            perfbench::genSyntheticFrame(oSize,nChannels,0,oImage);
+            LBSP oExtractor(0.333f,3);
+            for(size_t nKeyPointCount : {10000,25000,50000,100000}) {
+                std::mt19937 oGen(0);
+                std::uniform_int_distribution<int> oColDistrib(nBorderSize,oSize.width-nBorderSize-1), oRowDistrib(nBorderSize,oSize.height-nBorderSize-1);
+                std::vector<cv::KeyPoint> voKeyPoints(nKeyPointCount);
+                for(cv::KeyPoint& oKeyPoint : voKeyPoints)
+                    oKeyPoint = cv::KeyPoint(cv::Point2f((float)oColDistrib(oGen),(float)oRowDistrib(oGen)),1.0f);
+                const std::string sConfigName = "LBSP sparse ["+std::to_string(nChannels)+"ch, "+std::to_string(oSize.width)+"x"+std::to_string(oSize.height)+", "+std::to_string(nKeyPointCount/1000)+"k kpts]";
+                cv::Mat oOrigOrderDescs, oBatchedDescs;
+                oExtractor.setSpatialBatching(false);
+                CxxUtils::StopWatch oStopWatch;
+                for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx)
+                    oExtractor.compute2(oImage,voKeyPoints,oOrigOrderDescs);
+                const double dOrigOrderTime_sec = oStopWatch.tock();
+                perfbench::printResult(sConfigName+" original order",dOrigOrderTime_sec,nIterCount,"frame");
+                oExtractor.setSpatialBatching(true);
+                oStopWatch.tick();
+                for(size_t nIterIdx=0; nIterIdx<nIterCount; ++nIterIdx)
+                    oExtractor.compute2(oImage,voKeyPoints,oBatchedDescs);
+                const double dBatchedTime_sec = oStopWatch.tock();
+                perfbench::printResult(sConfigName+" row-block batched",dBatchedTime_sec,nIterCount,"frame");
+                lvAssert(voKeyPoints.size()==nKeyPointCount); // all keypoints are valid, none should be filtered out
+                size_t nMismatches = 0;
+                for(const cv::KeyPoint& oKeyPoint : voKeyPoints) {
+                    const int x = (int)oKeyPoint.pt.x, y = (int)oKeyPoint.pt.y;
+                    for(int c=0; c<nChannels; ++c)
+                        nMismatches += (oOrigOrderDescs.ptr<ushort>(y)[x*nChannels+c]!=oBatchedDescs.ptr<ushort>(y)[x*nChannels+c]);
+                }
+                std::cout << "\t\tspeedup vs. original order : " << std::fixed << std::setprecision(2) << dOrigOrderTime_sec/dBatchedTime_sec << "   (descriptors " << (nMismatches?"DIFFER":"identical") << ")" << std::endl;
+                lvAssert(nMismatches==0);
+            }
+        }
+    }
+
+} //anonymous namespace
+
+PERFBENCH_REGISTER("lbsp_sparse","LBSP sparse keypoint extraction throughput, original keypoint order vs. row-block batching with prefetching (10k-100k keypoints)",bench_lbsp_sparse);
@@ -0,0 +1,39 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perfbench.hpp"
+
+int main(int argc, char** argv) {
+    try {
+        const auto& mBenchRegistry = perfbench::getBenchRegistry();
+        if(argc<2 || mBenchRegistry.find(argv[1])==mBenchRegistry.end()) {
+            std::cout << "Usage: " << argv[0] << " <bench_name> [bench args...]\n\nAvailable benchmarks:\n";
+            for(const auto& oBench : mBenchRegistry)
+                std::cout << "\t" << std::left << std::setw(24) << oBench.first << oBench.second.first << "\n";
+            std::cout << std::endl;
+            return (argc<2)?0:1;
+        }
+        std::cout << "\n[" << CxxUtils::getTimeStamp() << "]\n" << ParallelUtils::getDispatchReport() << "\nRunning '" << argv[1] << "'...\n" << std::endl;
+        mBenchRegistry.at(argv[1]).second(argc-2,argv+2);
+    }
+    catch(const cv::Exception& e) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught cv::Exception:\n" << e.what() << "\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    catch(const std::exception& e) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught std::exception:\n" << e.what() << "\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    catch(...) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught unhandled exception\n!!!!!!!!!!!!!!\n" << std::endl; return 1;}
+    std::cout << "\n[" << CxxUtils::getTimeStamp() << "]\n" << std::endl;
+    std::cout << "All done." << std::endl;
+    return 0;
+}
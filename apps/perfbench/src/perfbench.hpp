@@ -0,0 +1,85 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "litiv/video.hpp"
+#include "litiv/imgproc.hpp"
+#include <map>
+
+namespace perfbench {
+
+    //! benchmark entry point signature; receives the arguments following the benchmark name
+    using BenchFunc = std::function<void(int,char**)>;
+
+    //! returns the global benchmark registry (name => {description, entry point})
+    inline std::map<std::string,std::pair<std::string,BenchFunc>>& getBenchRegistry() {
+        static std::map<std::string,std::pair<std::string,BenchFunc>> s_mBenchRegistry;
+        return s_mBenchRegistry;
+    }
+
+    //! registers a benchmark in the global registry at static init time (see PERFBENCH_REGISTER)
+    struct BenchRegistrar {
+        BenchRegistrar(const std::string& sName, const std::string& sDesc, BenchFunc lFunc) {
+            lvAssert(getBenchRegistry().find(sName)==getBenchRegistry().end());
+            getBenchRegistry()[sName] = std::make_pair(sDesc,lFunc);
+        }
+    };
+
+#define PERFBENCH_REGISTER(name,desc,func) static const perfbench::BenchRegistrar s_oBenchRegistrar_##func(name,desc,func)
+
+    //! generates a synthetic video frame (textured static background w/ sensor noise & a moving textured block)
+    inline void genSyntheticFrame(const cv::Size& oSize, int nChannels, size_t nFrameIdx, cv::Mat& oFrame) {
+        static std::mutex s_oBGMutex;
+        static std::map<std::pair<int,int>,cv::Mat> s_mBGs;
+        cv::Mat oBG;
+        {
+            std::mutex_lock_guard oLock(s_oBGMutex);
+            cv::Mat& oCachedBG = s_mBGs[std::make_pair(oSize.area(),nChannels)];
+            if(oCachedBG.empty() || oCachedBG.size()!=oSize) {
+                cv::RNG oRNG(0);
+                oCachedBG.create(oSize,CV_8UC(nChannels));
+                oRNG.fill(oCachedBG,cv::RNG::UNIFORM,cv::Scalar::all(0),cv::Scalar::all(256));
+                cv::GaussianBlur(oCachedBG,oCachedBG,cv::Size(7,7),0);
+            }
+            oBG = oCachedBG;
+        }
+        cv::RNG oRNG((uint64)nFrameIdx+1);
+        cv::Mat oNoise(oSize,CV_16SC(nChannels));
+        oRNG.fill(oNoise,cv::RNG::NORMAL,cv::Scalar::all(0),cv::Scalar::all(4));
+        oBG.convertTo(oFrame,CV_16S);
+        oFrame += oNoise;
+        const int nBlockSize = std::max(oSize.height/4,8);
+        const int nBlockX = int((nFrameIdx*7)%(size_t)std::max(oSize.width-nBlockSize,1));
+        const int nBlockY = int((nFrameIdx*3)%(size_t)std::max(oSize.height-nBlockSize,1));
+        oFrame(cv::Rect(nBlockX,nBlockY,std::min(nBlockSize,oSize.width),std::min(nBlockSize,oSize.height))) = cv::Scalar::all(32+(nFrameIdx%4)*48);
+        oFrame.convertTo(oFrame,CV_8U);
+    }
+
+    //! parses an optional positional size_t argument
+    inline size_t getArg(int argc, char** argv, int nIdx, size_t nDefault) {
+        return (argc>nIdx)?(size_t)std::stoul(argv[nIdx]):nDefault;
+    }
+
+    //! prints a single result line in a uniform format
+    inline void printResult(const std::string& sName, double dTotalTime_sec, size_t nIters, const std::string& sUnit="it") {
+        std::cout << "\t" << std::left << std::setw(48) << sName << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << dTotalTime_sec*1000/nIters << " ms/" << sUnit << "   ("
+                  << std::setw(9) << std::setprecision(2) << nIters/dTotalTime_sec << " " << sUnit << "/s)" << std::endl;
+    }
+
+} //namespace perfbench
@@ -17,12 +17,14 @@
 
 #pragma once
 
+#include <map>
 #include <opencv2/core.hpp>
 #include <opencv2/imgproc.hpp>
 #include <opencv2/features2d.hpp>
 #include "litiv/utils/ParallelUtils.hpp"
 #include "litiv/utils/DistanceUtils.hpp"
 #include "litiv/utils/CxxUtils.hpp"
+#include "litiv/utils/PlatformUtils.hpp"
 
 /*!
     Local Binary Similarity Pattern (LBSP) feature extractor
@@ -41,9 +43,9 @@ public:
     LBSP(float fRelThreshold, size_t nThresholdOffset=0);
     //! default destructor
     virtual ~LBSP();
-    //! loads extractor params from the specified file node @@@@ not impl
+    //! loads extractor params from the specified file node (missing fields keep their current value)
     virtual void read(const cv::FileNode&);
-    //! writes extractor params to the specified file storage @@@@ not impl
+    //! writes extractor params to the specified file storage
     virtual void write(cv::FileStorage&) const;
     //! sets the 'reference' image to be used for inter-frame comparisons (note: if no image is set or if the image is empty, the algorithm will default back to intra-frame comparisons)
     virtual void setReference(const cv::Mat&);
@@ -57,16 +59,70 @@ public:
     virtual float getRelThreshold() const;
     //! returns the current absolute threshold used for comparisons (-1 = invalid/not used)
     virtual size_t getAbsThreshold() const;
+    //! sets whether large sparse keypoint sets are processed in row-block order with patch prefetching (descriptors are always returned in the original keypoint order)
+    void setSpatialBatching(bool bEnabled);
+    //! returns whether large sparse keypoint sets are processed in row-block order (default = true)
+    bool isUsingSpatialBatching() const;
 
     //! similar to DescriptorExtractor::compute(const cv::Mat& image, ...), but in this case, the descriptors matrix has the same shape as the input matrix
     void compute2(const cv::Mat& oImage, std::vector<cv::KeyPoint>& voKeypoints, cv::Mat& oDescriptors) const;
     //! batch version of LBSP::compute2(const cv::Mat& image, ...)
     void compute2(const std::vector<cv::Mat>& voImageCollection, std::vector<std::vector<cv::KeyPoint> >& vvoPointCollection, std::vector<cv::Mat>& voDescCollection) const;
+    //! dense version of LBSP::compute2(const cv::Mat& image, ...), where descriptors are computed for all pixels at once (border pixels are set to zero)
+    void compute2(const cv::Mat& oImage, cv::Mat& oDescriptors) const;
+    //! callback type used to stream batch results as they finish (image index + descriptors; called from worker threads, in completion order)
+    typedef std::function<void(size_t,const cv::Mat&)> BatchCallback;
+    //! parallel batch version of LBSP::compute2(const cv::Mat& image, ...), where images are dispatched over the given worker pool
+    void compute2(const std::vector<cv::Mat>& voImageCollection, std::vector<std::vector<cv::KeyPoint> >& vvoPointCollection, std::vector<cv::Mat>& voDescCollection,
+                  PlatformUtils::DynamicWorkerPool& oWorkerPool, const BatchCallback& lCallback=BatchCallback()) const;
+    //! parallel batch version of the dense LBSP::compute2(const cv::Mat& image, ...), where images are dispatched over the given worker pool
+    void compute2(const std::vector<cv::Mat>& voImageCollection, std::vector<cv::Mat>& voDescCollection,
+                  PlatformUtils::DynamicWorkerPool& oWorkerPool, const BatchCallback& lCallback=BatchCallback()) const;
 
+    //! binary descriptor image file header (fields are stored as-is, i.e. little-endian on all supported platforms)
+    struct DescFileHeader {
+        //! file signature, always "LBSPDESC"
+        char acMagic[8];
+        //! file format version
+        uint32_t nVersion;
+        //! descriptor image size & channel count
+        uint32_t nRows,nCols,nChannels;
+        //! descriptor size in bits, which also identifies the pattern used (see LBSPPattern)
+        uint32_t nDescBits;
+        //! extractor params used to compute the descriptors (see LBSP constructors)
+        uint32_t nOnlyUsingAbsThreshold;
+        float fRelThreshold;
+        uint32_t nThreshold;
+        //! uncompressed size of each data block (0 if the data is not compressed)
+        uint32_t nBlockSize;
+        //! number of compressed data blocks (0 if the data is not compressed)
+        uint32_t nBlockCount;
+        //! offset of the descriptor data (64-byte aligned) or of the compressed block size table, in bytes
+        uint64_t nDataOffset;
+        //! total size of the descriptor data once decompressed, in bytes
+        uint64_t nDataSize;
+    };
+    //! dense descriptor image loaded via LBSP::readDescImage (if the file was not compressed, 'oDesc' points to a copy-on-write file mapping owned by its refcount)
+    struct DescImage {
+        DescFileHeader oHeader;
+        cv::Mat oDesc;
+    };
+    //! writes a dense descriptor image (any pattern size, see LBSP_) along with this extractor's params to a binary file, optionally using LZ4-style block compression
+    //! (if 'nDescBits' is 0, it is deduced from the matrix depth; 64 bit descriptor images share their depth with 32 bit ones, and must specify it)
+    void writeDescImage(const std::string& sFilePath, const cv::Mat& oDesc, bool bCompress=false, size_t nDescBits=0) const;
+    //! reads a dense descriptor image written via LBSP::writeDescImage (uncompressed files are memory-mapped instead of copied)
+    static DescImage readDescImage(const std::string& sFilePath);
+
+    //! utility function, computes the descriptors of all pixels of an 8-bit image using a per-reference-intensity threshold LUT (row-streaming kernel, uses AVX2 if supported at runtime; border pixels are set to zero)
+    static void computeDescriptorImage(const cv::Mat& oInputImg, const cv::Mat& oRefImg, const uchar* anThresholdLUT, cv::Mat& oDesc);
+    //! utility function, returns whether the AVX2 kernel is used in 'computeDescriptorImage'
+    static bool isUsingVectorizedKernel();
     //! utility function, used to reshape a descriptors matrix to its input image size via their keypoint locations
     static void reshapeDesc(cv::Size oSize, const std::vector<cv::KeyPoint>& voKeypoints, const cv::Mat& oDescriptors, cv::Mat& oOutput);
     //! utility function, used to illustrate the difference between two descriptor images
     static void calcDescImgDiff(const cv::Mat& oDesc1, const cv::Mat& oDesc2, cv::Mat& oOutput, bool bForceMergeChannels=false);
+    //! utility function, computes the Hamming distance map of two CV_16UC1/3 descriptor images (CV_8UC1/3 output, or CV_8UC1 with summed channel distances if merging; uses AVX2 if supported at runtime)
+    static void calcDescDistMap(const cv::Mat& oDesc1, const cv::Mat& oDesc2, cv::Mat& oDistMap, bool bMergeChannels=false);
     //! utility function, used to filter out bad keypoints that would trigger out of bounds error because they're too close to the image border
     static void validateKeyPoints(std::vector<cv::KeyPoint>& voKeypoints, cv::Size oImgSize);
     //! utility function, used to filter out bad pixels in a ROI that would trigger out of bounds error because they're too close to the image border
@@ -176,6 +232,9 @@ public:
         return LBSP::computeDescriptor_threshold(anVals.data(),nRef,nThreshold);
     }
 
+    //! utility function, thresholds 'nCount' consecutive 16-byte lookup arrays against their own reference and threshold values (runtime-dispatched batch version of the function below)
+    static void computeDescriptor_threshold(const uchar* aanVals, const uchar* anRefs, const uchar* anThresholds, size_t nCount, desc_t* anDescs);
+
     //! utility function, shortcut/lightweight/direct single-point LBSP computation function for extra flexibility (array thresholding only)
     inline static desc_t computeDescriptor_threshold(const uchar* const anVals, const uchar nRef, const uchar nThreshold) {
         // note: this function is used to threshold an LBSP pattern based on a predefined lookup array (see LBSP_16bits_dbcross_lookup for more information)
@@ -223,18 +282,35 @@ public:
     inline static void computeDescriptor_gradient(const uchar* const aanVals, const uchar* const anRefs, Tr1& nGradX, Tr1& nGradY, Tr2& nGradMag) {
         // note: this function is used to threshold a multi-channel LBSP pattern based on a predefined lookup array (see LBSP_16bits_dbcross_lookup for more information)
         // @@@ todo: use array template to unroll loops & allow any descriptor size here
-        static_assert(std::numeric_limits<Tr1>::max()>=4*LBSP::DESC_SIZE_BITS,"output size is too small for descriptor config");
         static_assert(nChannels>0,"need at least one image channel");
         CV_DbgAssert(aanVals);
         CV_DbgAssert(anRefs);
-        desc_t nTempDesc = computeDescriptor_threshold(aanVals+(nChannels-1)*LBSP::DESC_SIZE_BITS,anRefs[nChannels-1],((anRefs[nChannels-1]>>nRelShift)+nAbsOffset)/2);
+        std::array<desc_t,nChannels> anDescs;
+        CxxUtils::unroll<nChannels>([&](int cn) {
+            anDescs[cn] = computeDescriptor_threshold(aanVals+cn*LBSP::DESC_SIZE_BITS,anRefs[cn],computeDescriptor_gradientThreshold<nAbsOffset,nRelShift>(anRefs[cn]));
+        });
+        LBSP::computeDescriptor_gradient<nChannels>(anDescs.data(),nGradX,nGradY,nGradMag);
+    }
+
+    //! utility function, returns the threshold used by 'computeDescriptor_gradient' for the given reference value (mixes rel+abs)
+    template<size_t nAbsOffset=20, size_t nRelShift=2>
+    inline static uchar computeDescriptor_gradientThreshold(const uchar nRef) {
+        return uchar(((nRef>>nRelShift)+nAbsOffset)/2);
+    }
+
+    //! utility function, single-point LBSP gradient estimation function for descriptors already thresholded w/ 'computeDescriptor_gradientThreshold' (returns max-channel only)
+    template<size_t nChannels, typename Tr1=char, typename Tr2=uchar>
+    inline static void computeDescriptor_gradient(const desc_t* const anDescs, Tr1& nGradX, Tr1& nGradY, Tr2& nGradMag) {
+        static_assert(std::numeric_limits<Tr1>::max()>=4*LBSP::DESC_SIZE_BITS,"output size is too small for descriptor config");
+        static_assert(nChannels>0,"need at least one image channel");
+        CV_DbgAssert(anDescs);
+        desc_t nTempDesc = anDescs[nChannels-1];
         nGradMag = (Tr2)DistanceUtils::popcount(nTempDesc);
         CxxUtils::unroll<nChannels-1>([&](int cn) {
-            desc_t nNewTempDesc = computeDescriptor_threshold(aanVals+cn*LBSP::DESC_SIZE_BITS,anRefs[cn],((anRefs[cn]>>nRelShift)+nAbsOffset)/2);
-            const Tr2 nNewGradMag = (Tr2)DistanceUtils::popcount(nNewTempDesc);
+            const Tr2 nNewGradMag = (Tr2)DistanceUtils::popcount(anDescs[cn]);
             if(nGradMag<nNewGradMag) {
                 nGradMag = nNewGradMag;
-                nTempDesc = nNewTempDesc;
+                nTempDesc = anDescs[cn];
             }
         });
         nGradX = (Tr1)DistanceUtils::popcount(nTempDesc&s_nDesc_16bitdbcross_GradX_Pos)-(Tr1)DistanceUtils::popcount(nTempDesc&s_nDesc_16bitdbcross_GradX_Neg);
@@ -245,10 +321,14 @@ public:
 protected:
     //! classic 'compute' implementation, based on the regular DescriptorExtractor::computeImpl arguments & expected output
     virtual void computeImpl(const cv::Mat& oImage, std::vector<cv::KeyPoint>& voKeypoints, cv::Mat& oDescriptors) const;
-    const bool m_bOnlyUsingAbsThreshold;
-    const float m_fRelThreshold;
-    const size_t m_nThreshold;
+    //! fills the per-reference-intensity threshold LUT matching this extractor's parameters (used by the dense kernel)
+    void getThresholdLUT(std::array<uchar,UCHAR_MAX+1>& anThresholdLUT) const;
+    bool m_bOnlyUsingAbsThreshold;
+    float m_fRelThreshold;
+    size_t m_nThreshold;
     cv::Mat m_oRefImage;
+    //! defines whether sparse keypoints are bucketed by row blocks before extraction (runtime option, not serialized)
+    bool m_bUseSpatialBatching;
 
     // arrays below do not rely on std::array to avoid multi-dim init problems w/ static constexpr in header files
 
@@ -299,3 +379,266 @@ protected:
 //#endif //(!HAVE_SSE2)
     }
 };
+
+//! compile-time LBSP sampling pattern definitions, specialized by descriptor size (in bits); see LBSP_ for the matching kernels
+template<size_t nDescBits>
+struct LBSPPattern;
+
+//! LBSP 8 bit pattern, using the 3x3 ring around the reference pixel (fastest, but least discriminative)
+template<>
+struct LBSPPattern<8> {
+    //! utility, specifies the integer type used to store descriptors
+    typedef uchar desc_t;
+    //! utility, specifies the pixel size of the pattern used (width and height)
+    static constexpr size_t PATCH_SIZE = 3;
+    //  O O O        6  5  4
+    //  O X O   =>   7  X  3
+    //  O O O        0  1  2
+    static constexpr int s_anIdxLUT_x[8] = {-1, 0, 1, 1, 1, 0,-1,-1};
+    static constexpr int s_anIdxLUT_y[8] = {-1,-1,-1, 0, 1, 1, 1, 0};
+};
+
+//! LBSP 16 bit pattern, identical to the 5x5 double-cross pattern used by the LBSP extractor (see LBSP::s_anIdxLUT_16bitdbcross)
+template<>
+struct LBSPPattern<16> {
+    //! utility, specifies the integer type used to store descriptors
+    typedef ushort desc_t;
+    //! utility, specifies the pixel size of the pattern used (width and height)
+    static constexpr size_t PATCH_SIZE = 5;
+    static constexpr int s_anIdxLUT_x[16] = {-2, 2, 0, 0,  -2, 2, 2,-2,   0,-1, 0, 1,  -1, 1, 1,-1};
+    static constexpr int s_anIdxLUT_y[16] = { 0, 0,-2, 2,   2,-2, 2,-2,   1, 0,-1, 0,  -1, 1,-1, 1};
+};
+
+//! LBSP 32 bit pattern, using the 16 bit double-cross pattern plus 16 samples on the 7x7 outer ring
+template<>
+struct LBSPPattern<32> {
+    //! utility, specifies the integer type used to store descriptors
+    typedef uint32_t desc_t;
+    //! utility, specifies the pixel size of the pattern used (width and height)
+    static constexpr size_t PATCH_SIZE = 7;
+    //  O   O O O   O       20 .. 29 19 28 .. 22
+    //    O   O   O         ..  4 ..  3 ..  6 ..
+    //  O   O O O   O       30 .. 15  8 13 .. 27
+    //  O O O X O O O   =>  16  0  9  X 11  1 17
+    //  O   O O O   O       31 .. 12 10 14 .. 26
+    //    O   O   O         ..  7 ..  2 ..  5 ..
+    //  O   O O O   O       23 .. 24 18 25 .. 21
+    static constexpr int s_anIdxLUT_x[32] = {-2, 2, 0, 0,  -2, 2, 2,-2,   0,-1, 0, 1,  -1, 1, 1,-1,
+                                             -3, 3, 0, 0,  -3, 3, 3,-3,  -1, 1, 3, 3,   1,-1,-3,-3};
+    static constexpr int s_anIdxLUT_y[32] = { 0, 0,-2, 2,   2,-2, 2,-2,   1, 0,-1, 0,  -1, 1,-1, 1,
+                                              0, 0,-3, 3,   3,-3, 3,-3,  -3,-3,-1, 1,   3, 3, 1,-1};
+};
+
+//! LBSP 64 bit pattern, using the whole 7x7 neighborhood plus 16 samples on the 9x9 outer ring
+template<>
+struct LBSPPattern<64> {
+    //! utility, specifies the integer type used to store descriptors
+    typedef uint64_t desc_t;
+    //! utility, specifies the pixel size of the pattern used (width and height)
+    static constexpr size_t PATCH_SIZE = 9;
+    // note: the first 32 samples are identical to the 32 bit pattern's, so only the 48 samples of a 7x7 patch would not fill 64 bits
+    static constexpr int s_anIdxLUT_x[64] = {-2, 2, 0, 0,  -2, 2, 2,-2,   0,-1, 0, 1,  -1, 1, 1,-1,
+                                             -3, 3, 0, 0,  -3, 3, 3,-3,  -1, 1, 3, 3,   1,-1,-3,-3,
+                                             -1, 1, 2, 2,   1,-1,-2,-2,  -2, 2, 3, 3,   2,-2,-3,-3,
+                                             -4, 4, 0, 0,  -4, 4, 4,-4,  -2, 2, 4, 4,   2,-2,-4,-4};
+    static constexpr int s_anIdxLUT_y[64] = { 0, 0,-2, 2,   2,-2, 2,-2,   1, 0,-1, 0,  -1, 1,-1, 1,
+                                              0, 0,-3, 3,   3,-3, 3,-3,  -3,-3,-1, 1,   3, 3, 1,-1,
+                                             -2,-2,-1, 1,   2, 2, 1,-1,  -3,-3,-2, 2,   3, 3, 2,-2,
+                                              0, 0,-4, 4,   4,-4, 4,-4,  -4,-4,-2, 2,   4, 4, 2,-2};
+};
+
+/*!
+    Local Binary Similarity Pattern (LBSP) kernels templated on descriptor size (8/16/32/64 bits, see LBSPPattern).
+
+    LBSP_<16> uses the same pattern as the LBSP extractor above; smaller patterns trade accuracy for throughput, and
+    larger ones do the opposite. Dense descriptor images store 8/16/32 bit descriptors in CV_8U/CV_16U/CV_32S
+    matrices, and 64 bit descriptors as pairs of CV_32S channels (OpenCV has no 64 bit integer type, and raw bits
+    stored as doubles could form NaNs); in all cases, descriptors should be accessed via 'ptr<desc_t>(...)'.
+ */
+template<size_t nDescBits>
+struct LBSP_ : public LBSPPattern<nDescBits> {
+    static_assert(nDescBits==8 || nDescBits==16 || nDescBits==32 || nDescBits==64,"unsupported LBSP descriptor size");
+    //! utility, specifies the integer type used to store descriptors
+    typedef typename LBSPPattern<nDescBits>::desc_t desc_t;
+    static_assert(sizeof(desc_t)*8==nDescBits,"bad descriptor storage type for pattern");
+    //! utility, specifies the number of bytes per descriptor
+    static constexpr size_t DESC_SIZE = nDescBits/8;
+    //! utility, specifies the number of bits per descriptor
+    static constexpr size_t DESC_SIZE_BITS = nDescBits;
+    //! utility, specifies the matrix depth used to store dense descriptor images
+    static constexpr int DESC_MAT_DEPTH = (nDescBits==8)?CV_8U:(nDescBits==16)?CV_16U:CV_32S;
+    //! utility, specifies the number of matrix channels used to store a single descriptor in dense descriptor images
+    static constexpr int DESC_MAT_CN = (nDescBits==64)?2:1;
+
+    //! utility function, shortcut/lightweight/direct single-point LBSP computation function for extra flexibility (single-channel lookup + thresholding)
+    template<size_t nChannels>
+    inline static void computeDescriptor(const cv::Mat& oInputImg, const uchar nRef, const int _x, const int _y, const size_t _c, const uchar nThreshold, desc_t& nDesc) {
+        alignas(16) std::array<uchar,DESC_SIZE_BITS> anVals;
+        LBSP_::computeDescriptor_lookup<nChannels>(oInputImg,_x,_y,_c,anVals.data());
+        nDesc = LBSP_::computeDescriptor_threshold(anVals.data(),nRef,nThreshold);
+    }
+
+    //! utility function, shortcut/lightweight/direct single-point LBSP computation function for extra flexibility (single-channel lookup only)
+    template<size_t nChannels>
+    inline static void computeDescriptor_lookup(const cv::Mat& oInputImg, const int _x, const int _y, const size_t _c, uchar* anVals) {
+        static_assert(nChannels>0,"need at least one image channel");
+        CV_DbgAssert(anVals);
+        CV_DbgAssert(!oInputImg.empty());
+        CV_DbgAssert(oInputImg.type()==CV_8UC(nChannels) && _c<nChannels);
+        CV_DbgAssert(_x>=(int)LBSP_::PATCH_SIZE/2 && _y>=(int)LBSP_::PATCH_SIZE/2);
+        CV_DbgAssert(_x<oInputImg.cols-(int)LBSP_::PATCH_SIZE/2 && _y<oInputImg.rows-(int)LBSP_::PATCH_SIZE/2);
+        const ptrdiff_t nRowStep = (ptrdiff_t)oInputImg.step.p[0];
+        const ptrdiff_t nColStep = (ptrdiff_t)oInputImg.step.p[1];
+        const uchar* const anData = oInputImg.data+_y*nRowStep+_x*nColStep+_c;
+        CxxUtils::unroll<DESC_SIZE_BITS>([&](int n) {
+            anVals[n] = anData[nRowStep*LBSP_::s_anIdxLUT_y[n]+nColStep*LBSP_::s_anIdxLUT_x[n]];
+        });
+    }
+
+    //! utility function, shortcut/lightweight/direct single-point LBSP computation function for extra flexibility (array thresholding only, array must be 16-byte aligned)
+    inline static desc_t computeDescriptor_threshold(const uchar* const anVals, const uchar nRef, const uchar nThreshold) {
+        CV_DbgAssert(anVals);
+#if HAVE_SSE2
+        // 16 comparisons per chunk; 'dist > threshold' <=> saturated 'dist - threshold' is non-zero
+        CV_DbgAssert(((uintptr_t)anVals&15)==0);
+        const __m128i _anRefVals = _mm_set1_epi8((char)nRef);
+        const __m128i _anThresholds = _mm_set1_epi8((char)nThreshold);
+        const __m128i _anZeros = _mm_setzero_si128();
+        desc_t nDesc = 0;
+        for(size_t nChunkIdx=0; nChunkIdx<(DESC_SIZE_BITS+15)/16; ++nChunkIdx) {
+            const __m128i _anInputVals = (DESC_SIZE_BITS<16)?_mm_loadl_epi64((const __m128i*)anVals):_mm_load_si128((const __m128i*)(anVals+nChunkIdx*16));
+            const __m128i _anDistVals = _mm_or_si128(_mm_subs_epu8(_anInputVals,_anRefVals),_mm_subs_epu8(_anRefVals,_anInputVals));
+            const int nNotGreaterMask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_subs_epu8(_anDistVals,_anThresholds),_anZeros));
+            nDesc |= desc_t(desc_t(~nNotGreaterMask&0xFFFF)<<(nChunkIdx*16));
+        }
+        return nDesc;
+#else //(!HAVE_SSE2)
+        desc_t nDesc = 0;
+        CxxUtils::unroll<DESC_SIZE_BITS>([&](int n) {
+            nDesc |= desc_t(desc_t(DistanceUtils::L1dist(anVals[n],nRef)>nThreshold)<<n);
+        });
+        return nDesc;
+#endif //(!HAVE_SSE2)
+    }
+
+    //! utility function, computes the descriptors of all pixels of an 8-bit image using a per-reference-intensity threshold LUT (uses AVX2 if supported at runtime, see LBSP::isUsingVectorizedKernel; border pixels are set to zero)
+    static void computeDescriptorImage(const cv::Mat& oInputImg, const cv::Mat& oRefImg, const uchar* anThresholdLUT, cv::Mat& oDesc);
+};
+
+template<size_t nDescBits>
+constexpr size_t LBSP_<nDescBits>::DESC_SIZE;
+template<size_t nDescBits>
+constexpr size_t LBSP_<nDescBits>::DESC_SIZE_BITS;
+template<size_t nDescBits>
+constexpr int LBSP_<nDescBits>::DESC_MAT_DEPTH;
+template<size_t nDescBits>
+constexpr int LBSP_<nDescBits>::DESC_MAT_CN;
+
+/*!
+    Per-frame LBSP descriptor image cache, used to share intra-frame descriptors between consumers of the same frames.
+
+    Entries are keyed by (frame id, threshold LUT), and are computed only once via LBSP::computeDescriptorImage(...)
+    by the first consumer asking for them; other consumers then receive a read-only reference to the same image. Only
+    the entries of the latest frame ids are kept alive by the cache itself; descriptor images already handed out stay
+    valid until their last reference is released. Frame ids must uniquely identify frames for all cache users (i.e.
+    all consumers must be fed the same frames in lockstep, and the cache should be cleared when restarting a stream).
+ */
+class LBSPDescriptorCache {
+public:
+    //! threshold LUT type used as part of the cache key (indexed by reference intensity)
+    using ThresholdLUT = std::array<uchar,UCHAR_MAX+1>;
+    //! constructor; entries whose frame id lags the latest one by more than 'nMaxFrameLag' are dropped
+    LBSPDescriptorCache(size_t nMaxFrameLag=1);
+    //! returns the intra-frame descriptor image of the given frame using the given threshold LUT (computed on first request, thread-safe)
+    std::shared_ptr<const cv::Mat> get(const cv::Mat& oImage, size_t nFrameId, const ThresholdLUT& anThresholdLUT);
+    //! drops all cached entries (descriptor images already handed out remain valid)
+    void clear();
+    //! returns the number of descriptor images computed by the cache so far
+    size_t getComputeCount() const;
+    //! returns the number of requests answered without computing a new descriptor image
+    size_t getHitCount() const;
+protected:
+    //! cache key type: frame id + threshold LUT
+    using Key = std::pair<size_t,ThresholdLUT>;
+    //! cached entries (futures, so that concurrent requests for the same key wait for a single computation)
+    std::map<Key,std::shared_future<std::shared_ptr<const cv::Mat>>> m_mEntries;
+    //! protects the entry map and counters
+    mutable std::mutex m_oMutex;
+    //! maximum frame id lag before entries are dropped
+    const size_t m_nMaxFrameLag;
+    //! latest frame id requested so far
+    size_t m_nLatestFrameId;
+    //! internal counters for cache usage stats
+    size_t m_nComputeCount,m_nHitCount;
+};
+
+/*!
+    Multi-scale LBSP engine, used to share pyramid levels and lookup maps between multi-scale LBSP consumers.
+
+    A summed-area table of the input image is built in a single pass (on first use), and all downscaled levels are
+    then derived from it independently via box filtering; level 'n' is the average of 2^n x 2^n pixel blocks (partial
+    blocks are averaged over their actual size), and arbitrary scale factors can also be sampled directly. Pyramid level
+    images and their LBSP lookup maps are only materialized when first requested, and are kept until the next call to
+    'setImage' (buffers are reused across images of the same size). This class is not thread-safe.
+ */
+class LBSPPyramid {
+public:
+    //! default constructor; an image must be provided via 'setImage' before any level can be requested
+    LBSPPyramid();
+    //! sets the input image (8-bit, 1 to 4 channels, kept by reference) and invalidates all previously materialized levels
+    void setImage(const cv::Mat& oImage);
+    //! returns the channel count of the current input image
+    size_t getChannels() const;
+    //! returns the size of the given pyramid level (each level halves the size of the previous one, rounding up)
+    cv::Size getLevelSize(size_t nLevel) const;
+    //! returns the image of the given pyramid level (level 0 is the input image itself), materializing it if needed
+    cv::Mat getLevelImage(size_t nLevel);
+    //! returns the LBSP lookup map of the given pyramid level (DESC_SIZE_BITS values per channel per pixel, borders filled with the center value), materializing it if needed
+    cv::Mat getLevelLookup(size_t nLevel);
+    //! materializes the image of the given pyramid level and allocates (without filling) its LBSP lookup map; returns the level image (not thread-safe)
+    cv::Mat getLevelLookupBuffer(size_t nLevel);
+    //! fills rows [nRowBegin,nRowEnd[ of a lookup map allocated via 'getLevelLookupBuffer' (thread-safe for disjoint row ranges; the map is not flagged as materialized)
+    void fillLevelLookupRows(size_t nLevel, int nRowBegin, int nRowEnd);
+    //! returns the (possibly partially filled) lookup map buffer of the given pyramid level, as allocated via 'getLevelLookupBuffer'
+    cv::Mat getLevelLookupData(size_t nLevel) const;
+    //! releases all lookup map buffers (e.g. when switching to on-the-fly lookups via 'computeLookup')
+    void releaseLookups();
+    //! computes the lookup values of a single level image pixel exactly as stored in lookup maps (borders filled with the center value)
+    template<size_t nChannels>
+    static void computeLookup(const cv::Mat& oLevelImage, int nColIdx, int nRowIdx, uchar* aanLUT);
+    //! computes the LBSP descriptor image of the given pyramid level (1 or 3 channels only) using the provided absolute threshold LUT
+    void getLevelDescriptors(size_t nLevel, const uchar* anThresholdLUT, cv::Mat& oDesc);
+    //! computes a box-filtered version of the input image at an arbitrary scale factor in ]0,1] directly from the summed-area table
+    void getScaledImage(double dScale, cv::Mat& oOutput);
+    //! computes the LBSP descriptor image (1 or 3 channels only) at an arbitrary scale factor in ]0,1] using the provided absolute threshold LUT
+    void getScaledDescriptors(double dScale, const uchar* anThresholdLUT, cv::Mat& oDesc);
+    //! returns whether the image (or lookup map) of the given pyramid level is currently materialized
+    bool isLevelMaterialized(size_t nLevel, bool bLookup=false) const;
+protected:
+    //! builds the summed-area table of the current input image, if not already done
+    void buildIntegral();
+    //! current input image (shallow copy)
+    cv::Mat m_oImage;
+    //! summed-area table of the input image (uint32 accumulators, read as wrapping unsigned values)
+    cv::Mat m_oIntegral;
+    //! per-level image and lookup map buffers
+    std::vector<cv::Mat> m_voLevelImages,m_voLevelLookups;
+    //! per-level image and lookup map validity flags
+    std::vector<bool> m_vbLevelImageReady,m_vbLevelLookupReady;
+    //! defines whether the summed-area table is up-to-date with the input image
+    bool m_bIntegralReady;
+};
+
+template<size_t nChannels>
+void LBSPPyramid::computeLookup(const cv::Mat& oLevelImage, int nColIdx, int nRowIdx, uchar* aanLUT) {
+    constexpr int nBorderSize = (int)LBSP::PATCH_SIZE/2;
+    CV_DbgAssert(oLevelImage.type()==CV_8UC(nChannels) && aanLUT);
+    CV_DbgAssert(nColIdx>=0 && nColIdx<oLevelImage.cols && nRowIdx>=0 && nRowIdx<oLevelImage.rows);
+    if(nRowIdx<nBorderSize || nRowIdx>=oLevelImage.rows-nBorderSize || nColIdx<nBorderSize || nColIdx>=oLevelImage.cols-nBorderSize) {
+        const uchar* const anCenter = oLevelImage.ptr<uchar>(nRowIdx)+nColIdx*nChannels;
+        for(size_t c=0; c<nChannels; ++c)
+            std::fill_n(aanLUT+c*LBSP::DESC_SIZE_BITS,LBSP::DESC_SIZE_BITS,anCenter[c]);
+    }
+    else
+        LBSP::computeDescriptor_lookup<nChannels>(oLevelImage,nColIdx,nRowIdx,aanLUT);
+}
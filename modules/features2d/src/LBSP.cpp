@@ -23,29 +23,51 @@ constexpr int LBSP::s_anIdxLUT_16bitdbcross_GradX[16];
 constexpr int LBSP::s_anIdxLUT_16bitdbcross_GradY[16];
 constexpr LBSP::IdxLUTOffsetArray LBSP::s_oIdxLUT_16bitdbcross_x;
 constexpr LBSP::IdxLUTOffsetArray LBSP::s_oIdxLUT_16bitdbcross_y;
+constexpr size_t LBSPPattern<8>::PATCH_SIZE;
+constexpr int LBSPPattern<8>::s_anIdxLUT_x[8];
+constexpr int LBSPPattern<8>::s_anIdxLUT_y[8];
+constexpr size_t LBSPPattern<16>::PATCH_SIZE;
+constexpr int LBSPPattern<16>::s_anIdxLUT_x[16];
+constexpr int LBSPPattern<16>::s_anIdxLUT_y[16];
+constexpr size_t LBSPPattern<32>::PATCH_SIZE;
+constexpr int LBSPPattern<32>::s_anIdxLUT_x[32];
+constexpr int LBSPPattern<32>::s_anIdxLUT_y[32];
+constexpr size_t LBSPPattern<64>::PATCH_SIZE;
+constexpr int LBSPPattern<64>::s_anIdxLUT_x[64];
+constexpr int LBSPPattern<64>::s_anIdxLUT_y[64];
 
 LBSP::LBSP(size_t nThreshold) :
         m_bOnlyUsingAbsThreshold(true),
         m_fRelThreshold(0), // unused
         m_nThreshold(nThreshold),
-        m_oRefImage() {}
+        m_oRefImage(),
+        m_bUseSpatialBatching(true) {}
 
 LBSP::LBSP(float fRelThreshold, size_t nThresholdOffset) :
         m_bOnlyUsingAbsThreshold(false),
         m_fRelThreshold(fRelThreshold),
         m_nThreshold(nThresholdOffset),
-        m_oRefImage() {
+        m_oRefImage(),
+        m_bUseSpatialBatching(true) {
     CV_Assert(m_fRelThreshold>=0);
 }
 
 LBSP::~LBSP() {}
 
-void LBSP::read(const cv::FileNode& /*fn*/) {
-    // ... = fn["..."];
+void LBSP::read(const cv::FileNode& oNode) {
+    if(!oNode["only_using_abs_threshold"].empty())
+        m_bOnlyUsingAbsThreshold = (int)oNode["only_using_abs_threshold"]!=0;
+    if(!oNode["rel_threshold"].empty())
+        m_fRelThreshold = (float)oNode["rel_threshold"];
+    if(!oNode["threshold"].empty())
+        m_nThreshold = (size_t)(int)oNode["threshold"];
+    CV_Assert(m_fRelThreshold>=0);
 }
 
-void LBSP::write(cv::FileStorage& /*fs*/) const {
-    //fs << "..." << ...;
+void LBSP::write(cv::FileStorage& oFS) const {
+    oFS << "only_using_abs_threshold" << (int)m_bOnlyUsingAbsThreshold;
+    oFS << "rel_threshold" << m_fRelThreshold;
+    oFS << "threshold" << (int)m_nThreshold;
 }
 
 void LBSP::setReference(const cv::Mat& img) {
@@ -73,82 +95,127 @@ size_t LBSP::getAbsThreshold() const {
     return m_nThreshold;
 }
 
+void LBSP::setSpatialBatching(bool bEnabled) {
+    m_bUseSpatialBatching = bEnabled;
+}
+
+bool LBSP::isUsingSpatialBatching() const {
+    return m_bUseSpatialBatching;
+}
+
+// keypoint sets smaller than this are processed in their original order (sorting would not pay off)
+static constexpr size_t s_nSparseBatchMinKeyPoints = 256;
+// height of the row blocks used to bucket sparse keypoints (a block + its patch margins should fit in L2 for HD images)
+static constexpr int s_nSparseBatchRowBlockSize = 16;
+// number of keypoints to look ahead of when prefetching patch data
+static constexpr size_t s_nSparseBatchPrefetchDist = 8;
+// number of keypoints whose lookup values are gathered before being thresholded at once (see LBSP::computeDescriptor_threshold)
+static constexpr size_t s_nSparseBatchThresholdSize = 32;
+
+// fills the processing order of the given (validated) keypoints, bucketed by row block, and sorted by column inside each
+// block, so that neighboring patches are visited while they are still cached (two stable counting sorts, O(N+cols+rows))
+static void lbsp_sortKeyPointsByRowBlocks(const std::vector<cv::KeyPoint>& voKeyPoints, const cv::Size& oImgSize, std::vector<uint32_t>& vnOrder) {
+    CV_Assert(voKeyPoints.size()<=size_t(UINT32_MAX));
+    const size_t nKeyPoints = voKeyPoints.size();
+    const size_t nBlockCount = size_t((oImgSize.height+s_nSparseBatchRowBlockSize-1)/s_nSparseBatchRowBlockSize);
+    std::vector<uint32_t> vnCounts(std::max(size_t(oImgSize.width),nBlockCount)+1), vnTempOrder(nKeyPoints);
+    for(size_t k=0; k<nKeyPoints; ++k)
+        ++vnCounts[size_t(voKeyPoints[k].pt.x)+1];
+    for(size_t nColIdx=1; nColIdx<=size_t(oImgSize.width); ++nColIdx)
+        vnCounts[nColIdx] += vnCounts[nColIdx-1];
+    for(size_t k=0; k<nKeyPoints; ++k)
+        vnTempOrder[vnCounts[size_t(voKeyPoints[k].pt.x)]++] = uint32_t(k);
+    std::fill(vnCounts.begin(),vnCounts.end(),0u);
+    for(size_t k=0; k<nKeyPoints; ++k)
+        ++vnCounts[size_t(voKeyPoints[k].pt.y)/s_nSparseBatchRowBlockSize+1];
+    for(size_t nBlockIdx=1; nBlockIdx<=nBlockCount; ++nBlockIdx)
+        vnCounts[nBlockIdx] += vnCounts[nBlockIdx-1];
+    vnOrder.resize(nKeyPoints);
+    for(const uint32_t k : vnTempOrder)
+        vnOrder[vnCounts[size_t(voKeyPoints[k].pt.y)/s_nSparseBatchRowBlockSize]++] = k;
+}
+
+// prefetches the input patch (and reference pixel, if different) of the given keypoint
+static inline void lbsp_prefetchPatch(const cv::Mat& oInputImg, const cv::Mat& oRefMat, const cv::KeyPoint& oKeyPoint) {
+#if HAVE_SSE2
+    const int x = (int)oKeyPoint.pt.x;
+    const int y = (int)oKeyPoint.pt.y;
+    const uchar* const pPatchData = oInputImg.data+oInputImg.step.p[0]*(y-(int)LBSP::PATCH_SIZE/2)+oInputImg.step.p[1]*(x-(int)LBSP::PATCH_SIZE/2);
+    CxxUtils::unroll<LBSP::PATCH_SIZE>([&](size_t nRowOffset) {
+        _mm_prefetch((const char*)(pPatchData+nRowOffset*oInputImg.step.p[0]),_MM_HINT_T0);
+    });
+    if(oRefMat.data!=oInputImg.data)
+        _mm_prefetch((const char*)(oRefMat.data+oRefMat.step.p[0]*y+oRefMat.step.p[1]*x),_MM_HINT_T0);
+#else //(!HAVE_SSE2)
+    UNUSED(oInputImg);
+    UNUSED(oRefMat);
+    UNUSED(oKeyPoint);
+#endif //(!HAVE_SSE2)
+}
+
+// processes keypoints in the given order (or in their original order if none is given), and writes descriptors either
+// in a single column (in the original keypoint order), or at the keypoint locations in an image-sized matrix
+template<typename TThresholdFunc>
 static inline void lbsp_computeImpl(const cv::Mat& oInputImg, const cv::Mat& oRefImg, const std::vector<cv::KeyPoint>& voKeyPoints,
-                                    cv::Mat& oDesc, bool bSingleColumnDesc, size_t nThreshold) {
+                                    const std::vector<uint32_t>& vnOrder, cv::Mat& oDesc, bool bSingleColumnDesc, TThresholdFunc lThreshold) {
     static_assert(LBSP::DESC_SIZE==2,"bad assumptions in impl below");
     CV_DbgAssert(oRefImg.empty() || (oRefImg.size==oInputImg.size && oRefImg.type()==oInputImg.type()));
     CV_DbgAssert(oInputImg.type()==CV_8UC1 || oInputImg.type()==CV_8UC3);
+    CV_DbgAssert(vnOrder.empty() || vnOrder.size()==voKeyPoints.size());
     const size_t nChannels = (size_t)oInputImg.channels();
     const cv::Mat& oRefMat = oRefImg.empty()?oInputImg:oRefImg;
     CV_DbgAssert(oInputImg.isContinuous() && oRefMat.isContinuous());
     const size_t nKeyPoints = voKeyPoints.size();
-    const uchar t = cv::saturate_cast<uchar>(nThreshold);
-    if(nChannels==1) {
-        if(bSingleColumnDesc)
-            oDesc.create((int)nKeyPoints,1,CV_16UC1);
-        else
-            oDesc.create(oInputImg.size(),CV_16UC1);
-        for(size_t k=0; k<nKeyPoints; ++k) {
-            const int x = (int)voKeyPoints[k].pt.x;
-            const int y = (int)voKeyPoints[k].pt.y;
-            LBSP::computeDescriptor<1>(oInputImg,oRefMat.at<uchar>(y,x),x,y,0,t,oDesc.at<ushort>((int)k));
-        }
-        return;
-    }
-    else { //nChannels==3
-        if(bSingleColumnDesc)
-            oDesc.create((int)nKeyPoints,1,CV_16UC3);
-        else
-            oDesc.create(oInputImg.size(),CV_16UC3);
-        alignas(16) const std::array<uchar,3> anThreshold = {t,t,t};
-        for(size_t k=0; k<nKeyPoints; ++k) {
+    if(bSingleColumnDesc)
+        oDesc.create((int)nKeyPoints,1,CV_16UC((int)nChannels));
+    else
+        oDesc.create(oInputImg.size(),CV_16UC((int)nChannels));
+    const bool bUseOrder = !vnOrder.empty();
+    // lookup values of a batch of keypoints are gathered first, and then all thresholded at once via the runtime-dispatched kernel
+    alignas(32) std::array<uchar,s_nSparseBatchThresholdSize*3*LBSP::DESC_SIZE_BITS> aanBatchVals;
+    std::array<uchar,s_nSparseBatchThresholdSize*3> anBatchRefs, anBatchThresholds;
+    std::array<LBSP::desc_t,s_nSparseBatchThresholdSize*3> anBatchDescs;
+    std::array<ushort*,s_nSparseBatchThresholdSize> apBatchResults;
+    for(size_t nBatchBegin=0; nBatchBegin<nKeyPoints; nBatchBegin+=s_nSparseBatchThresholdSize) {
+        const size_t nBatchSize = std::min(s_nSparseBatchThresholdSize,nKeyPoints-nBatchBegin);
+        for(size_t nBatchIdx=0; nBatchIdx<nBatchSize; ++nBatchIdx) {
+            const size_t i = nBatchBegin+nBatchIdx;
+            if(bUseOrder && i+s_nSparseBatchPrefetchDist<nKeyPoints)
+                lbsp_prefetchPatch(oInputImg,oRefMat,voKeyPoints[vnOrder[i+s_nSparseBatchPrefetchDist]]);
+            const size_t k = bUseOrder?size_t(vnOrder[i]):i;
             const int x = (int)voKeyPoints[k].pt.x;
             const int y = (int)voKeyPoints[k].pt.y;
-            const uchar* acRef = oRefMat.data+oInputImg.step.p[0]*y+oInputImg.step.p[1]*x;
-            LBSP::computeDescriptor(oInputImg,acRef,x,y,anThreshold,((ushort*)(oDesc.data+oDesc.step.p[0]*k)));
+            const uchar* acRef = oRefMat.data+oRefMat.step.p[0]*y+oRefMat.step.p[1]*x;
+            apBatchResults[nBatchIdx] = (ushort*)(bSingleColumnDesc?(oDesc.data+oDesc.step.p[0]*k):(oDesc.data+oDesc.step.p[0]*y+oDesc.step.p[1]*x));
+            const size_t nDescIdx = nBatchIdx*nChannels;
+            if(nChannels==1)
+                LBSP::computeDescriptor_lookup<1>(oInputImg,x,y,0,aanBatchVals.data()+nDescIdx*LBSP::DESC_SIZE_BITS);
+            else //nChannels==3
+                LBSP::computeDescriptor_lookup<3>(oInputImg,x,y,aanBatchVals.data()+nDescIdx*LBSP::DESC_SIZE_BITS);
+            for(size_t c=0; c<nChannels; ++c) {
+                anBatchRefs[nDescIdx+c] = acRef[c];
+                anBatchThresholds[nDescIdx+c] = lThreshold(acRef[c]);
+            }
         }
+        LBSP::computeDescriptor_threshold(aanBatchVals.data(),anBatchRefs.data(),anBatchThresholds.data(),nBatchSize*nChannels,anBatchDescs.data());
+        for(size_t nBatchIdx=0; nBatchIdx<nBatchSize; ++nBatchIdx)
+            for(size_t c=0; c<nChannels; ++c)
+                apBatchResults[nBatchIdx][c] = anBatchDescs[nBatchIdx*nChannels+c];
     }
 }
 
 static inline void lbsp_computeImpl(const cv::Mat& oInputImg, const cv::Mat& oRefImg, const std::vector<cv::KeyPoint>& voKeyPoints,
-                                    cv::Mat& oDesc, bool bSingleColumnDesc, float fThreshold, size_t nThresholdOffset) {
-    static_assert(LBSP::DESC_SIZE==2,"bad assumptions in impl below");
-    CV_DbgAssert(oRefImg.empty() || (oRefImg.size==oInputImg.size && oRefImg.type()==oInputImg.type()));
-    CV_DbgAssert(oInputImg.type()==CV_8UC1 || oInputImg.type()==CV_8UC3);
+                                    const std::vector<uint32_t>& vnOrder, cv::Mat& oDesc, bool bSingleColumnDesc, size_t nThreshold) {
+    const uchar t = cv::saturate_cast<uchar>(nThreshold);
+    lbsp_computeImpl(oInputImg,oRefImg,voKeyPoints,vnOrder,oDesc,bSingleColumnDesc,[t](uchar){return t;});
+}
+
+static inline void lbsp_computeImpl(const cv::Mat& oInputImg, const cv::Mat& oRefImg, const std::vector<cv::KeyPoint>& voKeyPoints,
+                                    const std::vector<uint32_t>& vnOrder, cv::Mat& oDesc, bool bSingleColumnDesc, float fThreshold, size_t nThresholdOffset) {
     CV_DbgAssert(fThreshold>=0);
-    const size_t nChannels = (size_t)oInputImg.channels();
-    const cv::Mat& oRefMat = oRefImg.empty()?oInputImg:oRefImg;
-    CV_DbgAssert(oInputImg.isContinuous() && oRefMat.isContinuous());
-    const size_t nKeyPoints = voKeyPoints.size();
-    if(nChannels==1) {
-        if(bSingleColumnDesc)
-            oDesc.create((int)nKeyPoints,1,CV_16UC1);
-        else
-            oDesc.create(oInputImg.size(),CV_16UC1);
-        for(size_t k=0; k<nKeyPoints; ++k) {
-            const int x = (int)voKeyPoints[k].pt.x;
-            const int y = (int)voKeyPoints[k].pt.y;
-            const uchar nThreshold = cv::saturate_cast<uchar>(oRefMat.at<uchar>(y,x)*fThreshold+nThresholdOffset);
-            ushort& nResult = bSingleColumnDesc?oDesc.at<ushort>((int)k):oDesc.at<ushort>(y,x);
-            LBSP::computeDescriptor<1>(oInputImg,oRefMat.at<uchar>(y,x),x,y,0,nThreshold,nResult);
-        }
-    }
-    else { //nChannels==3
-        if(bSingleColumnDesc)
-            oDesc.create((int)nKeyPoints,1,CV_16UC3);
-        else
-            oDesc.create(oInputImg.size(),CV_16UC3);
-        for(size_t k=0; k<nKeyPoints; ++k) {
-            const int x = (int)voKeyPoints[k].pt.x;
-            const int y = (int)voKeyPoints[k].pt.y;
-            const uchar* acRef = oRefMat.data+oInputImg.step.p[0]*y+oInputImg.step.p[1]*x;
-            alignas(16) const std::array<uchar,3> anThreshold = {cv::saturate_cast<uchar>(acRef[0]*fThreshold+nThresholdOffset),
-                                                                 cv::saturate_cast<uchar>(acRef[1]*fThreshold+nThresholdOffset),
-                                                                 cv::saturate_cast<uchar>(acRef[2]*fThreshold+nThresholdOffset)};
-            ushort* anResult = (ushort*)(bSingleColumnDesc?(oDesc.data+oDesc.step.p[0]*k):(oDesc.data+oDesc.step.p[0]*y+oDesc.step.p[1]*x));
-            LBSP::computeDescriptor(oInputImg,acRef,x,y,anThreshold,anResult);
-        }
-    }
+    lbsp_computeImpl(oInputImg,oRefImg,voKeyPoints,vnOrder,oDesc,bSingleColumnDesc,[fThreshold,nThresholdOffset](uchar nRef){
+        return cv::saturate_cast<uchar>(nRef*fThreshold+nThresholdOffset);
+    });
 }
 
 void LBSP::compute2(const cv::Mat& oImage, std::vector<cv::KeyPoint>& voKeypoints, cv::Mat& oDescriptors) const {
@@ -159,10 +226,13 @@ void LBSP::compute2(const cv::Mat& oImage, std::vector<cv::KeyPoint>& voKeypoint
         oDescriptors.release();
         return;
     }
+    std::vector<uint32_t> vnOrder;
+    if(m_bUseSpatialBatching && voKeypoints.size()>=s_nSparseBatchMinKeyPoints)
+        lbsp_sortKeyPointsByRowBlocks(voKeypoints,oImage.size(),vnOrder);
     if(m_bOnlyUsingAbsThreshold)
-        lbsp_computeImpl(oImage,m_oRefImage,voKeypoints,oDescriptors,false,m_nThreshold);
+        lbsp_computeImpl(oImage,m_oRefImage,voKeypoints,vnOrder,oDescriptors,false,m_nThreshold);
     else
-        lbsp_computeImpl(oImage,m_oRefImage,voKeypoints,oDescriptors,false,m_fRelThreshold,m_nThreshold);
+        lbsp_computeImpl(oImage,m_oRefImage,voKeypoints,vnOrder,oDescriptors,false,m_fRelThreshold,m_nThreshold);
 }
 
 void LBSP::compute2(const std::vector<cv::Mat>& voImageCollection, std::vector<std::vector<cv::KeyPoint> >& vvoPointCollection, std::vector<cv::Mat>& voDescCollection) const {
@@ -172,6 +242,314 @@ void LBSP::compute2(const std::vector<cv::Mat>& voImageCollection, std::vector<s
         compute2(voImageCollection[i], vvoPointCollection[i], voDescCollection[i]);
 }
 
+// local define used to compile the AVX2/AVX-512 kernels (selected at runtime, see ParallelUtils::getSIMDLevel)
+#if HAVE_SIMD_DISPATCH
+#define USE_AVX2_DENSE_KERNEL 1
+#define AVX2_TARGET_ATTRIB SIMD_TARGET_ATTRIB("avx2")
+#define AVX512_TARGET_ATTRIB SIMD_TARGET_ATTRIB("avx512f,avx512bw,avx2")
+#else //(!HAVE_SIMD_DISPATCH)
+#define USE_AVX2_DENSE_KERNEL 0
+#endif //(!HAVE_SIMD_DISPATCH)
+
+// SIMD level of the inline (compile-time) kernels used as fallbacks when no runtime-dispatched kernel is available
+#if HAVE_SIMD_SUPPORT && HAVE_SSE2
+static constexpr ParallelUtils::eSIMDLevel s_eFallbackSIMDLevel = ParallelUtils::eSIMD_SSE2;
+#else //(!HAVE_SIMD_SUPPORT || !HAVE_SSE2)
+static constexpr ParallelUtils::eSIMDLevel s_eFallbackSIMDLevel = ParallelUtils::eSIMD_Scalar;
+#endif //(!HAVE_SIMD_SUPPORT || !HAVE_SSE2)
+
+// note: in an interleaved row, the neighbor of byte 'b' (pixel b/nChannels, channel b%nChannels) at (dx,dy) is always at 'b+dy*step+dx*nChannels',
+// so all kernels below process rows as flat byte arrays, and descriptor 'b' is written at the same (desc_t) index in the output row
+template<size_t nDescBits>
+static inline void lbsp_computeDenseRow(const uchar* pInputRow, const uchar* pRefRow, const std::array<ptrdiff_t,nDescBits>& anOffsets,
+                                        const uchar* anThresholdLUT, size_t nBegin, size_t nEnd, typename LBSP_<nDescBits>::desc_t* pDescRow) {
+    typedef typename LBSP_<nDescBits>::desc_t desc_t;
+    for(size_t b=nBegin; b<nEnd; ++b) {
+        const uchar nRef = pRefRow[b];
+        const uchar nThreshold = anThresholdLUT[nRef];
+        desc_t nDesc = 0;
+        CxxUtils::unroll<nDescBits>([&](int n) {
+            nDesc |= desc_t(desc_t(DistanceUtils::L1dist(pInputRow[b+anOffsets[n]],nRef)>nThreshold)<<n);
+        });
+        pDescRow[b] = nDesc;
+    }
+}
+
+#if USE_AVX2_DENSE_KERNEL
+
+// the functions below interleave the comparison byte planes of 32 consecutive descriptors (plane 'k' holds bits [8k,8k+7]) into
+// full descriptors; unpacks work within 128-bit lanes, so the low/high lane halves are reordered via lane permutations before storing
+
+AVX2_TARGET_ATTRIB static inline void lbsp_storeDescPlanes_AVX2(const __m256i* _aanPlanes, uchar* pDescs) {
+    _mm256_storeu_si256((__m256i*)pDescs,_aanPlanes[0]);
+}
+
+AVX2_TARGET_ATTRIB static inline void lbsp_storeDescPlanes_AVX2(const __m256i* _aanPlanes, ushort* pDescs) {
+    const __m256i _anDescs_A = _mm256_unpacklo_epi8(_aanPlanes[0],_aanPlanes[1]); // descs [0-7], [16-23]
+    const __m256i _anDescs_B = _mm256_unpackhi_epi8(_aanPlanes[0],_aanPlanes[1]); // descs [8-15], [24-31]
+    _mm256_storeu_si256((__m256i*)pDescs,_mm256_permute2x128_si256(_anDescs_A,_anDescs_B,0x20));
+    _mm256_storeu_si256((__m256i*)(pDescs+16),_mm256_permute2x128_si256(_anDescs_A,_anDescs_B,0x31));
+}
+
+AVX2_TARGET_ATTRIB static inline void lbsp_storeDescPlanes_AVX2(const __m256i* _aanPlanes, uint32_t* pDescs) {
+    const __m256i _anWords01_A = _mm256_unpacklo_epi8(_aanPlanes[0],_aanPlanes[1]); // descs [0-7], [16-23]
+    const __m256i _anWords01_B = _mm256_unpackhi_epi8(_aanPlanes[0],_aanPlanes[1]); // descs [8-15], [24-31]
+    const __m256i _anWords23_A = _mm256_unpacklo_epi8(_aanPlanes[2],_aanPlanes[3]);
+    const __m256i _anWords23_B = _mm256_unpackhi_epi8(_aanPlanes[2],_aanPlanes[3]);
+    const __m256i _anDescs_A = _mm256_unpacklo_epi16(_anWords01_A,_anWords23_A); // descs [0-3], [16-19]
+    const __m256i _anDescs_B = _mm256_unpackhi_epi16(_anWords01_A,_anWords23_A); // descs [4-7], [20-23]
+    const __m256i _anDescs_C = _mm256_unpacklo_epi16(_anWords01_B,_anWords23_B); // descs [8-11], [24-27]
+    const __m256i _anDescs_D = _mm256_unpackhi_epi16(_anWords01_B,_anWords23_B); // descs [12-15], [28-31]
+    _mm256_storeu_si256((__m256i*)pDescs,_mm256_permute2x128_si256(_anDescs_A,_anDescs_B,0x20));
+    _mm256_storeu_si256((__m256i*)(pDescs+8),_mm256_permute2x128_si256(_anDescs_C,_anDescs_D,0x20));
+    _mm256_storeu_si256((__m256i*)(pDescs+16),_mm256_permute2x128_si256(_anDescs_A,_anDescs_B,0x31));
+    _mm256_storeu_si256((__m256i*)(pDescs+24),_mm256_permute2x128_si256(_anDescs_C,_anDescs_D,0x31));
+}
+
+AVX2_TARGET_ATTRIB static inline void lbsp_storeDescPlanes_AVX2(const __m256i* _aanPlanes, uint64_t* pDescs) {
+    __m256i _aanWords[8], _aanDWords[8];
+    for(size_t k=0; k<4; ++k) {
+        _aanWords[k*2] = _mm256_unpacklo_epi8(_aanPlanes[k*2],_aanPlanes[k*2+1]); // descs [0-7], [16-23] (bytes 2k/2k+1)
+        _aanWords[k*2+1] = _mm256_unpackhi_epi8(_aanPlanes[k*2],_aanPlanes[k*2+1]); // descs [8-15], [24-31] (bytes 2k/2k+1)
+    }
+    for(size_t k=0; k<2; ++k) {
+        for(size_t h=0; h<2; ++h) {
+            _aanDWords[k*4+h*2] = _mm256_unpacklo_epi16(_aanWords[k*4+h],_aanWords[k*4+2+h]); // descs [8h+0 - 8h+3] (bytes 4k to 4k+3)
+            _aanDWords[k*4+h*2+1] = _mm256_unpackhi_epi16(_aanWords[k*4+h],_aanWords[k*4+2+h]); // descs [8h+4 - 8h+7] (bytes 4k to 4k+3)
+        }
+    }
+    for(size_t q=0; q<4; ++q) {
+        const __m256i _anDescs_A = _mm256_unpacklo_epi32(_aanDWords[q],_aanDWords[4+q]); // descs [4q+0, 4q+1], [16+4q+0, 16+4q+1]
+        const __m256i _anDescs_B = _mm256_unpackhi_epi32(_aanDWords[q],_aanDWords[4+q]); // descs [4q+2, 4q+3], [16+4q+2, 16+4q+3]
+        _mm256_storeu_si256((__m256i*)(pDescs+q*4),_mm256_permute2x128_si256(_anDescs_A,_anDescs_B,0x20));
+        _mm256_storeu_si256((__m256i*)(pDescs+16+q*4),_mm256_permute2x128_si256(_anDescs_A,_anDescs_B,0x31));
+    }
+}
+
+// computes the descriptors of 32 consecutive row bytes at once; returns the index of the first byte left for the scalar kernel
+template<size_t nDescBits>
+AVX2_TARGET_ATTRIB static size_t lbsp_computeDenseRow_AVX2(const uchar* pInputRow, const uchar* pRefRow, const std::array<ptrdiff_t,nDescBits>& anOffsets,
+                                                           const uchar* anThresholdLUT, bool bConstThreshold, size_t nBegin, size_t nEnd,
+                                                           typename LBSP_<nDescBits>::desc_t* pDescRow) {
+    alignas(32) std::array<uchar,32> anThresholds;
+    const __m256i _anZeros = _mm256_setzero_si256();
+    __m256i _anThresholds = _mm256_set1_epi8((char)anThresholdLUT[0]);
+    size_t b = nBegin;
+    for(; b+32<=nEnd; b+=32) {
+        const __m256i _anRefs = _mm256_loadu_si256((const __m256i*)(pRefRow+b));
+        if(!bConstThreshold) {
+            for(size_t i=0; i<32; ++i)
+                anThresholds[i] = anThresholdLUT[pRefRow[b+i]];
+            _anThresholds = _mm256_load_si256((const __m256i*)anThresholds.data());
+        }
+        __m256i _aanPlanes[nDescBits/8];
+        for(size_t k=0; k<nDescBits/8; ++k)
+            _aanPlanes[k] = _anZeros;
+        for(size_t n=0; n<nDescBits; ++n) { // note: plain loop, lambdas do not inherit the target attribute
+            const __m256i _anVals = _mm256_loadu_si256((const __m256i*)(pInputRow+b+anOffsets[n]));
+            const __m256i _anDists = _mm256_sub_epi8(_mm256_max_epu8(_anVals,_anRefs),_mm256_min_epu8(_anVals,_anRefs));
+            // dist > threshold <=> saturated (dist - threshold) != 0
+            const __m256i _abNotGreater = _mm256_cmpeq_epi8(_mm256_subs_epu8(_anDists,_anThresholds),_anZeros);
+            _aanPlanes[n/8] = _mm256_or_si256(_aanPlanes[n/8],_mm256_andnot_si256(_abNotGreater,_mm256_set1_epi8((char)(1<<(n%8)))));
+        }
+        lbsp_storeDescPlanes_AVX2(_aanPlanes,pDescRow+b);
+    }
+    return b;
+}
+
+#endif //USE_AVX2_DENSE_KERNEL
+
+bool LBSP::isUsingVectorizedKernel() {
+#if USE_AVX2_DENSE_KERNEL
+    static const bool s_bSupported = ParallelUtils::getSIMDLevel()>=ParallelUtils::eSIMD_AVX2;
+#else //(!USE_AVX2_DENSE_KERNEL)
+    static const bool s_bSupported = false;
+#endif //(!USE_AVX2_DENSE_KERNEL)
+    static const bool s_bRegistered = [](){
+        const ParallelUtils::eSIMDLevel eLevel = s_bSupported?ParallelUtils::eSIMD_AVX2:s_eFallbackSIMDLevel;
+        ParallelUtils::registerDispatchedKernel("LBSP::computeDescriptorImage",eLevel);
+        ParallelUtils::registerDispatchedKernel("LBSP::calcDescDistMap",eLevel);
+        return true;
+    }();
+    UNUSED(s_bRegistered);
+    return s_bSupported;
+}
+
+static void lbsp_thresholdLookups(const uchar* aanVals, const uchar* anRefs, const uchar* anThresholds, size_t nCount, LBSP::desc_t* anDescs) {
+    for(size_t n=0; n<nCount; ++n)
+        anDescs[n] = LBSP::computeDescriptor_threshold(aanVals+n*LBSP::DESC_SIZE_BITS,anRefs[n],anThresholds[n]);
+}
+
+#if USE_AVX2_DENSE_KERNEL
+
+// 'dist > threshold' is evaluated as 'saturated (dist - threshold) != 0' on 2 lookup arrays (one per 128-bit lane) at once
+AVX2_TARGET_ATTRIB static void lbsp_thresholdLookups_AVX2(const uchar* aanVals, const uchar* anRefs, const uchar* anThresholds, size_t nCount, LBSP::desc_t* anDescs) {
+    static_assert(LBSP::DESC_SIZE_BITS==16 && sizeof(LBSP::desc_t)==2,"bad assumptions in impl below");
+    size_t n = 0;
+    for(; n+2<=nCount; n+=2) {
+        const __m256i _anVals = _mm256_loadu_si256((const __m256i*)(aanVals+n*LBSP::DESC_SIZE_BITS));
+        const __m256i _anRefs = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_set1_epi8((char)anRefs[n])),_mm_set1_epi8((char)anRefs[n+1]),1);
+        const __m256i _anThresholds = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_set1_epi8((char)anThresholds[n])),_mm_set1_epi8((char)anThresholds[n+1]),1);
+        const __m256i _anDists = _mm256_or_si256(_mm256_subs_epu8(_anVals,_anRefs),_mm256_subs_epu8(_anRefs,_anVals));
+        const uint32_t nBits = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_subs_epu8(_anDists,_anThresholds),_mm256_setzero_si256()));
+        anDescs[n] = LBSP::desc_t(nBits);
+        anDescs[n+1] = LBSP::desc_t(nBits>>16);
+    }
+    lbsp_thresholdLookups(aanVals+n*LBSP::DESC_SIZE_BITS,anRefs+n,anThresholds+n,nCount-n,anDescs+n);
+}
+
+// same as above, with 4 lookup arrays per 512-bit register, and the comparison mask used directly as descriptor bits
+AVX512_TARGET_ATTRIB static void lbsp_thresholdLookups_AVX512(const uchar* aanVals, const uchar* anRefs, const uchar* anThresholds, size_t nCount, LBSP::desc_t* anDescs) {
+    static_assert(LBSP::DESC_SIZE_BITS==16 && sizeof(LBSP::desc_t)==2,"bad assumptions in impl below");
+    size_t n = 0;
+    for(; n+4<=nCount; n+=4) {
+        const __m512i _anVals = _mm512_loadu_si512((const void*)(aanVals+n*LBSP::DESC_SIZE_BITS));
+        __m512i _anRefs = _mm512_castsi128_si512(_mm_set1_epi8((char)anRefs[n]));
+        __m512i _anThresholds = _mm512_castsi128_si512(_mm_set1_epi8((char)anThresholds[n]));
+        _anRefs = _mm512_inserti32x4(_anRefs,_mm_set1_epi8((char)anRefs[n+1]),1);
+        _anThresholds = _mm512_inserti32x4(_anThresholds,_mm_set1_epi8((char)anThresholds[n+1]),1);
+        _anRefs = _mm512_inserti32x4(_anRefs,_mm_set1_epi8((char)anRefs[n+2]),2);
+        _anThresholds = _mm512_inserti32x4(_anThresholds,_mm_set1_epi8((char)anThresholds[n+2]),2);
+        _anRefs = _mm512_inserti32x4(_anRefs,_mm_set1_epi8((char)anRefs[n+3]),3);
+        _anThresholds = _mm512_inserti32x4(_anThresholds,_mm_set1_epi8((char)anThresholds[n+3]),3);
+        const __m512i _anDists = _mm512_or_si512(_mm512_subs_epu8(_anVals,_anRefs),_mm512_subs_epu8(_anRefs,_anVals));
+        const uint64_t nBits = (uint64_t)_mm512_cmpgt_epu8_mask(_anDists,_anThresholds);
+        for(size_t nDescIdx=0; nDescIdx<4; ++nDescIdx)
+            anDescs[n+nDescIdx] = LBSP::desc_t(nBits>>(nDescIdx*16));
+    }
+    lbsp_thresholdLookups_AVX2(aanVals+n*LBSP::DESC_SIZE_BITS,anRefs+n,anThresholds+n,nCount-n,anDescs+n);
+}
+
+#endif //USE_AVX2_DENSE_KERNEL
+
+void LBSP::computeDescriptor_threshold(const uchar* aanVals, const uchar* anRefs, const uchar* anThresholds, size_t nCount, desc_t* anDescs) {
+    typedef void(*ThresholdLookupsFunc)(const uchar*,const uchar*,const uchar*,size_t,desc_t*);
+    static const ThresholdLookupsFunc s_pFunc = ParallelUtils::selectDispatchedKernel<ThresholdLookupsFunc>("LBSP::computeDescriptor_threshold",{
+#if USE_AVX2_DENSE_KERNEL
+        {ParallelUtils::eSIMD_AVX512,lbsp_thresholdLookups_AVX512},
+        {ParallelUtils::eSIMD_AVX2,lbsp_thresholdLookups_AVX2},
+#endif //USE_AVX2_DENSE_KERNEL
+        {s_eFallbackSIMDLevel,lbsp_thresholdLookups},
+    });
+    CV_DbgAssert(!nCount || (aanVals && anRefs && anThresholds && anDescs));
+    s_pFunc(aanVals,anRefs,anThresholds,nCount,anDescs);
+}
+
+// resolves the kernels of this file at startup, so that they appear in the dispatch report before their first use
+static const struct LBSPDispatchInit {
+    LBSPDispatchInit() {
+        LBSP::isUsingVectorizedKernel();
+        LBSP::computeDescriptor_threshold(nullptr,nullptr,nullptr,0,nullptr);
+    }
+} s_oLBSPDispatchInit;
+
+void LBSP::computeDescriptorImage(const cv::Mat& oInputImg, const cv::Mat& oRefImg, const uchar* anThresholdLUT, cv::Mat& oDesc) {
+    static_assert(LBSP_<16>::PATCH_SIZE==LBSP::PATCH_SIZE && LBSP_<16>::DESC_SIZE==LBSP::DESC_SIZE,"bad assumptions in impl below");
+    LBSP_<16>::computeDescriptorImage(oInputImg,oRefImg,anThresholdLUT,oDesc);
+}
+
+template<size_t nDescBits>
+void LBSP_<nDescBits>::computeDescriptorImage(const cv::Mat& oInputImg, const cv::Mat& oRefImg, const uchar* anThresholdLUT, cv::Mat& oDesc) {
+    CV_Assert(!oInputImg.empty() && (oInputImg.type()==CV_8UC1 || oInputImg.type()==CV_8UC3) && anThresholdLUT);
+    CV_Assert(oRefImg.empty() || (oRefImg.size==oInputImg.size && oRefImg.type()==oInputImg.type()));
+    CV_Assert(oDesc.data!=oInputImg.data && oDesc.data!=oRefImg.data);
+    const cv::Mat& oRefMat = oRefImg.empty()?oInputImg:oRefImg;
+    const int nChannels = oInputImg.channels();
+    const int nBorderSize = (int)LBSP_::PATCH_SIZE/2;
+    oDesc.create(oInputImg.size(),CV_MAKETYPE(DESC_MAT_DEPTH,nChannels*DESC_MAT_CN));
+    oDesc = cv::Scalar::all(0);
+    if(oInputImg.rows<=nBorderSize*2 || oInputImg.cols<=nBorderSize*2)
+        return;
+    std::array<ptrdiff_t,nDescBits> anOffsets;
+    for(size_t n=0; n<nDescBits; ++n)
+        anOffsets[n] = (ptrdiff_t)oInputImg.step.p[0]*LBSP_::s_anIdxLUT_y[n]+nChannels*LBSP_::s_anIdxLUT_x[n];
+    const size_t nBegin = size_t(nBorderSize*nChannels), nEnd = size_t((oInputImg.cols-nBorderSize)*nChannels);
+#if USE_AVX2_DENSE_KERNEL
+    const bool bUsingVectorizedKernel = LBSP::isUsingVectorizedKernel();
+    const bool bConstThreshold = std::all_of(anThresholdLUT,anThresholdLUT+UCHAR_MAX+1,[&](uchar nThreshold){return nThreshold==anThresholdLUT[0];});
+#endif //USE_AVX2_DENSE_KERNEL
+    for(int nRowIdx=nBorderSize; nRowIdx<oInputImg.rows-nBorderSize; ++nRowIdx) {
+        const uchar* pInputRow = oInputImg.ptr<uchar>(nRowIdx);
+        const uchar* pRefRow = oRefMat.ptr<uchar>(nRowIdx);
+        desc_t* pDescRow = oDesc.ptr<desc_t>(nRowIdx);
+        size_t nScalarBegin = nBegin;
+#if USE_AVX2_DENSE_KERNEL
+        if(bUsingVectorizedKernel)
+            nScalarBegin = lbsp_computeDenseRow_AVX2<nDescBits>(pInputRow,pRefRow,anOffsets,anThresholdLUT,bConstThreshold,nBegin,nEnd,pDescRow);
+#endif //USE_AVX2_DENSE_KERNEL
+        lbsp_computeDenseRow<nDescBits>(pInputRow,pRefRow,anOffsets,anThresholdLUT,nScalarBegin,nEnd,pDescRow);
+    }
+}
+
+template struct LBSP_<8>;
+template struct LBSP_<16>;
+template struct LBSP_<32>;
+template struct LBSP_<64>;
+
+void LBSP::getThresholdLUT(std::array<uchar,UCHAR_MAX+1>& anThresholdLUT) const {
+    for(size_t t=0; t<=UCHAR_MAX; ++t)
+        anThresholdLUT[t] = m_bOnlyUsingAbsThreshold?cv::saturate_cast<uchar>(m_nThreshold):cv::saturate_cast<uchar>(t*m_fRelThreshold+m_nThreshold);
+}
+
+void LBSP::compute2(const cv::Mat& oImage, cv::Mat& oDescriptors) const {
+    CV_Assert(!oImage.empty());
+    std::array<uchar,UCHAR_MAX+1> anThresholdLUT;
+    getThresholdLUT(anThresholdLUT);
+    LBSP::computeDescriptorImage(oImage,m_oRefImage,anThresholdLUT.data(),oDescriptors);
+}
+
+// runs 'lJob' for all indices in [0,nJobs) with (at most) one task per pool worker, each claiming indices via a shared counter,
+// so that no per-image task/future is allocated; the first exception thrown stops all workers, and is rethrown once they are done
+static inline void lbsp_runBatch(size_t nJobs, PlatformUtils::DynamicWorkerPool& oWorkerPool, const std::function<void(size_t)>& lJob) {
+    std::atomic_size_t nNextJobIdx(0);
+    std::atomic_bool bAbort(false);
+    const auto lWorker = [&]() {
+        size_t nJobIdx;
+        while(!bAbort && (nJobIdx=nNextJobIdx++)<nJobs) {
+            try {
+                lJob(nJobIdx);
+            }
+            catch(...) {
+                bAbort = true;
+                throw;
+            }
+        }
+    };
+    const size_t nTasks = std::min(nJobs,oWorkerPool.getWorkerCount());
+    std::vector<std::future<void>> voTasks;
+    voTasks.reserve(nTasks);
+    for(size_t nTaskIdx=0; nTaskIdx<nTasks; ++nTaskIdx)
+        voTasks.push_back(oWorkerPool.queueTask(lWorker));
+    for(std::future<void>& oTask : voTasks)
+        oTask.wait(); // all workers must be done before unwinding, as they reference local state
+    for(std::future<void>& oTask : voTasks)
+        oTask.get(); // will rethrow any exception caught in the workers
+}
+
+void LBSP::compute2(const std::vector<cv::Mat>& voImageCollection, std::vector<std::vector<cv::KeyPoint> >& vvoPointCollection, std::vector<cv::Mat>& voDescCollection,
+                    PlatformUtils::DynamicWorkerPool& oWorkerPool, const BatchCallback& lCallback) const {
+    CV_Assert(voImageCollection.size()==vvoPointCollection.size());
+    voDescCollection.resize(voImageCollection.size()); // note: existing output matrices are reused by 'create' if their size/type match
+    lbsp_runBatch(voImageCollection.size(),oWorkerPool,[&](size_t nImageIdx) {
+        compute2(voImageCollection[nImageIdx],vvoPointCollection[nImageIdx],voDescCollection[nImageIdx]);
+        if(lCallback)
+            lCallback(nImageIdx,voDescCollection[nImageIdx]);
+    });
+}
+
+void LBSP::compute2(const std::vector<cv::Mat>& voImageCollection, std::vector<cv::Mat>& voDescCollection,
+                    PlatformUtils::DynamicWorkerPool& oWorkerPool, const BatchCallback& lCallback) const {
+    std::array<uchar,UCHAR_MAX+1> anThresholdLUT;
+    getThresholdLUT(anThresholdLUT); // shared (read-only) by all workers
+    voDescCollection.resize(voImageCollection.size()); // note: existing output matrices are reused by 'create' if their size/type match
+    lbsp_runBatch(voImageCollection.size(),oWorkerPool,[&](size_t nImageIdx) {
+        CV_Assert(!voImageCollection[nImageIdx].empty());
+        LBSP::computeDescriptorImage(voImageCollection[nImageIdx],m_oRefImage,anThresholdLUT.data(),voDescCollection[nImageIdx]);
+        if(lCallback)
+            lCallback(nImageIdx,voDescCollection[nImageIdx]);
+    });
+}
+
 void LBSP::computeImpl(const cv::Mat& oImage, std::vector<cv::KeyPoint>& voKeypoints, cv::Mat& oDescriptors) const {
     CV_Assert(!oImage.empty());
     cv::KeyPointsFilter::runByImageBorder(voKeypoints,oImage.size(),PATCH_SIZE/2);
@@ -180,10 +558,13 @@ void LBSP::computeImpl(const cv::Mat& oImage, std::vector<cv::KeyPoint>& voKeypo
         oDescriptors.release();
         return;
     }
+    std::vector<uint32_t> vnOrder;
+    if(m_bUseSpatialBatching && voKeypoints.size()>=s_nSparseBatchMinKeyPoints)
+        lbsp_sortKeyPointsByRowBlocks(voKeypoints,oImage.size(),vnOrder);
     if(m_bOnlyUsingAbsThreshold)
-        lbsp_computeImpl(oImage,m_oRefImage,voKeypoints,oDescriptors,true,m_nThreshold);
+        lbsp_computeImpl(oImage,m_oRefImage,voKeypoints,vnOrder,oDescriptors,true,m_nThreshold);
     else
-        lbsp_computeImpl(oImage,m_oRefImage,voKeypoints,oDescriptors,true,m_fRelThreshold,m_nThreshold);
+        lbsp_computeImpl(oImage,m_oRefImage,voKeypoints,vnOrder,oDescriptors,true,m_fRelThreshold,m_nThreshold);
 }
 
 void LBSP::reshapeDesc(cv::Size oSize, const std::vector<cv::KeyPoint>& voKeypoints, const cv::Mat& oDescriptors, cv::Mat& oOutput) {
@@ -218,42 +599,84 @@ void LBSP::calcDescImgDiff(const cv::Mat& oDesc1, const cv::Mat& oDesc2, cv::Mat
     static_assert(LBSP::DESC_SIZE==2,"bad assumptions in impl below");
     CV_DbgAssert(oDesc1.size()==oDesc2.size() && oDesc1.type()==oDesc2.type());
     CV_DbgAssert(oDesc1.type()==CV_16UC1 || oDesc1.type()==CV_16UC3);
-    CV_DbgAssert(CV_MAT_DEPTH(oDesc1.type())==CV_16U);
-    CV_DbgAssert(oDesc1.step.p[0]==oDesc2.step.p[0] && oDesc1.step.p[1]==oDesc2.step.p[1]);
     const float fScaleFactor = (float)UCHAR_MAX/(LBSP::DESC_SIZE_BITS);
-    const size_t nChannels = CV_MAT_CN(oDesc1.type());
-    const size_t _step_row = oDesc1.step.p[0];
-    if(nChannels==1) {
-        oOutput.create(oDesc1.size(),CV_8UC1);
-        oOutput = cv::Scalar(0);
-        for(int i=0; i<oDesc1.rows; ++i) {
-            const size_t idx = _step_row*i;
-            const ushort* const desc1_ptr = (ushort*)(oDesc1.data+idx);
-            const ushort* const desc2_ptr = (ushort*)(oDesc2.data+idx);
-            for(int j=0; j<oDesc1.cols; ++j)
-                oOutput.at<uchar>(i,j) = (uchar)(fScaleFactor*DistanceUtils::hdist(desc1_ptr[j],desc2_ptr[j]));
+    const int nChannels = oDesc1.channels();
+    // raw distances are scaled via LUTs afterwards (same truncation as the original per-descriptor computations)
+    std::array<uchar,LBSP::DESC_SIZE_BITS+1> anScaledDists,anScaledDists_Merged;
+    for(size_t nDist=0; nDist<=LBSP::DESC_SIZE_BITS; ++nDist) {
+        anScaledDists[nDist] = (uchar)(fScaleFactor*nDist);
+        anScaledDists_Merged[nDist] = (uchar)((fScaleFactor*nDist)/3);
+    }
+    cv::Mat oDistMap;
+    LBSP::calcDescDistMap(oDesc1,oDesc2,oDistMap,false);
+    const bool bMergeChannels = bForceMergeChannels && nChannels==3;
+    oOutput.create(oDesc1.size(),bMergeChannels?CV_8UC1:CV_8UC(nChannels));
+    for(int nRowIdx=0; nRowIdx<oDesc1.rows; ++nRowIdx) {
+        const uchar* pDistRow = oDistMap.ptr<uchar>(nRowIdx);
+        uchar* pOutputRow = oOutput.ptr<uchar>(nRowIdx);
+        if(bMergeChannels) {
+            for(int nColIdx=0; nColIdx<oDesc1.cols; ++nColIdx)
+                pOutputRow[nColIdx] = uchar(anScaledDists_Merged[pDistRow[nColIdx*3]]+anScaledDists_Merged[pDistRow[nColIdx*3+1]]+anScaledDists_Merged[pDistRow[nColIdx*3+2]]);
+        }
+        else {
+            for(int nIdx=0; nIdx<oDesc1.cols*nChannels; ++nIdx)
+                pOutputRow[nIdx] = anScaledDists[pDistRow[nIdx]];
         }
     }
-    else { //nChannels==3
-        if(bForceMergeChannels)
-            oOutput.create(oDesc1.size(),CV_8UC1);
-        else
-            oOutput.create(oDesc1.size(),CV_8UC3);
-        oOutput = cv::Scalar::all(0);
-        for(int i=0; i<oDesc1.rows; ++i) {
-            const size_t idx =  _step_row*i;
-            const ushort* const desc1_ptr = (ushort*)(oDesc1.data+idx);
-            const ushort* const desc2_ptr = (ushort*)(oDesc2.data+idx);
-            uchar* output_ptr = oOutput.data + oOutput.step.p[0]*i;
-            for(int j=0; j<oDesc1.cols; ++j) {
-                for(size_t n=0;n<3; ++n) {
-                    const size_t idx2 = 3*j+n;
-                    if(bForceMergeChannels)
-                        output_ptr[j] += (uchar)((fScaleFactor*DistanceUtils::hdist(desc1_ptr[idx2],desc2_ptr[idx2]))/3);
-                    else
-                        output_ptr[idx2] = (uchar)(fScaleFactor*DistanceUtils::hdist(desc1_ptr[idx2],desc2_ptr[idx2]));
-                }
-            }
+}
+
+#if USE_AVX2_DENSE_KERNEL
+
+// computes the Hamming distances between two packed 16-bit descriptor arrays 32 at a time (nibble LUT popcount, no popcnt needed); returns the index of the first descriptor left for the scalar loop
+AVX2_TARGET_ATTRIB static size_t lbsp_calcDescDistRow_AVX2(const ushort* pDescRow1, const ushort* pDescRow2, size_t nDescCount, uchar* pDistRow) {
+    const __m256i _anNibbleLUT = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+    const __m256i _anLowNibbleMask = _mm256_set1_epi8(0x0F);
+    const __m256i _anLowByteMask = _mm256_set1_epi16(0x00FF);
+    size_t n = 0;
+    for(; n+32<=nDescCount; n+=32) {
+        __m256i _anDists[2];
+        for(size_t h=0; h<2; ++h) {
+            const __m256i _anXorVals = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(pDescRow1+n+h*16)),_mm256_loadu_si256((const __m256i*)(pDescRow2+n+h*16)));
+            const __m256i _anByteCounts = _mm256_add_epi8(_mm256_shuffle_epi8(_anNibbleLUT,_mm256_and_si256(_anXorVals,_anLowNibbleMask)),
+                                                          _mm256_shuffle_epi8(_anNibbleLUT,_mm256_and_si256(_mm256_srli_epi16(_anXorVals,4),_anLowNibbleMask)));
+            _anDists[h] = _mm256_add_epi16(_mm256_and_si256(_anByteCounts,_anLowByteMask),_mm256_srli_epi16(_anByteCounts,8));
+        }
+        // packs work within 128-bit lanes: (0-7,16-23,8-15,24-31) is reordered via a 64-bit permutation
+        _mm256_storeu_si256((__m256i*)(pDistRow+n),_mm256_permute4x64_epi64(_mm256_packus_epi16(_anDists[0],_anDists[1]),0xD8));
+    }
+    return n;
+}
+
+#endif //USE_AVX2_DENSE_KERNEL
+
+void LBSP::calcDescDistMap(const cv::Mat& oDesc1, const cv::Mat& oDesc2, cv::Mat& oDistMap, bool bMergeChannels) {
+    static_assert(LBSP::DESC_SIZE==2 && 3*LBSP::DESC_SIZE_BITS<=UCHAR_MAX,"bad assumptions in impl below");
+    CV_Assert(oDesc1.size()==oDesc2.size() && oDesc1.type()==oDesc2.type());
+    CV_Assert(oDesc1.type()==CV_16UC1 || oDesc1.type()==CV_16UC3);
+    const int nChannels = oDesc1.channels();
+    const bool bMergingChannels = bMergeChannels && nChannels>1;
+    oDistMap.create(oDesc1.size(),bMergingChannels?CV_8UC1:CV_8UC(nChannels));
+    const size_t nRowDescCount = size_t(oDesc1.cols*nChannels);
+    // when merging, per-channel distances go through a single row buffer, so the whole map is still computed in one pass
+    std::vector<uchar> vRowDists(bMergingChannels?nRowDescCount:0);
+#if USE_AVX2_DENSE_KERNEL
+    const bool bUsingVectorizedKernel = LBSP::isUsingVectorizedKernel();
+#endif //USE_AVX2_DENSE_KERNEL
+    for(int nRowIdx=0; nRowIdx<oDesc1.rows; ++nRowIdx) {
+        const ushort* pDescRow1 = oDesc1.ptr<ushort>(nRowIdx);
+        const ushort* pDescRow2 = oDesc2.ptr<ushort>(nRowIdx);
+        uchar* pDistRow = bMergingChannels?vRowDists.data():oDistMap.ptr<uchar>(nRowIdx);
+        size_t nDescIdx = 0;
+#if USE_AVX2_DENSE_KERNEL
+        if(bUsingVectorizedKernel)
+            nDescIdx = lbsp_calcDescDistRow_AVX2(pDescRow1,pDescRow2,nRowDescCount,pDistRow);
+#endif //USE_AVX2_DENSE_KERNEL
+        for(; nDescIdx<nRowDescCount; ++nDescIdx)
+            pDistRow[nDescIdx] = (uchar)DistanceUtils::hdist(pDescRow1[nDescIdx],pDescRow2[nDescIdx]);
+        if(bMergingChannels) {
+            uchar* pMergedDistRow = oDistMap.ptr<uchar>(nRowIdx);
+            for(int nColIdx=0; nColIdx<oDesc1.cols; ++nColIdx)
+                pMergedDistRow[nColIdx] = uchar(pDistRow[nColIdx*3]+pDistRow[nColIdx*3+1]+pDistRow[nColIdx*3+2]);
         }
     }
 }
@@ -322,3 +745,492 @@ std::string LBSP::getShaderFunctionSource(size_t nChannels, bool bUseSharedDataP
 }
 
 #endif //HAVE_GLSL
+
+LBSPDescriptorCache::LBSPDescriptorCache(size_t nMaxFrameLag) :
+        m_nMaxFrameLag(nMaxFrameLag),
+        m_nLatestFrameId(0),
+        m_nComputeCount(0),
+        m_nHitCount(0) {}
+
+std::shared_ptr<const cv::Mat> LBSPDescriptorCache::get(const cv::Mat& oImage, size_t nFrameId, const ThresholdLUT& anThresholdLUT) {
+    CV_Assert(!oImage.empty() && (oImage.type()==CV_8UC1 || oImage.type()==CV_8UC3));
+    std::shared_future<std::shared_ptr<const cv::Mat>> oEntry;
+    std::promise<std::shared_ptr<const cv::Mat>> oPromise;
+    bool bMustCompute = false;
+    {
+        std::mutex_lock_guard oLock(m_oMutex);
+        if(nFrameId>m_nLatestFrameId) {
+            m_nLatestFrameId = nFrameId;
+            for(auto oIter=m_mEntries.begin(); oIter!=m_mEntries.end();) {
+                if(oIter->first.first+m_nMaxFrameLag<m_nLatestFrameId)
+                    oIter = m_mEntries.erase(oIter);
+                else
+                    ++oIter;
+            }
+        }
+        Key oKey(nFrameId,anThresholdLUT);
+        auto oIter = m_mEntries.find(oKey);
+        if(oIter==m_mEntries.end()) {
+            oEntry = oPromise.get_future().share();
+            m_mEntries.emplace(std::move(oKey),oEntry);
+            bMustCompute = true;
+            ++m_nComputeCount;
+        }
+        else {
+            oEntry = oIter->second;
+            ++m_nHitCount;
+        }
+    }
+    if(bMustCompute) {
+        try {
+            auto pDesc = std::make_shared<cv::Mat>();
+            LBSP::computeDescriptorImage(oImage,cv::Mat(),anThresholdLUT.data(),*pDesc);
+            oPromise.set_value(std::move(pDesc));
+        }
+        catch(...) {
+            {
+                std::mutex_lock_guard oLock(m_oMutex);
+                m_mEntries.erase(Key(nFrameId,anThresholdLUT));
+            }
+            oPromise.set_exception(std::current_exception());
+        }
+    }
+    std::shared_ptr<const cv::Mat> pDesc = oEntry.get();
+    CV_Assert(pDesc->size()==oImage.size() && pDesc->channels()==oImage.channels());
+    return pDesc;
+}
+
+void LBSPDescriptorCache::clear() {
+    std::mutex_lock_guard oLock(m_oMutex);
+    m_mEntries.clear();
+    m_nLatestFrameId = 0;
+}
+
+size_t LBSPDescriptorCache::getComputeCount() const {
+    std::mutex_lock_guard oLock(m_oMutex);
+    return m_nComputeCount;
+}
+
+size_t LBSPDescriptorCache::getHitCount() const {
+    std::mutex_lock_guard oLock(m_oMutex);
+    return m_nHitCount;
+}
+
+// LZ4-style block codec used for descriptor image files: each block is a series of sequences made of a token byte (literal
+// count in the high nibble, match length minus 4 in the low nibble, where 15 means 'continued in 255-saturated extra bytes'),
+// the literals, a 2-byte little-endian match offset, and the extra match length bytes; the last sequence only holds literals
+static constexpr size_t s_nDescFileMinMatchLength = 4;
+static constexpr size_t s_nDescFileBlockSize = 1<<20;
+
+static inline void lbsp_writeSeqLength(std::vector<uchar>& vOutput, size_t nLength) {
+    for(; nLength>=UCHAR_MAX; nLength-=UCHAR_MAX)
+        vOutput.push_back(UCHAR_MAX);
+    vOutput.push_back((uchar)nLength);
+}
+
+static inline size_t lbsp_readSeqLength(const uchar* pInput, size_t nInputSize, size_t& nInputIdx) {
+    size_t nLength = 0;
+    uchar nByte;
+    do {
+        CV_Assert(nInputIdx<nInputSize);
+        nByte = pInput[nInputIdx++];
+        nLength += nByte;
+    } while(nByte==UCHAR_MAX);
+    return nLength;
+}
+
+static inline void lbsp_writeSequence(std::vector<uchar>& vOutput, const uchar* pLiterals, size_t nLiteralCount, size_t nMatchOffset, size_t nMatchLength) {
+    const size_t nMatchLengthCode = nMatchLength?nMatchLength-s_nDescFileMinMatchLength:0;
+    vOutput.push_back(uchar((std::min(nLiteralCount,size_t(15))<<4)|std::min(nMatchLengthCode,size_t(15))));
+    if(nLiteralCount>=15)
+        lbsp_writeSeqLength(vOutput,nLiteralCount-15);
+    vOutput.insert(vOutput.end(),pLiterals,pLiterals+nLiteralCount);
+    if(nMatchLength) {
+        vOutput.push_back(uchar(nMatchOffset&0xFF));
+        vOutput.push_back(uchar(nMatchOffset>>8));
+        if(nMatchLengthCode>=15)
+            lbsp_writeSeqLength(vOutput,nMatchLengthCode-15);
+    }
+}
+
+static void lbsp_compressBlock(const uchar* pInput, size_t nInputSize, std::vector<uchar>& vOutput) {
+    constexpr size_t nHashBits = 12, nMaxMatchOffset = USHRT_MAX;
+    std::array<uint32_t,size_t(1)<<nHashBits> anHashTable; // stores (last position + 1) of each 4-byte sequence hash
+    anHashTable.fill(0);
+    vOutput.clear();
+    size_t nAnchorIdx = 0, nInputIdx = 0;
+    while(nInputIdx+s_nDescFileMinMatchLength<=nInputSize) {
+        uint32_t nSeqVal;
+        memcpy(&nSeqVal,pInput+nInputIdx,sizeof(nSeqVal));
+        const size_t nHash = size_t((nSeqVal*2654435761u)>>(32-nHashBits));
+        const size_t nCandidateIdx = anHashTable[nHash];
+        anHashTable[nHash] = uint32_t(nInputIdx+1);
+        if(nCandidateIdx && nInputIdx-(nCandidateIdx-1)<=nMaxMatchOffset && !memcmp(pInput+nCandidateIdx-1,&nSeqVal,sizeof(nSeqVal))) {
+            const size_t nMatchIdx = nCandidateIdx-1;
+            size_t nMatchLength = s_nDescFileMinMatchLength;
+            while(nInputIdx+nMatchLength<nInputSize && pInput[nMatchIdx+nMatchLength]==pInput[nInputIdx+nMatchLength])
+                ++nMatchLength;
+            lbsp_writeSequence(vOutput,pInput+nAnchorIdx,nInputIdx-nAnchorIdx,nInputIdx-nMatchIdx,nMatchLength);
+            nInputIdx += nMatchLength;
+            nAnchorIdx = nInputIdx;
+        }
+        else
+            ++nInputIdx;
+    }
+    lbsp_writeSequence(vOutput,pInput+nAnchorIdx,nInputSize-nAnchorIdx,0,0);
+}
+
+static void lbsp_decompressBlock(const uchar* pInput, size_t nInputSize, uchar* pOutput, size_t nOutputSize) {
+    size_t nInputIdx = 0, nOutputIdx = 0;
+    while(nInputIdx<nInputSize) {
+        const uchar nToken = pInput[nInputIdx++];
+        size_t nLiteralCount = nToken>>4;
+        if(nLiteralCount==15)
+            nLiteralCount += lbsp_readSeqLength(pInput,nInputSize,nInputIdx);
+        CV_Assert(nInputIdx+nLiteralCount<=nInputSize && nOutputIdx+nLiteralCount<=nOutputSize);
+        memcpy(pOutput+nOutputIdx,pInput+nInputIdx,nLiteralCount);
+        nInputIdx += nLiteralCount;
+        nOutputIdx += nLiteralCount;
+        if(nInputIdx==nInputSize)
+            break; // last sequence only holds literals
+        CV_Assert(nInputIdx+2<=nInputSize);
+        const size_t nMatchOffset = size_t(pInput[nInputIdx])|(size_t(pInput[nInputIdx+1])<<8);
+        nInputIdx += 2;
+        size_t nMatchLength = (nToken&15);
+        if(nMatchLength==15)
+            nMatchLength += lbsp_readSeqLength(pInput,nInputSize,nInputIdx);
+        nMatchLength += s_nDescFileMinMatchLength;
+        CV_Assert(nMatchOffset>0 && nMatchOffset<=nOutputIdx && nOutputIdx+nMatchLength<=nOutputSize);
+        for(size_t nByteIdx=0; nByteIdx<nMatchLength; ++nByteIdx) // note: matches may overlap their own output (i.e. runs)
+            pOutput[nOutputIdx+nByteIdx] = pOutput[nOutputIdx+nByteIdx-nMatchOffset];
+        nOutputIdx += nMatchLength;
+    }
+    CV_Assert(nOutputIdx==nOutputSize);
+}
+
+static inline size_t lbsp_getDescBitsFromDepth(int nDepth) {
+    // note: 64 bit descriptors are also stored in CV_32S matrices (two channels each, see LBSP_), and cannot be deduced this way
+    return (nDepth==CV_8U)?8:(nDepth==CV_16U)?16:(nDepth==CV_32S)?32:0;
+}
+
+static inline int lbsp_getDescMatType(size_t nDescBits, size_t nChannels) {
+    return CV_MAKETYPE((nDescBits==8)?CV_8U:(nDescBits==16)?CV_16U:CV_32S,int(nChannels*((nDescBits==64)?2:1)));
+}
+
+void LBSP::writeDescImage(const std::string& sFilePath, const cv::Mat& oDesc, bool bCompress, size_t nDescBits) const {
+    static_assert(sizeof(DescFileHeader)==64,"unexpected descriptor file header padding");
+    if(nDescBits==0)
+        nDescBits = lbsp_getDescBitsFromDepth(oDesc.depth());
+    CV_Assert(!oDesc.empty() && oDesc.dims==2 && (nDescBits==8 || nDescBits==16 || nDescBits==32 || nDescBits==64));
+    const size_t nChannels = size_t(oDesc.channels())/((nDescBits==64)?2:1);
+    CV_Assert(nChannels>0 && oDesc.type()==lbsp_getDescMatType(nDescBits,nChannels));
+    const cv::Mat oContinuousDesc = oDesc.isContinuous()?oDesc:oDesc.clone();
+    DescFileHeader oHeader = {};
+    memcpy(oHeader.acMagic,"LBSPDESC",sizeof(oHeader.acMagic));
+    oHeader.nVersion = 1;
+    oHeader.nRows = (uint32_t)oDesc.rows;
+    oHeader.nCols = (uint32_t)oDesc.cols;
+    oHeader.nChannels = (uint32_t)nChannels;
+    oHeader.nDescBits = (uint32_t)nDescBits;
+    oHeader.nOnlyUsingAbsThreshold = (uint32_t)m_bOnlyUsingAbsThreshold;
+    oHeader.fRelThreshold = m_fRelThreshold;
+    oHeader.nThreshold = (uint32_t)m_nThreshold;
+    oHeader.nDataSize = uint64_t(oContinuousDesc.total()*oContinuousDesc.elemSize());
+    const uchar* pData = oContinuousDesc.data;
+    std::ofstream oFile(sFilePath,std::ios::out|std::ios::binary|std::ios::trunc);
+    lvAssert(oFile.is_open());
+    if(!bCompress) {
+        oHeader.nDataOffset = sizeof(DescFileHeader);
+        oFile.write((const char*)&oHeader,sizeof(oHeader));
+        oFile.write((const char*)pData,(std::streamsize)oHeader.nDataSize);
+    }
+    else {
+        // note: blocks that would not shrink are stored raw (i.e. their stored size equals their decompressed size)
+        oHeader.nBlockSize = (uint32_t)s_nDescFileBlockSize;
+        oHeader.nBlockCount = (uint32_t)((oHeader.nDataSize+s_nDescFileBlockSize-1)/s_nDescFileBlockSize);
+        oHeader.nDataOffset = sizeof(DescFileHeader);
+        std::vector<uint32_t> vnBlockSizes(oHeader.nBlockCount);
+        std::vector<std::vector<uchar>> vvBlocks(oHeader.nBlockCount);
+        for(size_t nBlockIdx=0; nBlockIdx<oHeader.nBlockCount; ++nBlockIdx) {
+            const size_t nBlockOffset = nBlockIdx*s_nDescFileBlockSize;
+            const size_t nRawBlockSize = std::min(s_nDescFileBlockSize,size_t(oHeader.nDataSize)-nBlockOffset);
+            lbsp_compressBlock(pData+nBlockOffset,nRawBlockSize,vvBlocks[nBlockIdx]);
+            if(vvBlocks[nBlockIdx].size()>=nRawBlockSize)
+                vvBlocks[nBlockIdx].assign(pData+nBlockOffset,pData+nBlockOffset+nRawBlockSize);
+            vnBlockSizes[nBlockIdx] = (uint32_t)vvBlocks[nBlockIdx].size();
+        }
+        oFile.write((const char*)&oHeader,sizeof(oHeader));
+        oFile.write((const char*)vnBlockSizes.data(),(std::streamsize)(vnBlockSizes.size()*sizeof(uint32_t)));
+        for(const std::vector<uchar>& vBlock : vvBlocks)
+            oFile.write((const char*)vBlock.data(),(std::streamsize)vBlock.size());
+    }
+    lvAssert(oFile.good());
+}
+
+namespace {
+
+    //! matrix allocator used to tie the lifetime of a memory-mapped descriptor file to all the matrix headers pointing into its data
+    struct DescFileMatAllocator : public cv::MatAllocator {
+        typedef std::shared_ptr<const PlatformUtils::MappedFile> MappingPtr;
+        cv::UMatData* allocate(int nDims, const int* anSizes, int nType, void* pData, size_t* anSteps, int nFlags, cv::UMatUsageFlags eUsageFlags) const override {
+            // note: only reached if a matrix header using this allocator is recreated; the new buffer then belongs to the default allocator
+            return cv::Mat::getStdAllocator()->allocate(nDims,anSizes,nType,pData,anSteps,nFlags,eUsageFlags);
+        }
+        bool allocate(cv::UMatData* pData, int nAccessFlags, cv::UMatUsageFlags eUsageFlags) const override {
+            return cv::Mat::getStdAllocator()->allocate(pData,nAccessFlags,eUsageFlags);
+        }
+        void deallocate(cv::UMatData* pData) const override {
+            if(!pData)
+                return;
+            CV_Assert(pData->refcount==0 && pData->urefcount==0);
+            delete (MappingPtr*)pData->userdata;
+            delete pData;
+        }
+        //! makes 'oMat' (a header over the mapped data) hold a reference to the mapping, so that copies of it keep the data alive
+        static void attach(cv::Mat& oMat, const MappingPtr& pMapping) {
+            static DescFileMatAllocator s_oAllocator;
+            CV_Assert(oMat.u==nullptr && oMat.isContinuous() && pMapping);
+            cv::UMatData* pData = new cv::UMatData(&s_oAllocator);
+            pData->data = pData->origdata = oMat.data;
+            pData->size = oMat.total()*oMat.elemSize();
+            pData->userdata = new MappingPtr(pMapping);
+            pData->refcount = 1;
+            oMat.u = pData;
+            oMat.allocator = &s_oAllocator;
+        }
+    };
+
+} // namespace
+
+LBSP::DescImage LBSP::readDescImage(const std::string& sFilePath) {
+    DescImage oOutput;
+    std::shared_ptr<const PlatformUtils::MappedFile> pMapping = std::make_shared<PlatformUtils::MappedFile>(sFilePath);
+    const uchar* pFileData = pMapping->data();
+    const size_t nFileSize = pMapping->size();
+    CV_Assert(nFileSize>=sizeof(DescFileHeader));
+    DescFileHeader& oHeader = oOutput.oHeader;
+    memcpy(&oHeader,pFileData,sizeof(DescFileHeader));
+    CV_Assert(!memcmp(oHeader.acMagic,"LBSPDESC",sizeof(oHeader.acMagic)) && oHeader.nVersion==1);
+    CV_Assert(oHeader.nDescBits==8 || oHeader.nDescBits==16 || oHeader.nDescBits==32 || oHeader.nDescBits==64);
+    CV_Assert(oHeader.nRows>0 && oHeader.nCols>0 && oHeader.nChannels>0 && oHeader.nChannels*((oHeader.nDescBits==64)?2:1)<=CV_CN_MAX);
+    const int nType = lbsp_getDescMatType(oHeader.nDescBits,oHeader.nChannels);
+    CV_Assert(oHeader.nDataSize==uint64_t(oHeader.nRows)*oHeader.nCols*oHeader.nChannels*(oHeader.nDescBits/8));
+    if(oHeader.nBlockCount==0) {
+        CV_Assert(oHeader.nDataOffset+oHeader.nDataSize<=nFileSize);
+        // note: the matrix points to the (copy-on-write) mapping, which stays alive for as long as any header references its data
+        oOutput.oDesc = cv::Mat((int)oHeader.nRows,(int)oHeader.nCols,nType,(void*)(pFileData+oHeader.nDataOffset));
+        DescFileMatAllocator::attach(oOutput.oDesc,pMapping);
+    }
+    else {
+        CV_Assert(oHeader.nBlockSize>0 && oHeader.nBlockCount==(oHeader.nDataSize+oHeader.nBlockSize-1)/oHeader.nBlockSize);
+        CV_Assert(oHeader.nDataOffset+oHeader.nBlockCount*sizeof(uint32_t)<=nFileSize);
+        std::vector<uint32_t> vnBlockSizes(oHeader.nBlockCount);
+        memcpy(vnBlockSizes.data(),pFileData+oHeader.nDataOffset,vnBlockSizes.size()*sizeof(uint32_t));
+        oOutput.oDesc.create((int)oHeader.nRows,(int)oHeader.nCols,nType);
+        size_t nBlockFileOffset = size_t(oHeader.nDataOffset)+vnBlockSizes.size()*sizeof(uint32_t);
+        for(size_t nBlockIdx=0; nBlockIdx<oHeader.nBlockCount; ++nBlockIdx) {
+            const size_t nBlockOffset = nBlockIdx*oHeader.nBlockSize;
+            const size_t nRawBlockSize = std::min(size_t(oHeader.nBlockSize),size_t(oHeader.nDataSize)-nBlockOffset);
+            CV_Assert(nBlockFileOffset+vnBlockSizes[nBlockIdx]<=nFileSize);
+            if(vnBlockSizes[nBlockIdx]==nRawBlockSize)
+                memcpy(oOutput.oDesc.data+nBlockOffset,pFileData+nBlockFileOffset,nRawBlockSize);
+            else
+                lbsp_decompressBlock(pFileData+nBlockFileOffset,vnBlockSizes[nBlockIdx],oOutput.oDesc.data+nBlockOffset,nRawBlockSize);
+            nBlockFileOffset += vnBlockSizes[nBlockIdx];
+        }
+    }
+    return oOutput;
+}
+
+
+// box-filters (and decimates) an image via its summed-area table; output pixel (r,c) is the rounded average of the input
+// block spanning rows [anRowBounds[r],anRowBounds[r+1]) and cols [anColBounds[c],anColBounds[c+1]) (bounds must increase)
+static void lbsp_boxResample(const cv::Mat& oIntegral, const std::vector<int>& vnRowBounds, const std::vector<int>& vnColBounds, cv::Mat& oOutput) {
+    const size_t nChannels = (size_t)oIntegral.channels();
+    CV_DbgAssert(vnRowBounds.size()>1 && vnColBounds.size()>1);
+    oOutput.create((int)vnRowBounds.size()-1,(int)vnColBounds.size()-1,CV_8UC((int)nChannels));
+    for(int nRowIdx=0; nRowIdx<oOutput.rows; ++nRowIdx) {
+        const int nBoxRows = vnRowBounds[nRowIdx+1]-vnRowBounds[nRowIdx];
+        const uint32_t* anTopRow = oIntegral.ptr<uint32_t>(vnRowBounds[nRowIdx]);
+        const uint32_t* anBottomRow = oIntegral.ptr<uint32_t>(vnRowBounds[nRowIdx+1]);
+        uchar* anOutputRow = oOutput.ptr<uchar>(nRowIdx);
+        for(int nColIdx=0; nColIdx<oOutput.cols; ++nColIdx) {
+            const size_t nLeftIdx = vnColBounds[nColIdx]*nChannels, nRightIdx = vnColBounds[nColIdx+1]*nChannels;
+            const uint32_t nBoxArea = uint32_t(nBoxRows*(vnColBounds[nColIdx+1]-vnColBounds[nColIdx]));
+            CV_DbgAssert(nBoxArea>0);
+            for(size_t c=0; c<nChannels; ++c) {
+                // unsigned wrap-around cancels out as long as the box sum itself fits in 32 bits
+                const uint32_t nBoxSum = anBottomRow[nRightIdx+c]-anBottomRow[nLeftIdx+c]-anTopRow[nRightIdx+c]+anTopRow[nLeftIdx+c];
+                anOutputRow[nColIdx*nChannels+c] = uchar((nBoxSum+nBoxArea/2)/nBoxArea);
+            }
+        }
+    }
+}
+
+template<size_t nChannels>
+static void lbsp_fillLookupRows(const cv::Mat& oImage, cv::Mat& oLookupMap, int nRowBegin, int nRowEnd) {
+    constexpr size_t nColLUTStep = LBSP::DESC_SIZE_BITS*nChannels;
+    CV_DbgAssert(oImage.type()==CV_8UC(nChannels) && oImage.isContinuous());
+    CV_DbgAssert(oLookupMap.rows==oImage.rows && oLookupMap.cols==int(oImage.cols*nColLUTStep));
+    CV_DbgAssert(nRowBegin>=0 && nRowBegin<=nRowEnd && nRowEnd<=oImage.rows);
+    for(int nRowIdx=nRowBegin; nRowIdx<nRowEnd; ++nRowIdx) {
+        uchar* const anLUTRow = oLookupMap.ptr<uchar>(nRowIdx);
+        for(int nColIdx=0; nColIdx<oImage.cols; ++nColIdx)
+            LBSPPyramid::computeLookup<nChannels>(oImage,nColIdx,nRowIdx,anLUTRow+nColIdx*nColLUTStep);
+    }
+}
+
+static void lbsp_fillLookupRows(const cv::Mat& oImage, cv::Mat& oLookupMap, int nRowBegin, int nRowEnd, size_t nChannels) {
+    if(nChannels==1)
+        lbsp_fillLookupRows<1>(oImage,oLookupMap,nRowBegin,nRowEnd);
+    else if(nChannels==2)
+        lbsp_fillLookupRows<2>(oImage,oLookupMap,nRowBegin,nRowEnd);
+    else if(nChannels==3)
+        lbsp_fillLookupRows<3>(oImage,oLookupMap,nRowBegin,nRowEnd);
+    else //nChannels==4
+        lbsp_fillLookupRows<4>(oImage,oLookupMap,nRowBegin,nRowEnd);
+}
+
+LBSPPyramid::LBSPPyramid() :
+        m_bIntegralReady(false) {}
+
+void LBSPPyramid::setImage(const cv::Mat& oImage) {
+    CV_Assert(!oImage.empty() && oImage.depth()==CV_8U && oImage.channels()<=4);
+    CV_Assert(oImage.isContinuous());
+    m_oImage = oImage;
+    m_bIntegralReady = false;
+    std::fill(m_vbLevelImageReady.begin(),m_vbLevelImageReady.end(),false);
+    std::fill(m_vbLevelLookupReady.begin(),m_vbLevelLookupReady.end(),false);
+}
+
+size_t LBSPPyramid::getChannels() const {
+    CV_Assert(!m_oImage.empty());
+    return (size_t)m_oImage.channels();
+}
+
+cv::Size LBSPPyramid::getLevelSize(size_t nLevel) const {
+    CV_Assert(!m_oImage.empty());
+    CV_Assert(nLevel<sizeof(int)*8-1);
+    const int nBlockSize = 1<<nLevel;
+    return cv::Size((m_oImage.cols+nBlockSize-1)>>nLevel,(m_oImage.rows+nBlockSize-1)>>nLevel);
+}
+
+cv::Mat LBSPPyramid::getLevelImage(size_t nLevel) {
+    CV_Assert(!m_oImage.empty());
+    if(nLevel==0)
+        return m_oImage;
+    if(m_voLevelImages.size()<=nLevel) {
+        m_voLevelImages.resize(nLevel+1);
+        m_voLevelLookups.resize(nLevel+1);
+        m_vbLevelImageReady.resize(nLevel+1,false);
+        m_vbLevelLookupReady.resize(nLevel+1,false);
+    }
+    if(!m_vbLevelImageReady[nLevel]) {
+        const int nBlockSize = 1<<nLevel;
+        CV_Assert(uint64_t(nBlockSize)*nBlockSize*UCHAR_MAX<=uint64_t(UINT32_MAX));
+        buildIntegral();
+        const cv::Size oLevelSize = getLevelSize(nLevel);
+        std::vector<int> vnRowBounds((size_t)oLevelSize.height+1), vnColBounds((size_t)oLevelSize.width+1);
+        for(size_t nRowIdx=0; nRowIdx<vnRowBounds.size(); ++nRowIdx)
+            vnRowBounds[nRowIdx] = std::min(int(nRowIdx<<nLevel),m_oImage.rows);
+        for(size_t nColIdx=0; nColIdx<vnColBounds.size(); ++nColIdx)
+            vnColBounds[nColIdx] = std::min(int(nColIdx<<nLevel),m_oImage.cols);
+        lbsp_boxResample(m_oIntegral,vnRowBounds,vnColBounds,m_voLevelImages[nLevel]);
+        m_vbLevelImageReady[nLevel] = true;
+    }
+    return m_voLevelImages[nLevel];
+}
+
+cv::Mat LBSPPyramid::getLevelLookup(size_t nLevel) {
+    if(!isLevelMaterialized(nLevel,true)) {
+        const cv::Mat oLevelImage = getLevelLookupBuffer(nLevel);
+        lbsp_fillLookupRows(oLevelImage,m_voLevelLookups[nLevel],0,oLevelImage.rows,getChannels());
+        m_vbLevelLookupReady[nLevel] = true;
+    }
+    return m_voLevelLookups[nLevel];
+}
+
+cv::Mat LBSPPyramid::getLevelLookupBuffer(size_t nLevel) {
+    const cv::Mat oLevelImage = getLevelImage(nLevel);
+    if(m_voLevelLookups.size()<=nLevel) {
+        m_voLevelLookups.resize(nLevel+1);
+        m_vbLevelLookupReady.resize(nLevel+1,false);
+    }
+    m_voLevelLookups[nLevel].create(oLevelImage.rows,int(oLevelImage.cols*LBSP::DESC_SIZE_BITS*getChannels()),CV_8UC1);
+    return oLevelImage;
+}
+
+void LBSPPyramid::fillLevelLookupRows(size_t nLevel, int nRowBegin, int nRowEnd) {
+    CV_DbgAssert(isLevelMaterialized(nLevel) && nLevel<m_voLevelLookups.size() && !m_voLevelLookups[nLevel].empty());
+    const cv::Mat& oLevelImage = (nLevel==0)?m_oImage:m_voLevelImages[nLevel];
+    lbsp_fillLookupRows(oLevelImage,m_voLevelLookups[nLevel],nRowBegin,nRowEnd,getChannels());
+}
+
+cv::Mat LBSPPyramid::getLevelLookupData(size_t nLevel) const {
+    CV_Assert(nLevel<m_voLevelLookups.size() && !m_voLevelLookups[nLevel].empty());
+    return m_voLevelLookups[nLevel];
+}
+
+void LBSPPyramid::releaseLookups() {
+    m_voLevelLookups.assign(m_voLevelLookups.size(),cv::Mat());
+    std::fill(m_vbLevelLookupReady.begin(),m_vbLevelLookupReady.end(),false);
+}
+
+void LBSPPyramid::getLevelDescriptors(size_t nLevel, const uchar* anThresholdLUT, cv::Mat& oDesc) {
+    LBSP::computeDescriptorImage(getLevelImage(nLevel),cv::Mat(),anThresholdLUT,oDesc);
+}
+
+void LBSPPyramid::getScaledImage(double dScale, cv::Mat& oOutput) {
+    CV_Assert(!m_oImage.empty());
+    CV_Assert(dScale>0 && dScale<=1);
+    const int nOutputRows = std::max(cvRound(m_oImage.rows*dScale),1);
+    const int nOutputCols = std::max(cvRound(m_oImage.cols*dScale),1);
+    // block bounds are floored, so each block spans either floor(1/scale) or ceil(1/scale) pixels along each axis
+    std::vector<int> vnRowBounds((size_t)nOutputRows+1), vnColBounds((size_t)nOutputCols+1);
+    for(size_t nRowIdx=0; nRowIdx<vnRowBounds.size(); ++nRowIdx)
+        vnRowBounds[nRowIdx] = int(uint64_t(nRowIdx)*m_oImage.rows/nOutputRows);
+    for(size_t nColIdx=0; nColIdx<vnColBounds.size(); ++nColIdx)
+        vnColBounds[nColIdx] = int(uint64_t(nColIdx)*m_oImage.cols/nOutputCols);
+    const uint64_t nMaxBlockArea = uint64_t((m_oImage.rows+nOutputRows-1)/nOutputRows)*((m_oImage.cols+nOutputCols-1)/nOutputCols);
+    CV_Assert(nMaxBlockArea*UCHAR_MAX<=uint64_t(UINT32_MAX));
+    buildIntegral();
+    lbsp_boxResample(m_oIntegral,vnRowBounds,vnColBounds,oOutput);
+}
+
+void LBSPPyramid::getScaledDescriptors(double dScale, const uchar* anThresholdLUT, cv::Mat& oDesc) {
+    cv::Mat oScaledImage;
+    getScaledImage(dScale,oScaledImage);
+    LBSP::computeDescriptorImage(oScaledImage,cv::Mat(),anThresholdLUT,oDesc);
+}
+
+bool LBSPPyramid::isLevelMaterialized(size_t nLevel, bool bLookup) const {
+    if(m_oImage.empty())
+        return false;
+    if(bLookup)
+        return nLevel<m_vbLevelLookupReady.size() && m_vbLevelLookupReady[nLevel];
+    return nLevel==0 || (nLevel<m_vbLevelImageReady.size() && m_vbLevelImageReady[nLevel]);
+}
+
+void LBSPPyramid::buildIntegral() {
+    if(m_bIntegralReady)
+        return;
+    const size_t nChannels = getChannels();
+    const size_t nRowElems = size_t(m_oImage.cols)*nChannels;
+    // note: cv::integral uses signed accumulators, which can overflow on large images; here, the sums wrap around safely
+    m_oIntegral.create(m_oImage.rows+1,m_oImage.cols+1,CV_32SC((int)nChannels));
+    std::fill_n(m_oIntegral.ptr<uint32_t>(0),nRowElems+nChannels,0u);
+    for(int nRowIdx=0; nRowIdx<m_oImage.rows; ++nRowIdx) {
+        const uchar* const anImgRow = m_oImage.ptr<uchar>(nRowIdx);
+        const uint32_t* const anPrevRow = m_oIntegral.ptr<uint32_t>(nRowIdx)+nChannels;
+        uint32_t* const anCurrRow = m_oIntegral.ptr<uint32_t>(nRowIdx+1)+nChannels;
+        std::array<uint32_t,4> anRowSums = {};
+        std::fill_n(anCurrRow-nChannels,nChannels,0u);
+        for(size_t nElemIdx=0; nElemIdx<nRowElems; nElemIdx+=nChannels) {
+            for(size_t c=0; c<nChannels; ++c) {
+                anRowSums[c] += anImgRow[nElemIdx+c];
+                anCurrRow[nElemIdx+c] = anPrevRow[nElemIdx+c]+anRowSums[c];
+            }
+        }
+    }
+    m_bIntegralReady = true;
+}
@@ -19,6 +19,7 @@
 
 #include "litiv/imgproc/EdgeDetectorCanny.hpp"
 #include "litiv/imgproc/EdgeDetectorLBSP.hpp"
+#include "litiv/imgproc/EdgeDetectorTiled.hpp"
 
 namespace litiv {
 
@@ -31,6 +32,11 @@ namespace litiv {
     //! 'thins' the provided image (currently only works on 1ch 8UC1 images, treated as binary)
     void thinning(const cv::Mat& oInput, cv::Mat& oOutput, eThinningMode eMode=eThinningMode_LamLeeSuen);
 
+    //! computes the number of thresholds at which each pixel belongs to an (8-connected) hysteresis edge in a single union-find pass,
+    //! given the number of thresholds at which it is an edge candidate (low test) and an edge seed (high test); counts are taken over
+    //! the same ordered threshold list, and pixels that pass a test at some threshold must also pass it at all the previous ones
+    void computeHysteresisSweep(const cv::Mat& oCandidateCountMap, const cv::Mat& oSeedCountMap, cv::Mat& oEdgeCountMap);
+
     //! performs non-maximum suppression on the input image, with a (nWinSize)x(nWinSize) window
     template<int nWinSize>
     void nonMaxSuppression(const cv::Mat& oInput, cv::Mat& oOutput, const cv::Mat& oMask=cv::Mat());
@@ -28,6 +28,16 @@ struct IIEdgeDetector : public cv::Algorithm {
     virtual void apply_threshold(cv::InputArray oInputImage, cv::OutputArray oEdgeMask, double dThreshold) = 0;
     //! edge detection function; performs a full sensitivty sweep and returns a non-binary (grayscale confidence) edge map
     virtual void apply(cv::InputArray oInputImage, cv::OutputArray oEdgeMask) = 0;
+    //! computes (without hysteresis) the number of thresholds at which each pixel is an edge candidate (low test) and an edge seed (high test); counts
+    //! are taken over the full sensitivity sweep of 'apply' if the threshold is negative, or over the single threshold of 'apply_threshold' otherwise
+    //! (returns false if the detector cannot split hysteresis from its other stages, in which case tiled processing is unavailable)
+    virtual bool apply_hysteresis_counts(cv::InputArray /*oInputImage*/, cv::OutputArray /*oCandidateCountMap*/, cv::OutputArray /*oSeedCountMap*/, double /*dThreshold*/) {return false;}
+    //! converts (in-place) the full sweep hysteresis edge counts obtained from 'apply_hysteresis_counts' into the confidence edge map format of 'apply'
+    virtual void finalize_edge_counts(cv::Mat& /*oEdgeCountMap*/) {lvError("Missing impl");}
+    //! returns the radius (in pixels) of the neighborhood that can influence the hysteresis counts of a pixel (used to size tile halos)
+    virtual size_t getSupportRadius() const {return m_nROIBorderSize;}
+    //! returns the alignment (in pixels) required for tile origins so that tiled hysteresis counts match whole-image ones
+    virtual size_t getTileAlignment() const {return 1;}
     //! required for derived class destruction from this interface
     virtual ~IIEdgeDetector() {}
 
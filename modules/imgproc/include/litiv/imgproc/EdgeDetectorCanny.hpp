@@ -48,7 +48,14 @@ struct EdgeDetectorCanny : public IEdgeDetector {
     //! thresholded edge detection function; the threshold should be between 0 and 1 (will use default otherwise), and sets the base hysteresis threshold
     virtual void apply_threshold(cv::InputArray oInputImage, cv::OutputArray oEdgeMask, double dThreshold=EDGCANNY_DEFAULT_THRESHOLD);
     //! edge detection function; returns a confidence edge mask (0-255) instead of a thresholded/binary edge mask
+    //! (equivalent to accumulating 'apply_threshold' over all thresholds, but gradients are only computed once, and all hysteresis levels are solved in a single sweep)
     virtual void apply(cv::InputArray oInputImage, cv::OutputArray oEdgeMask);
+    //! computes the candidate/seed hysteresis test counts of 'apply' (negative threshold) or 'apply_threshold' (single threshold) without solving hysteresis
+    virtual bool apply_hysteresis_counts(cv::InputArray oInputImage, cv::OutputArray oCandidateCountMap, cv::OutputArray oSeedCountMap, double dThreshold);
+    //! normalizes full sweep hysteresis edge counts to the 0-255 range, as in 'apply'
+    virtual void finalize_edge_counts(cv::Mat& oEdgeCountMap);
+    //! returns the combined radius of the gaussian blur, Sobel and non-max suppression windows
+    virtual size_t getSupportRadius() const;
 
 protected:
     //! base threshold multiplier used to compute the upper hysteresis threshold
@@ -19,6 +19,7 @@
 
 #include "litiv/imgproc/EdgeDetectionUtils.hpp"
 #include "litiv/features2d/LBSP.hpp"
+#include "litiv/utils/PlatformUtils.hpp"
 
 //! defines the default value for EdgeDetectorLBSP::m_nLevels
 #define EDGLBSP_DEFAULT_LEVEL_COUNT (3)
@@ -41,6 +42,24 @@ public:
     virtual void apply_threshold(cv::InputArray oInputImage, cv::OutputArray oEdgeMask, double dDetThreshold=EDGLBSP_DEFAULT_DET_THRESHOLD);
     //! edge detection function; returns a confidence edge mask (0-255) instead of a thresholded/binary edge mask
     virtual void apply(cv::InputArray oInputImage, cv::OutputArray oEdgeMask);
+    //! computes the candidate/seed hysteresis test counts of 'apply' (negative threshold) or 'apply_threshold' (single threshold) without solving hysteresis
+    virtual bool apply_hysteresis_counts(cv::InputArray oInputImage, cv::OutputArray oCandidateCountMap, cv::OutputArray oSeedCountMap, double dDetThreshold);
+    //! scales full sweep hysteresis edge counts to the 0-255 range (and normalizes them, if needed), as in 'apply'
+    virtual void finalize_edge_counts(cv::Mat& oEdgeCountMap);
+    //! returns the full-scale radius covered by the coarsest level's LBSP patches and by the non-max suppression window
+    virtual size_t getSupportRadius() const;
+    //! returns the full-scale block size of the coarsest pyramid level
+    virtual size_t getTileAlignment() const;
+    //! sets whether 'apply' computes gradients once and solves all thresholds in a single hysteresis sweep instead of thresholding the image once per level (same output)
+    void setThresholdSweep(bool bEnabled);
+    //! returns whether 'apply' uses the single-pass threshold sweep (default = true)
+    bool isUsingThresholdSweep() const;
+    //! sets the number of full-scale rows per band (0 = single band, otherwise must be even) used to pipeline lookup/gradient/threshold work across pyramid levels, and the number of threads used to process bands (results do not depend on either)
+    void setParallelBands(size_t nBandRows, size_t nWorkers);
+    //! sets whether LBSP lookup values are computed on the fly from the pyramid images instead of being stored in per-level lookup maps (DESC_SIZE_BITS bytes per channel per pixel; same output)
+    void setCompactLookup(bool bEnabled);
+    //! returns whether LBSP lookup values are computed on the fly (default = false)
+    bool isUsingCompactLookup() const;
 
 protected:
 
@@ -52,23 +71,41 @@ protected:
     const double m_dGaussianKernelSigma;
     //! defines whether the output is normalized to the full 0-255 range or not
     const bool m_bNormalizeOutput;
-    //! pre-allocated image pyramid maps for multi-scale LBSP lookup
-    std::vector<std::aligned_vector<uchar,32>> m_vvuInputPyrMaps;
-    //! pre-allocated image pyramid LUT maps for multi-scale LBSP computation
-    std::vector<std::aligned_vector<uchar,32>> m_vvuLBSPLookupMaps;
-    //! pre-allocated image gradient reconstruction map
+    //! defines whether 'apply' uses the single-pass threshold sweep or the per-threshold loop (runtime option)
+    bool m_bUseThresholdSweep;
+    //! multi-scale LBSP engine providing the (lazily materialized) pyramid levels and their lookup maps
+    LBSPPyramid m_oPyramid;
+    //! pre-allocated image gradient reconstruction map (full scale, w/ NMS borders)
     std::aligned_vector<uchar,32> m_vuLBSPGradMapData;
+    //! pre-allocated per-level image gradient maps (coarse scales only)
+    std::vector<cv::Mat> m_voLevelGradMaps;
     //! pre-allocated image edge reconstruction map
     std::aligned_vector<uchar,32> m_vuEdgeTempMaskData;
     //! multi-level image map size lookup list
     std::vector<cv::Size> m_voMapSizeList;
     //! hysteresis recursive search stack
     std::vector<uchar*> m_vuHystStack;
+    //! pre-allocated per-pixel edge candidate/seed threshold count maps (used by the threshold sweep)
+    cv::Mat m_oCandidateCountMap, m_oSeedCountMap;
+    //! number of full-scale rows per band used to split the pyramid work (0 = single band)
+    size_t m_nBandRows;
+    //! worker pool used to process bands concurrently (null if processing on the calling thread only)
+    std::unique_ptr<PlatformUtils::DynamicWorkerPool> m_pWorkerPool;
+    //! defines whether LBSP lookup values are computed on the fly instead of being stored in lookup maps (runtime option)
+    bool m_bUseCompactLookup;
 
-    //! internal lookup/pyramiding function w/ explicit definitions for 1 to 4 channels
-    template<size_t nChannels>
+    //! internal lookup/pyramiding function (levels are only materialized once thresholded)
     void apply_internal_lookup(const cv::Mat& oInputImg);
-    void apply_internal_lookup(const cv::Mat& oInputImg, size_t nChannels);
+    //! internal multi-scale gradient reconstruction function; calls 'lRowFunc(row_idx,grad_row)' for each full-scale row once its NMS window is ready
+    //! (bottom-up on the calling thread, or by bands on the worker pool if 'bConcurrentRowFunc' is true)
+    template<size_t nChannels, typename TRowFunc>
+    void apply_internal_gradients(const cv::Mat& oInputImg, TRowFunc&& lRowFunc, bool bConcurrentRowFunc);
+    //! internal hysteresis test counting function w/ explicit definitions for 1 to 4 channels; returns the number of (sorted) thresholds at which each pixel is an edge candidate/seed
+    template<size_t nChannels>
+    void apply_internal_counts(const cv::Mat& oInputImg, cv::Mat& oCandidateCountMap, cv::Mat& oSeedCountMap, const std::vector<uchar>& vnDetThresholds);
+    void apply_internal_counts(const cv::Mat& oInputImg, cv::Mat& oCandidateCountMap, cv::Mat& oSeedCountMap, const std::vector<uchar>& vnDetThresholds, size_t nChannels);
+    //! returns the list of integral thresholds used by the threshold sweep of 'apply'
+    static const std::vector<uchar>& getSweepThresholds();
     //! internal thresholding function w/ explicit definitions for 1 to 4 channels
     template<size_t nChannels>
     void apply_internal_threshold(const cv::Mat& oInputImg, cv::Mat& oEdgeMask, uchar nDetThreshold);
@@ -0,0 +1,82 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "litiv/imgproc/EdgeDetectionUtils.hpp"
+#include "litiv/utils/PlatformUtils.hpp"
+
+//! defines the default value for EdgeDetectorTiled::m_oTileSize (tile core size, without halos)
+#define EDGTILED_DEFAULT_TILE_SIZE (512)
+
+/*!
+    Tiled edge detection driver (wraps any detector that implements IIEdgeDetector::apply_hysteresis_counts).
+
+    The image is split into tiles whose cores are padded with halos sized to the wrapped detector's support; hysteresis test
+    counts are computed for each padded tile in parallel (one detector instance per concurrent tile), and hysteresis is solved
+    inside each tile core. A second pass then propagates edges across tile borders, starting from border pixels only, so that
+    the output matches whole-image detection exactly. Detector scratch memory is bounded by the padded tile size; only the
+    output mask and a candidate count map are allocated at full scale.
+ */
+class EdgeDetectorTiled : public IEdgeDetector {
+public:
+    //! factory used to create the wrapped detector instances (all instances must share the same parameters; may be called from worker threads)
+    using DetectorFactory = std::function<std::shared_ptr<IIEdgeDetector>()>;
+    //! full constructor
+    EdgeDetectorTiled(DetectorFactory lDetectorFactory,
+                      cv::Size oTileSize=cv::Size(EDGTILED_DEFAULT_TILE_SIZE,EDGTILED_DEFAULT_TILE_SIZE),
+                      size_t nWorkers=1);
+    //! returns the default threshold value of the wrapped detector
+    virtual double getDefaultThreshold() const;
+    //! thresholded edge detection function; the threshold follows the wrapped detector's conventions (will use default if negative)
+    virtual void apply_threshold(cv::InputArray oInputImage, cv::OutputArray oEdgeMask, double dThreshold);
+    //! edge detection function; returns the same confidence edge mask as the wrapped detector's 'apply'
+    virtual void apply(cv::InputArray oInputImage, cv::OutputArray oEdgeMask);
+    //! sets the tile core size (rounded up to the wrapped detector's tile alignment) and the number of threads used to process tiles (results do not depend on either)
+    void setTiling(cv::Size oTileSize, size_t nWorkers);
+    //! returns the (aligned) tile core size
+    cv::Size getTileSize() const;
+    //! returns the halo size added on each side of tile cores (derived from the wrapped detector's support radius)
+    size_t getHaloSize() const;
+
+protected:
+    //! factory used to create new wrapped detector instances when all existing ones are busy
+    const DetectorFactory m_lDetectorFactory;
+    //! reference wrapped detector instance (used for parameter queries and output finalization)
+    const std::shared_ptr<IIEdgeDetector> m_pDetector;
+    //! wrapped detector instances that are not currently processing a tile
+    std::vector<std::shared_ptr<IIEdgeDetector>> m_vpIdleDetectors;
+    //! mutex used to guard the idle detector list
+    std::mutex m_oIdleDetectorsMutex;
+    //! tile core size (multiple of the wrapped detector's tile alignment)
+    cv::Size m_oTileSize;
+    //! halo size added on each side of tile cores (multiple of the wrapped detector's tile alignment)
+    const size_t m_nHaloSize;
+    //! worker pool used to process tiles concurrently (null if processing on the calling thread only)
+    std::unique_ptr<PlatformUtils::DynamicWorkerPool> m_pWorkerPool;
+    //! pre-allocated full-scale edge candidate count map (used to propagate edges across tile borders)
+    cv::Mat m_oCandidateCountMap;
+    //! pre-allocated edge propagation queue, bucketed by edge count
+    std::array<std::vector<size_t>,UCHAR_MAX+1> m_avnPropagBuckets;
+
+    //! internal tiled detection function; returns the number of thresholds at which each pixel is an edge (negative threshold = full sweep)
+    void apply_internal(const cv::Mat& oInputImg, cv::Mat& oEdgeCountMap, double dThreshold);
+    //! returns an idle wrapped detector instance (creating a new one if needed)
+    std::shared_ptr<IIEdgeDetector> popIdleDetector();
+    //! returns a wrapped detector instance to the idle list
+    void pushIdleDetector(const std::shared_ptr<IIEdgeDetector>& pDetector);
+};
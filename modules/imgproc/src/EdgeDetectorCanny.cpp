@@ -16,6 +16,7 @@
 // limitations under the License.
 
 #include "litiv/imgproc/EdgeDetectorCanny.hpp"
+#include "litiv/imgproc.hpp"
 
 EdgeDetectorCanny::EdgeDetectorCanny(double dHystLowThrshFactor, double dGaussianKernelSigma) :
         m_dHystLowThrshFactor(dHystLowThrshFactor),
@@ -44,17 +45,92 @@ void EdgeDetectorCanny::apply_threshold(cv::InputArray _oInputImage, cv::OutputA
     cv::Canny(oInputImg,oEdgeMask,dThreshold*m_dHystLowThrshFactor,dThreshold,nWindowSize,bUseL2Gradient);
 }
 
-void EdgeDetectorCanny::apply(cv::InputArray _oInputImage, cv::OutputArray _oEdgeMask) {
+// mirrors the integer threshold conversion done internally by cv::Canny (which compares squared magnitudes when using the L2 norm)
+static inline int getCannyIntThreshold(double dThreshold, bool bUseL2Gradient) {
+    if(bUseL2Gradient) {
+        dThreshold = std::min(32767.0,dThreshold);
+        if(dThreshold>0)
+            dThreshold *= dThreshold;
+    }
+    return cvFloor(dThreshold);
+}
+
+bool EdgeDetectorCanny::apply_hysteresis_counts(cv::InputArray _oInputImage, cv::OutputArray _oCandidateCountMap, cv::OutputArray _oSeedCountMap, double dThreshold) {
     cv::Mat oInputImg = _oInputImage.getMat();
     CV_Assert(!oInputImg.empty());
     CV_Assert(oInputImg.channels()==1 || oInputImg.channels()==3 || oInputImg.channels()==4);
-    _oEdgeMask.create(oInputImg.size(),CV_8UC1);
-    cv::Mat oEdgeMask = _oEdgeMask.getMat();
-    oEdgeMask = cv::Scalar_<uchar>(0);
-    cv::Mat oTempEdgeMask = oEdgeMask.clone();
-    for(size_t nCurrThreshold=0; nCurrThreshold<UCHAR_MAX; ++nCurrThreshold) {
-        apply_threshold(oInputImg,oTempEdgeMask,double(nCurrThreshold));
-        oEdgeMask += oTempEdgeMask/UCHAR_MAX;
+    if(m_dGaussianKernelSigma>0) {
+        const int nDefaultKernelSize = int(8*ceil(m_dGaussianKernelSigma));
+        const int nRealHalfKernelSize = (nDefaultKernelSize-1)/2;
+        oInputImg = oInputImg.clone();
+        cv::GaussianBlur(oInputImg,oInputImg,cv::Size(nRealHalfKernelSize,nRealHalfKernelSize),m_dGaussianKernelSigma,m_dGaussianKernelSigma);
+    }
+    static const int nWindowSize = EDGCANNY_SOBEL_KERNEL_SIZE;
+    static const bool bUseL2Gradient = EDGCANNY_USE_L2_GRADIENT_NORM;
+    // gradients & non-max suppression do not depend on the thresholds, so they are only computed once; with both thresholds at zero,
+    // cv::Canny returns exactly the set of non-suppressed pixels with non-null gradient magnitude (i.e. all potential edges)
+    cv::Mat oNMSMask;
+    cv::Canny(oInputImg,oNMSMask,0,0,nWindowSize,bUseL2Gradient);
+    cv::Mat oGradX, oGradY;
+    cv::Sobel(oInputImg,oGradX,CV_16S,1,0,nWindowSize,1,0,cv::BORDER_REPLICATE);
+    cv::Sobel(oInputImg,oGradY,CV_16S,0,1,nWindowSize,1,0,cv::BORDER_REPLICATE);
+    // thresholds (in cv::Canny's integer magnitude domain) are sorted, so each pixel's test counts are found via binary search
+    std::vector<int> vnLowThresholds, vnHighThresholds;
+    if(dThreshold<0) {
+        vnLowThresholds.resize(UCHAR_MAX);
+        vnHighThresholds.resize(UCHAR_MAX);
+        for(size_t nCurrThreshold=0; nCurrThreshold<UCHAR_MAX; ++nCurrThreshold) {
+            vnLowThresholds[nCurrThreshold] = getCannyIntThreshold(double(nCurrThreshold)*m_dHystLowThrshFactor,bUseL2Gradient);
+            vnHighThresholds[nCurrThreshold] = getCannyIntThreshold(double(nCurrThreshold),bUseL2Gradient);
+        }
+    }
+    else {
+        vnLowThresholds.push_back(getCannyIntThreshold(dThreshold*m_dHystLowThrshFactor,bUseL2Gradient));
+        vnHighThresholds.push_back(getCannyIntThreshold(dThreshold,bUseL2Gradient));
     }
-    cv::normalize(oEdgeMask,oEdgeMask,0,UCHAR_MAX,cv::NORM_MINMAX);
+    const int nChannels = oInputImg.channels();
+    _oCandidateCountMap.create(oInputImg.size(),CV_8UC1);
+    _oSeedCountMap.create(oInputImg.size(),CV_8UC1);
+    cv::Mat oCandidateCountMap = _oCandidateCountMap.getMat(), oSeedCountMap = _oSeedCountMap.getMat();
+    oCandidateCountMap = cv::Scalar_<uchar>(0);
+    oSeedCountMap = cv::Scalar_<uchar>(0);
+    for(int nRowIter=0; nRowIter<oInputImg.rows; ++nRowIter) {
+        const uchar* anNMSMask = oNMSMask.ptr<uchar>(nRowIter);
+        const short* anGradX = oGradX.ptr<short>(nRowIter);
+        const short* anGradY = oGradY.ptr<short>(nRowIter);
+        uchar* anCandidateCounts = oCandidateCountMap.ptr<uchar>(nRowIter);
+        uchar* anSeedCounts = oSeedCountMap.ptr<uchar>(nRowIter);
+        for(int nColIter=0; nColIter<oInputImg.cols; ++nColIter) {
+            if(!anNMSMask[nColIter])
+                continue;
+            // as in cv::Canny, multi-channel gradient magnitudes are taken from the channel with the strongest response
+            int nGradMag = 0;
+            for(int nChIter=0; nChIter<nChannels; ++nChIter) {
+                const int nGradX = anGradX[nColIter*nChannels+nChIter], nGradY = anGradY[nColIter*nChannels+nChIter];
+                nGradMag = std::max(nGradMag,bUseL2Gradient?(nGradX*nGradX+nGradY*nGradY):(std::abs(nGradX)+std::abs(nGradY)));
+            }
+            anCandidateCounts[nColIter] = (uchar)(std::lower_bound(vnLowThresholds.begin(),vnLowThresholds.end(),nGradMag)-vnLowThresholds.begin());
+            anSeedCounts[nColIter] = (uchar)(std::lower_bound(vnHighThresholds.begin(),vnHighThresholds.end(),nGradMag)-vnHighThresholds.begin());
+        }
+    }
+    return true;
+}
+
+void EdgeDetectorCanny::finalize_edge_counts(cv::Mat& oEdgeCountMap) {
+    cv::normalize(oEdgeCountMap,oEdgeCountMap,0,UCHAR_MAX,cv::NORM_MINMAX);
+}
+
+size_t EdgeDetectorCanny::getSupportRadius() const {
+    // blur kernel radius, plus the Sobel aperture radius, plus the non-max suppression radius
+    const size_t nBlurRadius = (m_dGaussianKernelSigma>0)?size_t((int(8*ceil(m_dGaussianKernelSigma))-1)/2)/2:size_t(0);
+    return nBlurRadius+EDGCANNY_SOBEL_KERNEL_SIZE/2+1;
+}
+
+void EdgeDetectorCanny::apply(cv::InputArray _oInputImage, cv::OutputArray _oEdgeMask) {
+    cv::Mat oCandidateCountMap, oSeedCountMap;
+    apply_hysteresis_counts(_oInputImage,oCandidateCountMap,oSeedCountMap,-1);
+    _oEdgeMask.create(oCandidateCountMap.size(),CV_8UC1);
+    cv::Mat oEdgeMask = _oEdgeMask.getMat();
+    litiv::computeHysteresisSweep(oCandidateCountMap,oSeedCountMap,oEdgeMask);
+    finalize_edge_counts(oEdgeMask);
 }
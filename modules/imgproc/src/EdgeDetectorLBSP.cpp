@@ -28,135 +28,203 @@ EdgeDetectorLBSP::EdgeDetectorLBSP(size_t nLevels, double dHystLowThrshFactor, b
         m_dHystLowThrshFactor(dHystLowThrshFactor),
         m_dGaussianKernelSigma(0),
         m_bNormalizeOutput(bNormalizeOutput),
-        m_vvuInputPyrMaps(std::max(nLevels,size_t(1))-1),
-        m_vvuLBSPLookupMaps(nLevels),
-        m_voMapSizeList(nLevels) {
+        m_bUseThresholdSweep(true),
+        m_voMapSizeList(nLevels),
+        m_nBandRows(0),
+        m_bUseCompactLookup(false) {
     m_nROIBorderSize = LBSP::PATCH_SIZE/2;
     CV_Assert(m_nLevels>0);
 }
 
-template<size_t nChannels>
 void EdgeDetectorLBSP::apply_internal_lookup(const cv::Mat& oInputImg) {
     CV_DbgAssert(!oInputImg.empty());
     CV_DbgAssert(oInputImg.isContinuous());
-    const int nOrigType = CV_8UC(int(nChannels));
     CV_DbgAssert(m_nROIBorderSize==LBSP::PATCH_SIZE/2);
-    constexpr size_t nROIBorderSize = LBSP::PATCH_SIZE/2;
+    CV_Assert(oInputImg.channels()>=1 && oInputImg.channels()<=4);
+    m_oPyramid.setImage(oInputImg);
+    for(size_t nLevelIter=0; nLevelIter<m_nLevels; ++nLevelIter)
+        m_voMapSizeList[nLevelIter] = m_oPyramid.getLevelSize(nLevelIter);
+}
+
+// checks whether the gradient magnitude at the given grad map position (4ch: gradx, grady, gradmag, 'dont care') is maximal along its orientation
+template<size_t nNMSHalfWinSize>
+static inline bool isGradMapLocalMaximum(const uchar* const anGradMapPx, const size_t nGradMapColStep, const size_t nGradMapRowStep) {
+#if USE_3_AXIS_ORIENT
+    const char nGradX = ((const char*)anGradMapPx)[0];
+    const char nGradY = ((const char*)anGradMapPx)[1];
+    const uint nShift_FPA = 15;
+    constexpr uint nTG22deg_FPA = (int)(0.4142135623730950488016887242097*(1<<nShift_FPA)+0.5); // == tan(pi/8)
+    const uint nGradX_abs = (uint)std::abs(nGradX);
+    const uint nGradY_abs = (uint)std::abs(nGradY)<<nShift_FPA;
+    uint nTG22GradX_FPA = nGradX_abs*nTG22deg_FPA; // == 0.4142135623730950488016887242097*nGradX_abs
+    if(nGradY_abs<nTG22GradX_FPA) // if(nGradX_abs<0.4142135623730950488016887242097*nGradX_abs) == flat gradient (sector 0)
+        return litiv::isLocalMaximum_Horizontal<nNMSHalfWinSize>(anGradMapPx+2,nGradMapColStep,nGradMapRowStep);
+    // else(nGradX_abs>=0.4142135623730950488016887242097*nGradX_abs) == not a flat gradient (sectors 1, 2 or 3)
+    uint nTG67GradX_FPA = nTG22GradX_FPA+(nGradX_abs<<(nShift_FPA+1)); // == 2.4142135623730950488016887242097*nGradX_abs == tan(3*pi/8)*nGradX_abs
+    if(nGradY_abs>nTG67GradX_FPA) // if(nGradX_abs>2.4142135623730950488016887242097*nGradX_abs == vertical gradient (sector 2)
+        return litiv::isLocalMaximum_Vertical<nNMSHalfWinSize>(anGradMapPx+2,nGradMapColStep,nGradMapRowStep);
+    // else(nGradX_abs<=2.4142135623730950488016887242097*nGradX_abs == diagonal gradient (sector 1 or 3, depending on grad sign diff)
+    if(nGradX || nGradY)
+        return litiv::isLocalMaximum_Diagonal<nNMSHalfWinSize>(anGradMapPx+2,nGradMapColStep,nGradMapRowStep,(nGradX^nGradY)>=0);
+    return litiv::isLocalMaximum_Diagonal<nNMSHalfWinSize,true>(anGradMapPx+2,nGradMapColStep,nGradMapRowStep) ||
+           litiv::isLocalMaximum_Diagonal<nNMSHalfWinSize,false>(anGradMapPx+2,nGradMapColStep,nGradMapRowStep);
+#else //(!USE_3_AXIS_ORIENT)
+    const uint nGradX_abs = (uint)std::abs(((const char*)anGradMapPx)[0]);
+    const uint nGradY_abs = (uint)std::abs(((const char*)anGradMapPx)[1]);
+    return (nGradY_abs<=nGradX_abs && litiv::isLocalMaximum_Horizontal<nNMSHalfWinSize>(anGradMapPx+2,nGradMapColStep,nGradMapRowStep)) ||
+           (nGradY_abs>nGradX_abs && litiv::isLocalMaximum_Vertical<nNMSHalfWinSize>(anGradMapPx+2,nGradMapColStep,nGradMapRowStep));
+#endif //(!USE_3_AXIS_ORIENT)
+}
+
+template<size_t nChannels, typename TRowFunc>
+void EdgeDetectorLBSP::apply_internal_gradients(const cv::Mat& oInputImg, TRowFunc&& lRowFunc, bool bConcurrentRowFunc) {
+    CV_DbgAssert(!oInputImg.empty());
+    CV_DbgAssert(oInputImg.isContinuous());
     const size_t nColLUTStep = LBSP::DESC_SIZE_BITS*nChannels;
-    size_t nNextScaleRows = size_t(oInputImg.rows);
-    size_t nNextScaleCols = size_t(oInputImg.cols);
-    size_t nNextRowLUTStep = nColLUTStep*nNextScaleCols;
-    cv::Size oNextScaleSize((int)nNextScaleCols,(int)nNextScaleRows);
-    size_t nNextScaleMapSize = oNextScaleSize.area();
-    m_vvuLBSPLookupMaps[0].resize(nNextScaleMapSize*nChannels*LBSP::DESC_SIZE_BITS);
-    m_voMapSizeList[0] = oNextScaleSize;
-    cv::Mat oNextPyrInputMap = oInputImg;
-    for(size_t nLevelIter=0; nLevelIter<m_nLevels; ++nLevelIter) {
-        if(!nNextScaleMapSize)
-            break;
-        const size_t nCurrScaleRows = nNextScaleRows;
-        const size_t nCurrScaleCols = nNextScaleCols;
-        const size_t nCurrRowLUTStep = nNextRowLUTStep;
-        const cv::Mat oCurrPyrInputMap = oNextPyrInputMap;
-        nNextScaleRows = (nCurrScaleRows+1)/2;
-        nNextScaleCols = (nCurrScaleCols+1)/2;
-        nNextRowLUTStep = nColLUTStep*nNextScaleCols;
-        oNextScaleSize = cv::Size((int)nNextScaleCols,(int)nNextScaleRows);
-        nNextScaleMapSize = nLevelIter+1<m_nLevels?oNextScaleSize.area():0;
-        if(nNextScaleMapSize) {
-            m_vvuInputPyrMaps[nLevelIter].resize(nNextScaleMapSize*nChannels);
-            m_vvuLBSPLookupMaps[nLevelIter+1].resize(nNextScaleMapSize*nChannels*LBSP::DESC_SIZE_BITS);
-            m_voMapSizeList[nLevelIter+1] = oNextScaleSize;
-            oNextPyrInputMap = cv::Mat(oNextScaleSize,nOrigType,m_vvuInputPyrMaps[nLevelIter].data());
-            CV_DbgAssert(size_t(oNextScaleSize.area()*nChannels)==m_vvuInputPyrMaps[nLevelIter].size());
+    constexpr size_t nNMSWinSize = USE_5x5_NON_MAX_SUPP?LBSP::PATCH_SIZE:3;
+    constexpr size_t nNMSHalfWinSize = nNMSWinSize>>1;
+    const cv::Size oMapSize(oInputImg.cols+nNMSHalfWinSize*2,oInputImg.rows+nNMSHalfWinSize*2);
+    constexpr size_t nGradMapColStep = 4; // 4ch (gradx, grady, gradmag, 'dont care')
+    const size_t nGradMapRowStep = oMapSize.width*nGradMapColStep;
+    // full-scale gradients go in a zero-padded map (for NMS), and each coarser level gets its own map so that bands of different levels never overlap
+    m_vuLBSPGradMapData.resize(oMapSize.height*nGradMapRowStep);
+    cv::Mat oGradMap(oMapSize,CV_8UC4,m_vuLBSPGradMapData.data());
+    std::fill(m_vuLBSPGradMapData.data(),m_vuLBSPGradMapData.data()+nGradMapRowStep*nNMSHalfWinSize,0);
+    std::fill(m_vuLBSPGradMapData.data()+(oMapSize.height-nNMSHalfWinSize)*nGradMapRowStep,m_vuLBSPGradMapData.data()+oMapSize.height*nGradMapRowStep,0);
+    m_voLevelGradMaps.resize(m_nLevels);
+    std::vector<cv::Mat> voPyrMaps(m_nLevels), voLookupMaps(m_nLevels);
+    for(size_t nLevelIdx=0; nLevelIdx<m_nLevels; ++nLevelIdx) {
+        if(m_bUseCompactLookup)
+            voPyrMaps[nLevelIdx] = m_oPyramid.getLevelImage(nLevelIdx);
+        else {
+            voPyrMaps[nLevelIdx] = m_oPyramid.getLevelLookupBuffer(nLevelIdx);
+            voLookupMaps[nLevelIdx] = m_oPyramid.getLevelLookupData(nLevelIdx);
+            CV_DbgAssert(voLookupMaps[nLevelIdx].isContinuous());
         }
-        const auto lBorderColLookup = [&](size_t nRowIter, size_t nCurrRowLUTIdx, size_t nColIter){
-            const size_t nCurrColLUTIdx = nCurrRowLUTIdx+nColIter*nColLUTStep;
-            uchar* aanCurrLUT = m_vvuLBSPLookupMaps[nLevelIter].data()+nCurrColLUTIdx;
-            const uchar* aanCurrImg = oCurrPyrInputMap.data+nCurrColLUTIdx/LBSP::DESC_SIZE_BITS;
-            CV_DbgAssert(nCurrColLUTIdx<m_vvuLBSPLookupMaps[nLevelIter].size() && (nCurrColLUTIdx%LBSP::DESC_SIZE_BITS)==0);
-#if HAVE_SSE2
-            // no slower than fill_n if fill_n is implemented with SSE
-            static_assert(LBSP::DESC_SIZE_BITS==16,"all channels should already be 16-byte-aligned");
-            CxxUtils::unroll<nChannels>([&](size_t nChIter){
-                ParallelUtils::copy_16ub((__m128i*)(aanCurrLUT+nChIter*LBSP::DESC_SIZE_BITS),*(aanCurrImg+nChIter));
-            });
-#else //(!HAVE_SSE2)
-            CxxUtils::unroll<nChannels>([&](size_t nChIter){
-                std::fill_n(aanCurrLUT+nChIter*LBSP::DESC_SIZE_BITS,LBSP::DESC_SIZE_BITS,*(aanCurrImg+nChIter));
-            });
-#endif //(!HAVE_SSE2)
-            if(nNextScaleMapSize && !(nRowIter%2) && !(nColIter%2)) {
-                const size_t nNextColLUTIdx = (nRowIter/2)*nNextRowLUTStep + (nColIter/2)*nColLUTStep;
-                for(size_t nChIter = 0; nChIter<nChannels; ++nChIter) {
-                    const size_t nNextPyrImgIdx = nNextColLUTIdx/LBSP::DESC_SIZE_BITS + nChIter;
-                    CV_DbgAssert(nNextPyrImgIdx<size_t(oNextPyrInputMap.dataend-oNextPyrInputMap.datastart));
-                    *(oNextPyrInputMap.data+nNextPyrImgIdx) = *(aanCurrImg+nChIter);
-                }
+        CV_DbgAssert(voPyrMaps[nLevelIdx].size()==m_voMapSizeList[nLevelIdx] && voPyrMaps[nLevelIdx].type()==CV_8UC(int(nChannels)) && voPyrMaps[nLevelIdx].isContinuous());
+        if(nLevelIdx>0)
+            m_voLevelGradMaps[nLevelIdx].create(m_voMapSizeList[nLevelIdx],CV_8UC4);
+    }
+#if USE_MIN_GRAD_ORIENT
+    static_assert(nGradMapColStep==4,"Need 32-bit chunks to copy (see lines with uint32_t)");
+    const uint32_t nDefaultGradMapVal4Ch = (CHAR_MAX<<24)|(CHAR_MAX<<16)|(UCHAR_MAX)<<8;
+    const auto lAbsCharComp = [](char a, char b){return std::abs(a)<std::abs(b);};
+#else //(!USE_MIN_GRAD_ORIENT)
+    const cv::Vec4b oDefaultGradMapVal4Ch(0,0,UCHAR_MAX,0);
+    uint32_t nDefaultGradMapVal4Ch;
+    memcpy(&nDefaultGradMapVal4Ch,oDefaultGradMapVal4Ch.val,sizeof(uint32_t));
+#endif //(!USE_MIN_GRAD_ORIENT)
+    // each level refines the gradients of the (2x2-upsampled) coarser one, row by row, so a band of rows only depends on a single coarser band
+    // in compact mode, lookup values are computed on the fly one row at a time (only the PATCH_SIZE level image rows around it are ever touched)
+    // the lookup arrays of a row are consecutive, so they are all thresholded at once via the runtime-dispatched batch kernel before gradients are derived
+    const auto lProcessGradBand = [&](size_t nLevelIdx, int nRowBegin, int nRowEnd) {
+        if(!m_bUseCompactLookup)
+            m_oPyramid.fillLevelLookupRows(nLevelIdx,nRowBegin,nRowEnd);
+        const cv::Mat& oPyrMap = voPyrMaps[nLevelIdx];
+        const cv::Mat& oLookupMap = voLookupMaps[nLevelIdx];
+        const int nCols = m_voMapSizeList[nLevelIdx].width;
+        const size_t nRowLUTStep = nColLUTStep*(size_t)nCols;
+        const size_t nRowDescCount = nChannels*(size_t)nCols;
+        std::aligned_vector<uchar,32> vnLocalRowLUT(m_bUseCompactLookup?nRowLUTStep:size_t(0));
+        std::vector<uchar> vnRowThresholds(nRowDescCount);
+        std::vector<LBSP::desc_t> vnRowDescs(nRowDescCount);
+        for(int nRowIter=nRowBegin; nRowIter<nRowEnd; ++nRowIter) {
+            uchar* anGradRow = (nLevelIdx==0)?(oGradMap.ptr<uchar>(nRowIter+(int)nNMSHalfWinSize)+nGradMapColStep*nNMSHalfWinSize):m_voLevelGradMaps[nLevelIdx].ptr<uchar>(nRowIter);
+            const uchar* anPrevGradRow = (nLevelIdx+1<m_nLevels)?m_voLevelGradMaps[nLevelIdx+1].ptr<uchar>(nRowIter>>1):nullptr;
+            const uchar* const anRowRefColors = oPyrMap.ptr<uchar>(nRowIter);
+            if(m_bUseCompactLookup)
+                for(int nColIter=0; nColIter<nCols; ++nColIter)
+                    LBSPPyramid::computeLookup<nChannels>(oPyrMap,nColIter,nRowIter,vnLocalRowLUT.data()+nColIter*nColLUTStep);
+            const uchar* const anRowLUT = m_bUseCompactLookup?vnLocalRowLUT.data():(oLookupMap.data+nRowIter*nRowLUTStep);
+            for(size_t nDescIdx=0; nDescIdx<nRowDescCount; ++nDescIdx)
+                vnRowThresholds[nDescIdx] = LBSP::computeDescriptor_gradientThreshold(anRowRefColors[nDescIdx]);
+            LBSP::computeDescriptor_threshold(anRowLUT,anRowRefColors,vnRowThresholds.data(),nRowDescCount,vnRowDescs.data());
+            for(size_t nColIter=0; nColIter<(size_t)nCols; ++nColIter) {
+                const uchar* const anPrevGrad = anPrevGradRow?(anPrevGradRow+(nColIter>>1)*nGradMapColStep):(const uchar*)&nDefaultGradMapVal4Ch;
+                uchar* const anCurrGrad = anGradRow+nColIter*nGradMapColStep;
+                char nGradX, nGradY;
+                uchar nGradMag;
+                LBSP::computeDescriptor_gradient<nChannels>(vnRowDescs.data()+nColIter*nChannels,nGradX,nGradY,nGradMag);
+#if USE_MIN_GRAD_ORIENT
+                (char&)(anCurrGrad[0]) = std::min(nGradX,char(anPrevGrad[0]),lAbsCharComp);
+                (char&)(anCurrGrad[1]) = std::min(nGradY,char(anPrevGrad[1]),lAbsCharComp);
+#else //(!USE_MIN_GRAD_ORIENT)
+                CV_DbgAssert((nGradX+(char)(anPrevGrad[0]*2))/2<=UCHAR_MAX);
+                CV_DbgAssert((nGradY+(char)(anPrevGrad[1]*2))/2<=UCHAR_MAX);
+                (char&)(anCurrGrad[0]) = ((nGradX+(char)(anPrevGrad[0]*2))/2);
+                (char&)(anCurrGrad[1]) = ((nGradY+(char)(anPrevGrad[1]*2))/2);
+#endif //(!USE_MIN_GRAD_ORIENT)
+                anCurrGrad[2] = std::min(nGradMag,anPrevGrad[2]);
+                anCurrGrad[3] = anPrevGrad[3];
             }
-        };
-        const auto lBorderRowLookup = [&](size_t nRowIter){
-            const size_t nCurrRowLUTIdx = nRowIter*nCurrRowLUTStep;
-            for(size_t nColIter = 0; nColIter<nCurrScaleCols; ++nColIter)
-                lBorderColLookup(nRowIter,nCurrRowLUTIdx,nColIter);
-        };
-        size_t nRowIter = 0;
-        for(; nRowIter<nROIBorderSize; ++nRowIter)
-            lBorderRowLookup(nRowIter);
-        for(; nRowIter<nCurrScaleRows-nROIBorderSize; ++nRowIter) {
-            const size_t nCurrRowLUTIdx = nRowIter*nCurrRowLUTStep;
-            size_t nColIter = 0;
-            for(; nColIter<nROIBorderSize; ++nColIter)
-                lBorderColLookup(nRowIter,nCurrRowLUTIdx,nColIter);
-            for(; nColIter<nCurrScaleCols-nROIBorderSize; ++nColIter) {
-                const size_t nCurrColLUTIdx = nCurrRowLUTIdx+nColIter*nColLUTStep;
-                uchar* aanCurrLUT = m_vvuLBSPLookupMaps[nLevelIter].data()+nCurrColLUTIdx;
-                CV_DbgAssert(nCurrColLUTIdx<m_vvuLBSPLookupMaps[nLevelIter].size() && (nCurrColLUTIdx%LBSP::DESC_SIZE_BITS)==0);
-                LBSP::computeDescriptor_lookup<nChannels>(oCurrPyrInputMap,int(nColIter),int(nRowIter),aanCurrLUT);
-                if(nNextScaleMapSize && !(nRowIter%2) && !(nColIter%2)) {
-                    const size_t nNextColLUTIdx = (nRowIter/2)*nNextRowLUTStep + (nColIter/2)*nColLUTStep;
-                    for(size_t nChIter = 0; nChIter<nChannels; ++nChIter) {
-#if HAVE_SSE2
-                        static_assert(LBSP::DESC_SIZE_BITS==16,"all channels should already be 16-byte-aligned");
-                        __m128i _anInputVals = _mm_load_si128((__m128i*)(aanCurrLUT+nChIter*LBSP::DESC_SIZE_BITS));
-                        size_t nLUTSum = (size_t)ParallelUtils::hsum_16ub(_anInputVals);
-#else //(!HAVE_SSE2)
-                        uchar* anCurrChLUT = aanCurrLUT+nChIter*LBSP::DESC_SIZE_BITS;
-                        size_t nLUTSum = 0;
-                        CxxUtils::unroll<LBSP::DESC_SIZE_BITS>([&](size_t nLUTIter){
-                            nLUTSum += anCurrChLUT[nLUTIter];
-                        });
-#endif //(!HAVE_SSE2)
-                        const size_t nNextPyrImgIdx = nNextColLUTIdx/LBSP::DESC_SIZE_BITS + nChIter;
-                        CV_DbgAssert(nNextPyrImgIdx<size_t(oNextPyrInputMap.dataend-oNextPyrInputMap.datastart));
-                        *(oNextPyrInputMap.data+nNextPyrImgIdx) = uchar(nLUTSum/LBSP::DESC_SIZE_BITS);
-                    }
-                }
+            if(nLevelIdx==0) {
+                std::fill(anGradRow-nGradMapColStep*nNMSHalfWinSize,anGradRow,0);
+                std::fill(anGradRow+oInputImg.cols*nGradMapColStep,anGradRow+(oInputImg.cols+nNMSHalfWinSize)*nGradMapColStep,0);
             }
-            for(; nColIter<nCurrScaleCols; ++nColIter)
-                lBorderColLookup(nRowIter,nCurrRowLUTIdx,nColIter);
         }
-        for(; nRowIter<nCurrScaleRows; ++nRowIter)
-            lBorderRowLookup(nRowIter);
+    };
+    // bands are queued in dependency order (tasks only ever wait on tasks queued before them, so the FIFO pool cannot deadlock), and coarse
+    // bands are interleaved with the full-scale bands that need them, so that all levels (and the row functor) are processed in a pipelined fashion
+    const int nBandRows = (m_nBandRows==0 || m_nBandRows>=(size_t)oInputImg.rows)?oInputImg.rows:(int)m_nBandRows;
+    CV_DbgAssert(nBandRows==oInputImg.rows || (nBandRows%2)==0);
+    std::vector<std::vector<std::shared_future<void>>> vvoGradBandTasks(m_nLevels);
+    for(size_t nLevelIdx=0; nLevelIdx<m_nLevels; ++nLevelIdx)
+        vvoGradBandTasks[nLevelIdx].resize(size_t((m_voMapSizeList[nLevelIdx].height+nBandRows-1)/nBandRows));
+    std::vector<std::shared_future<void>> voRowFuncBandTasks(bConcurrentRowFunc?vvoGradBandTasks[0].size():size_t(0));
+    const auto lWaitTask = [](const std::shared_future<void>& oTask) {
+        if(oTask.valid()) // invalid if the task was processed on the calling thread
+            oTask.get(); // will rethrow any exception caught in the worker
+    };
+    const auto lQueueTask = [&](std::function<void()>&& lTask) {
+        if(m_pWorkerPool)
+            return m_pWorkerPool->queueTask(std::move(lTask)).share();
+        lTask();
+        return std::shared_future<void>();
+    };
+    const auto lProcessRowFuncBand = [&](size_t nBandIdx) {
+        for(size_t nGradBandIdx=(nBandIdx>0?nBandIdx-1:0); nGradBandIdx<=nBandIdx+1 && nGradBandIdx<vvoGradBandTasks[0].size(); ++nGradBandIdx)
+            lWaitTask(vvoGradBandTasks[0][nGradBandIdx]);
+        const int nRowBegin = int(nBandIdx)*nBandRows, nRowEnd = std::min(nRowBegin+nBandRows,oInputImg.rows);
+        for(int nRowIter=nRowEnd-1; nRowIter>=nRowBegin; --nRowIter)
+            lRowFunc(nRowIter,(const uchar*)oGradMap.ptr<uchar>(nRowIter+(int)nNMSHalfWinSize)+nGradMapColStep*nNMSHalfWinSize);
+    };
+    std::vector<size_t> vnQueuedGradBandCounts(m_nLevels,0);
+    for(size_t nBandIdx=0; nBandIdx<vvoGradBandTasks[0].size(); ++nBandIdx) {
+        for(size_t nLevelIdx=m_nLevels-1; nLevelIdx!=size_t(-1); --nLevelIdx) {
+            const size_t nLevelBandIdx = nBandIdx>>nLevelIdx;
+            if(nLevelBandIdx<vnQueuedGradBandCounts[nLevelIdx])
+                continue;
+            CV_DbgAssert(nLevelBandIdx==vnQueuedGradBandCounts[nLevelIdx] && nLevelBandIdx<vvoGradBandTasks[nLevelIdx].size());
+            vvoGradBandTasks[nLevelIdx][nLevelBandIdx] = lQueueTask([&,nLevelIdx,nLevelBandIdx]() {
+                if(nLevelIdx+1<m_nLevels)
+                    lWaitTask(vvoGradBandTasks[nLevelIdx+1][nLevelBandIdx>>1]);
+                const int nRowBegin = int(nLevelBandIdx)*nBandRows;
+                lProcessGradBand(nLevelIdx,nRowBegin,std::min(nRowBegin+nBandRows,m_voMapSizeList[nLevelIdx].height));
+            });
+            ++vnQueuedGradBandCounts[nLevelIdx];
+        }
+        // NMS windows of a full-scale band overlap with the previous and next bands, so row functor bands lag one band behind
+        if(bConcurrentRowFunc && nBandIdx>0)
+            voRowFuncBandTasks[nBandIdx-1] = lQueueTask([&,nBandIdx]() {lProcessRowFuncBand(nBandIdx-1);});
     }
-}
-
-template void EdgeDetectorLBSP::apply_internal_lookup<1>(const cv::Mat&);
-template void EdgeDetectorLBSP::apply_internal_lookup<2>(const cv::Mat&);
-template void EdgeDetectorLBSP::apply_internal_lookup<3>(const cv::Mat&);
-template void EdgeDetectorLBSP::apply_internal_lookup<4>(const cv::Mat&);
-
-void EdgeDetectorLBSP::apply_internal_lookup(const cv::Mat& oInputImg, size_t nChannels) {
-    if(nChannels==1)
-        apply_internal_lookup<1>(oInputImg);
-    else if(nChannels==2)
-        apply_internal_lookup<2>(oInputImg);
-    else if(nChannels==3)
-        apply_internal_lookup<3>(oInputImg);
-    else if(nChannels==4)
-        apply_internal_lookup<4>(oInputImg);
-    else
-        CV_Error(-1,"Unexpected channel count");
+    if(bConcurrentRowFunc)
+        voRowFuncBandTasks.back() = lQueueTask([&]() {lProcessRowFuncBand(voRowFuncBandTasks.size()-1);});
+    // all tasks reference local state, so they must all be done before anything gets rethrown
+    for(const std::vector<std::shared_future<void>>& voGradBandTasks : vvoGradBandTasks)
+        for(const std::shared_future<void>& oTask : voGradBandTasks)
+            if(oTask.valid())
+                oTask.wait();
+    for(const std::shared_future<void>& oTask : voRowFuncBandTasks)
+        if(oTask.valid())
+            oTask.wait();
+    for(const std::vector<std::shared_future<void>>& voGradBandTasks : vvoGradBandTasks)
+        for(const std::shared_future<void>& oTask : voGradBandTasks)
+            lWaitTask(oTask);
+    for(const std::shared_future<void>& oTask : voRowFuncBandTasks)
+        lWaitTask(oTask);
+    if(!bConcurrentRowFunc) // bands are visited bottom-up to keep the full-scale row order strictly decreasing
+        for(size_t nBandIdx=vvoGradBandTasks[0].size()-1; nBandIdx!=size_t(-1); --nBandIdx)
+            lProcessRowFuncBand(nBandIdx);
 }
 
 template<size_t nChannels>
@@ -165,8 +233,6 @@ void EdgeDetectorLBSP::apply_internal_threshold(const cv::Mat& oInputImg, cv::Ma
     CV_DbgAssert(oInputImg.isContinuous());
     CV_DbgAssert(!oEdgeMask.empty());
     CV_DbgAssert(oEdgeMask.isContinuous());
-    const int nOrigType = CV_8UC(int(nChannels));
-    const size_t nColLUTStep = LBSP::DESC_SIZE_BITS*nChannels;
     const uchar nHystHighThreshold = nDetThreshold;
     const uchar nHystLowThreshold = (uchar)(nDetThreshold*m_dHystLowThrshFactor);
     constexpr size_t nNMSWinSize = USE_5x5_NON_MAX_SUPP?LBSP::PATCH_SIZE:3;
@@ -176,22 +242,10 @@ void EdgeDetectorLBSP::apply_internal_threshold(const cv::Mat& oInputImg, cv::Ma
     const size_t nGradMapRowStep = oMapSize.width*nGradMapColStep;
     constexpr size_t nEdgeMapColStep = 1; // 1ch (label)
     const size_t nEdgeMapRowStep = oMapSize.width*nEdgeMapColStep;
-    m_vuLBSPGradMapData.resize(oMapSize.height*nGradMapRowStep);
     m_vuEdgeTempMaskData.resize(oMapSize.height*nEdgeMapRowStep);
-    cv::Mat oGradMap(oMapSize,CV_8UC4,m_vuLBSPGradMapData.data());
     cv::Mat oEdgeTempMask(oMapSize,CV_8UC1,m_vuEdgeTempMaskData.data());
-    std::fill(m_vuLBSPGradMapData.data(),m_vuLBSPGradMapData.data()+nGradMapRowStep*nNMSHalfWinSize,0);
-    std::fill(m_vuLBSPGradMapData.data()+(oMapSize.height-nNMSHalfWinSize)*nGradMapRowStep,m_vuLBSPGradMapData.data()+oMapSize.height*nGradMapRowStep,0);
     std::fill(m_vuEdgeTempMaskData.data(),m_vuEdgeTempMaskData.data()+nEdgeMapRowStep*nNMSHalfWinSize,1);
     std::fill(m_vuEdgeTempMaskData.data()+(oMapSize.height-nNMSHalfWinSize)*nEdgeMapRowStep,m_vuEdgeTempMaskData.data()+oMapSize.height*nEdgeMapRowStep,1);
-#if USE_MIN_GRAD_ORIENT
-    static_assert(nGradMapColStep==4,"Need 32-bit chunks to copy (see lines with uint32_t)");
-    constexpr uint32_t nDefaultGradMapVal4Ch = (CHAR_MAX<<24)|(CHAR_MAX<<16)|(UCHAR_MAX)<<8;
-    std::fill((uint32_t*)(m_vuLBSPGradMapData.data()+nGradMapRowStep*nNMSHalfWinSize+nGradMapColStep*nNMSHalfWinSize),(uint32_t*)(m_vuLBSPGradMapData.data()+(oMapSize.height-nNMSHalfWinSize)*nGradMapRowStep-nNMSHalfWinSize*nGradMapColStep),nDefaultGradMapVal4Ch);
-    const auto lAbsCharComp = [](char a, char b){return std::abs(a)<std::abs(b);};
-#else //(!USE_MIN_GRAD_ORIENT)
-    oGradMap(cv::Rect(nNMSHalfWinSize,nNMSHalfWinSize,m_voMapSizeList.back().width,m_voMapSizeList.back().height)) = cv::Scalar_<uchar>(0,0,UCHAR_MAX,0);
-#endif //(!USE_MIN_GRAD_ORIENT)
     size_t nCurrHystStackSize = std::max(std::max((size_t)1<<10,(size_t)oMapSize.area()/8),m_vuHystStack.size());
     m_vuHystStack.resize(nCurrHystStackSize);
     uchar** pauHystStack_top = &m_vuHystStack[0];
@@ -214,120 +268,29 @@ void EdgeDetectorLBSP::apply_internal_threshold(const cv::Mat& oInputImg, cv::Ma
             pauHystStack_top = pauHystStack_bottom+nUsedHystStackSize;
         }
     };
-    for(int nLevelIter = (int)m_nLevels-1; nLevelIter>=0; --nLevelIter) {
-        const cv::Size& oCurrScaleSize = m_voMapSizeList[nLevelIter];
-        const cv::Mat& oPyrMap = (!nLevelIter)?oInputImg:cv::Mat(oCurrScaleSize,nOrigType,m_vvuInputPyrMaps[nLevelIter-1].data());
-        const size_t nRowLUTStep = nColLUTStep*(size_t)oCurrScaleSize.width;
-        for(int nRowIter = oCurrScaleSize.height-1; nRowIter>=-(int)nNMSHalfWinSize; --nRowIter) {
-            uchar* anGradRow = oGradMap.data+(nRowIter+nNMSHalfWinSize)*nGradMapRowStep+nGradMapColStep*nNMSHalfWinSize;
-            CV_DbgAssert(anGradRow>oGradMap.datastart && anGradRow<oGradMap.dataend);
-            if(nRowIter>=0) {
-                const size_t nRowLUTIdx = nRowIter*nRowLUTStep;
-                for(size_t nColIter = (size_t)oCurrScaleSize.width-1; nColIter!=size_t(-1); --nColIter) {
-                    const size_t nColLUTIdx = nRowLUTIdx+nColIter*nColLUTStep;
-                    const uchar* const anCurrLUT = m_vvuLBSPLookupMaps[nLevelIter].data()+nColLUTIdx;
-                    const uchar* const auRefColor = (oPyrMap.data+nColLUTIdx/LBSP::DESC_SIZE_BITS);
-                    char nGradX, nGradY;
-                    uchar nGradMag;
-                    LBSP::computeDescriptor_gradient<nChannels>(anCurrLUT,auRefColor,nGradX,nGradY,nGradMag);
-#if USE_MIN_GRAD_ORIENT
-                    (char&)(anGradRow[nColIter*nGradMapColStep]) = std::min(nGradX,char(anGradRow[nColIter*nGradMapColStep]),lAbsCharComp);
-                    (char&)(anGradRow[nColIter*nGradMapColStep+1]) = std::min(nGradY,char(anGradRow[nColIter*nGradMapColStep+1]),lAbsCharComp);
-#else //(!USE_MIN_GRAD_ORIENT)
-                    CV_DbgAssert((nGradX+(char)(anGradRow[nColIter*nGradMapColStep]*2))/2<=UCHAR_MAX);
-                    CV_DbgAssert((nGradY+(char)(anGradRow[nColIter*nGradMapColStep+1]*2))/2<=UCHAR_MAX);
-                    (char&)(anGradRow[nColIter*nGradMapColStep]) = ((nGradX+(char)(anGradRow[nColIter*nGradMapColStep]*2))/2);
-                    (char&)(anGradRow[nColIter*nGradMapColStep+1]) = ((nGradY+(char)(anGradRow[nColIter*nGradMapColStep+1]*2))/2);
-#endif //(!USE_MIN_GRAD_ORIENT)
-                    anGradRow[nColIter*nGradMapColStep+2] = std::min(nGradMag,anGradRow[nColIter*nGradMapColStep+2]);
-                    if(nLevelIter>0) {
-                        const size_t nRowIter_base = nRowIter << 1;
-                        const size_t nColIter_base = nColIter << 1;
-                        CV_DbgAssert((nRowIter_base+1)<size_t(oMapSize.height));
-                        CV_DbgAssert((nColIter_base+1)<size_t(oMapSize.width));
-                        CxxUtils::unroll<2>([&](int nRowIterOffset){
-                            uchar* anNextScaleGradRow = oGradMap.data+(nRowIter_base+nRowIterOffset+nNMSHalfWinSize)*nGradMapRowStep+nGradMapColStep*nNMSHalfWinSize;
-                            CV_DbgAssert(anNextScaleGradRow<oGradMap.dataend);
-                            CxxUtils::unroll<2>([&](int nColIterOffset){ // 4ch x 8ub = 32-bit chunks to copy
-                                *(uint32_t*)(anNextScaleGradRow+(nColIter_base+nColIterOffset)*nGradMapColStep) = *(uint32_t*)(anGradRow+nColIter*nGradMapColStep);
-                            });
-                        });
-                    }
-                }
+    // note: seeds are only pushed if their bottom/left neighbors are not seeds already, so rows are visited in order, on the calling thread
+    apply_internal_gradients<nChannels>(oInputImg,[&](int nRowIdx, const uchar* anGradRow) {
+        uchar* anEdgeMapRow = oEdgeTempMask.ptr<uchar>(nRowIdx+(int)nNMSHalfWinSize)+nNMSHalfWinSize*nEdgeMapColStep;
+        std::fill(anEdgeMapRow-nEdgeMapColStep*nNMSHalfWinSize,anEdgeMapRow,1);
+        std::fill(anEdgeMapRow+oInputImg.cols*nEdgeMapColStep,anEdgeMapRow+(oInputImg.cols+nNMSHalfWinSize)*nEdgeMapColStep,1);
+        stack_check_size(oInputImg.cols);
+        bool nNeighbMax = false;
+        for(size_t nColIter = 0; nColIter<(size_t)oInputImg.cols; ++nColIter) {
+            const uchar nGradMag = anGradRow[nColIter*nGradMapColStep+2];
+            if(nGradMag<nHystLowThreshold || !isGradMapLocalMaximum<nNMSHalfWinSize>(anGradRow+nColIter*nGradMapColStep,nGradMapColStep,nGradMapRowStep)) {
+                nNeighbMax = false;
+                anEdgeMapRow[nColIter*nEdgeMapColStep] = 1; // not an edge
+                continue;
             }
-            if(nLevelIter==0) {
-                std::fill(anGradRow-nGradMapColStep*nNMSHalfWinSize,anGradRow,0); // remove if init'd at top
-                std::fill(anGradRow+oInputImg.cols*nGradMapColStep,anGradRow+(oInputImg.cols+nNMSHalfWinSize)*nGradMapColStep,0);
-                if(nRowIter<oCurrScaleSize.height-int(nNMSHalfWinSize)) {
-                    anGradRow += nGradMapRowStep*nNMSHalfWinSize; // offset by nNMSHalfWinSize rows
-                    uchar* anEdgeMapRow = oEdgeTempMask.ptr<uchar>(nRowIter+nNMSHalfWinSize)+nNMSHalfWinSize*nEdgeMapColStep;
-                    std::fill(anEdgeMapRow-nEdgeMapColStep*nNMSHalfWinSize,anEdgeMapRow,1);
-                    std::fill(anEdgeMapRow+oInputImg.cols*nEdgeMapColStep,anEdgeMapRow+(oInputImg.cols+nNMSHalfWinSize)*nEdgeMapColStep,1);
-                    stack_check_size(oInputImg.cols);
-                    bool nNeighbMax = false;
-                    for(size_t nColIter = 0; nColIter<(size_t)oInputImg.cols; ++nColIter) {
-                        // make sure all 'quick-idx' lookups are at the right positions...
-                        CV_DbgAssert(anGradRow[nColIter*nGradMapColStep]==oGradMap.at<cv::Vec4b>(int(nRowIter+(nNMSHalfWinSize*2)),int(nColIter+nNMSHalfWinSize))[0]);
-                        CV_DbgAssert(anGradRow[nColIter*nGradMapColStep+1]==oGradMap.at<cv::Vec4b>(int(nRowIter+(nNMSHalfWinSize*2)),int(nColIter+nNMSHalfWinSize))[1]);
-                        for(int nNMSWinIter=-(int)nNMSHalfWinSize; nNMSWinIter<=(int)nNMSHalfWinSize; ++nNMSWinIter)
-                            CV_DbgAssert(anGradRow[nColIter*nGradMapColStep+nGradMapRowStep*nNMSWinIter+2]==oGradMap.at<cv::Vec4b>(int(nRowIter+nNMSWinIter+(nNMSHalfWinSize*2)),int(nColIter+nNMSHalfWinSize))[2]);
-                        const uchar nGradMag = anGradRow[nColIter*nGradMapColStep+2];
-                        if(nGradMag>=nHystLowThreshold) {
-#if USE_3_AXIS_ORIENT
-                            const char nGradX = ((char*)anGradRow)[nColIter*nGradMapColStep];
-                            const char nGradY = ((char*)anGradRow)[nColIter*nGradMapColStep+1];
-                            const uint nShift_FPA = 15;
-                            constexpr uint nTG22deg_FPA = (int)(0.4142135623730950488016887242097*(1<<nShift_FPA)+0.5); // == tan(pi/8)
-                            const uint nGradX_abs = (uint)std::abs(nGradX);
-                            const uint nGradY_abs = (uint)std::abs(nGradY)<<nShift_FPA;
-                            uint nTG22GradX_FPA = nGradX_abs*nTG22deg_FPA; // == 0.4142135623730950488016887242097*nGradX_abs
-                            if(nGradY_abs<nTG22GradX_FPA) { // if(nGradX_abs<0.4142135623730950488016887242097*nGradX_abs) == flat gradient (sector 0)
-                                if(litiv::isLocalMaximum_Horizontal<nNMSHalfWinSize>(anGradRow+nColIter*nGradMapColStep+2,nGradMapColStep,nGradMapRowStep))
-                                    goto _edge_good; // push as 'edge'
-                            }
-                            else { // else(nGradX_abs>=0.4142135623730950488016887242097*nGradX_abs) == not a flat gradient (sectors 1, 2 or 3)
-                                uint nTG67GradX_FPA = nTG22GradX_FPA+(nGradX_abs<<(nShift_FPA+1)); // == 2.4142135623730950488016887242097*nGradX_abs == tan(3*pi/8)*nGradX_abs
-                                if(nGradY_abs>nTG67GradX_FPA) { // if(nGradX_abs>2.4142135623730950488016887242097*nGradX_abs == vertical gradient (sector 2)
-                                    if(litiv::isLocalMaximum_Vertical<nNMSHalfWinSize>(anGradRow+nColIter*nGradMapColStep+2,nGradMapColStep,nGradMapRowStep))
-                                        goto _edge_good;
-                                }
-                                else { // else(nGradX_abs<=2.4142135623730950488016887242097*nGradX_abs == diagonal gradient (sector 1 or 3, depending on grad sign diff)
-                                    if(nGradX || nGradY) {
-                                        if(litiv::isLocalMaximum_Diagonal<nNMSHalfWinSize>(anGradRow+nColIter*nGradMapColStep+2,nGradMapColStep,nGradMapRowStep,(nGradX^nGradY)>=0))
-                                            goto _edge_good;
-                                    }
-                                    else {
-                                        if(litiv::isLocalMaximum_Diagonal<nNMSHalfWinSize,true>(anGradRow+nColIter*nGradMapColStep+2,nGradMapColStep,nGradMapRowStep) ||
-                                           litiv::isLocalMaximum_Diagonal<nNMSHalfWinSize,false>(anGradRow+nColIter*nGradMapColStep+2,nGradMapColStep,nGradMapRowStep))
-                                            goto _edge_good;
-                                    }
-                                }
-                            }
-#else //(!USE_3_AXIS_ORIENT)
-                            const uint nGradX_abs = (uint)std::abs(anGradRow[nColIter*nGradMapColStep]);
-                            const uint nGradY_abs = (uint)std::abs(anGradRow[nColIter*nGradMapColStep+1]);
-                            if((nGradY_abs<=nGradX_abs && isLocalMaximum_Horizontal<nNMSHalfWinSize>(anGradRow+nColIter*nGradMapColStep+2,nGradMapColStep,nGradMapRowStep)) ||
-                               (nGradY_abs>nGradX_abs && isLocalMaximum_Vertical<nNMSHalfWinSize>(anGradRow+nColIter*nGradMapColStep+2,nGradMapColStep,nGradMapRowStep)))
-                                goto _edge_good;
-#endif //(!USE_3_AXIS_ORIENT)
-                        }
-                        nNeighbMax = false;
-                        anEdgeMapRow[nColIter*nEdgeMapColStep] = 1; // not an edge
-                        continue;
-                        _edge_good:
-                        // if not neighbor to previously identified edge, and gradmag above max threshold
-                        if(!nNeighbMax && nGradMag>=nHystHighThreshold && anEdgeMapRow[nColIter*nEdgeMapColStep+nEdgeMapRowStep]!=2) {
-                            stack_push(anEdgeMapRow+nColIter);
-                            nNeighbMax = true;
-                            continue;
-                        }
-                        //_edge_maybe:
-                        anEdgeMapRow[nColIter*nEdgeMapColStep] = 0; // might belong to an edge
-                    }
-                }
+            // if not neighbor to previously identified edge, and gradmag above max threshold
+            if(!nNeighbMax && nGradMag>=nHystHighThreshold && anEdgeMapRow[nColIter*nEdgeMapColStep+nEdgeMapRowStep]!=2) {
+                stack_push(anEdgeMapRow+nColIter);
+                nNeighbMax = true;
+                continue;
             }
+            anEdgeMapRow[nColIter*nEdgeMapColStep] = 0; // might belong to an edge
         }
-    }
+    },false);
     CV_DbgAssert(oEdgeTempMask.step.p[0]==nEdgeMapRowStep);
     CV_DbgAssert(oEdgeTempMask.step.p[1]==nEdgeMapColStep);
     while(pauHystStack_top>pauHystStack_bottom) {
@@ -357,6 +320,42 @@ void EdgeDetectorLBSP::apply_internal_threshold(const cv::Mat& oInputImg, cv::Ma
             oEdgeMaskData[nColIter] = (uchar)-(*(anEdgeTempMaskData+nColIter*nEdgeMapColStep)>>1);
 }
 
+template<size_t nChannels>
+void EdgeDetectorLBSP::apply_internal_counts(const cv::Mat& oInputImg, cv::Mat& oCandidateCountMap, cv::Mat& oSeedCountMap, const std::vector<uchar>& vnDetThresholds) {
+    CV_DbgAssert(!oInputImg.empty());
+    CV_DbgAssert(oInputImg.isContinuous());
+    CV_DbgAssert(std::is_sorted(vnDetThresholds.begin(),vnDetThresholds.end()) && vnDetThresholds.size()<=UCHAR_MAX);
+    constexpr size_t nNMSWinSize = USE_5x5_NON_MAX_SUPP?LBSP::PATCH_SIZE:3;
+    constexpr size_t nNMSHalfWinSize = nNMSWinSize>>1;
+    constexpr size_t nGradMapColStep = 4; // 4ch (gradx, grady, gradmag, 'dont care')
+    const size_t nGradMapRowStep = (oInputImg.cols+nNMSHalfWinSize*2)*nGradMapColStep;
+    // edge candidate/seed sets are monotone w.r.t. the threshold, so the tests passed by a gradient magnitude over the (sorted) threshold
+    // list can be counted ahead of time (same low/high hysteresis thresholds as in apply_internal_threshold)
+    std::array<uchar,LBSP::MAX_GRAD_MAG+1> anCandidateCountLUT, anSeedCountLUT;
+    for(size_t nGradMag=0; nGradMag<=LBSP::MAX_GRAD_MAG; ++nGradMag) {
+        anCandidateCountLUT[nGradMag] = anSeedCountLUT[nGradMag] = 0;
+        for(const uchar nCurrThreshold : vnDetThresholds) {
+            anCandidateCountLUT[nGradMag] += uchar(nGradMag>=(size_t)(uchar)(nCurrThreshold*m_dHystLowThrshFactor));
+            anSeedCountLUT[nGradMag] += uchar(nGradMag>=(size_t)nCurrThreshold);
+        }
+    }
+    oCandidateCountMap.create(oInputImg.size(),CV_8UC1);
+    oSeedCountMap.create(oInputImg.size(),CV_8UC1);
+    apply_internal_gradients<nChannels>(oInputImg,[&](int nRowIdx, const uchar* anGradRow) {
+        uchar* anCandidateCounts = oCandidateCountMap.ptr<uchar>(nRowIdx);
+        uchar* anSeedCounts = oSeedCountMap.ptr<uchar>(nRowIdx);
+        for(size_t nColIter = 0; nColIter<(size_t)oInputImg.cols; ++nColIter) {
+            if(isGradMapLocalMaximum<nNMSHalfWinSize>(anGradRow+nColIter*nGradMapColStep,nGradMapColStep,nGradMapRowStep)) {
+                const uchar nGradMag = anGradRow[nColIter*nGradMapColStep+2];
+                anCandidateCounts[nColIter] = anCandidateCountLUT[nGradMag];
+                anSeedCounts[nColIter] = anSeedCountLUT[nGradMag];
+            }
+            else
+                anCandidateCounts[nColIter] = anSeedCounts[nColIter] = 0;
+        }
+    },true);
+}
+
 template void EdgeDetectorLBSP::apply_internal_threshold<1>(const cv::Mat&, cv::Mat&, uchar);
 template void EdgeDetectorLBSP::apply_internal_threshold<2>(const cv::Mat&, cv::Mat&, uchar);
 template void EdgeDetectorLBSP::apply_internal_threshold<3>(const cv::Mat&, cv::Mat&, uchar);
@@ -375,6 +374,52 @@ void EdgeDetectorLBSP::apply_internal_threshold(const cv::Mat& oInputImg, cv::Ma
         CV_Error(-1,"Unexpected channel count");
 }
 
+template void EdgeDetectorLBSP::apply_internal_counts<1>(const cv::Mat&, cv::Mat&, cv::Mat&, const std::vector<uchar>&);
+template void EdgeDetectorLBSP::apply_internal_counts<2>(const cv::Mat&, cv::Mat&, cv::Mat&, const std::vector<uchar>&);
+template void EdgeDetectorLBSP::apply_internal_counts<3>(const cv::Mat&, cv::Mat&, cv::Mat&, const std::vector<uchar>&);
+template void EdgeDetectorLBSP::apply_internal_counts<4>(const cv::Mat&, cv::Mat&, cv::Mat&, const std::vector<uchar>&);
+
+void EdgeDetectorLBSP::apply_internal_counts(const cv::Mat& oInputImg, cv::Mat& oCandidateCountMap, cv::Mat& oSeedCountMap, const std::vector<uchar>& vnDetThresholds, size_t nChannels) {
+    if(nChannels==1)
+        apply_internal_counts<1>(oInputImg,oCandidateCountMap,oSeedCountMap,vnDetThresholds);
+    else if(nChannels==2)
+        apply_internal_counts<2>(oInputImg,oCandidateCountMap,oSeedCountMap,vnDetThresholds);
+    else if(nChannels==3)
+        apply_internal_counts<3>(oInputImg,oCandidateCountMap,oSeedCountMap,vnDetThresholds);
+    else if(nChannels==4)
+        apply_internal_counts<4>(oInputImg,oCandidateCountMap,oSeedCountMap,vnDetThresholds);
+    else
+        CV_Error(-1,"Unexpected channel count");
+}
+
+void EdgeDetectorLBSP::setThresholdSweep(bool bEnabled) {
+    m_bUseThresholdSweep = bEnabled;
+}
+
+bool EdgeDetectorLBSP::isUsingThresholdSweep() const {
+    return m_bUseThresholdSweep;
+}
+
+void EdgeDetectorLBSP::setCompactLookup(bool bEnabled) {
+    m_bUseCompactLookup = bEnabled;
+    if(m_bUseCompactLookup)
+        m_oPyramid.releaseLookups();
+}
+
+bool EdgeDetectorLBSP::isUsingCompactLookup() const {
+    return m_bUseCompactLookup;
+}
+
+void EdgeDetectorLBSP::setParallelBands(size_t nBandRows, size_t nWorkers) {
+    CV_Assert((nBandRows%2)==0); // each coarse band must map to a whole number of finer bands
+    CV_Assert(nWorkers>0);
+    m_nBandRows = nBandRows;
+    if(nWorkers==1)
+        m_pWorkerPool.reset();
+    else if(!m_pWorkerPool || m_pWorkerPool->getWorkerCount()!=nWorkers)
+        m_pWorkerPool = std::make_unique<PlatformUtils::DynamicWorkerPool>(nWorkers);
+}
+
 void EdgeDetectorLBSP::apply_threshold(cv::InputArray _oInputImage, cv::OutputArray _oEdgeMask, double dDetThreshold) {
     cv::Mat oInputImg = _oInputImage.getMat();
     CV_Assert(!oInputImg.empty());
@@ -390,7 +435,7 @@ void EdgeDetectorLBSP::apply_threshold(cv::InputArray _oInputImage, cv::OutputAr
     if(dDetThreshold<0||dDetThreshold>1)
         dDetThreshold = getDefaultThreshold();
     const uchar nDetThreshold = (uchar)(dDetThreshold*LBSP::MAX_GRAD_MAG);
-    apply_internal_lookup(oInputImg,oInputImg.channels());
+    apply_internal_lookup(oInputImg);
     apply_internal_threshold(oInputImg,oEdgeMask,nDetThreshold,oInputImg.channels());
 }
 
@@ -404,15 +449,75 @@ void EdgeDetectorLBSP::apply(cv::InputArray _oInputImage, cv::OutputArray _oEdge
         oInputImg = oInputImg.clone();
         cv::GaussianBlur(oInputImg,oInputImg,cv::Size(nRealKernelSize,nRealKernelSize),m_dGaussianKernelSigma,m_dGaussianKernelSigma);
     }
-    apply_internal_lookup(oInputImg,oInputImg.channels());
+    apply_internal_lookup(oInputImg);
     _oEdgeMask.create(oInputImg.size(),CV_8UC1);
     cv::Mat oEdgeMask = _oEdgeMask.getMat();
-    oEdgeMask = cv::Scalar_<uchar>(0);
-    cv::Mat oTempEdgeMask = oEdgeMask.clone();
-    for(size_t nCurrThreshold=0; nCurrThreshold<LBSP::MAX_GRAD_MAG; ++nCurrThreshold) {
-        apply_internal_threshold(oInputImg,oTempEdgeMask,uchar(nCurrThreshold),oInputImg.channels());
-        oEdgeMask += oTempEdgeMask/double(LBSP::MAX_GRAD_MAG);
+    if(m_bUseThresholdSweep) {
+        apply_internal_counts(oInputImg,m_oCandidateCountMap,m_oSeedCountMap,getSweepThresholds(),oInputImg.channels());
+        litiv::computeHysteresisSweep(m_oCandidateCountMap,m_oSeedCountMap,oEdgeMask);
+        finalize_edge_counts(oEdgeMask);
+    }
+    else {
+        oEdgeMask = cv::Scalar_<uchar>(0);
+        cv::Mat oTempEdgeMask = oEdgeMask.clone();
+        for(size_t nCurrThreshold=0; nCurrThreshold<LBSP::MAX_GRAD_MAG; ++nCurrThreshold) {
+            apply_internal_threshold(oInputImg,oTempEdgeMask,uchar(nCurrThreshold),oInputImg.channels());
+            oEdgeMask += oTempEdgeMask/double(LBSP::MAX_GRAD_MAG);
+        }
+        if(m_bNormalizeOutput)
+            cv::normalize(oEdgeMask,oEdgeMask,0,UCHAR_MAX,cv::NORM_MINMAX);
     }
+}
+
+bool EdgeDetectorLBSP::apply_hysteresis_counts(cv::InputArray _oInputImage, cv::OutputArray _oCandidateCountMap, cv::OutputArray _oSeedCountMap, double dDetThreshold) {
+    cv::Mat oInputImg = _oInputImage.getMat();
+    CV_Assert(!oInputImg.empty());
+    CV_Assert(oInputImg.isContinuous());
+    if(m_dGaussianKernelSigma>0) {
+        const int nDefaultKernelSize = int(8*ceil(m_dGaussianKernelSigma));
+        const int nRealKernelSize = nDefaultKernelSize%2==0?nDefaultKernelSize+1:nDefaultKernelSize;
+        oInputImg = oInputImg.clone();
+        cv::GaussianBlur(oInputImg,oInputImg,cv::Size(nRealKernelSize,nRealKernelSize),m_dGaussianKernelSigma,m_dGaussianKernelSigma);
+    }
+    if(dDetThreshold>1)
+        dDetThreshold = getDefaultThreshold();
+    apply_internal_lookup(oInputImg);
+    _oCandidateCountMap.create(oInputImg.size(),CV_8UC1);
+    _oSeedCountMap.create(oInputImg.size(),CV_8UC1);
+    cv::Mat oCandidateCountMap = _oCandidateCountMap.getMat(), oSeedCountMap = _oSeedCountMap.getMat();
+    if(dDetThreshold<0)
+        apply_internal_counts(oInputImg,oCandidateCountMap,oSeedCountMap,getSweepThresholds(),oInputImg.channels());
+    else
+        apply_internal_counts(oInputImg,oCandidateCountMap,oSeedCountMap,std::vector<uchar>{(uchar)(dDetThreshold*LBSP::MAX_GRAD_MAG)},oInputImg.channels());
+    return true;
+}
+
+void EdgeDetectorLBSP::finalize_edge_counts(cv::Mat& oEdgeCountMap) {
+    // each threshold at which a pixel is an edge adds the same (rounded) increment as in the per-threshold accumulation of 'apply'
+    oEdgeCountMap *= (double)cv::saturate_cast<uchar>(double(UCHAR_MAX)/LBSP::MAX_GRAD_MAG);
     if(m_bNormalizeOutput)
-        cv::normalize(oEdgeMask,oEdgeMask,0,UCHAR_MAX,cv::NORM_MINMAX);
+        cv::normalize(oEdgeCountMap,oEdgeCountMap,0,UCHAR_MAX,cv::NORM_MINMAX);
+}
+
+size_t EdgeDetectorLBSP::getSupportRadius() const {
+    // the coarsest level's LBSP patches (plus the block containing the pixel, and one block for partially covered tile borders), plus
+    // the full-scale non-max suppression window, plus the (optional) blur kernel radius
+    constexpr size_t nNMSHalfWinSize = (USE_5x5_NON_MAX_SUPP?LBSP::PATCH_SIZE:3)>>1;
+    const size_t nBlurRadius = (m_dGaussianKernelSigma>0)?size_t(int(8*ceil(m_dGaussianKernelSigma))/2):size_t(0);
+    return ((LBSP::PATCH_SIZE/2+2)<<(m_nLevels-1))+nNMSHalfWinSize+nBlurRadius;
+}
+
+size_t EdgeDetectorLBSP::getTileAlignment() const {
+    // coarse level blocks must cover the same full-scale pixels in tiles as in the whole image
+    return size_t(1)<<(m_nLevels-1);
+}
+
+const std::vector<uchar>& EdgeDetectorLBSP::getSweepThresholds() {
+    static const std::vector<uchar> s_vnSweepThresholds = [](){
+        std::vector<uchar> vnThresholds(LBSP::MAX_GRAD_MAG);
+        for(size_t nCurrThreshold=0; nCurrThreshold<LBSP::MAX_GRAD_MAG; ++nCurrThreshold)
+            vnThresholds[nCurrThreshold] = uchar(nCurrThreshold);
+        return vnThresholds;
+    }();
+    return s_vnSweepThresholds;
 }
@@ -0,0 +1,191 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "litiv/imgproc/EdgeDetectorTiled.hpp"
+#include "litiv/imgproc.hpp"
+
+// rounds the given value up to the next multiple of the given alignment
+static inline size_t getAlignedSize(size_t nSize, size_t nAlignment) {
+    return ((nSize+nAlignment-1)/nAlignment)*nAlignment;
+}
+
+EdgeDetectorTiled::EdgeDetectorTiled(DetectorFactory lDetectorFactory, cv::Size oTileSize, size_t nWorkers) :
+        m_lDetectorFactory(std::move(lDetectorFactory)),
+        m_pDetector(m_lDetectorFactory?m_lDetectorFactory():nullptr),
+        m_nHaloSize(m_pDetector?getAlignedSize(m_pDetector->getSupportRadius(),m_pDetector->getTileAlignment()):size_t(0)) {
+    CV_Assert(m_pDetector);
+    CV_Assert(m_pDetector->getTileAlignment()>0);
+    m_vpIdleDetectors.push_back(m_pDetector);
+    setTiling(oTileSize,nWorkers);
+}
+
+double EdgeDetectorTiled::getDefaultThreshold() const {
+    return m_pDetector->getDefaultThreshold();
+}
+
+void EdgeDetectorTiled::setTiling(cv::Size oTileSize, size_t nWorkers) {
+    CV_Assert(oTileSize.area()>0);
+    CV_Assert(nWorkers>0);
+    const size_t nAlignment = m_pDetector->getTileAlignment();
+    m_oTileSize = cv::Size((int)getAlignedSize((size_t)oTileSize.width,nAlignment),(int)getAlignedSize((size_t)oTileSize.height,nAlignment));
+    if(nWorkers==1)
+        m_pWorkerPool.reset();
+    else if(!m_pWorkerPool || m_pWorkerPool->getWorkerCount()!=nWorkers)
+        m_pWorkerPool = std::make_unique<PlatformUtils::DynamicWorkerPool>(nWorkers);
+}
+
+cv::Size EdgeDetectorTiled::getTileSize() const {
+    return m_oTileSize;
+}
+
+size_t EdgeDetectorTiled::getHaloSize() const {
+    return m_nHaloSize;
+}
+
+std::shared_ptr<IIEdgeDetector> EdgeDetectorTiled::popIdleDetector() {
+    {
+        std::mutex_lock_guard sync_lock(m_oIdleDetectorsMutex);
+        if(!m_vpIdleDetectors.empty()) {
+            std::shared_ptr<IIEdgeDetector> pDetector = std::move(m_vpIdleDetectors.back());
+            m_vpIdleDetectors.pop_back();
+            return pDetector;
+        }
+    }
+    std::shared_ptr<IIEdgeDetector> pDetector = m_lDetectorFactory();
+    CV_Assert(pDetector);
+    return pDetector;
+}
+
+void EdgeDetectorTiled::pushIdleDetector(const std::shared_ptr<IIEdgeDetector>& pDetector) {
+    std::mutex_lock_guard sync_lock(m_oIdleDetectorsMutex);
+    m_vpIdleDetectors.push_back(pDetector);
+}
+
+void EdgeDetectorTiled::apply_internal(const cv::Mat& oInputImg, cv::Mat& oEdgeCountMap, double dThreshold) {
+    CV_DbgAssert(!oInputImg.empty());
+    const cv::Rect oImageRect(cv::Point(0,0),oInputImg.size());
+    const cv::Size oTileGridSize((oInputImg.cols+m_oTileSize.width-1)/m_oTileSize.width,(oInputImg.rows+m_oTileSize.height-1)/m_oTileSize.height);
+    const int nHaloSize = (int)m_nHaloSize;
+    oEdgeCountMap.create(oInputImg.size(),CV_8UC1);
+    m_oCandidateCountMap.create(oInputImg.size(),CV_8UC1);
+    CV_DbgAssert(m_oCandidateCountMap.isContinuous());
+    // first pass: each padded tile is processed independently (w/ its own copy of the input), and hysteresis is solved inside its core only
+    const auto lProcessTile = [&](int nTileRowIdx, int nTileColIdx) {
+        const cv::Rect oCoreRect = cv::Rect(cv::Point(nTileColIdx*m_oTileSize.width,nTileRowIdx*m_oTileSize.height),m_oTileSize)&oImageRect;
+        const cv::Rect oPaddedRect = cv::Rect(oCoreRect.x-nHaloSize,oCoreRect.y-nHaloSize,oCoreRect.width+nHaloSize*2,oCoreRect.height+nHaloSize*2)&oImageRect;
+        const cv::Rect oCoreRectInTile(oCoreRect.tl()-oPaddedRect.tl(),oCoreRect.size());
+        const cv::Mat oTileImg = oInputImg(oPaddedRect).clone();
+        cv::Mat oTileCandidateCountMap, oTileSeedCountMap, oCoreEdgeCountMap;
+        std::shared_ptr<IIEdgeDetector> pDetector = popIdleDetector();
+        bool bSupported = false;
+        try {
+            bSupported = pDetector->apply_hysteresis_counts(oTileImg,oTileCandidateCountMap,oTileSeedCountMap,dThreshold);
+        }
+        catch(...) {
+            pushIdleDetector(pDetector);
+            throw;
+        }
+        pushIdleDetector(pDetector);
+        lvAssert(bSupported);
+        litiv::computeHysteresisSweep(oTileCandidateCountMap(oCoreRectInTile),oTileSeedCountMap(oCoreRectInTile),oCoreEdgeCountMap);
+        cv::Mat oCandidateCountMapCore = m_oCandidateCountMap(oCoreRect), oEdgeCountMapCore = oEdgeCountMap(oCoreRect);
+        oTileCandidateCountMap(oCoreRectInTile).copyTo(oCandidateCountMapCore);
+        oCoreEdgeCountMap.copyTo(oEdgeCountMapCore);
+    };
+    std::vector<std::future<void>> voTileTasks;
+    for(int nTileRowIdx=0; nTileRowIdx<oTileGridSize.height; ++nTileRowIdx) {
+        for(int nTileColIdx=0; nTileColIdx<oTileGridSize.width; ++nTileColIdx) {
+            if(m_pWorkerPool)
+                voTileTasks.push_back(m_pWorkerPool->queueTask(lProcessTile,nTileRowIdx,nTileColIdx));
+            else
+                lProcessTile(nTileRowIdx,nTileColIdx);
+        }
+    }
+    // all tasks reference local state, so they must all be done before anything gets rethrown
+    for(const std::future<void>& oTask : voTileTasks)
+        oTask.wait();
+    for(std::future<void>& oTask : voTileTasks)
+        oTask.get();
+    // second pass: edges can only be missing where a tile border splits a candidate component, so (as in a bottleneck path search) edge counts
+    // are propagated in decreasing order starting from the pixels on either side of tile borders, and only while they improve neighboring counts
+    const size_t nCols = (size_t)oInputImg.cols, nRows = (size_t)oInputImg.rows;
+    const uchar* const anCandidateCounts = m_oCandidateCountMap.data;
+    // the output may be a non-continuous ROI, so its pixels are addressed via its own row step (queued indices are packed)
+    const size_t nEdgeCountRowStep = oEdgeCountMap.step.p[0];
+    const auto lGetEdgeCount = [&](size_t nRowIdx, size_t nColIdx) -> uchar& {
+        return oEdgeCountMap.data[nRowIdx*nEdgeCountRowStep+nColIdx];
+    };
+    const auto lPushBorderPx = [&](size_t nRowIdx, size_t nColIdx) {
+        const uchar nEdgeCount = lGetEdgeCount(nRowIdx,nColIdx);
+        if(nEdgeCount)
+            m_avnPropagBuckets[nEdgeCount].push_back(nRowIdx*nCols+nColIdx);
+    };
+    for(size_t nBorderRowIdx=(size_t)m_oTileSize.height; nBorderRowIdx<nRows; nBorderRowIdx+=(size_t)m_oTileSize.height) {
+        for(size_t nColIdx=0; nColIdx<nCols; ++nColIdx) {
+            lPushBorderPx(nBorderRowIdx-1,nColIdx);
+            lPushBorderPx(nBorderRowIdx,nColIdx);
+        }
+    }
+    for(size_t nBorderColIdx=(size_t)m_oTileSize.width; nBorderColIdx<nCols; nBorderColIdx+=(size_t)m_oTileSize.width) {
+        for(size_t nRowIdx=0; nRowIdx<nRows; ++nRowIdx) {
+            lPushBorderPx(nRowIdx,nBorderColIdx-1);
+            lPushBorderPx(nRowIdx,nBorderColIdx);
+        }
+    }
+    for(size_t nCount=UCHAR_MAX; nCount>0; --nCount) {
+        std::vector<size_t>& vnBucket = m_avnPropagBuckets[nCount];
+        while(!vnBucket.empty()) {
+            const size_t nPxIdx = vnBucket.back();
+            vnBucket.pop_back();
+            const size_t nRowIdx = nPxIdx/nCols, nColIdx = nPxIdx%nCols;
+            if((size_t)lGetEdgeCount(nRowIdx,nColIdx)!=nCount)
+                continue; // stale entry, the pixel was already reached with a higher count
+            for(size_t nNeighbRowIdx=(nRowIdx>0?nRowIdx-1:0); nNeighbRowIdx<=std::min(nRowIdx+1,nRows-1); ++nNeighbRowIdx) {
+                for(size_t nNeighbColIdx=(nColIdx>0?nColIdx-1:0); nNeighbColIdx<=std::min(nColIdx+1,nCols-1); ++nNeighbColIdx) {
+                    const size_t nNeighbPxIdx = nNeighbRowIdx*nCols+nNeighbColIdx;
+                    const uchar nNewCount = std::min((uchar)nCount,anCandidateCounts[nNeighbPxIdx]);
+                    uchar& nNeighbEdgeCount = lGetEdgeCount(nNeighbRowIdx,nNeighbColIdx);
+                    if(nNewCount>nNeighbEdgeCount) {
+                        nNeighbEdgeCount = nNewCount;
+                        m_avnPropagBuckets[nNewCount].push_back(nNeighbPxIdx);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void EdgeDetectorTiled::apply_threshold(cv::InputArray _oInputImage, cv::OutputArray _oEdgeMask, double dThreshold) {
+    cv::Mat oInputImg = _oInputImage.getMat();
+    CV_Assert(!oInputImg.empty());
+    if(dThreshold<0)
+        dThreshold = getDefaultThreshold();
+    _oEdgeMask.create(oInputImg.size(),CV_8UC1);
+    cv::Mat oEdgeMask = _oEdgeMask.getMat();
+    apply_internal(oInputImg,oEdgeMask,dThreshold);
+    // with a single threshold, edge counts are binary
+    oEdgeMask *= UCHAR_MAX;
+}
+
+void EdgeDetectorTiled::apply(cv::InputArray _oInputImage, cv::OutputArray _oEdgeMask) {
+    cv::Mat oInputImg = _oInputImage.getMat();
+    CV_Assert(!oInputImg.empty());
+    _oEdgeMask.create(oInputImg.size(),CV_8UC1);
+    cv::Mat oEdgeMask = _oEdgeMask.getMat();
+    apply_internal(oInputImg,oEdgeMask,-1);
+    m_pDetector->finalize_edge_counts(oEdgeMask);
+}
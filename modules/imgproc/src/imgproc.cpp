@@ -151,3 +151,97 @@ void litiv::thinning(const cv::Mat& oInput, cv::Mat& oOutput, eThinningMode eMod
     }
     while(!bEq);
 }
+
+void litiv::computeHysteresisSweep(const cv::Mat& oCandidateCountMap, const cv::Mat& oSeedCountMap, cv::Mat& oEdgeCountMap) {
+    CV_Assert(!oCandidateCountMap.empty() && oCandidateCountMap.type()==CV_8UC1);
+    CV_Assert(oSeedCountMap.size()==oCandidateCountMap.size() && oSeedCountMap.type()==CV_8UC1);
+    const int nRows = oCandidateCountMap.rows, nCols = oCandidateCountMap.cols;
+    oEdgeCountMap.create(oCandidateCountMap.size(),CV_8UC1);
+    oEdgeCountMap = cv::Scalar_<uchar>(0);
+    // candidates are indexed compactly in raster order, and ordered by candidate/seed counts via counting sort
+    cv::Mat_<int> oCandidateIdxMap(oCandidateCountMap.size(),-1);
+    std::vector<int> vnCandidatePxIdxs;
+    std::array<size_t,UCHAR_MAX+2> anInsertBucketOffsets{}, anSeedBucketOffsets{};
+    for(int nRowIter=0; nRowIter<nRows; ++nRowIter) {
+        const uchar* anCandidateCounts = oCandidateCountMap.ptr<uchar>(nRowIter);
+        const uchar* anSeedCounts = oSeedCountMap.ptr<uchar>(nRowIter);
+        int* anCandidateIdxs = oCandidateIdxMap.ptr<int>(nRowIter);
+        for(int nColIter=0; nColIter<nCols; ++nColIter) {
+            if(anCandidateCounts[nColIter]) {
+                anCandidateIdxs[nColIter] = (int)vnCandidatePxIdxs.size();
+                vnCandidatePxIdxs.push_back(nRowIter*nCols+nColIter);
+                ++anInsertBucketOffsets[anCandidateCounts[nColIter]+1];
+                ++anSeedBucketOffsets[std::min(anSeedCounts[nColIter],anCandidateCounts[nColIter])+1];
+            }
+        }
+    }
+    const size_t nCandidates = vnCandidatePxIdxs.size();
+    for(size_t nBucketIdx=1; nBucketIdx<anInsertBucketOffsets.size(); ++nBucketIdx) {
+        anInsertBucketOffsets[nBucketIdx] += anInsertBucketOffsets[nBucketIdx-1];
+        anSeedBucketOffsets[nBucketIdx] += anSeedBucketOffsets[nBucketIdx-1];
+    }
+    std::vector<int> vnInsertOrder(nCandidates), vnSeedOrder(nCandidates);
+    {
+        std::array<size_t,UCHAR_MAX+2> anInsertBucketFill = anInsertBucketOffsets, anSeedBucketFill = anSeedBucketOffsets;
+        for(size_t nCandidateIdx=0; nCandidateIdx<nCandidates; ++nCandidateIdx) {
+            const int nPxIdx = vnCandidatePxIdxs[nCandidateIdx];
+            const uchar nCandidateCount = oCandidateCountMap.at<uchar>(nPxIdx/nCols,nPxIdx%nCols);
+            const uchar nSeedCount = std::min(oSeedCountMap.at<uchar>(nPxIdx/nCols,nPxIdx%nCols),nCandidateCount);
+            vnInsertOrder[anInsertBucketFill[nCandidateCount]++] = (int)nCandidateIdx;
+            vnSeedOrder[anSeedBucketFill[nSeedCount]++] = (int)nCandidateIdx;
+        }
+    }
+    // union-find forest over inserted candidates; inactive components (w/o seed yet) keep all their members in a circular list,
+    // which is assigned the current count (and dropped) once the component gets seeded or merged with a seeded component
+    std::vector<int> vnParents(nCandidates,-1), vnNextMembers(nCandidates);
+    std::vector<uchar> vnRanks(nCandidates,0), vbActive(nCandidates,0);
+    const auto lFind = [&](int nIdx) {
+        while(vnParents[nIdx]!=nIdx)
+            nIdx = vnParents[nIdx] = vnParents[vnParents[nIdx]];
+        return nIdx;
+    };
+    const auto lActivate = [&](int nRootIdx, uchar nCount) {
+        int nMemberIdx = nRootIdx;
+        do {
+            // the output may be a non-continuous ROI, so it is written row by row (packed indices only hold for the candidate list)
+            const int nPxIdx = vnCandidatePxIdxs[nMemberIdx];
+            oEdgeCountMap.ptr<uchar>(nPxIdx/nCols)[nPxIdx%nCols] = nCount;
+            nMemberIdx = vnNextMembers[nMemberIdx];
+        } while(nMemberIdx!=nRootIdx);
+        vbActive[nRootIdx] = 1;
+    };
+    const auto lUnion = [&](int nIdxA, int nIdxB, uchar nCount) {
+        int nRootA = lFind(nIdxA), nRootB = lFind(nIdxB);
+        if(nRootA==nRootB)
+            return;
+        if(vbActive[nRootA]!=vbActive[nRootB])
+            lActivate(vbActive[nRootA]?nRootB:nRootA,nCount);
+        else if(!vbActive[nRootA])
+            std::swap(vnNextMembers[nRootA],vnNextMembers[nRootB]); // splices both circular member lists
+        if(vnRanks[nRootA]<vnRanks[nRootB])
+            std::swap(nRootA,nRootB);
+        vnParents[nRootB] = nRootA;
+        vnRanks[nRootA] += uchar(vnRanks[nRootA]==vnRanks[nRootB]);
+    };
+    // counts are processed from the least to the most sensitive threshold, so candidate sets only grow (and components only merge)
+    for(size_t nCount=UCHAR_MAX; nCount>0; --nCount) {
+        for(size_t nOrderIdx=anInsertBucketOffsets[nCount]; nOrderIdx<anInsertBucketOffsets[nCount+1]; ++nOrderIdx) {
+            const int nCandidateIdx = vnInsertOrder[nOrderIdx];
+            vnParents[nCandidateIdx] = vnNextMembers[nCandidateIdx] = nCandidateIdx;
+            const int nRowIter = vnCandidatePxIdxs[nCandidateIdx]/nCols, nColIter = vnCandidatePxIdxs[nCandidateIdx]%nCols;
+            for(int nNeighbRowIter=std::max(nRowIter-1,0); nNeighbRowIter<=std::min(nRowIter+1,nRows-1); ++nNeighbRowIter) {
+                const int* anNeighbCandidateIdxs = oCandidateIdxMap.ptr<int>(nNeighbRowIter);
+                for(int nNeighbColIter=std::max(nColIter-1,0); nNeighbColIter<=std::min(nColIter+1,nCols-1); ++nNeighbColIter) {
+                    const int nNeighbCandidateIdx = anNeighbCandidateIdxs[nNeighbColIter];
+                    if(nNeighbCandidateIdx>=0 && nNeighbCandidateIdx!=nCandidateIdx && vnParents[nNeighbCandidateIdx]>=0)
+                        lUnion(nCandidateIdx,nNeighbCandidateIdx,(uchar)nCount);
+                }
+            }
+        }
+        for(size_t nOrderIdx=anSeedBucketOffsets[nCount]; nOrderIdx<anSeedBucketOffsets[nCount+1]; ++nOrderIdx) {
+            const int nRootIdx = lFind(vnSeedOrder[nOrderIdx]);
+            if(!vbActive[nRootIdx])
+                lActivate(nRootIdx,(uchar)nCount);
+        }
+    }
+}
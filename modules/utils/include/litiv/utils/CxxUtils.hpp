@@ -18,6 +18,7 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 #include <mutex>
 #include <array>
 #include <vector>
@@ -223,6 +224,52 @@ namespace CxxUtils {
         std::chrono::high_resolution_clock::time_point m_nTick;
     };
 
+    //! fast & lightweight pseudo-random number generator (xoshiro128**) meant to replace 'rand()' in per-pixel loops
+    //! note: not thread-safe; use one instance per thread/tile, and derive their seeds via 'getSubSeed' for reproducible results
+    struct FastRNG {
+        typedef uint32_t result_type;
+        //! initializes the generator state from a single 64-bit seed (via splitmix64)
+        explicit FastRNG(uint64_t nSeed=0) {seed(nSeed);}
+        //! resets the generator state from a single 64-bit seed (via splitmix64)
+        void seed(uint64_t nSeed) {
+            for(size_t n=0; n<4; n+=2) {
+                const uint64_t nVal = splitmix64(nSeed);
+                m_anState[n] = (uint32_t)nVal;
+                m_anState[n+1] = (uint32_t)(nVal>>32);
+            }
+            if(!(m_anState[0]|m_anState[1]|m_anState[2]|m_anState[3])) // all-zero state is a fixed point
+                m_anState[0] = 1;
+        }
+        //! returns the next 32-bit pseudo-random value
+        inline result_type operator()() {
+            const uint32_t nResult = rotl(m_anState[1]*5,7)*9;
+            const uint32_t nTemp = m_anState[1]<<9;
+            m_anState[2] ^= m_anState[0];
+            m_anState[3] ^= m_anState[1];
+            m_anState[1] ^= m_anState[2];
+            m_anState[0] ^= m_anState[3];
+            m_anState[2] ^= nTemp;
+            m_anState[3] = rotl(m_anState[3],11);
+            return nResult;
+        }
+        static constexpr result_type min() {return 0;}
+        static constexpr result_type max() {return UINT32_MAX;}
+        //! returns a seed derived from a base seed and an index (e.g. tile or thread index), decorrelated from neighboring indices
+        static inline uint64_t getSubSeed(uint64_t nBaseSeed, uint64_t nIdx) {
+            uint64_t nState = nBaseSeed^(nIdx*0xD1B54A32D192ED03ULL);
+            return splitmix64(nState);
+        }
+    private:
+        static inline uint32_t rotl(uint32_t nVal, int nShift) {return (nVal<<nShift)|(nVal>>(32-nShift));}
+        static inline uint64_t splitmix64(uint64_t& nState) {
+            uint64_t nVal = (nState += 0x9E3779B97F4A7C15ULL);
+            nVal = (nVal^(nVal>>30))*0xBF58476D1CE4E5B9ULL;
+            nVal = (nVal^(nVal>>27))*0x94D049BB133111EBULL;
+            return nVal^(nVal>>31);
+        }
+        uint32_t m_anState[4];
+    };
+
     static inline std::string getTimeStamp() {
         std::time_t tNow = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
         char acBuffer[128];
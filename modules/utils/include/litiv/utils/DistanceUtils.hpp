@@ -23,6 +23,39 @@
 
 namespace DistanceUtils {
 
+    //! defines whether whole-array distances over the given element type/channel count are forwarded to the block-wise kernels below
+    template<size_t nChannels, typename T>
+    struct has_blockwise_impl : std::integral_constant<bool,(nChannels>0 && nChannels<=4) && (std::is_same<T,uchar>::value || std::is_same<T,ushort>::value || std::is_same<T,float>::value)> {};
+
+    //! computes the L1 distance between two 1-4 channel arrays, w/ optional per-element mask (block-wise, runtime-dispatched)
+    size_t L1dist(const uchar* a, const uchar* b, size_t nElements, size_t nChannels, const uchar* m=NULL);
+    //! computes the L1 distance between two 1-4 channel arrays, w/ optional per-element mask (block-wise, runtime-dispatched)
+    size_t L1dist(const ushort* a, const ushort* b, size_t nElements, size_t nChannels, const uchar* m=NULL);
+    //! computes the L1 distance between two 1-4 channel arrays, w/ optional per-element mask (block-wise, runtime-dispatched)
+    float L1dist(const float* a, const float* b, size_t nElements, size_t nChannels, const uchar* m=NULL);
+    //! computes the squared L2 distance between two 1-4 channel arrays, w/ optional per-element mask (block-wise, runtime-dispatched)
+    size_t L2sqrdist(const uchar* a, const uchar* b, size_t nElements, size_t nChannels, const uchar* m=NULL);
+    //! computes the squared L2 distance between two 1-4 channel arrays, w/ optional per-element mask (block-wise, runtime-dispatched)
+    size_t L2sqrdist(const ushort* a, const ushort* b, size_t nElements, size_t nChannels, const uchar* m=NULL);
+    //! computes the squared L2 distance between two 1-4 channel arrays, w/ optional per-element mask (block-wise, runtime-dispatched)
+    float L2sqrdist(const float* a, const float* b, size_t nElements, size_t nChannels, const uchar* m=NULL);
+    //! computes the L2 distance between two 1-4 channel arrays, w/ optional per-element mask (block-wise, runtime-dispatched)
+    float L2dist(const uchar* a, const uchar* b, size_t nElements, size_t nChannels, const uchar* m=NULL);
+    //! computes the L2 distance between two 1-4 channel arrays, w/ optional per-element mask (block-wise, runtime-dispatched)
+    float L2dist(const ushort* a, const ushort* b, size_t nElements, size_t nChannels, const uchar* m=NULL);
+    //! computes the L2 distance between two 1-4 channel arrays, w/ optional per-element mask (block-wise, runtime-dispatched)
+    float L2dist(const float* a, const float* b, size_t nElements, size_t nChannels, const uchar* m=NULL);
+    //! computes the color distortion between two 2-4 channel arrays, w/ optional per-element mask (block-wise)
+    size_t cdist(const uchar* a, const uchar* b, size_t nElements, size_t nChannels, const uchar* m=NULL);
+    //! computes the color distortion between two 2-4 channel arrays, w/ optional per-element mask (block-wise)
+    size_t cdist(const ushort* a, const ushort* b, size_t nElements, size_t nChannels, const uchar* m=NULL);
+    //! computes the color distortion between two 2-4 channel arrays, w/ optional per-element mask (block-wise)
+    float cdist(const float* a, const float* b, size_t nElements, size_t nChannels, const uchar* m=NULL);
+    //! computes the hamming distance between two 1-4 channel arrays, w/ optional per-element mask (block-wise, runtime-dispatched)
+    size_t hdist(const uchar* a, const uchar* b, size_t nElements, size_t nChannels, const uchar* m=NULL);
+    //! computes the hamming distance between two 1-4 channel arrays, w/ optional per-element mask (block-wise, runtime-dispatched)
+    size_t hdist(const ushort* a, const ushort* b, size_t nElements, size_t nChannels, const uchar* m=NULL);
+
     //! computes the L1 distance between two integer values
     template<typename T>
     static inline typename std::enable_if<std::is_integral<T>::value,size_t>::type L1dist(T a, T b) {
@@ -66,7 +99,7 @@ namespace DistanceUtils {
 
     //! computes the L1 distance between two generic arrays
     template<size_t nChannels, typename T>
-    static inline auto L1dist(const T* const a, const T* const b, size_t nElements, const uchar* m=NULL) -> decltype(L1dist<nChannels>(a,b)) {
+    static inline auto L1dist(const T* const a, const T* const b, size_t nElements, const uchar* m=NULL) -> typename std::enable_if<!has_blockwise_impl<nChannels,T>::value,decltype(L1dist<nChannels>(a,b))>::type {
         decltype(L1dist<nChannels>(a,b)) gResult = 0;
         size_t nTotElements = nElements*nChannels;
         if(m) {
@@ -81,6 +114,12 @@ namespace DistanceUtils {
         return gResult;
     }
 
+    //! computes the L1 distance between two generic arrays (forwarded to the block-wise kernels)
+    template<size_t nChannels, typename T>
+    static inline auto L1dist(const T* const a, const T* const b, size_t nElements, const uchar* m=NULL) -> typename std::enable_if<has_blockwise_impl<nChannels,T>::value,decltype(L1dist<nChannels>(a,b))>::type {
+        return L1dist(a,b,nElements,nChannels,m);
+    }
+
     //! computes the L1 distance between two generic arrays
     template<typename T>
     static inline auto L1dist(const T* const a, const T* const b, size_t nElements, size_t nChannels, const uchar* m=NULL) -> decltype(L1dist<3>(a,b,nElements,m)) {
@@ -144,7 +183,7 @@ namespace DistanceUtils {
 
     //! computes the squared L2 distance between two generic arrays
     template<size_t nChannels, typename T>
-    static inline auto L2sqrdist(const T* const a, const T* const b, size_t nElements, const uchar* m=NULL) -> decltype(L2sqrdist<nChannels>(a,b)) {
+    static inline auto L2sqrdist(const T* const a, const T* const b, size_t nElements, const uchar* m=NULL) -> typename std::enable_if<!has_blockwise_impl<nChannels,T>::value,decltype(L2sqrdist<nChannels>(a,b))>::type {
         decltype(L2sqrdist<nChannels>(a,b)) gResult = 0;
         size_t nTotElements = nElements*nChannels;
         if(m) {
@@ -159,6 +198,12 @@ namespace DistanceUtils {
         return gResult;
     }
 
+    //! computes the squared L2 distance between two generic arrays (forwarded to the block-wise kernels)
+    template<size_t nChannels, typename T>
+    static inline auto L2sqrdist(const T* const a, const T* const b, size_t nElements, const uchar* m=NULL) -> typename std::enable_if<has_blockwise_impl<nChannels,T>::value,decltype(L2sqrdist<nChannels>(a,b))>::type {
+        return L2sqrdist(a,b,nElements,nChannels,m);
+    }
+
     //! computes the squared L2 distance between two generic arrays
     template<typename T>
     static inline auto L2sqrdist(const T* const a, const T* const b, size_t nElements, size_t nChannels, const uchar* m=NULL) -> decltype(L2sqrdist<3>(a,b,nElements,m)) {
@@ -213,7 +258,7 @@ namespace DistanceUtils {
 
     //! computes the L2 distance between two generic arrays
     template<size_t nChannels, typename T>
-    static inline float L2dist(const T* const a, const T* const b, size_t nElements, const uchar* m=NULL) {
+    static inline typename std::enable_if<!has_blockwise_impl<nChannels,T>::value,float>::type L2dist(const T* const a, const T* const b, size_t nElements, const uchar* m=NULL) {
         decltype(L2sqrdist<nChannels>(a,b)) gResult = 0;
         size_t nTotElements = nElements*nChannels;
         if(m) {
@@ -228,6 +273,12 @@ namespace DistanceUtils {
         return sqrt((float)gResult);
     }
 
+    //! computes the L2 distance between two generic arrays (forwarded to the block-wise kernels)
+    template<size_t nChannels, typename T>
+    static inline typename std::enable_if<has_blockwise_impl<nChannels,T>::value,float>::type L2dist(const T* const a, const T* const b, size_t nElements, const uchar* m=NULL) {
+        return L2dist(a,b,nElements,nChannels,m);
+    }
+
     //! computes the squared L2 distance between two generic arrays
     template<typename T>
     static inline float L2dist(const T* const a, const T* const b, size_t nElements, size_t nChannels, const uchar* m=NULL) {
@@ -339,7 +390,7 @@ namespace DistanceUtils {
 
     //! computes the color distortion between two generic arrays
     template<size_t nChannels, typename T>
-    static inline auto cdist(const T* const a, const T* const b, size_t nElements, const uchar* m=NULL) -> decltype(cdist<nChannels>(a,b)) {
+    static inline auto cdist(const T* const a, const T* const b, size_t nElements, const uchar* m=NULL) -> typename std::enable_if<!has_blockwise_impl<nChannels,T>::value,decltype(cdist<nChannels>(a,b))>::type {
         decltype(cdist<nChannels>(a,b)) gResult = 0;
         size_t nTotElements = nElements*nChannels;
         if(m) {
@@ -354,6 +405,12 @@ namespace DistanceUtils {
         return gResult;
     }
 
+    //! computes the color distortion between two generic arrays (forwarded to the block-wise kernels)
+    template<size_t nChannels, typename T>
+    static inline auto cdist(const T* const a, const T* const b, size_t nElements, const uchar* m=NULL) -> typename std::enable_if<has_blockwise_impl<nChannels,T>::value,decltype(cdist<nChannels>(a,b))>::type {
+        return cdist(a,b,nElements,nChannels,m);
+    }
+
     //! computes the color distortion between two generic arrays
     template<typename T>
     static inline auto cdist(const T* const a, const T* const b, size_t nElements, size_t nChannels, const uchar* m=NULL) -> decltype(cdist<3>(a,b,nElements,m)) {
@@ -489,6 +546,15 @@ namespace DistanceUtils {
         return popcount<T>(a^b);
     }
 
+    //! computes the population count of a byte buffer of arbitrary size (runtime-dispatched)
+    size_t popcount(const uchar* anData, size_t nBytes);
+
+    //! computes the hamming distance between two byte buffers of arbitrary size (runtime-dispatched)
+    size_t hdist(const uchar* a, const uchar* b, size_t nBytes);
+
+    //! computes the L1 distance between two unsigned byte arrays of arbitrary size, with all channels summed (runtime-dispatched)
+    size_t L1dist(const uchar* a, const uchar* b, size_t nBytes);
+
     //! computes the gradient magnitude distance between two N-byte vectors
     template<typename T>
     static inline size_t gdist(T a, T b) {
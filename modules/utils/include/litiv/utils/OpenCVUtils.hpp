@@ -40,11 +40,12 @@ namespace cv { // extending cv
     }
 
     //! returns a random init/sampling position for the specified pixel position, given a predefined kernel; also guards against out-of-bounds values via image/border size check.
-    template<int nKernelHeight,int nKernelWidth>
+    //! note: all random positions are drawn using the provided generator (e.g. CxxUtils::FastRNG) to keep results reproducible for a given seed
+    template<int nKernelHeight,int nKernelWidth,typename TRNG>
     static inline void getRandSamplePosition(const std::array<std::array<int,nKernelWidth>,nKernelHeight>& anSamplesInitPattern,
                                              const int nSamplesInitPatternTot,int& nSampleCoord_X,int& nSampleCoord_Y,
-                                             const int nOrigCoord_X,const int nOrigCoord_Y,const int nBorderSize,const cv::Size& oImageSize) {
-        int r = 1+rand()%nSamplesInitPatternTot;
+                                             const int nOrigCoord_X,const int nOrigCoord_Y,const int nBorderSize,const cv::Size& oImageSize,TRNG& oRNG) {
+        int r = 1+(int)(oRNG()%(uint32_t)nSamplesInitPatternTot);
         for(nSampleCoord_X=0; nSampleCoord_X<nKernelWidth; ++nSampleCoord_X) {
             for(nSampleCoord_Y=0; nSampleCoord_Y<nKernelHeight; ++nSampleCoord_Y) {
                 r -= anSamplesInitPattern[nSampleCoord_Y][nSampleCoord_X];
@@ -59,7 +60,8 @@ namespace cv { // extending cv
     }
 
     //! returns a random init/sampling position for the specified pixel position; also guards against out-of-bounds values via image/border size check.
-    static inline void getRandSamplePosition_3x3_std1(int& nSampleCoord_X,int& nSampleCoord_Y,const int nOrigCoord_X,const int nOrigCoord_Y,const int nBorderSize,const cv::Size& oImageSize) {
+    template<typename TRNG>
+    static inline void getRandSamplePosition_3x3_std1(int& nSampleCoord_X,int& nSampleCoord_Y,const int nOrigCoord_X,const int nOrigCoord_Y,const int nBorderSize,const cv::Size& oImageSize,TRNG& oRNG) {
         // based on 'floor(fspecial('gaussian',3,1)*256)'
         static_assert(sizeof(std::array<int,3>)==sizeof(int)*3,"bad std::array stl impl");
         static const int s_nSamplesInitPatternTot = 256;
@@ -68,11 +70,12 @@ namespace cv { // extending cv
                 std::array<int,3>{32,52,32,},
                 std::array<int,3>{19,32,19,},
         };
-        getRandSamplePosition<3,3>(s_anSamplesInitPattern,s_nSamplesInitPatternTot,nSampleCoord_X,nSampleCoord_Y,nOrigCoord_X,nOrigCoord_Y,nBorderSize,oImageSize);
+        getRandSamplePosition<3,3>(s_anSamplesInitPattern,s_nSamplesInitPatternTot,nSampleCoord_X,nSampleCoord_Y,nOrigCoord_X,nOrigCoord_Y,nBorderSize,oImageSize,oRNG);
     }
 
     //! returns a random init/sampling position for the specified pixel position; also guards against out-of-bounds values via image/border size check.
-    static inline void getRandSamplePosition_7x7_std2(int& nSampleCoord_X,int& nSampleCoord_Y,const int nOrigCoord_X,const int nOrigCoord_Y,const int nBorderSize,const cv::Size& oImageSize) {
+    template<typename TRNG>
+    static inline void getRandSamplePosition_7x7_std2(int& nSampleCoord_X,int& nSampleCoord_Y,const int nOrigCoord_X,const int nOrigCoord_Y,const int nBorderSize,const cv::Size& oImageSize,TRNG& oRNG) {
         // based on 'floor(fspecial('gaussian',7,2)*512)'
         static_assert(sizeof(std::array<int,7>)==sizeof(int)*7,"bad std::array stl impl");
         static const int s_nSamplesInitPatternTot = 512;
@@ -85,34 +88,36 @@ namespace cv { // extending cv
                 std::array<int,7>{ 4, 8,12,14,12, 8, 4,},
                 std::array<int,7>{ 2, 4, 6, 7, 6, 4, 2,},
         };
-        getRandSamplePosition<7,7>(s_anSamplesInitPattern,s_nSamplesInitPatternTot,nSampleCoord_X,nSampleCoord_Y,nOrigCoord_X,nOrigCoord_Y,nBorderSize,oImageSize);
+        getRandSamplePosition<7,7>(s_anSamplesInitPattern,s_nSamplesInitPatternTot,nSampleCoord_X,nSampleCoord_Y,nOrigCoord_X,nOrigCoord_Y,nBorderSize,oImageSize,oRNG);
     }
 
     //! returns a random neighbor position for the specified pixel position, given a predefined neighborhood; also guards against out-of-bounds values via image/border size check.
-    template<int nNeighborCount>
+    template<int nNeighborCount,typename TRNG>
     static inline void getRandNeighborPosition(const std::array<std::array<int,2>,nNeighborCount>& anNeighborPattern,
                                                int& nNeighborCoord_X,int& nNeighborCoord_Y,
                                                const int nOrigCoord_X,const int nOrigCoord_Y,
-                                               const int nBorderSize,const cv::Size& oImageSize) {
-        int r = rand()%nNeighborCount;
+                                               const int nBorderSize,const cv::Size& oImageSize,TRNG& oRNG) {
+        int r = (int)(oRNG()%(uint32_t)nNeighborCount);
         nNeighborCoord_X = nOrigCoord_X+anNeighborPattern[r][0];
         nNeighborCoord_Y = nOrigCoord_Y+anNeighborPattern[r][1];
         clampImageCoords(nNeighborCoord_X,nNeighborCoord_Y,nBorderSize,oImageSize);
     }
 
     //! returns a random neighbor position for the specified pixel position; also guards against out-of-bounds values via image/border size check.
-    static inline void getRandNeighborPosition_3x3(int& nNeighborCoord_X,int& nNeighborCoord_Y,const int nOrigCoord_X,const int nOrigCoord_Y,const int nBorderSize,const cv::Size& oImageSize) {
+    template<typename TRNG>
+    static inline void getRandNeighborPosition_3x3(int& nNeighborCoord_X,int& nNeighborCoord_Y,const int nOrigCoord_X,const int nOrigCoord_Y,const int nBorderSize,const cv::Size& oImageSize,TRNG& oRNG) {
         typedef std::array<int,2> Nb;
         static const std::array<std::array<int,2>,8> s_anNeighborPattern ={
                 Nb{-1, 1},Nb{0, 1},Nb{1, 1},
                 Nb{-1, 0},         Nb{1, 0},
                 Nb{-1,-1},Nb{0,-1},Nb{1,-1},
         };
-        getRandNeighborPosition<8>(s_anNeighborPattern,nNeighborCoord_X,nNeighborCoord_Y,nOrigCoord_X,nOrigCoord_Y,nBorderSize,oImageSize);
+        getRandNeighborPosition<8>(s_anNeighborPattern,nNeighborCoord_X,nNeighborCoord_Y,nOrigCoord_X,nOrigCoord_Y,nBorderSize,oImageSize,oRNG);
     }
 
     //! returns a random neighbor position for the specified pixel position; also guards against out-of-bounds values via image/border size check.
-    static inline void getRandNeighborPosition_5x5(int& nNeighborCoord_X,int& nNeighborCoord_Y,const int nOrigCoord_X,const int nOrigCoord_Y,const int nBorderSize,const cv::Size& oImageSize) {
+    template<typename TRNG>
+    static inline void getRandNeighborPosition_5x5(int& nNeighborCoord_X,int& nNeighborCoord_Y,const int nOrigCoord_X,const int nOrigCoord_Y,const int nBorderSize,const cv::Size& oImageSize,TRNG& oRNG) {
         typedef std::array<int,2> Nb;
         static const std::array<std::array<int,2>,24> s_anNeighborPattern ={
                 Nb{-2, 2},Nb{-1, 2},Nb{0, 2},Nb{1, 2},Nb{2, 2},
@@ -121,7 +126,7 @@ namespace cv { // extending cv
                 Nb{-2,-1},Nb{-1,-1},Nb{0,-1},Nb{1,-1},Nb{2,-1},
                 Nb{-2,-2},Nb{-1,-2},Nb{0,-2},Nb{1,-2},Nb{2,-2},
         };
-        getRandNeighborPosition<24>(s_anNeighborPattern,nNeighborCoord_X,nNeighborCoord_Y,nOrigCoord_X,nOrigCoord_Y,nBorderSize,oImageSize);
+        getRandNeighborPosition<24>(s_anNeighborPattern,nNeighborCoord_X,nNeighborCoord_Y,nOrigCoord_X,nOrigCoord_Y,nBorderSize,oImageSize,oRNG);
     }
 
     //! writes a given text string on an image using the original cv::putText (this function only acts as a simplification wrapper)
@@ -142,6 +147,31 @@ namespace cv { // extending cv
         voKPs = voNewKPs;
     }
 
+    //! binary median filter for CV_8UC1 masks based on bit-packed rows & popcounts (cost per pixel does not depend on the kernel size)
+    struct BinaryMedianBlur {
+        //! default constructor; buffers are allocated on the first 'reset' call
+        BinaryMedianBlur() : m_nCols(0), m_nRows(0), m_nKernelSize(0), m_nPushedRows(0), m_nPoppedRows(0) {}
+        //! drop-in replacement for cv::medianBlur on 0/255 masks (non-zero values are considered foreground, borders are replicated, and in-place filtering is allowed)
+        void apply(const cv::Mat& oSrc, cv::Mat& oDst, int nKernelSize);
+        //! streaming interface: prepares the filter for a new image of the given size (kernel size must be odd and smaller than 64)
+        void reset(const cv::Size& oSize, int nKernelSize);
+        //! streaming interface: pushes the next input row (each available output row must be popped before pushing more rows)
+        void pushRow(const uchar* pSrcRow);
+        //! streaming interface: writes the next output row if all input rows it depends on were pushed, and returns whether it did
+        bool popRow(uchar* pDstRow);
+    protected:
+        //! image size & kernel size used for the latest reset
+        int m_nCols, m_nRows, m_nKernelSize;
+        //! number of input rows pushed/output rows popped since the latest reset
+        int m_nPushedRows, m_nPoppedRows;
+        //! bit-packed version of the latest pushed row (with replicated borders)
+        std::vector<uint64_t> m_vnPackedRow;
+        //! ring buffer of per-pixel horizontal window counts for the latest kernel size+1 pushed rows
+        std::vector<uchar> m_vnRowCounts;
+        //! per-pixel vertical sums of horizontal window counts for the latest popped row
+        std::vector<int> m_vnWindowCounts;
+    };
+
     //! helper struct for image display & callback management (must be created via DisplayHelper::create due to enable_shared_from_this interface)
     struct DisplayHelper : public CxxUtils::enable_shared_from_this<DisplayHelper> {
 
@@ -43,6 +43,19 @@
 #error "Bad default number of threads specified."
 #endif //DEFAULT_NB_THREADS<1
 
+// runtime SIMD dispatch is only available on x86 targets; kernels for each instruction set are compiled via function-level
+// target attributes (so the baseline build flags do not matter), and are selected once at runtime via cpuid
+#if HAVE_SIMD_SUPPORT && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#define HAVE_SIMD_DISPATCH 1
+#if defined(_MSC_VER)
+#define SIMD_TARGET_ATTRIB(sTarget)
+#else //(!defined(_MSC_VER))
+#define SIMD_TARGET_ATTRIB(sTarget) __attribute__((target(sTarget)))
+#endif //(!defined(_MSC_VER))
+#else //(!HAVE_SIMD_SUPPORT || !x86)
+#define HAVE_SIMD_DISPATCH 0
+#endif //(!HAVE_SIMD_SUPPORT || !x86)
+
 namespace ParallelUtils {
 
     enum eParallelAlgoType {
@@ -110,6 +123,39 @@ namespace ParallelUtils {
     };
     using NonParallelAlgo = IParallelAlgo_<eNonParallel>;
 
+    //! runtime SIMD levels used to select dispatched kernels (each level implies all the previous ones)
+    enum eSIMDLevel {
+        eSIMD_Scalar, //!< no vector instructions
+        eSIMD_SSE2, //!< SSE2
+        eSIMD_SSE4_1, //!< SSE4.1 + POPCNT
+        eSIMD_AVX2, //!< AVX2 + FMA3 (with OS support for YMM state)
+        eSIMD_AVX512, //!< AVX-512 F + BW (with OS support for ZMM state)
+    };
+    //! returns the highest SIMD level supported by both the host CPU and this build (detected once via cpuid, thread-safe)
+    eSIMDLevel getSIMDLevel();
+    //! returns the display name of the given SIMD level
+    const char* getSIMDLevelName(eSIMDLevel eLevel);
+    //! registers the SIMD level selected for a dispatched kernel, so that it appears in the dispatch report (thread-safe)
+    void registerDispatchedKernel(const std::string& sKernelName, eSIMDLevel eKernelLevel);
+    //! returns a multi-line report of the detected SIMD level and of the kernels selected so far (most register at startup)
+    std::string getDispatchReport();
+    //! returns the first kernel of the given (level,kernel) list, sorted by decreasing level, that the runtime SIMD level supports (the last one is the fallback), and registers it
+    template<typename TFunc>
+    inline TFunc selectDispatchedKernel(const std::string& sKernelName, std::initializer_list<std::pair<eSIMDLevel,TFunc>> lCandidates) {
+        CV_Assert(lCandidates.size()>0);
+        const eSIMDLevel eLevel = getSIMDLevel();
+        auto pCandidate = lCandidates.begin();
+        while(pCandidate->first>eLevel && pCandidate+1!=lCandidates.end())
+            ++pCandidate;
+        registerDispatchedKernel(sKernelName,pCandidate->first);
+        return pCandidate->second;
+    }
+
+    //! returns the sum of the provided unsigned byte array (runtime-dispatched)
+    size_t hsum_ub(const uchar* anData, size_t nCount);
+    //! returns the maximum value of the provided unsigned byte array, or zero if it is empty (runtime-dispatched)
+    uchar hmax_ub(const uchar* anData, size_t nCount);
+
 #if HAVE_SIMD_SUPPORT
 
 #if HAVE_MMX
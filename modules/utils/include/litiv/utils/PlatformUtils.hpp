@@ -59,6 +59,8 @@ void SafeRelease(T **ppT) {if(*ppT) {(*ppT)->Release();*ppT = nullptr;}}
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/resource.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <stdio.h>
 #endif //(!defined(_MSC_VER))
 
@@ -232,13 +234,14 @@ namespace PlatformUtils {
         return vfResult;
     }
 
-    template<size_t nWorkers>
-    struct WorkerPool {
-        static_assert(nWorkers>0,"Worker pool must have at least one work thread");
-        WorkerPool() : m_bIsActive(true) {
-            CxxUtils::unroll<nWorkers>([this](size_t){m_vhWorkers.emplace_back(std::bind(&WorkerPool::entry,this));});
+    //! thread pool with a number of workers fixed at construction time; tasks are executed in the order they are queued
+    struct DynamicWorkerPool {
+        explicit DynamicWorkerPool(size_t nWorkers) : m_bIsActive(true) {
+            CV_Assert(nWorkers>0);
+            for(size_t nWorkerIdx=0; nWorkerIdx<nWorkers; ++nWorkerIdx)
+                m_vhWorkers.emplace_back(std::bind(&DynamicWorkerPool::entry,this));
         }
-        ~WorkerPool() {
+        ~DynamicWorkerPool() {
             m_bIsActive = false;
             m_oSyncVar.notify_all();
             for(std::thread& oWorker : m_vhWorkers)
@@ -258,6 +261,10 @@ namespace PlatformUtils {
             m_oSyncVar.notify_one();
             return oTaskRes;
         }
+        //! returns the number of worker threads owned by this pool
+        size_t getWorkerCount() const {
+            return m_vhWorkers.size();
+        }
     protected:
         std::queue<std::function<void()>> m_qTasks;
         std::vector<std::thread> m_vhWorkers;
@@ -278,8 +285,38 @@ namespace PlatformUtils {
                 }
             }
         }
-        WorkerPool(const WorkerPool&) = delete;
-        WorkerPool& operator=(const WorkerPool&) = delete;
+        DynamicWorkerPool(const DynamicWorkerPool&) = delete;
+        DynamicWorkerPool& operator=(const DynamicWorkerPool&) = delete;
+    };
+
+    template<size_t nWorkers>
+    struct WorkerPool : public DynamicWorkerPool {
+        static_assert(nWorkers>0,"Worker pool must have at least one work thread");
+        WorkerPool() : DynamicWorkerPool(nWorkers) {}
+    };
+
+    //! private memory mapping of a whole file; the mapped data stays valid for the lifetime of the object, and pages are copy-on-write (writes
+    //! through a const-casted pointer, e.g. by in-place ops on a matrix wrapping the data, stay private to the process and never reach the file)
+    struct MappedFile {
+        //! maps the given file in memory (throws if the file cannot be opened or mapped)
+        explicit MappedFile(const std::string& sFilePath);
+        //! unmaps the file
+        ~MappedFile();
+        //! returns a pointer to the beginning of the file data
+        const uchar* data() const {return m_pData;}
+        //! returns the size of the mapped file, in bytes
+        size_t size() const {return m_nSize;}
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+    protected:
+        const uchar* m_pData;
+        size_t m_nSize;
+#if defined(_MSC_VER)
+        HANDLE m_hFile;
+        HANDLE m_hMapping;
+#else //(!defined(_MSC_VER))
+        int m_nFileDesc;
+#endif //(!defined(_MSC_VER))
     };
 
 #if USE_KINECTSDK_STANDALONE
@@ -0,0 +1,664 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "litiv/utils/DistanceUtils.hpp"
+#include <cstring>
+#include <algorithm>
+
+template<bool bXOR>
+static size_t popcount_Scalar(const uchar* a, const uchar* b, size_t nBytes) {
+    size_t nResult = 0, n = 0;
+    for(; n+8<=nBytes; n+=8) {
+        uint64_t nChunkA, nChunkB = 0;
+        memcpy(&nChunkA,a+n,8);
+        if(bXOR)
+            memcpy(&nChunkB,b+n,8);
+        nResult += DistanceUtils::popcount(uint64_t(nChunkA^nChunkB));
+    }
+    for(; n<nBytes; ++n)
+        nResult += DistanceUtils::popcount_LUT8[bXOR?uchar(a[n]^b[n]):a[n]];
+    return nResult;
+}
+
+template<typename T>
+static auto L1dist_Scalar(const T* a, const T* b, size_t nValues) -> decltype(DistanceUtils::L1dist(*a,*b)) {
+    decltype(DistanceUtils::L1dist(*a,*b)) tResult = 0;
+    for(size_t n=0; n<nValues; ++n)
+        tResult += DistanceUtils::L1dist(a[n],b[n]);
+    return tResult;
+}
+
+template<typename T>
+static auto L2sqrdist_Scalar(const T* a, const T* b, size_t nValues) -> decltype(DistanceUtils::L2sqrdist(*a,*b)) {
+    decltype(DistanceUtils::L2sqrdist(*a,*b)) tResult = 0;
+    for(size_t n=0; n<nValues; ++n)
+        tResult += DistanceUtils::L2sqrdist(a[n],b[n]);
+    return tResult;
+}
+
+template<size_t nChannels, typename T>
+static auto cdist_Scalar(const T* a, const T* b, size_t nValues) -> decltype(DistanceUtils::cdist<nChannels>(a,b)) {
+    decltype(DistanceUtils::cdist<nChannels>(a,b)) tResult = 0;
+    for(size_t n=0; n<nValues; n+=nChannels)
+        tResult += DistanceUtils::cdist<nChannels>(a+n,b+n);
+    return tResult;
+}
+
+#if HAVE_SIMD_DISPATCH
+
+template<bool bXOR>
+SIMD_TARGET_ATTRIB("popcnt") static size_t popcount_POPCNT(const uchar* a, const uchar* b, size_t nBytes) {
+    size_t nResult = 0, n = 0;
+#if defined(__x86_64__) || defined(_M_X64)
+    for(; n+8<=nBytes; n+=8) {
+        uint64_t nChunkA, nChunkB = 0;
+        memcpy(&nChunkA,a+n,8);
+        if(bXOR)
+            memcpy(&nChunkB,b+n,8);
+        nResult += (size_t)_mm_popcnt_u64(nChunkA^nChunkB);
+    }
+#endif //defined(__x86_64__) || defined(_M_X64)
+    for(; n+4<=nBytes; n+=4) {
+        uint32_t nChunkA, nChunkB = 0;
+        memcpy(&nChunkA,a+n,4);
+        if(bXOR)
+            memcpy(&nChunkB,b+n,4);
+        nResult += (size_t)_mm_popcnt_u32(nChunkA^nChunkB);
+    }
+    for(; n<nBytes; ++n)
+        nResult += DistanceUtils::popcount_LUT8[bXOR?uchar(a[n]^b[n]):a[n]];
+    return nResult;
+}
+
+// popcounts use a nibble LUT via byte shuffles, with per-byte counts horizontally summed via SAD (no overflow possible)
+template<bool bXOR>
+SIMD_TARGET_ATTRIB("avx2,popcnt") static size_t popcount_AVX2(const uchar* a, const uchar* b, size_t nBytes) {
+    const __m256i _anNibbleLUT = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+    const __m256i _anLowNibbleMask = _mm256_set1_epi8(0x0F);
+    __m256i _anSums = _mm256_setzero_si256();
+    size_t n = 0;
+    for(; n+32<=nBytes; n+=32) {
+        __m256i _anVals = _mm256_loadu_si256((const __m256i*)(a+n));
+        if(bXOR)
+            _anVals = _mm256_xor_si256(_anVals,_mm256_loadu_si256((const __m256i*)(b+n)));
+        const __m256i _anLowCounts = _mm256_shuffle_epi8(_anNibbleLUT,_mm256_and_si256(_anVals,_anLowNibbleMask));
+        const __m256i _anHighCounts = _mm256_shuffle_epi8(_anNibbleLUT,_mm256_and_si256(_mm256_srli_epi16(_anVals,4),_anLowNibbleMask));
+        _anSums = _mm256_add_epi64(_anSums,_mm256_sad_epu8(_mm256_add_epi8(_anLowCounts,_anHighCounts),_mm256_setzero_si256()));
+    }
+    alignas(32) uint64_t anSums[4];
+    _mm256_store_si256((__m256i*)anSums,_anSums);
+    return size_t(anSums[0]+anSums[1]+anSums[2]+anSums[3])+popcount_POPCNT<bXOR>(a+n,bXOR?b+n:b,nBytes-n);
+}
+
+template<bool bXOR>
+SIMD_TARGET_ATTRIB("avx512f,avx512bw,avx2,popcnt") static size_t popcount_AVX512(const uchar* a, const uchar* b, size_t nBytes) {
+    const __m512i _anNibbleLUT = _mm512_set4_epi32(0x04030302,0x03020201,0x03020201,0x02010100); // same LUT, packed as 32-bit words
+    const __m512i _anLowNibbleMask = _mm512_set1_epi8(0x0F);
+    __m512i _anSums = _mm512_setzero_si512();
+    size_t n = 0;
+    for(; n+64<=nBytes; n+=64) {
+        __m512i _anVals = _mm512_loadu_si512((const void*)(a+n));
+        if(bXOR)
+            _anVals = _mm512_xor_si512(_anVals,_mm512_loadu_si512((const void*)(b+n)));
+        const __m512i _anLowCounts = _mm512_shuffle_epi8(_anNibbleLUT,_mm512_and_si512(_anVals,_anLowNibbleMask));
+        const __m512i _anHighCounts = _mm512_shuffle_epi8(_anNibbleLUT,_mm512_and_si512(_mm512_srli_epi16(_anVals,4),_anLowNibbleMask));
+        _anSums = _mm512_add_epi64(_anSums,_mm512_sad_epu8(_mm512_add_epi8(_anLowCounts,_anHighCounts),_mm512_setzero_si512()));
+    }
+    alignas(64) uint64_t anSums[8];
+    _mm512_store_si512((void*)anSums,_anSums);
+    uint64_t nResult = 0;
+    for(size_t nLane=0; nLane<8; ++nLane)
+        nResult += anSums[nLane];
+    return size_t(nResult)+popcount_AVX2<bXOR>(a+n,bXOR?b+n:b,nBytes-n);
+}
+
+SIMD_TARGET_ATTRIB("sse2") static size_t L1dist_8u_SSE2(const uchar* a, const uchar* b, size_t nBytes) {
+    __m128i _anSums = _mm_setzero_si128();
+    size_t n = 0;
+    for(; n+16<=nBytes; n+=16)
+        _anSums = _mm_add_epi64(_anSums,_mm_sad_epu8(_mm_loadu_si128((const __m128i*)(a+n)),_mm_loadu_si128((const __m128i*)(b+n))));
+    alignas(16) uint64_t anSums[2];
+    _mm_store_si128((__m128i*)anSums,_anSums);
+    return size_t(anSums[0]+anSums[1])+L1dist_Scalar(a+n,b+n,nBytes-n);
+}
+
+SIMD_TARGET_ATTRIB("avx2") static size_t L1dist_8u_AVX2(const uchar* a, const uchar* b, size_t nBytes) {
+    __m256i _anSums = _mm256_setzero_si256();
+    size_t n = 0;
+    for(; n+32<=nBytes; n+=32)
+        _anSums = _mm256_add_epi64(_anSums,_mm256_sad_epu8(_mm256_loadu_si256((const __m256i*)(a+n)),_mm256_loadu_si256((const __m256i*)(b+n))));
+    alignas(32) uint64_t anSums[4];
+    _mm256_store_si256((__m256i*)anSums,_anSums);
+    return size_t(anSums[0]+anSums[1]+anSums[2]+anSums[3])+L1dist_8u_SSE2(a+n,b+n,nBytes-n);
+}
+
+SIMD_TARGET_ATTRIB("avx512f,avx512bw,avx2") static size_t L1dist_8u_AVX512(const uchar* a, const uchar* b, size_t nBytes) {
+    __m512i _anSums = _mm512_setzero_si512();
+    size_t n = 0;
+    for(; n+64<=nBytes; n+=64)
+        _anSums = _mm512_add_epi64(_anSums,_mm512_sad_epu8(_mm512_loadu_si512((const void*)(a+n)),_mm512_loadu_si512((const void*)(b+n))));
+    alignas(64) uint64_t anSums[8];
+    _mm512_store_si512((void*)anSums,_anSums);
+    uint64_t nResult = 0;
+    for(size_t nLane=0; nLane<8; ++nLane)
+        nResult += anSums[nLane];
+    return size_t(nResult)+L1dist_8u_AVX2(a+n,b+n,nBytes-n);
+}
+
+// 16-bit L1 and 8-bit L2 kernels accumulate into 32-bit lanes, which are flushed into 64-bit sums before they can overflow
+// (each lane receives at most 2x(2^16-1) per L1 iteration, and 4x(2^8-1)^2 per L2 iteration)
+static constexpr size_t s_nMaxChunkIters_L1dist16u = size_t(1)<<14;
+static constexpr size_t s_nMaxChunkIters_L2sqrdist8u = size_t(1)<<13;
+
+SIMD_TARGET_ATTRIB("sse2") static size_t L1dist_16u_SSE2(const ushort* a, const ushort* b, size_t nValues) {
+    const __m128i _anZero = _mm_setzero_si128();
+    const size_t nVecValues = nValues&~size_t(7);
+    __m128i _anSums = _anZero;
+    size_t n = 0;
+    while(n<nVecValues) {
+        const size_t nChunkEnd = std::min(nVecValues,n+s_nMaxChunkIters_L1dist16u*8);
+        __m128i _anChunkSums = _anZero;
+        for(; n<nChunkEnd; n+=8) {
+            const __m128i _anA = _mm_loadu_si128((const __m128i*)(a+n)), _anB = _mm_loadu_si128((const __m128i*)(b+n));
+            const __m128i _anDiffs = _mm_or_si128(_mm_subs_epu16(_anA,_anB),_mm_subs_epu16(_anB,_anA));
+            _anChunkSums = _mm_add_epi32(_anChunkSums,_mm_add_epi32(_mm_unpacklo_epi16(_anDiffs,_anZero),_mm_unpackhi_epi16(_anDiffs,_anZero)));
+        }
+        _anSums = _mm_add_epi64(_anSums,_mm_add_epi64(_mm_unpacklo_epi32(_anChunkSums,_anZero),_mm_unpackhi_epi32(_anChunkSums,_anZero)));
+    }
+    alignas(16) uint64_t anSums[2];
+    _mm_store_si128((__m128i*)anSums,_anSums);
+    return size_t(anSums[0]+anSums[1])+L1dist_Scalar(a+n,b+n,nValues-n);
+}
+
+SIMD_TARGET_ATTRIB("avx2") static size_t L1dist_16u_AVX2(const ushort* a, const ushort* b, size_t nValues) {
+    const __m256i _anZero = _mm256_setzero_si256();
+    const size_t nVecValues = nValues&~size_t(15);
+    __m256i _anSums = _anZero;
+    size_t n = 0;
+    while(n<nVecValues) {
+        const size_t nChunkEnd = std::min(nVecValues,n+s_nMaxChunkIters_L1dist16u*16);
+        __m256i _anChunkSums = _anZero;
+        for(; n<nChunkEnd; n+=16) {
+            const __m256i _anA = _mm256_loadu_si256((const __m256i*)(a+n)), _anB = _mm256_loadu_si256((const __m256i*)(b+n));
+            const __m256i _anDiffs = _mm256_or_si256(_mm256_subs_epu16(_anA,_anB),_mm256_subs_epu16(_anB,_anA));
+            _anChunkSums = _mm256_add_epi32(_anChunkSums,_mm256_add_epi32(_mm256_unpacklo_epi16(_anDiffs,_anZero),_mm256_unpackhi_epi16(_anDiffs,_anZero)));
+        }
+        _anSums = _mm256_add_epi64(_anSums,_mm256_add_epi64(_mm256_unpacklo_epi32(_anChunkSums,_anZero),_mm256_unpackhi_epi32(_anChunkSums,_anZero)));
+    }
+    alignas(32) uint64_t anSums[4];
+    _mm256_store_si256((__m256i*)anSums,_anSums);
+    return size_t(anSums[0]+anSums[1]+anSums[2]+anSums[3])+L1dist_16u_SSE2(a+n,b+n,nValues-n);
+}
+
+SIMD_TARGET_ATTRIB("avx512f,avx512bw,avx2") static size_t L1dist_16u_AVX512(const ushort* a, const ushort* b, size_t nValues) {
+    const __m512i _anZero = _mm512_setzero_si512();
+    const size_t nVecValues = nValues&~size_t(31);
+    uint64_t nResult = 0;
+    size_t n = 0;
+    while(n<nVecValues) {
+        const size_t nChunkEnd = std::min(nVecValues,n+s_nMaxChunkIters_L1dist16u*32);
+        __m512i _anChunkSums = _anZero;
+        for(; n<nChunkEnd; n+=32) {
+            const __m512i _anA = _mm512_loadu_si512((const void*)(a+n)), _anB = _mm512_loadu_si512((const void*)(b+n));
+            const __m512i _anDiffs = _mm512_or_si512(_mm512_subs_epu16(_anA,_anB),_mm512_subs_epu16(_anB,_anA));
+            _anChunkSums = _mm512_add_epi32(_anChunkSums,_mm512_add_epi32(_mm512_unpacklo_epi16(_anDiffs,_anZero),_mm512_unpackhi_epi16(_anDiffs,_anZero)));
+        }
+        alignas(64) uint32_t anChunkSums[16];
+        _mm512_store_si512((void*)anChunkSums,_anChunkSums);
+        for(size_t nLane=0; nLane<16; ++nLane)
+            nResult += anChunkSums[nLane];
+    }
+    return size_t(nResult)+L1dist_16u_AVX2(a+n,b+n,nValues-n);
+}
+
+// float kernels use two independent accumulators to hide the add/FMA latency
+SIMD_TARGET_ATTRIB("sse2") static float L1dist_32f_SSE2(const float* a, const float* b, size_t nValues) {
+    const __m128 _afSignMask = _mm_set1_ps(-0.0f);
+    __m128 _afSums0 = _mm_setzero_ps(), _afSums1 = _mm_setzero_ps();
+    size_t n = 0;
+    for(; n+8<=nValues; n+=8) {
+        _afSums0 = _mm_add_ps(_afSums0,_mm_andnot_ps(_afSignMask,_mm_sub_ps(_mm_loadu_ps(a+n),_mm_loadu_ps(b+n))));
+        _afSums1 = _mm_add_ps(_afSums1,_mm_andnot_ps(_afSignMask,_mm_sub_ps(_mm_loadu_ps(a+n+4),_mm_loadu_ps(b+n+4))));
+    }
+    alignas(16) float afSums[4];
+    _mm_store_ps(afSums,_mm_add_ps(_afSums0,_afSums1));
+    return (afSums[0]+afSums[1])+(afSums[2]+afSums[3])+L1dist_Scalar(a+n,b+n,nValues-n);
+}
+
+SIMD_TARGET_ATTRIB("avx2") static float L1dist_32f_AVX2(const float* a, const float* b, size_t nValues) {
+    const __m256 _afSignMask = _mm256_set1_ps(-0.0f);
+    __m256 _afSums0 = _mm256_setzero_ps(), _afSums1 = _mm256_setzero_ps();
+    size_t n = 0;
+    for(; n+16<=nValues; n+=16) {
+        _afSums0 = _mm256_add_ps(_afSums0,_mm256_andnot_ps(_afSignMask,_mm256_sub_ps(_mm256_loadu_ps(a+n),_mm256_loadu_ps(b+n))));
+        _afSums1 = _mm256_add_ps(_afSums1,_mm256_andnot_ps(_afSignMask,_mm256_sub_ps(_mm256_loadu_ps(a+n+8),_mm256_loadu_ps(b+n+8))));
+    }
+    alignas(32) float afSums[8];
+    _mm256_store_ps(afSums,_mm256_add_ps(_afSums0,_afSums1));
+    return ((afSums[0]+afSums[1])+(afSums[2]+afSums[3]))+((afSums[4]+afSums[5])+(afSums[6]+afSums[7]))+L1dist_32f_SSE2(a+n,b+n,nValues-n);
+}
+
+SIMD_TARGET_ATTRIB("avx512f,avx512bw,avx2") static float L1dist_32f_AVX512(const float* a, const float* b, size_t nValues) {
+    const __m512i _anAbsMask = _mm512_set1_epi32(0x7FFFFFFF);
+    __m512 _afSums0 = _mm512_setzero_ps(), _afSums1 = _mm512_setzero_ps();
+    size_t n = 0;
+    for(; n+32<=nValues; n+=32) {
+        _afSums0 = _mm512_add_ps(_afSums0,_mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(_mm512_sub_ps(_mm512_loadu_ps(a+n),_mm512_loadu_ps(b+n))),_anAbsMask)));
+        _afSums1 = _mm512_add_ps(_afSums1,_mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(_mm512_sub_ps(_mm512_loadu_ps(a+n+16),_mm512_loadu_ps(b+n+16))),_anAbsMask)));
+    }
+    alignas(64) float afSums[16];
+    _mm512_store_ps(afSums,_mm512_add_ps(_afSums0,_afSums1));
+    float fResult = 0.0f;
+    for(size_t nLane=0; nLane<16; ++nLane)
+        fResult += afSums[nLane];
+    return fResult+L1dist_32f_AVX2(a+n,b+n,nValues-n);
+}
+
+// 8-bit absolute differences are widened to 16 bits and squared+paired via madd (no sign issues, as diffs stay below 2^8)
+SIMD_TARGET_ATTRIB("sse2") static size_t L2sqrdist_8u_SSE2(const uchar* a, const uchar* b, size_t nValues) {
+    const __m128i _anZero = _mm_setzero_si128();
+    const size_t nVecValues = nValues&~size_t(15);
+    __m128i _anSums = _anZero;
+    size_t n = 0;
+    while(n<nVecValues) {
+        const size_t nChunkEnd = std::min(nVecValues,n+s_nMaxChunkIters_L2sqrdist8u*16);
+        __m128i _anChunkSums = _anZero;
+        for(; n<nChunkEnd; n+=16) {
+            const __m128i _anA = _mm_loadu_si128((const __m128i*)(a+n)), _anB = _mm_loadu_si128((const __m128i*)(b+n));
+            const __m128i _anDiffs = _mm_or_si128(_mm_subs_epu8(_anA,_anB),_mm_subs_epu8(_anB,_anA));
+            const __m128i _anDiffsLo = _mm_unpacklo_epi8(_anDiffs,_anZero), _anDiffsHi = _mm_unpackhi_epi8(_anDiffs,_anZero);
+            _anChunkSums = _mm_add_epi32(_anChunkSums,_mm_add_epi32(_mm_madd_epi16(_anDiffsLo,_anDiffsLo),_mm_madd_epi16(_anDiffsHi,_anDiffsHi)));
+        }
+        _anSums = _mm_add_epi64(_anSums,_mm_add_epi64(_mm_unpacklo_epi32(_anChunkSums,_anZero),_mm_unpackhi_epi32(_anChunkSums,_anZero)));
+    }
+    alignas(16) uint64_t anSums[2];
+    _mm_store_si128((__m128i*)anSums,_anSums);
+    return size_t(anSums[0]+anSums[1])+L2sqrdist_Scalar(a+n,b+n,nValues-n);
+}
+
+SIMD_TARGET_ATTRIB("avx2") static size_t L2sqrdist_8u_AVX2(const uchar* a, const uchar* b, size_t nValues) {
+    const __m256i _anZero = _mm256_setzero_si256();
+    const size_t nVecValues = nValues&~size_t(31);
+    __m256i _anSums = _anZero;
+    size_t n = 0;
+    while(n<nVecValues) {
+        const size_t nChunkEnd = std::min(nVecValues,n+s_nMaxChunkIters_L2sqrdist8u*32);
+        __m256i _anChunkSums = _anZero;
+        for(; n<nChunkEnd; n+=32) {
+            const __m256i _anA = _mm256_loadu_si256((const __m256i*)(a+n)), _anB = _mm256_loadu_si256((const __m256i*)(b+n));
+            const __m256i _anDiffs = _mm256_or_si256(_mm256_subs_epu8(_anA,_anB),_mm256_subs_epu8(_anB,_anA));
+            const __m256i _anDiffsLo = _mm256_unpacklo_epi8(_anDiffs,_anZero), _anDiffsHi = _mm256_unpackhi_epi8(_anDiffs,_anZero);
+            _anChunkSums = _mm256_add_epi32(_anChunkSums,_mm256_add_epi32(_mm256_madd_epi16(_anDiffsLo,_anDiffsLo),_mm256_madd_epi16(_anDiffsHi,_anDiffsHi)));
+        }
+        _anSums = _mm256_add_epi64(_anSums,_mm256_add_epi64(_mm256_unpacklo_epi32(_anChunkSums,_anZero),_mm256_unpackhi_epi32(_anChunkSums,_anZero)));
+    }
+    alignas(32) uint64_t anSums[4];
+    _mm256_store_si256((__m256i*)anSums,_anSums);
+    return size_t(anSums[0]+anSums[1]+anSums[2]+anSums[3])+L2sqrdist_8u_SSE2(a+n,b+n,nValues-n);
+}
+
+SIMD_TARGET_ATTRIB("avx512f,avx512bw,avx2") static size_t L2sqrdist_8u_AVX512(const uchar* a, const uchar* b, size_t nValues) {
+    const __m512i _anZero = _mm512_setzero_si512();
+    const size_t nVecValues = nValues&~size_t(63);
+    uint64_t nResult = 0;
+    size_t n = 0;
+    while(n<nVecValues) {
+        const size_t nChunkEnd = std::min(nVecValues,n+s_nMaxChunkIters_L2sqrdist8u*64);
+        __m512i _anChunkSums = _anZero;
+        for(; n<nChunkEnd; n+=64) {
+            const __m512i _anA = _mm512_loadu_si512((const void*)(a+n)), _anB = _mm512_loadu_si512((const void*)(b+n));
+            const __m512i _anDiffs = _mm512_or_si512(_mm512_subs_epu8(_anA,_anB),_mm512_subs_epu8(_anB,_anA));
+            const __m512i _anDiffsLo = _mm512_unpacklo_epi8(_anDiffs,_anZero), _anDiffsHi = _mm512_unpackhi_epi8(_anDiffs,_anZero);
+            _anChunkSums = _mm512_add_epi32(_anChunkSums,_mm512_add_epi32(_mm512_madd_epi16(_anDiffsLo,_anDiffsLo),_mm512_madd_epi16(_anDiffsHi,_anDiffsHi)));
+        }
+        alignas(64) uint32_t anChunkSums[16];
+        _mm512_store_si512((void*)anChunkSums,_anChunkSums);
+        for(size_t nLane=0; nLane<16; ++nLane)
+            nResult += anChunkSums[nLane];
+    }
+    return size_t(nResult)+L2sqrdist_8u_AVX2(a+n,b+n,nValues-n);
+}
+
+// 16-bit squared differences can reach 2^32, so they are computed directly as 64-bit products (even/odd 32-bit lanes)
+SIMD_TARGET_ATTRIB("sse2") static size_t L2sqrdist_16u_SSE2(const ushort* a, const ushort* b, size_t nValues) {
+    const __m128i _anZero = _mm_setzero_si128();
+    __m128i _anSums = _anZero;
+    size_t n = 0;
+    for(; n+8<=nValues; n+=8) {
+        const __m128i _anA = _mm_loadu_si128((const __m128i*)(a+n)), _anB = _mm_loadu_si128((const __m128i*)(b+n));
+        const __m128i _anDiffs = _mm_or_si128(_mm_subs_epu16(_anA,_anB),_mm_subs_epu16(_anB,_anA));
+        const __m128i _anDiffsLo = _mm_unpacklo_epi16(_anDiffs,_anZero), _anDiffsHi = _mm_unpackhi_epi16(_anDiffs,_anZero);
+        const __m128i _anDiffsLoOdd = _mm_srli_epi64(_anDiffsLo,32), _anDiffsHiOdd = _mm_srli_epi64(_anDiffsHi,32);
+        _anSums = _mm_add_epi64(_anSums,_mm_add_epi64(_mm_mul_epu32(_anDiffsLo,_anDiffsLo),_mm_mul_epu32(_anDiffsLoOdd,_anDiffsLoOdd)));
+        _anSums = _mm_add_epi64(_anSums,_mm_add_epi64(_mm_mul_epu32(_anDiffsHi,_anDiffsHi),_mm_mul_epu32(_anDiffsHiOdd,_anDiffsHiOdd)));
+    }
+    alignas(16) uint64_t anSums[2];
+    _mm_store_si128((__m128i*)anSums,_anSums);
+    return size_t(anSums[0]+anSums[1])+L2sqrdist_Scalar(a+n,b+n,nValues-n);
+}
+
+SIMD_TARGET_ATTRIB("avx2") static size_t L2sqrdist_16u_AVX2(const ushort* a, const ushort* b, size_t nValues) {
+    const __m256i _anZero = _mm256_setzero_si256();
+    __m256i _anSums = _anZero;
+    size_t n = 0;
+    for(; n+16<=nValues; n+=16) {
+        const __m256i _anA = _mm256_loadu_si256((const __m256i*)(a+n)), _anB = _mm256_loadu_si256((const __m256i*)(b+n));
+        const __m256i _anDiffs = _mm256_or_si256(_mm256_subs_epu16(_anA,_anB),_mm256_subs_epu16(_anB,_anA));
+        const __m256i _anDiffsLo = _mm256_unpacklo_epi16(_anDiffs,_anZero), _anDiffsHi = _mm256_unpackhi_epi16(_anDiffs,_anZero);
+        const __m256i _anDiffsLoOdd = _mm256_srli_epi64(_anDiffsLo,32), _anDiffsHiOdd = _mm256_srli_epi64(_anDiffsHi,32);
+        _anSums = _mm256_add_epi64(_anSums,_mm256_add_epi64(_mm256_mul_epu32(_anDiffsLo,_anDiffsLo),_mm256_mul_epu32(_anDiffsLoOdd,_anDiffsLoOdd)));
+        _anSums = _mm256_add_epi64(_anSums,_mm256_add_epi64(_mm256_mul_epu32(_anDiffsHi,_anDiffsHi),_mm256_mul_epu32(_anDiffsHiOdd,_anDiffsHiOdd)));
+    }
+    alignas(32) uint64_t anSums[4];
+    _mm256_store_si256((__m256i*)anSums,_anSums);
+    return size_t(anSums[0]+anSums[1]+anSums[2]+anSums[3])+L2sqrdist_16u_SSE2(a+n,b+n,nValues-n);
+}
+
+SIMD_TARGET_ATTRIB("avx512f,avx512bw,avx2") static size_t L2sqrdist_16u_AVX512(const ushort* a, const ushort* b, size_t nValues) {
+    const __m512i _anZero = _mm512_setzero_si512();
+    const __mmask8 nAllLanes = 0xFF; // maskz products avoid the undefined passthrough operand of the unmasked forms (gcc false positive)
+    __m512i _anSums = _anZero;
+    size_t n = 0;
+    for(; n+32<=nValues; n+=32) {
+        const __m512i _anA = _mm512_loadu_si512((const void*)(a+n)), _anB = _mm512_loadu_si512((const void*)(b+n));
+        const __m512i _anDiffs = _mm512_or_si512(_mm512_subs_epu16(_anA,_anB),_mm512_subs_epu16(_anB,_anA));
+        const __m512i _anDiffsLo = _mm512_unpacklo_epi16(_anDiffs,_anZero), _anDiffsHi = _mm512_unpackhi_epi16(_anDiffs,_anZero);
+        const __m512i _anDiffsLoOdd = _mm512_bsrli_epi128(_anDiffsLo,4), _anDiffsHiOdd = _mm512_bsrli_epi128(_anDiffsHi,4); // only the even lanes are read by mul_epu32
+        _anSums = _mm512_add_epi64(_anSums,_mm512_add_epi64(_mm512_maskz_mul_epu32(nAllLanes,_anDiffsLo,_anDiffsLo),_mm512_maskz_mul_epu32(nAllLanes,_anDiffsLoOdd,_anDiffsLoOdd)));
+        _anSums = _mm512_add_epi64(_anSums,_mm512_add_epi64(_mm512_maskz_mul_epu32(nAllLanes,_anDiffsHi,_anDiffsHi),_mm512_maskz_mul_epu32(nAllLanes,_anDiffsHiOdd,_anDiffsHiOdd)));
+    }
+    alignas(64) uint64_t anSums[8];
+    _mm512_store_si512((void*)anSums,_anSums);
+    uint64_t nResult = 0;
+    for(size_t nLane=0; nLane<8; ++nLane)
+        nResult += anSums[nLane];
+    return size_t(nResult)+L2sqrdist_16u_AVX2(a+n,b+n,nValues-n);
+}
+
+SIMD_TARGET_ATTRIB("sse2") static float L2sqrdist_32f_SSE2(const float* a, const float* b, size_t nValues) {
+    __m128 _afSums0 = _mm_setzero_ps(), _afSums1 = _mm_setzero_ps();
+    size_t n = 0;
+    for(; n+8<=nValues; n+=8) {
+        const __m128 _afDiffs0 = _mm_sub_ps(_mm_loadu_ps(a+n),_mm_loadu_ps(b+n));
+        const __m128 _afDiffs1 = _mm_sub_ps(_mm_loadu_ps(a+n+4),_mm_loadu_ps(b+n+4));
+        _afSums0 = _mm_add_ps(_afSums0,_mm_mul_ps(_afDiffs0,_afDiffs0));
+        _afSums1 = _mm_add_ps(_afSums1,_mm_mul_ps(_afDiffs1,_afDiffs1));
+    }
+    alignas(16) float afSums[4];
+    _mm_store_ps(afSums,_mm_add_ps(_afSums0,_afSums1));
+    return (afSums[0]+afSums[1])+(afSums[2]+afSums[3])+L2sqrdist_Scalar(a+n,b+n,nValues-n);
+}
+
+SIMD_TARGET_ATTRIB("avx2,fma") static float L2sqrdist_32f_AVX2(const float* a, const float* b, size_t nValues) {
+    __m256 _afSums0 = _mm256_setzero_ps(), _afSums1 = _mm256_setzero_ps();
+    size_t n = 0;
+    for(; n+16<=nValues; n+=16) {
+        const __m256 _afDiffs0 = _mm256_sub_ps(_mm256_loadu_ps(a+n),_mm256_loadu_ps(b+n));
+        const __m256 _afDiffs1 = _mm256_sub_ps(_mm256_loadu_ps(a+n+8),_mm256_loadu_ps(b+n+8));
+        _afSums0 = _mm256_fmadd_ps(_afDiffs0,_afDiffs0,_afSums0);
+        _afSums1 = _mm256_fmadd_ps(_afDiffs1,_afDiffs1,_afSums1);
+    }
+    alignas(32) float afSums[8];
+    _mm256_store_ps(afSums,_mm256_add_ps(_afSums0,_afSums1));
+    return ((afSums[0]+afSums[1])+(afSums[2]+afSums[3]))+((afSums[4]+afSums[5])+(afSums[6]+afSums[7]))+L2sqrdist_32f_SSE2(a+n,b+n,nValues-n);
+}
+
+SIMD_TARGET_ATTRIB("avx512f,avx512bw,avx2,fma") static float L2sqrdist_32f_AVX512(const float* a, const float* b, size_t nValues) {
+    __m512 _afSums0 = _mm512_setzero_ps(), _afSums1 = _mm512_setzero_ps();
+    size_t n = 0;
+    for(; n+32<=nValues; n+=32) {
+        const __m512 _afDiffs0 = _mm512_sub_ps(_mm512_loadu_ps(a+n),_mm512_loadu_ps(b+n));
+        const __m512 _afDiffs1 = _mm512_sub_ps(_mm512_loadu_ps(a+n+16),_mm512_loadu_ps(b+n+16));
+        _afSums0 = _mm512_fmadd_ps(_afDiffs0,_afDiffs0,_afSums0);
+        _afSums1 = _mm512_fmadd_ps(_afDiffs1,_afDiffs1,_afSums1);
+    }
+    alignas(64) float afSums[16];
+    _mm512_store_ps(afSums,_mm512_add_ps(_afSums0,_afSums1));
+    float fResult = 0.0f;
+    for(size_t nLane=0; nLane<16; ++nLane)
+        fResult += afSums[nLane];
+    return fResult+L2sqrdist_32f_AVX2(a+n,b+n,nValues-n);
+}
+
+#endif //HAVE_SIMD_DISPATCH
+
+typedef size_t(*PopcountFunc)(const uchar*,const uchar*,size_t);
+typedef size_t(*L1dist8uFunc)(const uchar*,const uchar*,size_t);
+
+size_t DistanceUtils::popcount(const uchar* anData, size_t nBytes) {
+    static const PopcountFunc s_pFunc = ParallelUtils::selectDispatchedKernel<PopcountFunc>("DistanceUtils::popcount",{
+#if HAVE_SIMD_DISPATCH
+        {ParallelUtils::eSIMD_AVX512,popcount_AVX512<false>},
+        {ParallelUtils::eSIMD_AVX2,popcount_AVX2<false>},
+        {ParallelUtils::eSIMD_SSE4_1,popcount_POPCNT<false>},
+#endif //HAVE_SIMD_DISPATCH
+        {ParallelUtils::eSIMD_Scalar,popcount_Scalar<false>},
+    });
+    return s_pFunc(anData,nullptr,nBytes);
+}
+
+size_t DistanceUtils::hdist(const uchar* a, const uchar* b, size_t nBytes) {
+    static const PopcountFunc s_pFunc = ParallelUtils::selectDispatchedKernel<PopcountFunc>("DistanceUtils::hdist",{
+#if HAVE_SIMD_DISPATCH
+        {ParallelUtils::eSIMD_AVX512,popcount_AVX512<true>},
+        {ParallelUtils::eSIMD_AVX2,popcount_AVX2<true>},
+        {ParallelUtils::eSIMD_SSE4_1,popcount_POPCNT<true>},
+#endif //HAVE_SIMD_DISPATCH
+        {ParallelUtils::eSIMD_Scalar,popcount_Scalar<true>},
+    });
+    return s_pFunc(a,b,nBytes);
+}
+
+size_t DistanceUtils::L1dist(const uchar* a, const uchar* b, size_t nBytes) {
+    static const L1dist8uFunc s_pFunc = ParallelUtils::selectDispatchedKernel<L1dist8uFunc>("DistanceUtils::L1dist<uchar>",{
+#if HAVE_SIMD_DISPATCH
+        {ParallelUtils::eSIMD_AVX512,L1dist_8u_AVX512},
+        {ParallelUtils::eSIMD_AVX2,L1dist_8u_AVX2},
+        {ParallelUtils::eSIMD_SSE2,L1dist_8u_SSE2},
+#endif //HAVE_SIMD_DISPATCH
+        {ParallelUtils::eSIMD_Scalar,L1dist_Scalar<uchar>},
+    });
+    return s_pFunc(a,b,nBytes);
+}
+
+typedef size_t(*L1dist16uFunc)(const ushort*,const ushort*,size_t);
+typedef float(*L1dist32fFunc)(const float*,const float*,size_t);
+typedef size_t(*L2sqrdist8uFunc)(const uchar*,const uchar*,size_t);
+typedef size_t(*L2sqrdist16uFunc)(const ushort*,const ushort*,size_t);
+typedef float(*L2sqrdist32fFunc)(const float*,const float*,size_t);
+
+// number of elements covered by each mask block in whole-array distances; fully set/unset blocks skip per-element mask checks
+static constexpr size_t s_nMaskBlockSize = 256;
+
+enum eMaskBlockState {
+    eMaskBlock_Unset, //!< no element of the block is set
+    eMaskBlock_Set, //!< all elements of the block are set
+    eMaskBlock_Mixed, //!< some elements of the block are set
+};
+
+static inline eMaskBlockState getMaskBlockState(const uchar* m, size_t nElements) {
+    // a 64-bit word holds at least one null byte iff (w-0x01..01)&~w&0x80..80 is non-null
+    uint64_t nAnySet = 0, nAnyUnset = 0;
+    size_t n = 0;
+    for(; n+8<=nElements; n+=8) {
+        uint64_t nWord;
+        memcpy(&nWord,m+n,8);
+        nAnySet |= nWord;
+        nAnyUnset |= (nWord-0x0101010101010101ull)&~nWord&0x8080808080808080ull;
+    }
+    for(; n<nElements; ++n) {
+        nAnySet |= m[n];
+        nAnyUnset |= uint64_t(!m[n]);
+    }
+    return !nAnySet?eMaskBlock_Unset:!nAnyUnset?eMaskBlock_Set:eMaskBlock_Mixed;
+}
+
+// applies a whole-array distance kernel (defined over channel values) to all elements, or only to the runs of set elements in the mask
+template<typename TResult, typename T, typename TKernel>
+static TResult blockwiseDist(const T* a, const T* b, size_t nElements, size_t nChannels, const uchar* m, TKernel pKernel) {
+    if(!m)
+        return pKernel(a,b,nElements*nChannels);
+    TResult tResult = 0;
+    for(size_t nBlockIdx=0; nBlockIdx<nElements; nBlockIdx+=s_nMaskBlockSize) {
+        const size_t nBlockEnd = std::min(nBlockIdx+s_nMaskBlockSize,nElements);
+        const eMaskBlockState eState = getMaskBlockState(m+nBlockIdx,nBlockEnd-nBlockIdx);
+        if(eState==eMaskBlock_Set)
+            tResult += pKernel(a+nBlockIdx*nChannels,b+nBlockIdx*nChannels,(nBlockEnd-nBlockIdx)*nChannels);
+        else if(eState==eMaskBlock_Mixed) {
+            for(size_t n=nBlockIdx; n<nBlockEnd;) {
+                if(!m[n]) {
+                    ++n;
+                    continue;
+                }
+                const size_t nRunIdx = n;
+                while(n<nBlockEnd && m[n])
+                    ++n;
+                tResult += pKernel(a+nRunIdx*nChannels,b+nRunIdx*nChannels,(n-nRunIdx)*nChannels);
+            }
+        }
+    }
+    return tResult;
+}
+
+template<typename TResult, typename T>
+static TResult blockwiseColorDist(const T* a, const T* b, size_t nElements, size_t nChannels, const uchar* m) {
+    CV_Assert(nChannels>1 && nChannels<=4);
+    switch(nChannels) {
+        case 2: return blockwiseDist<TResult>(a,b,nElements,nChannels,m,cdist_Scalar<2,T>);
+        case 3: return blockwiseDist<TResult>(a,b,nElements,nChannels,m,cdist_Scalar<3,T>);
+        case 4: return blockwiseDist<TResult>(a,b,nElements,nChannels,m,cdist_Scalar<4,T>);
+        default: return 0;
+    }
+}
+
+size_t DistanceUtils::L1dist(const uchar* a, const uchar* b, size_t nElements, size_t nChannels, const uchar* m) {
+    CV_Assert(nChannels>0 && nChannels<=4);
+    return blockwiseDist<size_t>(a,b,nElements,nChannels,m,[](const uchar* aRun, const uchar* bRun, size_t nValues){return DistanceUtils::L1dist(aRun,bRun,nValues);});
+}
+
+size_t DistanceUtils::L1dist(const ushort* a, const ushort* b, size_t nElements, size_t nChannels, const uchar* m) {
+    static const L1dist16uFunc s_pFunc = ParallelUtils::selectDispatchedKernel<L1dist16uFunc>("DistanceUtils::L1dist<ushort>",{
+#if HAVE_SIMD_DISPATCH
+        {ParallelUtils::eSIMD_AVX512,L1dist_16u_AVX512},
+        {ParallelUtils::eSIMD_AVX2,L1dist_16u_AVX2},
+        {ParallelUtils::eSIMD_SSE2,L1dist_16u_SSE2},
+#endif //HAVE_SIMD_DISPATCH
+        {ParallelUtils::eSIMD_Scalar,L1dist_Scalar<ushort>},
+    });
+    CV_Assert(nChannels>0 && nChannels<=4);
+    return blockwiseDist<size_t>(a,b,nElements,nChannels,m,s_pFunc);
+}
+
+float DistanceUtils::L1dist(const float* a, const float* b, size_t nElements, size_t nChannels, const uchar* m) {
+    static const L1dist32fFunc s_pFunc = ParallelUtils::selectDispatchedKernel<L1dist32fFunc>("DistanceUtils::L1dist<float>",{
+#if HAVE_SIMD_DISPATCH
+        {ParallelUtils::eSIMD_AVX512,L1dist_32f_AVX512},
+        {ParallelUtils::eSIMD_AVX2,L1dist_32f_AVX2},
+        {ParallelUtils::eSIMD_SSE2,L1dist_32f_SSE2},
+#endif //HAVE_SIMD_DISPATCH
+        {ParallelUtils::eSIMD_Scalar,L1dist_Scalar<float>},
+    });
+    CV_Assert(nChannels>0 && nChannels<=4);
+    return blockwiseDist<float>(a,b,nElements,nChannels,m,s_pFunc);
+}
+
+size_t DistanceUtils::L2sqrdist(const uchar* a, const uchar* b, size_t nElements, size_t nChannels, const uchar* m) {
+    static const L2sqrdist8uFunc s_pFunc = ParallelUtils::selectDispatchedKernel<L2sqrdist8uFunc>("DistanceUtils::L2sqrdist<uchar>",{
+#if HAVE_SIMD_DISPATCH
+        {ParallelUtils::eSIMD_AVX512,L2sqrdist_8u_AVX512},
+        {ParallelUtils::eSIMD_AVX2,L2sqrdist_8u_AVX2},
+        {ParallelUtils::eSIMD_SSE2,L2sqrdist_8u_SSE2},
+#endif //HAVE_SIMD_DISPATCH
+        {ParallelUtils::eSIMD_Scalar,L2sqrdist_Scalar<uchar>},
+    });
+    CV_Assert(nChannels>0 && nChannels<=4);
+    return blockwiseDist<size_t>(a,b,nElements,nChannels,m,s_pFunc);
+}
+
+size_t DistanceUtils::L2sqrdist(const ushort* a, const ushort* b, size_t nElements, size_t nChannels, const uchar* m) {
+    static const L2sqrdist16uFunc s_pFunc = ParallelUtils::selectDispatchedKernel<L2sqrdist16uFunc>("DistanceUtils::L2sqrdist<ushort>",{
+#if HAVE_SIMD_DISPATCH
+        {ParallelUtils::eSIMD_AVX512,L2sqrdist_16u_AVX512},
+        {ParallelUtils::eSIMD_AVX2,L2sqrdist_16u_AVX2},
+        {ParallelUtils::eSIMD_SSE2,L2sqrdist_16u_SSE2},
+#endif //HAVE_SIMD_DISPATCH
+        {ParallelUtils::eSIMD_Scalar,L2sqrdist_Scalar<ushort>},
+    });
+    CV_Assert(nChannels>0 && nChannels<=4);
+    return blockwiseDist<size_t>(a,b,nElements,nChannels,m,s_pFunc);
+}
+
+float DistanceUtils::L2sqrdist(const float* a, const float* b, size_t nElements, size_t nChannels, const uchar* m) {
+    static const L2sqrdist32fFunc s_pFunc = ParallelUtils::selectDispatchedKernel<L2sqrdist32fFunc>("DistanceUtils::L2sqrdist<float>",{
+#if HAVE_SIMD_DISPATCH
+        {ParallelUtils::eSIMD_AVX512,L2sqrdist_32f_AVX512},
+        {ParallelUtils::eSIMD_AVX2,L2sqrdist_32f_AVX2},
+        {ParallelUtils::eSIMD_SSE2,L2sqrdist_32f_SSE2},
+#endif //HAVE_SIMD_DISPATCH
+        {ParallelUtils::eSIMD_Scalar,L2sqrdist_Scalar<float>},
+    });
+    CV_Assert(nChannels>0 && nChannels<=4);
+    return blockwiseDist<float>(a,b,nElements,nChannels,m,s_pFunc);
+}
+
+float DistanceUtils::L2dist(const uchar* a, const uchar* b, size_t nElements, size_t nChannels, const uchar* m) {
+    return sqrt((float)L2sqrdist(a,b,nElements,nChannels,m));
+}
+
+float DistanceUtils::L2dist(const ushort* a, const ushort* b, size_t nElements, size_t nChannels, const uchar* m) {
+    return sqrt((float)L2sqrdist(a,b,nElements,nChannels,m));
+}
+
+float DistanceUtils::L2dist(const float* a, const float* b, size_t nElements, size_t nChannels, const uchar* m) {
+    return sqrt(L2sqrdist(a,b,nElements,nChannels,m));
+}
+
+size_t DistanceUtils::cdist(const uchar* a, const uchar* b, size_t nElements, size_t nChannels, const uchar* m) {
+    return blockwiseColorDist<size_t>(a,b,nElements,nChannels,m);
+}
+
+size_t DistanceUtils::cdist(const ushort* a, const ushort* b, size_t nElements, size_t nChannels, const uchar* m) {
+    return blockwiseColorDist<size_t>(a,b,nElements,nChannels,m);
+}
+
+float DistanceUtils::cdist(const float* a, const float* b, size_t nElements, size_t nChannels, const uchar* m) {
+    return blockwiseColorDist<float>(a,b,nElements,nChannels,m);
+}
+
+size_t DistanceUtils::hdist(const uchar* a, const uchar* b, size_t nElements, size_t nChannels, const uchar* m) {
+    CV_Assert(nChannels>0 && nChannels<=4);
+    return blockwiseDist<size_t>(a,b,nElements,nChannels,m,[](const uchar* aRun, const uchar* bRun, size_t nValues){return DistanceUtils::hdist(aRun,bRun,nValues);});
+}
+
+size_t DistanceUtils::hdist(const ushort* a, const ushort* b, size_t nElements, size_t nChannels, const uchar* m) {
+    CV_Assert(nChannels>0 && nChannels<=4);
+    return blockwiseDist<size_t>(a,b,nElements,nChannels,m,[](const ushort* aRun, const ushort* bRun, size_t nValues){return DistanceUtils::hdist((const uchar*)aRun,(const uchar*)bRun,nValues*sizeof(ushort));});
+}
+
+// resolves the kernels of this file at startup, so that they appear in the dispatch report before their first use
+static const struct DistanceUtilsDispatchInit {
+    DistanceUtilsDispatchInit() {
+        DistanceUtils::popcount(nullptr,0);
+        DistanceUtils::hdist(nullptr,nullptr,0);
+        DistanceUtils::L1dist(nullptr,nullptr,0);
+        DistanceUtils::L1dist((const ushort*)nullptr,(const ushort*)nullptr,0,1);
+        DistanceUtils::L1dist((const float*)nullptr,(const float*)nullptr,0,1);
+        DistanceUtils::L2sqrdist((const uchar*)nullptr,(const uchar*)nullptr,0,1);
+        DistanceUtils::L2sqrdist((const ushort*)nullptr,(const ushort*)nullptr,0,1);
+        DistanceUtils::L2sqrdist((const float*)nullptr,(const float*)nullptr,0,1);
+    }
+} s_oDistanceUtilsDispatchInit;
@@ -17,6 +17,7 @@
 
 #include "litiv/utils/OpenCVUtils.hpp"
 #include "litiv/utils/PlatformUtils.hpp"
+#include "litiv/utils/DistanceUtils.hpp"
 
 cv::DisplayHelperPtr cv::DisplayHelper::create(const std::string& sDisplayName, const std::string& sDebugFSDirPath, const cv::Size& oMaxSize, int nWindowFlags) {
     struct DisplayHelperWrapper : public DisplayHelper {
@@ -162,3 +163,81 @@ void cv::DisplayHelper::onMouseEventCallback(int nEvent, int x, int y, int nFlag
 void cv::DisplayHelper::onMouseEvent(int nEvent, int x, int y, int nFlags, void* pData) {
     (*(std::function<void(int,int,int,int)>*)pData)(nEvent,x,y,nFlags);
 }
+
+void cv::BinaryMedianBlur::apply(const cv::Mat& oSrc, cv::Mat& oDst, int nKernelSize) {
+    CV_Assert(!oSrc.empty() && oSrc.type()==CV_8UC1);
+    reset(oSrc.size(),nKernelSize);
+    const cv::Mat oSrcHeader = oSrc; // keeps the input alive if oDst is reallocated
+    oDst.create(oSrcHeader.size(),CV_8UC1);
+    // output rows are always popped right after the last input row they depend on, so in-place filtering is safe
+    int nDstRowIdx = 0;
+    for(int nSrcRowIdx=0; nSrcRowIdx<oSrcHeader.rows; ++nSrcRowIdx) {
+        pushRow(oSrcHeader.ptr<uchar>(nSrcRowIdx));
+        while(nDstRowIdx<oDst.rows && popRow(oDst.ptr<uchar>(nDstRowIdx)))
+            ++nDstRowIdx;
+    }
+    CV_Assert(nDstRowIdx==oDst.rows);
+}
+
+void cv::BinaryMedianBlur::reset(const cv::Size& oSize, int nKernelSize) {
+    CV_Assert(oSize.area()>0 && nKernelSize>0 && (nKernelSize%2)==1 && nKernelSize<64);
+    m_nCols = oSize.width;
+    m_nRows = oSize.height;
+    m_nKernelSize = nKernelSize;
+    m_nPushedRows = m_nPoppedRows = 0;
+    // one extra word is kept at the end so that any 64-bit window can be extracted from two consecutive words
+    m_vnPackedRow.resize((size_t(m_nCols+m_nKernelSize-1)+63)/64+1);
+    m_vnRowCounts.resize(size_t(m_nKernelSize+1)*m_nCols);
+    m_vnWindowCounts.resize(size_t(m_nCols));
+}
+
+void cv::BinaryMedianBlur::pushRow(const uchar* pSrcRow) {
+    const int nRadius = m_nKernelSize/2;
+    CV_Assert(pSrcRow && m_nPushedRows<m_nRows && m_nPushedRows<=m_nPoppedRows+nRadius);
+    std::fill(m_vnPackedRow.begin(),m_vnPackedRow.end(),uint64_t(0));
+    const int nPaddedCols = m_nCols+2*nRadius;
+    for(int nPaddedColIdx=0; nPaddedColIdx<nPaddedCols; ++nPaddedColIdx)
+        if(pSrcRow[std::min(std::max(nPaddedColIdx-nRadius,0),m_nCols-1)])
+            m_vnPackedRow[nPaddedColIdx/64] |= uint64_t(1)<<(nPaddedColIdx%64);
+    const uint64_t nWindowMask = (uint64_t(1)<<m_nKernelSize)-1;
+    uchar* pRowCounts = &m_vnRowCounts[size_t(m_nPushedRows%(m_nKernelSize+1))*m_nCols];
+    for(int nColIdx=0; nColIdx<m_nCols; ++nColIdx) {
+        const size_t nWordIdx = size_t(nColIdx/64);
+        const int nBitOffset = nColIdx%64;
+        uint64_t nWindow = m_vnPackedRow[nWordIdx]>>nBitOffset;
+        if(nBitOffset)
+            nWindow |= m_vnPackedRow[nWordIdx+1]<<(64-nBitOffset);
+        pRowCounts[nColIdx] = (uchar)DistanceUtils::popcount(nWindow&nWindowMask);
+    }
+    ++m_nPushedRows;
+}
+
+bool cv::BinaryMedianBlur::popRow(uchar* pDstRow) {
+    const int nRadius = m_nKernelSize/2;
+    CV_Assert(pDstRow && m_nPoppedRows<m_nRows);
+    if(m_nPushedRows<std::min(m_nPoppedRows+nRadius+1,m_nRows))
+        return false;
+    const auto lRowCounts = [&](int nRowIdx) {
+        return (const uchar*)&m_vnRowCounts[size_t(std::min(std::max(nRowIdx,0),m_nRows-1)%(m_nKernelSize+1))*m_nCols];
+    };
+    if(m_nPoppedRows==0) {
+        std::fill(m_vnWindowCounts.begin(),m_vnWindowCounts.end(),0);
+        for(int nOffset=-nRadius; nOffset<=nRadius; ++nOffset) {
+            const uchar* pRowCounts = lRowCounts(nOffset);
+            for(int nColIdx=0; nColIdx<m_nCols; ++nColIdx)
+                m_vnWindowCounts[nColIdx] += pRowCounts[nColIdx];
+        }
+    }
+    else {
+        // vertical sliding window w/ replicated borders: add the newest row, remove the oldest one
+        const uchar* pAddedRowCounts = lRowCounts(m_nPoppedRows+nRadius);
+        const uchar* pRemovedRowCounts = lRowCounts(m_nPoppedRows-nRadius-1);
+        for(int nColIdx=0; nColIdx<m_nCols; ++nColIdx)
+            m_vnWindowCounts[nColIdx] += int(pAddedRowCounts[nColIdx])-int(pRemovedRowCounts[nColIdx]);
+    }
+    const int nThreshold = (m_nKernelSize*m_nKernelSize)/2;
+    for(int nColIdx=0; nColIdx<m_nCols; ++nColIdx)
+        pDstRow[nColIdx] = (m_vnWindowCounts[nColIdx]>nThreshold)?UCHAR_MAX:0;
+    ++m_nPoppedRows;
+    return true;
+}
@@ -0,0 +1,244 @@
+
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "litiv/utils/ParallelUtils.hpp"
+#include <mutex>
+#include <map>
+#include <sstream>
+#if HAVE_SIMD_DISPATCH && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif //HAVE_SIMD_DISPATCH && !defined(_MSC_VER)
+
+#if HAVE_SIMD_DISPATCH
+
+// returns the 4 cpuid registers (eax, ebx, ecx, edx) for the given leaf/subleaf
+static inline std::array<uint32_t,4> getCPUIDRegs(uint32_t nLeaf, uint32_t nSubLeaf) {
+    std::array<uint32_t,4> anRegs = {};
+#if defined(_MSC_VER)
+    int anTempRegs[4];
+    __cpuidex(anTempRegs,(int)nLeaf,(int)nSubLeaf);
+    for(size_t n=0; n<4; ++n)
+        anRegs[n] = (uint32_t)anTempRegs[n];
+#else //(!defined(_MSC_VER))
+    __cpuid_count(nLeaf,nSubLeaf,anRegs[0],anRegs[1],anRegs[2],anRegs[3]);
+#endif //(!defined(_MSC_VER))
+    return anRegs;
+}
+
+// returns the XCR0 register (OS-enabled extended state mask); must only be called if OSXSAVE is set
+static inline uint64_t getXCR0() {
+#if defined(_MSC_VER)
+    return (uint64_t)_xgetbv(0);
+#else //(!defined(_MSC_VER))
+    uint32_t nLow, nHigh;
+    __asm__ volatile("xgetbv" : "=a"(nLow), "=d"(nHigh) : "c"(0));
+    return (uint64_t(nHigh)<<32)|nLow;
+#endif //(!defined(_MSC_VER))
+}
+
+static ParallelUtils::eSIMDLevel detectSIMDLevel() {
+    const uint32_t nMaxLeaf = getCPUIDRegs(0,0)[0];
+    if(nMaxLeaf<1)
+        return ParallelUtils::eSIMD_Scalar;
+    const std::array<uint32_t,4> anLeaf1 = getCPUIDRegs(1,0);
+    const std::array<uint32_t,4> anLeaf7 = (nMaxLeaf>=7)?getCPUIDRegs(7,0):std::array<uint32_t,4>{};
+    const bool bSSE2 = (anLeaf1[3]&(1u<<26))!=0;
+    const bool bSSE4_1 = (anLeaf1[2]&(1u<<19))!=0;
+    const bool bPOPCNT = (anLeaf1[2]&(1u<<23))!=0;
+    const bool bFMA = (anLeaf1[2]&(1u<<12))!=0;
+    const bool bOSXSAVE = (anLeaf1[2]&(1u<<27))!=0;
+    const bool bAVX = (anLeaf1[2]&(1u<<28))!=0;
+    const bool bAVX2 = (anLeaf7[1]&(1u<<5))!=0;
+    const bool bAVX512F = (anLeaf7[1]&(1u<<16))!=0;
+    const bool bAVX512BW = (anLeaf7[1]&(1u<<30))!=0;
+    const uint64_t nXCR0 = bOSXSAVE?getXCR0():0;
+    const bool bOSYMMState = (nXCR0&0x06)==0x06; // SSE + AVX state
+    const bool bOSZMMState = (nXCR0&0xE6)==0xE6; // SSE + AVX + opmask + ZMM state
+    if(!bSSE2)
+        return ParallelUtils::eSIMD_Scalar;
+    if(!bSSE4_1 || !bPOPCNT)
+        return ParallelUtils::eSIMD_SSE2;
+    if(!bAVX || !bAVX2 || !bFMA || !bOSYMMState)
+        return ParallelUtils::eSIMD_SSE4_1;
+    if(!bAVX512F || !bAVX512BW || !bOSZMMState)
+        return ParallelUtils::eSIMD_AVX2;
+    return ParallelUtils::eSIMD_AVX512;
+}
+
+#endif //HAVE_SIMD_DISPATCH
+
+ParallelUtils::eSIMDLevel ParallelUtils::getSIMDLevel() {
+#if HAVE_SIMD_DISPATCH
+    static const eSIMDLevel s_eLevel = detectSIMDLevel();
+    return s_eLevel;
+#else //(!HAVE_SIMD_DISPATCH)
+    return eSIMD_Scalar;
+#endif //(!HAVE_SIMD_DISPATCH)
+}
+
+const char* ParallelUtils::getSIMDLevelName(eSIMDLevel eLevel) {
+    switch(eLevel) {
+        case eSIMD_Scalar: return "scalar";
+        case eSIMD_SSE2: return "SSE2";
+        case eSIMD_SSE4_1: return "SSE4.1";
+        case eSIMD_AVX2: return "AVX2";
+        case eSIMD_AVX512: return "AVX-512";
+        default: return "unknown";
+    }
+}
+
+// registry is constructed on first use, as kernels may register themselves during static initialization
+static std::map<std::string,ParallelUtils::eSIMDLevel>& getDispatchRegistry(std::mutex*& pMutex) {
+    static std::mutex s_oMutex;
+    static std::map<std::string,ParallelUtils::eSIMDLevel> s_mRegistry;
+    pMutex = &s_oMutex;
+    return s_mRegistry;
+}
+
+void ParallelUtils::registerDispatchedKernel(const std::string& sKernelName, eSIMDLevel eKernelLevel) {
+    std::mutex* pMutex;
+    auto& mRegistry = getDispatchRegistry(pMutex);
+    std::mutex_lock_guard oLock(*pMutex);
+    mRegistry[sKernelName] = eKernelLevel;
+}
+
+std::string ParallelUtils::getDispatchReport() {
+    std::mutex* pMutex;
+    const auto& mRegistry = getDispatchRegistry(pMutex);
+    std::stringstream ssReport;
+    ssReport << "runtime SIMD level : " << getSIMDLevelName(getSIMDLevel()) << "\n";
+    std::mutex_lock_guard oLock(*pMutex);
+    for(const auto& oKernel : mRegistry)
+        ssReport << "\t" << oKernel.first << " : " << getSIMDLevelName(oKernel.second) << "\n";
+    return ssReport.str();
+}
+
+static size_t hsum_ub_Scalar(const uchar* anData, size_t nCount) {
+    size_t nSum = 0;
+    for(size_t n=0; n<nCount; ++n)
+        nSum += anData[n];
+    return nSum;
+}
+
+static uchar hmax_ub_Scalar(const uchar* anData, size_t nCount) {
+    uchar nMax = 0;
+    for(size_t n=0; n<nCount; ++n)
+        nMax = std::max(nMax,anData[n]);
+    return nMax;
+}
+
+#if HAVE_SIMD_DISPATCH
+
+SIMD_TARGET_ATTRIB("sse2") static size_t hsum_ub_SSE2(const uchar* anData, size_t nCount) {
+    __m128i _anSums = _mm_setzero_si128();
+    size_t n = 0;
+    for(; n+16<=nCount; n+=16)
+        _anSums = _mm_add_epi64(_anSums,_mm_sad_epu8(_mm_loadu_si128((const __m128i*)(anData+n)),_mm_setzero_si128()));
+    alignas(16) uint64_t anSums[2];
+    _mm_store_si128((__m128i*)anSums,_anSums);
+    return size_t(anSums[0]+anSums[1])+hsum_ub_Scalar(anData+n,nCount-n);
+}
+
+SIMD_TARGET_ATTRIB("sse2") static uchar hmax_ub_SSE2(const uchar* anData, size_t nCount) {
+    __m128i _anMax = _mm_setzero_si128();
+    size_t n = 0;
+    for(; n+16<=nCount; n+=16)
+        _anMax = _mm_max_epu8(_anMax,_mm_loadu_si128((const __m128i*)(anData+n)));
+    alignas(16) uchar anMax[16];
+    _mm_store_si128((__m128i*)anMax,_anMax);
+    return std::max(hmax_ub_Scalar(anMax,16),hmax_ub_Scalar(anData+n,nCount-n));
+}
+
+SIMD_TARGET_ATTRIB("avx2") static size_t hsum_ub_AVX2(const uchar* anData, size_t nCount) {
+    __m256i _anSums = _mm256_setzero_si256();
+    size_t n = 0;
+    for(; n+32<=nCount; n+=32)
+        _anSums = _mm256_add_epi64(_anSums,_mm256_sad_epu8(_mm256_loadu_si256((const __m256i*)(anData+n)),_mm256_setzero_si256()));
+    alignas(32) uint64_t anSums[4];
+    _mm256_store_si256((__m256i*)anSums,_anSums);
+    return size_t(anSums[0]+anSums[1]+anSums[2]+anSums[3])+hsum_ub_SSE2(anData+n,nCount-n);
+}
+
+SIMD_TARGET_ATTRIB("avx2") static uchar hmax_ub_AVX2(const uchar* anData, size_t nCount) {
+    __m256i _anMax = _mm256_setzero_si256();
+    size_t n = 0;
+    for(; n+32<=nCount; n+=32)
+        _anMax = _mm256_max_epu8(_anMax,_mm256_loadu_si256((const __m256i*)(anData+n)));
+    alignas(32) uchar anMax[32];
+    _mm256_store_si256((__m256i*)anMax,_anMax);
+    return std::max(hmax_ub_SSE2(anMax,32),hmax_ub_SSE2(anData+n,nCount-n));
+}
+
+SIMD_TARGET_ATTRIB("avx512f,avx512bw") static size_t hsum_ub_AVX512(const uchar* anData, size_t nCount) {
+    __m512i _anSums = _mm512_setzero_si512();
+    size_t n = 0;
+    for(; n+64<=nCount; n+=64)
+        _anSums = _mm512_add_epi64(_anSums,_mm512_sad_epu8(_mm512_loadu_si512((const void*)(anData+n)),_mm512_setzero_si512()));
+    alignas(64) uint64_t anSums[8];
+    _mm512_store_si512((void*)anSums,_anSums);
+    uint64_t nSum = 0;
+    for(size_t nLane=0; nLane<8; ++nLane)
+        nSum += anSums[nLane];
+    return size_t(nSum)+hsum_ub_AVX2(anData+n,nCount-n);
+}
+
+SIMD_TARGET_ATTRIB("avx512f,avx512bw") static uchar hmax_ub_AVX512(const uchar* anData, size_t nCount) {
+    __m512i _anMax = _mm512_setzero_si512();
+    size_t n = 0;
+    for(; n+64<=nCount; n+=64)
+        _anMax = _mm512_max_epu8(_anMax,_mm512_loadu_si512((const void*)(anData+n)));
+    alignas(64) uchar anMax[64];
+    _mm512_store_si512((void*)anMax,_anMax);
+    return std::max(hmax_ub_AVX2(anMax,64),hmax_ub_AVX2(anData+n,nCount-n));
+}
+
+#endif //HAVE_SIMD_DISPATCH
+
+typedef size_t(*hsum_ub_Func)(const uchar*,size_t);
+typedef uchar(*hmax_ub_Func)(const uchar*,size_t);
+
+size_t ParallelUtils::hsum_ub(const uchar* anData, size_t nCount) {
+    static const hsum_ub_Func s_pFunc = ParallelUtils::selectDispatchedKernel<hsum_ub_Func>("ParallelUtils::hsum_ub",{
+#if HAVE_SIMD_DISPATCH
+        {eSIMD_AVX512,hsum_ub_AVX512},
+        {eSIMD_AVX2,hsum_ub_AVX2},
+        {eSIMD_SSE2,hsum_ub_SSE2},
+#endif //HAVE_SIMD_DISPATCH
+        {eSIMD_Scalar,hsum_ub_Scalar},
+    });
+    return s_pFunc(anData,nCount);
+}
+
+uchar ParallelUtils::hmax_ub(const uchar* anData, size_t nCount) {
+    static const hmax_ub_Func s_pFunc = ParallelUtils::selectDispatchedKernel<hmax_ub_Func>("ParallelUtils::hmax_ub",{
+#if HAVE_SIMD_DISPATCH
+        {eSIMD_AVX512,hmax_ub_AVX512},
+        {eSIMD_AVX2,hmax_ub_AVX2},
+        {eSIMD_SSE2,hmax_ub_SSE2},
+#endif //HAVE_SIMD_DISPATCH
+        {eSIMD_Scalar,hmax_ub_Scalar},
+    });
+    return s_pFunc(anData,nCount);
+}
+
+// resolves the kernels of this file at startup, so that they appear in the dispatch report before their first use
+static const struct ParallelUtilsDispatchInit {
+    ParallelUtilsDispatchInit() {
+        ParallelUtils::hsum_ub(nullptr,0);
+        ParallelUtils::hmax_ub(nullptr,0);
+    }
+} s_oParallelUtilsDispatchInit;
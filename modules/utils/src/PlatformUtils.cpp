@@ -198,6 +198,66 @@ std::fstream PlatformUtils::CreateBinFileWithPrealloc(const std::string & sFileP
     return ssFile;
 }
 
+PlatformUtils::MappedFile::MappedFile(const std::string& sFilePath) :
+        m_pData(nullptr),
+        m_nSize(0) {
+#if defined(_MSC_VER)
+    m_hFile = CreateFileA(sFilePath.c_str(),GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,NULL);
+    if(m_hFile==INVALID_HANDLE_VALUE)
+        lvErrorExt("could not open file '%s' for mapping",sFilePath.c_str());
+    LARGE_INTEGER nFileSize;
+    if(!GetFileSizeEx(m_hFile,&nFileSize)) {
+        CloseHandle(m_hFile);
+        lvError("could not query file size for mapping");
+    }
+    m_nSize = size_t(nFileSize.QuadPart);
+    m_hMapping = NULL;
+    if(m_nSize>0) {
+        m_hMapping = CreateFileMappingA(m_hFile,NULL,PAGE_WRITECOPY,0,0,NULL);
+        if(m_hMapping)
+            m_pData = (const uchar*)MapViewOfFile(m_hMapping,FILE_MAP_COPY,0,0,0);
+        if(!m_pData) {
+            if(m_hMapping)
+                CloseHandle(m_hMapping);
+            CloseHandle(m_hFile);
+            lvError("could not map file in memory");
+        }
+    }
+#else //(!defined(_MSC_VER))
+    m_nFileDesc = open(sFilePath.c_str(),O_RDONLY);
+    if(m_nFileDesc<0)
+        lvErrorExt("could not open file '%s' for mapping",sFilePath.c_str());
+    struct stat oFileStat;
+    if(fstat(m_nFileDesc,&oFileStat)!=0) {
+        close(m_nFileDesc);
+        lvError("could not query file size for mapping");
+    }
+    m_nSize = size_t(oFileStat.st_size);
+    if(m_nSize>0) {
+        void* pData = mmap(nullptr,m_nSize,PROT_READ|PROT_WRITE,MAP_PRIVATE,m_nFileDesc,0);
+        if(pData==MAP_FAILED) {
+            close(m_nFileDesc);
+            lvError("could not map file in memory");
+        }
+        m_pData = (const uchar*)pData;
+    }
+#endif //(!defined(_MSC_VER))
+}
+
+PlatformUtils::MappedFile::~MappedFile() {
+#if defined(_MSC_VER)
+    if(m_pData)
+        UnmapViewOfFile(m_pData);
+    if(m_hMapping)
+        CloseHandle(m_hMapping);
+    CloseHandle(m_hFile);
+#else //(!defined(_MSC_VER))
+    if(m_pData)
+        munmap((void*)m_pData,m_nSize);
+    close(m_nFileDesc);
+#endif //(!defined(_MSC_VER))
+}
+
 void PlatformUtils::RegisterAllConsoleSignals(void(*lHandler)(int)) {
     signal(SIGINT,lHandler);
     signal(SIGTERM,lHandler);
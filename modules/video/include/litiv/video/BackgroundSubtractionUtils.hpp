@@ -19,6 +19,7 @@
 
 #include "litiv/utils/ParallelUtils.hpp"
 #include "litiv/utils/OpenCVUtils.hpp"
+#include "litiv/utils/PlatformUtils.hpp"
 #include <opencv2/video/background_segm.hpp>
 
 struct IIBackgroundSubtractor : public cv::BackgroundSubtractor {
@@ -39,9 +40,49 @@ struct IIBackgroundSubtractor : public cv::BackgroundSubtractor {
     virtual void setROI(cv::Mat& oROI);
     //! returns a copy of the ROI used for input analysis
     virtual cv::Mat getROICopy() const;
+    //! sets the seed used for all internal random number generation (takes effect at the next (re)initialization)
+    void setRandomSeed(uint64_t nSeed);
     //! required for derived class destruction from this interface
     virtual ~IIBackgroundSubtractor() {}
 
+    //! single frame of a multi-stream batch (see 'applyBatch'); all entries sharing the same instance form a stream
+    struct BatchEntry {
+        //! background subtractor instance (i.e. stream) to update with this frame
+        IIBackgroundSubtractor* pAlgo;
+        //! input frame to process
+        cv::Mat oInput;
+        //! output foreground mask (allocated by the instance's 'apply' if needed)
+        cv::Mat oFGMask;
+        //! learning rate passed to 'apply' (negative = use the instance's default)
+        double dLearningRate;
+    };
+    //! per-stream statistics reported by 'applyBatch'
+    struct BatchStreamStats {
+        //! background subtractor instance of this stream
+        IIBackgroundSubtractor* pAlgo;
+        //! number of frames processed for this stream
+        size_t nFrames;
+        //! mean/max time spent in 'apply' for a single frame of this stream
+        double dMeanLatency_ms, dMaxLatency_ms;
+        //! time elapsed between the start of the batch and the completion of this stream's last frame
+        double dCompletionTime_ms;
+    };
+    //! aggregate statistics reported by 'applyBatch'
+    struct BatchStats {
+        //! per-stream statistics (in order of first appearance in the batch)
+        std::vector<BatchStreamStats> voStreams;
+        //! total number of frames processed
+        size_t nTotFrames;
+        //! total time elapsed for the whole batch
+        double dWallTime_ms;
+        //! aggregate throughput for the whole batch
+        double dThroughput_fps;
+        //! number of times a worker picked up a stream queued on another worker
+        size_t nSteals;
+    };
+    //! processes a batch of (instance,frame) entries over a shared worker pool; the frames of a stream are processed one at a time, in batch order, while idle workers steal pending streams from busy ones (the pool must not be used internally by the instances, and this function must not be called from one of its tasks, as it blocks on tasks queued behind it)
+    static BatchStats applyBatch(std::vector<BatchEntry>& voBatch, PlatformUtils::DynamicWorkerPool& oPool);
+
 protected:
     //! default impl constructor (for common parameters only -- none must be const to avoid constructor hell when deriving)
     IIBackgroundSubtractor();
@@ -86,12 +127,148 @@ protected:
     cv::Mat m_oLastFGMask;
     //! copy of latest pixel intensities (used when refreshing model)
     cv::Mat m_oLastColorFrame;
+    //! seed used for internal random number generation (re-applied at each (re)initialization)
+    uint64_t m_nRandomSeed;
+    //! random number generator used for model init/update decisions (reseeded in initialize_common)
+    CxxUtils::FastRNG m_oRNG;
 
 private:
     IIBackgroundSubtractor& operator=(const IIBackgroundSubtractor&) = delete;
     IIBackgroundSubtractor(const IIBackgroundSubtractor&) = delete;
 };
 
+//! possible memory layouts for sample-based background models (see BackgroundSampleModel)
+enum eSampleModelLayout {
+    //! one image-sized plane per sample (the samples of a pixel are one plane apart in memory)
+    eSampleModelLayout_Planar=0,
+    //! all samples of a pixel are stored in a single 64-byte-aligned block, one channel after the other
+    eSampleModelLayout_Interleaved,
+};
+
+//! color+descriptor sample storage used by sample-based background models (e.g. ViBe-like), with a selectable memory layout
+struct BackgroundSampleModel {
+    //! default constructor; the model stays empty until initialized
+    BackgroundSampleModel(eSampleModelLayout eLayout=eSampleModelLayout_Planar);
+    //! (re)allocates the model for the given image size, channel count and sample count, and zero-initializes all samples
+    void initialize(const cv::Size& oImgSize, size_t nChannels, size_t nSamples);
+    //! changes the memory layout of the model (if already initialized, all samples are kept)
+    void setLayout(eSampleModelLayout eLayout);
+    //! returns the current memory layout of the model
+    inline eSampleModelLayout getLayout() const {return m_eLayout;}
+    //! returns whether the model is initialized or not
+    inline bool empty() const {return m_vData.empty();}
+    //! returns the number of samples per pixel in the model
+    inline size_t getSampleCount() const {return m_nSamples;}
+    //! returns the number of channels per sample in the model
+    inline size_t getChannelCount() const {return m_nChannels;}
+    //! returns the total number of bytes allocated for the model
+    inline size_t getTotalSize() const {return m_vData.size();}
+    //! returns a reference to a single color sample channel value for a given pixel
+    inline uchar& getColor(size_t nSampleIdx, size_t nPxIdx, size_t nChIdx=0) {
+        return m_pColorData[nSampleIdx*m_nColorSampleStep+nPxIdx*m_nColorPxStep+nChIdx*m_nColorChStep];
+    }
+    //! returns a single color sample channel value for a given pixel
+    inline uchar getColor(size_t nSampleIdx, size_t nPxIdx, size_t nChIdx=0) const {
+        return m_pColorData[nSampleIdx*m_nColorSampleStep+nPxIdx*m_nColorPxStep+nChIdx*m_nColorChStep];
+    }
+    //! returns a reference to a single descriptor sample channel value for a given pixel
+    inline ushort& getDesc(size_t nSampleIdx, size_t nPxIdx, size_t nChIdx=0) {
+        return m_pDescData[nSampleIdx*m_nDescSampleStep+nPxIdx*m_nDescPxStep+nChIdx*m_nDescChStep];
+    }
+    //! returns a single descriptor sample channel value for a given pixel
+    inline ushort getDesc(size_t nSampleIdx, size_t nPxIdx, size_t nChIdx=0) const {
+        return m_pDescData[nSampleIdx*m_nDescSampleStep+nPxIdx*m_nDescPxStep+nChIdx*m_nDescChStep];
+    }
+    //! returns a pointer to the first color sample of a given pixel & channel (see getColorSampleStep for iteration)
+    inline const uchar* getColorPtr(size_t nPxIdx, size_t nChIdx=0) const {
+        return m_pColorData+nPxIdx*m_nColorPxStep+nChIdx*m_nColorChStep;
+    }
+    //! returns a pointer to the first descriptor sample of a given pixel & channel (see getDescSampleStep for iteration)
+    inline const ushort* getDescPtr(size_t nPxIdx, size_t nChIdx=0) const {
+        return m_pDescData+nPxIdx*m_nDescPxStep+nChIdx*m_nDescChStep;
+    }
+    //! returns the step (in elements) between two consecutive samples of the same pixel & channel
+    inline size_t getColorSampleStep() const {return m_nColorSampleStep;}
+    //! returns the step (in elements) between two consecutive samples of the same pixel & channel
+    inline size_t getDescSampleStep() const {return m_nDescSampleStep;}
+
+protected:
+    //! recomputes data pointers and element steps based on the current layout & sizes
+    void updateSteps();
+    //! current memory layout used for sample storage
+    eSampleModelLayout m_eLayout;
+    //! image size, channel count and sample count used for the latest initialization
+    cv::Size m_oImgSize;
+    size_t m_nChannels, m_nSamples;
+    //! size (in bytes) of a pixel's sample block (interleaved layout only, always a multiple of 64)
+    size_t m_nPxBlockSize;
+    //! element steps used to compute the address of a color sample (sample/pixel/channel)
+    size_t m_nColorSampleStep, m_nColorPxStep, m_nColorChStep;
+    //! element steps used to compute the address of a desc sample (sample/pixel/channel)
+    size_t m_nDescSampleStep, m_nDescPxStep, m_nDescChStep;
+    //! pointers to the first color/desc sample in the data buffer
+    uchar* m_pColorData;
+    ushort* m_pDescData;
+    //! actual model data buffer (cache-line-aligned)
+    std::aligned_vector<uchar,64> m_vData;
+
+private:
+    BackgroundSampleModel& operator=(const BackgroundSampleModel&) = delete;
+    BackgroundSampleModel(const BackgroundSampleModel&) = delete;
+};
+
+/*!
+    Fused post-processing stage for binary (0/255) foreground masks, shared by SuBSENSE and PAWCS.
+
+    Produces the same results as the original OpenCV call chain (3x3 closing, border flood fill & hole filling,
+    7x7 erosion of the closed mask, median blur, 7x7 dilation, and blink map updates) using only two streaming
+    passes over image rows: the first one updates the blink maps, closes the raw mask and labels its background
+    runs, and the second one fills holes, applies the (bit-packed) median blur and dilates the result with small
+    row buffers.
+ */
+struct ForegroundMaskPostProcessor {
+    //! default constructor; internal buffers stay empty until initialized
+    ForegroundMaskPostProcessor() {}
+    //! (re)allocates all internal buffers for the given image size
+    void initialize(const cv::Size& oImgSize);
+    //! post-processes the raw mask into oFGMask (+dilated/inverted versions), and updates the raw mask & blink maps (all must be CV_8UC1 of the initialized size)
+    void apply(const cv::Mat& oRawFGMask, int nMedianBlurKernelSize, cv::Mat& oLastRawFGMask, cv::Mat& oLastRawFGBlinkMask, cv::Mat& oBlinksFrame,
+               cv::Mat& oFGMask, cv::Mat& oFGMask_dilated, cv::Mat& oFGMask_dilated_inverted);
+
+protected:
+    //! horizontal run of background (zero) pixels in the closed mask, used for connected component labelling
+    struct ZeroRun {
+        //! first/last+1 column of the run
+        int nBegin, nEnd;
+    };
+    //! labels the zero runs of the given closed mask row, and merges them with the overlapping runs of the previous row
+    void label_zero_runs(int nRowIdx);
+    //! returns the root run index of the component the given run belongs to
+    size_t find_root(size_t nRunIdx);
+    //! image size used for the latest initialization
+    cv::Size m_oImgSize;
+    //! closed (3x3) version of the raw mask
+    cv::Mat m_oFGMask_PreFlood;
+    //! row ring buffer used for the 3x3 dilated raw mask
+    std::vector<uchar> m_vDilatedRows;
+    //! row buffer used for the combined (raw+holes+eroded) mask
+    std::vector<uchar> m_vCombinedRow;
+    //! temporary row buffer used for separable min/max filtering
+    std::vector<uchar> m_vTempRow;
+    //! streaming bit-packed median filter applied to the combined mask rows
+    cv::BinaryMedianBlur m_oMedianBlur;
+    //! zero runs of the closed mask, in row order
+    std::vector<ZeroRun> m_voZeroRuns;
+    //! index of the first zero run of each row in m_voZeroRuns (with an extra end offset)
+    std::vector<size_t> m_vnRowRunOffsets;
+    //! union-find parent of each zero run
+    std::vector<size_t> m_vnRunParents;
+
+private:
+    ForegroundMaskPostProcessor& operator=(const ForegroundMaskPostProcessor&) = delete;
+    ForegroundMaskPostProcessor(const ForegroundMaskPostProcessor&) = delete;
+};
+
 template<ParallelUtils::eParallelAlgoType eImpl>
 struct IBackgroundSubtractor_;
 
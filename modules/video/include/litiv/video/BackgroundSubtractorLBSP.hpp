@@ -40,6 +40,8 @@ struct IBackgroundSubtractorLBSP_ : public IBackgroundSubtractor_<eImpl> {
 
     //! returns a copy of the latest reconstructed background descriptors image
     virtual void getBackgroundDescriptorsImage(cv::OutputArray oBGDescImg) const = 0;
+    //! sets the descriptor cache to share intra-frame descriptors with other consumers fed the same frames in lockstep (nullptr = compute internally)
+    void setDescriptorCache(std::shared_ptr<LBSPDescriptorCache> pDescCache) {m_pDescCache = std::move(pDescCache);}
 
 protected:
     //! default impl constructor (defined here as MSVC is very prude with template-class-template-cstor-definitions)
@@ -98,6 +100,10 @@ protected:
     const int m_nDefaultMedianBlurKernelSize;
     //! copy of latest descriptors (used when refreshing model)
     cv::Mat m_oLastDescFrame;
+    //! shared descriptor cache (keyed by frame index, may be null)
+    std::shared_ptr<LBSPDescriptorCache> m_pDescCache;
+    //! intra-frame descriptors of the frame being processed, fetched from the shared cache (null if not using a cache)
+    std::shared_ptr<const cv::Mat> m_pCurrDescFrame;
 };
 
 #if HAVE_GLSL
@@ -145,12 +145,14 @@ public:
     virtual void getBackgroundImage(cv::OutputArray oBGImg) const override;
     //! returns a copy of the latest reconstructed background descriptors image
     virtual void getBackgroundDescriptorsImage(cv::OutputArray oBGDescImg) const override;
+    //! sets the memory layout used for background samples storage (can be called before or after initialization)
+    void setSampleModelLayout(eSampleModelLayout eLayout);
 
 protected:
-    //! background model pixel intensity samples
-    std::vector<cv::Mat> m_voBGColorSamples;
-    //! background model descriptors samples
-    std::vector<cv::Mat> m_voBGDescSamples;
+    //! background model pixel intensity & descriptor samples
+    BackgroundSampleModel m_oBGSamples;
+    //! bit-packed median filter used for foreground mask post-processing
+    cv::BinaryMedianBlur m_oMedianBlur;
 };
 
 using BackgroundSubtractorLOBSTER = BackgroundSubtractorLOBSTER_<ParallelUtils::eNonParallel>;
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "litiv/video/BackgroundSubtractorLBSP.hpp"
+#include "litiv/utils/PlatformUtils.hpp"
 
 //! defines the default value for BackgroundSubtractorPAWCS::m_nDescDistThresholdOffset
 #define BGSPAWCS_DEFAULT_DESC_DIST_THRESHOLD_OFFSET (2)
@@ -63,6 +64,10 @@ public:
     virtual void getBackgroundDescriptorsImage(cv::OutputArray backgroundDescImage) const override;
     //! returns the default learning rate value used in 'apply'
     virtual double getDefaultLearningRate() const override {return 0;}
+    //! returns the total byte size of the preallocated word arena (word lists, dictionaries & global word maps)
+    size_t getWordArenaSize() const;
+    //! sets the number of image rows per model tile in 'apply' and 'refreshModel' (0 = single tile) and the number of threads used to process tiles (results do not depend on the latter)
+    void setParallelTiling(size_t nTileRows, size_t nWorkers);
 
 protected:
     template<size_t nChannels>
@@ -81,7 +86,7 @@ protected:
     };
     struct GlobalWordBase {
         float fLatestWeight;
-        cv::Mat oSpatioOccMap;
+        cv::Mat oSpatioOccMap; // non-owning header into m_oGlobalWordSpatioOccMaps
         uchar nDescBITS;
     };
     template<typename T>
@@ -94,8 +99,11 @@ protected:
     typedef GlobalWord<ColorLBSPFeature<3>> GlobalWord_3ch;
     struct PxInfo_PAWCS : PxInfoBase {
         size_t nGlobalWordMapLookupIdx;
-        std::vector<GlobalWordBase*> vpGlobalDictSortLUT;
     };
+    //! 32-bit index handle used to refer to a word stored in the word arena (i.e. in one of the word lists)
+    typedef uint32_t WordHandle;
+    //! handle value used to flag empty dictionary slots
+    static constexpr WordHandle s_nInvalidWordHandle = WordHandle(-1);
     //! absolute minimal color distance threshold ('R' or 'radius' in the original ViBe paper, used as the default/initial 'R(x)' value here)
     const size_t m_nMinColorDistThreshold;
     //! absolute descriptor distance threshold offset
@@ -119,17 +127,27 @@ protected:
     //! current local word weight offset
     size_t m_nLocalWordWeightOffset;
 
-    //! word lists & dictionaries
-    std::vector<LocalWordBase*> m_vpLocalWordDict;
+    //! word arena: fixed-size word lists sized once in 'initialize' (words are only recycled afterwards, never reallocated)
     std::vector<LocalWord_1ch> m_voLocalWordList_1ch;
     std::vector<LocalWord_3ch> m_voLocalWordList_3ch;
-    std::vector<LocalWord_1ch>::iterator m_pLocalWordListIter_1ch;
-    std::vector<LocalWord_3ch>::iterator m_pLocalWordListIter_3ch;
-    std::vector<GlobalWordBase*> m_vpGlobalWordDict;
     std::vector<GlobalWord_1ch> m_voGlobalWordList_1ch;
     std::vector<GlobalWord_3ch> m_voGlobalWordList_3ch;
-    std::vector<GlobalWord_1ch>::iterator m_pGlobalWordListIter_1ch;
-    std::vector<GlobalWord_3ch>::iterator m_pGlobalWordListIter_3ch;
+    //! number of words of the global list already handed out to the dictionary (local word handles are bound to their px's dictionary range instead)
+    size_t m_nUsedGlobalWords;
+    //! contiguous CV_32FC1 storage for all global word spatio-occurrence maps (one map per global word handle, stacked vertically)
+    cv::Mat m_oGlobalWordSpatioOccMaps;
+    //! byte size of a single global word spatio-occurrence map inside m_oGlobalWordSpatioOccMaps
+    size_t m_nGlobalWordSpatioOccMapSize;
+    //! per-pixel local word dictionaries (m_nCurrLocalWords handles per relevant px, sorted by weight)
+    std::vector<WordHandle> m_vnLocalWordDict;
+    //! cached local word weights, kept aligned with m_vnLocalWordDict (refreshed lazily, see LWORD_RANK_REFRESH_RATE in impl)
+    std::vector<float> m_vfLocalWordWeightCache;
+    //! frame index at which each cached local word weight was computed (entries from older frames are recomputed before being compared)
+    std::vector<size_t> m_vnLocalWordWeightCacheFrameIdx;
+    //! global word dictionary (m_nCurrGlobalWords handles, sorted by weight)
+    std::vector<WordHandle> m_vnGlobalWordDict;
+    //! per-pixel global word lookup order (m_nCurrGlobalWords handles per relevant px, sorted by local spatio-occurrence weight)
+    std::vector<WordHandle> m_vnGlobalWordSortLUT;
     std::vector<PxInfo_PAWCS> m_voPxInfoLUT_PAWCS;
 
     //! a lookup map used to keep track of regions where illumination recently changed
@@ -158,14 +176,116 @@ protected:
     cv::Mat m_oLastRawFGMask;
 
     //! pre-allocated CV_8UC1 matrices used to speed up morph ops
-    cv::Mat m_oFGMask_PreFlood;
-    cv::Mat m_oFGMask_FloodedHoles;
     cv::Mat m_oLastFGMask_dilated;
     cv::Mat m_oLastFGMask_dilated_inverted;
-    cv::Mat m_oCurrRawFGBlinkMask;
     cv::Mat m_oLastRawFGBlinkMask;
     cv::Mat m_oTempGlobalWordWeightDiffFactor;
-    cv::Mat m_oMorphExStructElement;
+    //! fused post-processing stage used to produce the final foreground mask & blink map in 'apply'
+    ForegroundMaskPostProcessor m_oPostProcessor;
+
+    //! returns a pointer to the word stored at the given arena handle (or nullptr for empty dictionary slots)
+    template<typename TWord>
+    static inline TWord* GetWord(std::vector<TWord>& voWordList, WordHandle nHandle) {
+        return (nHandle==s_nInvalidWordHandle)?nullptr:&voWordList[nHandle];
+    }
+    //! returns a const pointer to the word stored at the given arena handle (or nullptr for empty dictionary slots)
+    template<typename TWord>
+    static inline const TWord* GetWord(const std::vector<TWord>& voWordList, WordHandle nHandle) {
+        return (nHandle==s_nInvalidWordHandle)?nullptr:&voWordList[nHandle];
+    }
+    //! returns the channel-agnostic part of the local word stored at the given (valid) arena handle
+    inline LocalWordBase& getLocalWordBase(WordHandle nHandle) {
+        CV_DbgAssert(nHandle!=s_nInvalidWordHandle);
+        return (m_nImgChannels==1)?(LocalWordBase&)m_voLocalWordList_1ch[nHandle]:(LocalWordBase&)m_voLocalWordList_3ch[nHandle];
+    }
+    //! caches the weight of the local word at the given dictionary index, stamping it with the current frame index
+    inline void setCachedLocalWordWeight(size_t nLocalDictIdx, float fWeight) {
+        m_vfLocalWordWeightCache[nLocalDictIdx] = fWeight;
+        m_vnLocalWordWeightCacheFrameIdx[nLocalDictIdx] = m_nFrameIdx;
+    }
+    //! returns the cached weight of the local word at the given dictionary index (recomputed first if it was cached during an older frame)
+    inline float getCachedLocalWordWeight(size_t nLocalDictIdx) {
+        if(m_vnLocalWordWeightCacheFrameIdx[nLocalDictIdx]!=m_nFrameIdx)
+            setCachedLocalWordWeight(nLocalDictIdx,GetLocalWordWeight(getLocalWordBase(m_vnLocalWordDict[nLocalDictIdx]),m_nFrameIdx,m_nLocalWordWeightOffset));
+        return m_vfLocalWordWeightCache[nLocalDictIdx];
+    }
+    //! marks the cached weight of the local word at the given dictionary index as stale (used when its occurrence counters change outside a scan)
+    inline void invalidateCachedLocalWordWeight(size_t nLocalDictIdx) {
+        m_vnLocalWordWeightCacheFrameIdx[nLocalDictIdx] = SIZE_MAX;
+    }
+    //! swaps the cached weights (and their frame stamps) of two local dictionary entries, following a swap of their handles
+    inline void swapCachedLocalWordWeights(size_t nLocalDictIdxA, size_t nLocalDictIdxB) {
+        std::swap(m_vfLocalWordWeightCache[nLocalDictIdxA],m_vfLocalWordWeightCache[nLocalDictIdxB]);
+        std::swap(m_vnLocalWordWeightCacheFrameIdx[nLocalDictIdxA],m_vnLocalWordWeightCacheFrameIdx[nLocalDictIdxB]);
+    }
+    //! returns the channel-agnostic part of the global word stored at the given (valid) arena handle
+    inline GlobalWordBase& getGlobalWordBase(WordHandle nHandle) {
+        CV_DbgAssert(nHandle!=s_nInvalidWordHandle);
+        return (m_nImgChannels==1)?(GlobalWordBase&)m_voGlobalWordList_1ch[nHandle]:(GlobalWordBase&)m_voGlobalWordList_3ch[nHandle];
+    }
+    //! returns the localized weight of the global word stored at the given (valid) arena handle, read directly from the map arena
+    inline float& getGlobalWordLocalWeight(WordHandle nHandle, size_t nGlobalWordMapLookupIdx) {
+        return *(float*)(m_oGlobalWordSpatioOccMaps.data+nHandle*m_nGlobalWordSpatioOccMapSize+nGlobalWordMapLookupIdx);
+    }
+    //! global word weight update gathered in 'apply' (applied in-place, or deferred to frame end when multiple tiles are used)
+    struct GlobalWordUpdate {
+        //! handle of the matched global word (if invalid, the weakest word of the dictionary is replaced by the features below)
+        WordHandle nGlobalWordHandle;
+        //! spatio-occurrence map lookup index of the source pixel
+        size_t nGlobalWordMapLookupIdx;
+        //! local word weight sum of the source pixel
+        float fWeight;
+        //! source pixel color, intra-LBSP descriptor(s) and descriptor bit count (only the first channel is used for 1-ch images)
+        std::array<uchar,3> anColor;
+        std::array<ushort,3> anDesc;
+        uchar nDescBITS;
+    };
+    //! local dictionary update targeting a neighbor of the source pixel (deferred to frame end if the target is owned by another tile)
+    struct NeighborModelUpdate {
+        //! index of the pixel whose local dictionary will be updated
+        size_t nDstPxIdx;
+        //! source pixel color & intra-LBSP descriptor(s) (only the first channel is used for 1-ch images)
+        std::array<uchar,3> anColor;
+        std::array<ushort,3> anIntraDesc;
+        //! source pixel color & descriptor distance thresholds (total thresholds for 3-ch images)
+        size_t nColorDistThreshold, nDescDistThreshold;
+        //! source pixel local word weight sum threshold
+        float fLocalWordsWeightSumThreshold;
+        //! source pixel word occurrence increment & local update rate
+        size_t nWordOccIncr, nLocalWordUpdateRate;
+        //! specifies whether the source pixel is located in a flat region
+        bool bSrcRegionIsFlat;
+    };
+    //! holds all tile-specific data used in 'apply' and 'refreshModel'; each tile owns the local dictionaries of a band of image rows
+    struct TileInfo {
+        //! first/last+1 image rows owned by this tile
+        int nRowBegin, nRowEnd;
+        //! first/last+1 model indexes (in m_vnPxIdxLUT) processed by this tile
+        size_t nModelIterBegin, nModelIterEnd;
+        //! number of flat regions found in this tile for the current frame
+        size_t nFlatRegionCount;
+        //! list of neighbor updates targeting pixels owned by other tiles
+        std::vector<NeighborModelUpdate> voDeferredNeighborUpdates;
+        //! list of global word updates gathered in this tile (only used when multiple tiles are processed concurrently)
+        std::vector<GlobalWordUpdate> voDeferredGlobalWordUpdates;
+        //! random number generator used for all model update decisions in this tile (seeded from the tile index)
+        CxxUtils::FastRNG oRNG;
+    };
+    //! (re)builds the tile list based on the current image size, ROI and tile row count
+    void initialize_tiles();
+    //! runs the given processor on all tiles, using the worker pool if allowed and available (returns once all tiles are done)
+    void process_tiles(const std::function<void(TileInfo*)>& lTileProcessor, bool bAllowWorkers);
+    //! applies a global word weight update gathered in 'apply'
+    void update_global_word(const GlobalWordUpdate& oUpdate);
+    //! re-sorts the per-px global word lookup order for all pixels of the given tile
+    void sort_global_word_lut(const TileInfo& oTile);
+
+    //! number of image rows per tile (0 = whole image in a single tile)
+    size_t m_nTileRows;
+    //! list of tiles used to split the local model update work in 'apply' and 'refreshModel'
+    std::vector<TileInfo> m_voTiles;
+    //! worker pool used to process tiles concurrently (null if processing on the calling thread only)
+    std::unique_ptr<PlatformUtils::DynamicWorkerPool> m_pWorkerPool;
 
     //! internal weight lookup function for local words
     static float GetLocalWordWeight(const LocalWordBase& w, size_t nCurrFrame, size_t nOffset);
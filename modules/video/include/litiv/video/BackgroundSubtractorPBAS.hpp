@@ -36,6 +36,7 @@
 //
 // @@@@@@@@
 
+#include "litiv/utils/CxxUtils.hpp"
 #include <opencv2/video/background_segm.hpp>
 
 //! defines the internal threshold adjustment factor to use when determining if the variation of a single channel is enough to declare the pixel as foreground
@@ -106,6 +107,8 @@ public:
     virtual void apply(cv::InputArray image, cv::OutputArray fgmask, double learningRateOverride=BGSPBAS_DEFAULT_LEARNING_RATE_OVERRIDE) = 0;
     //! returns a copy of the latest reconstructed background image
     void getBackgroundImage(cv::OutputArray backgroundImage) const;
+    //! sets the seed used for all internal random number generation (takes effect at the next (re)initialization)
+    void setRandomSeed(uint64_t nSeed);
 
 protected:
     //! number of different samples per pixel/block to be taken from input frames to build the background model ('N' in the original ViBe/PBAS papers)
@@ -138,6 +141,10 @@ protected:
     cv::Mat m_oUpdateRateFrame;
     //! defines whether or not the subtractor is fully initialized
     bool m_bInitialized;
+    //! seed used for internal random number generation (re-applied at each (re)initialization)
+    uint64_t m_nRandomSeed;
+    //! random number generator used for model init/update decisions
+    CxxUtils::FastRNG m_oRNG;
 };
 
 /*!
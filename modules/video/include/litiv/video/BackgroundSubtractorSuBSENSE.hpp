@@ -18,6 +18,7 @@
 #pragma once
 
 #include "litiv/video/BackgroundSubtractorLBSP.hpp"
+#include "litiv/utils/PlatformUtils.hpp"
 
 //! defines the default value for BackgroundSubtractorSuBSENSE::m_nDescDistThresholdOffset
 #define BGSSUBSENSE_DEFAULT_DESC_DIST_THRESHOLD_OFFSET (3)
@@ -67,8 +68,47 @@ public:
     void getBackgroundDescriptorsImage(cv::OutputArray backgroundDescImage) const override;
     //! returns the default learning rate value used in 'apply'
     virtual double getDefaultLearningRate() const override {return 0;}
+    //! sets the memory layout used for background samples storage (can be called before or after initialization)
+    void setSampleModelLayout(eSampleModelLayout eLayout);
+    //! sets the number of image rows per model tile in 'apply' (0 = single tile) and the number of threads used to process tiles (results do not depend on the latter)
+    void setParallelTiling(size_t nTileRows, size_t nWorkers);
+    //! toggles the AVX2 sample matcher in 'apply' (only used if supported by the CPU at runtime; results are identical to the scalar path)
+    void setVectorizedMatching(bool bEnabled);
 
 protected:
+    //! neighbor spread update which targets a pixel outside the source pixel's tile (applied once all tiles are processed)
+    struct DeferredNeighborUpdate {
+        //! index of the pixel whose latest color/desc values will be copied (via m_oLastColorFrame & m_oLastDescFrame)
+        size_t nSrcPxIdx;
+        //! index of the pixel whose model will be updated
+        size_t nDstPxIdx;
+        //! index of the model sample to overwrite
+        size_t nSampleIdx;
+        //! specifies whether the update only goes through if the target pixel is considered a ghost
+        bool bGhostCheck;
+    };
+    //! holds all tile-specific data used in 'apply'; each tile owns the models of a band of image rows
+    struct TileInfo {
+        //! first/last+1 image rows owned by this tile
+        int nRowBegin, nRowEnd;
+        //! first/last+1 model indexes (in m_vnPxIdxLUT) processed by this tile
+        size_t nModelIterBegin, nModelIterEnd;
+        //! number of non-zero descriptors found in this tile for the current frame
+        size_t nNonZeroDescCount;
+        //! list of spread updates targeting pixels owned by other tiles
+        std::vector<DeferredNeighborUpdate> voDeferredUpdates;
+        //! random number generator used for all model update decisions in this tile (seeded from the tile index)
+        CxxUtils::FastRNG oRNG;
+    };
+    //! (re)builds the tile list based on the current image size, ROI and tile row count
+    void initialize_tiles();
+    //! processes all pixels of the given tile for a 1-ch input image (called from 'apply', possibly from a worker thread)
+    void apply_internal_1ch(const cv::Mat& oInputImg, cv::Mat& oCurrFGMask, TileInfo& oTile, double learningRateOverride, float fRollAvgFactor_LT, float fRollAvgFactor_ST);
+    //! processes all pixels of the given tile for a 3-ch input image (called from 'apply', possibly from a worker thread)
+    void apply_internal_3ch(const cv::Mat& oInputImg, cv::Mat& oCurrFGMask, TileInfo& oTile, double learningRateOverride, float fRollAvgFactor_LT, float fRollAvgFactor_ST);
+    //! applies all deferred neighbor spread updates, in tile order (must be called once all tiles are processed)
+    void apply_deferred_updates();
+
     //! absolute minimal color distance threshold ('R' or 'radius' in the original ViBe paper, used as the default/initial 'R(x)' value here)
     const size_t m_nMinColorDistThreshold;
     //! absolute descriptor distance threshold offset
@@ -92,10 +132,8 @@ protected:
     //! specifies the downsampled frame size used for cam motion analysis
     cv::Size m_oDownSampledFrameSize;
 
-    //! background model pixel color intensity samples (equivalent to 'B(x)' in PBAS)
-    std::vector<cv::Mat> m_voBGColorSamples;
-    //! background model descriptors samples
-    std::vector<cv::Mat> m_voBGDescSamples;
+    //! background model pixel color intensity & descriptor samples (equivalent to 'B(x)' in PBAS)
+    BackgroundSampleModel m_oBGSamples;
 
     //! per-pixel update rates ('T(x)' in PBAS, which contains pixel-level 'sigmas', as referred to in ViBe)
     cv::Mat m_oUpdateRateFrame;
@@ -123,13 +161,20 @@ protected:
     cv::Mat m_oLastRawFGMask;
 
     //! pre-allocated CV_8UC1 matrices used to speed up morph ops
-    cv::Mat m_oFGMask_PreFlood;
-    cv::Mat m_oFGMask_FloodedHoles;
     cv::Mat m_oLastFGMask_dilated;
     cv::Mat m_oLastFGMask_dilated_inverted;
-    cv::Mat m_oCurrRawFGBlinkMask;
     cv::Mat m_oLastRawFGBlinkMask;
-    cv::Mat m_oMorphExStructElement;
+    //! fused post-processing stage used to produce the final foreground mask & blink map in 'apply'
+    ForegroundMaskPostProcessor m_oPostProcessor;
+
+    //! number of image rows per tile (0 = whole image in a single tile)
+    size_t m_nTileRows;
+    //! list of tiles used to split the model update work in 'apply'
+    std::vector<TileInfo> m_voTiles;
+    //! worker pool used to process tiles concurrently (null if processing on the calling thread only)
+    std::unique_ptr<PlatformUtils::DynamicWorkerPool> m_pWorkerPool;
+    //! specifies whether the AVX2 sample matcher is used in 'apply' instead of the scalar loops
+    bool m_bUsingVectorizedMatcher;
 };
 
 using BackgroundSubtractorSuBSENSE = BackgroundSubtractorSuBSENSE_<ParallelUtils::eNonParallel>;
@@ -36,6 +36,7 @@
 //
 // @@@@@@@@
 
+#include "litiv/utils/CxxUtils.hpp"
 #include <opencv2/video/background_segm.hpp>
 
 //! defines the default value for BackgroundSubtractorViBe::m_nColorDistThreshold
@@ -70,6 +71,8 @@ public:
     virtual void apply(cv::InputArray image, cv::OutputArray fgmask, double learningRate=BGSVIBE_DEFAULT_LEARNING_RATE) = 0;
     //! returns a copy of the latest reconstructed background image
     void getBackgroundImage(cv::OutputArray backgroundImage) const;
+    //! sets the seed used for all internal random number generation (takes effect at the next (re)initialization)
+    void setRandomSeed(uint64_t nSeed);
 
 protected:
     //! number of different samples per pixel/block to be taken from input frames to build the background model ('N' in the original ViBe paper)
@@ -84,6 +87,10 @@ protected:
     const size_t m_nColorDistThreshold;
     //! defines whether or not the subtractor is fully initialized
     bool m_bInitialized;
+    //! seed used for internal random number generation (re-applied at each (re)initialization)
+    uint64_t m_nRandomSeed;
+    //! random number generator used for model init/update decisions
+    CxxUtils::FastRNG m_oRNG;
 };
 
 /*!
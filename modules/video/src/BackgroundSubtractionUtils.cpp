@@ -51,6 +51,119 @@ cv::Mat IIBackgroundSubtractor::getROICopy() const {
     return m_oROI.clone();
 }
 
+void IIBackgroundSubtractor::setRandomSeed(uint64_t nSeed) {
+    m_nRandomSeed = nSeed;
+}
+
+IIBackgroundSubtractor::BatchStats IIBackgroundSubtractor::applyBatch(std::vector<BatchEntry>& voBatch, PlatformUtils::DynamicWorkerPool& oPool) {
+    // each stream (i.e. instance) keeps the ordered list of its batch entries; streams are owned by a single worker at a time
+    struct StreamInfo {
+        std::vector<size_t> vnEntryIdxs;
+        size_t nNextEntry;
+        double dTotLatency_ms;
+        BatchStreamStats oStats;
+    };
+    // each worker owns a queue of pending streams; it pops its own from the front, and steals the longest-idle stream (also at the front) of others
+    struct WorkerQueue {
+        std::mutex oMutex;
+        std::deque<size_t> qnStreamIdxs;
+    };
+    std::vector<StreamInfo> voStreams;
+    std::map<IIBackgroundSubtractor*,size_t> mStreamIdxMap;
+    for(size_t nEntryIdx=0; nEntryIdx<voBatch.size(); ++nEntryIdx) {
+        IIBackgroundSubtractor* pAlgo = voBatch[nEntryIdx].pAlgo;
+        CV_Assert(pAlgo!=nullptr && !voBatch[nEntryIdx].oInput.empty());
+        auto pStreamIter = mStreamIdxMap.find(pAlgo);
+        if(pStreamIter==mStreamIdxMap.end()) {
+            pStreamIter = mStreamIdxMap.insert(std::make_pair(pAlgo,voStreams.size())).first;
+            voStreams.emplace_back();
+            voStreams.back().nNextEntry = 0;
+            voStreams.back().dTotLatency_ms = 0.0;
+            voStreams.back().oStats = BatchStreamStats{pAlgo,0,0.0,0.0,0.0};
+        }
+        voStreams[pStreamIter->second].vnEntryIdxs.push_back(nEntryIdx);
+    }
+    BatchStats oBatchStats;
+    oBatchStats.nTotFrames = voBatch.size();
+    oBatchStats.nSteals = 0;
+    oBatchStats.dWallTime_ms = 0.0;
+    oBatchStats.dThroughput_fps = 0.0;
+    if(voBatch.empty())
+        return oBatchStats;
+    const size_t nWorkers = std::min(oPool.getWorkerCount(),voStreams.size());
+    std::vector<WorkerQueue> voQueues(nWorkers);
+    for(size_t nStreamIdx=0; nStreamIdx<voStreams.size(); ++nStreamIdx)
+        voQueues[nStreamIdx%nWorkers].qnStreamIdxs.push_back(nStreamIdx);
+    std::atomic_size_t nRemainingFrames(voBatch.size());
+    std::atomic_size_t nSteals(0);
+    std::atomic_bool bAbort(false);
+    const auto nBatchStartTime = std::chrono::high_resolution_clock::now();
+    const auto lWorker = [&](size_t nWorkerIdx) {
+        try {
+            while(nRemainingFrames>0 && !bAbort) {
+                size_t nStreamIdx = SIZE_MAX;
+                {
+                    std::mutex_lock_guard oLock(voQueues[nWorkerIdx].oMutex);
+                    if(!voQueues[nWorkerIdx].qnStreamIdxs.empty()) {
+                        nStreamIdx = voQueues[nWorkerIdx].qnStreamIdxs.front();
+                        voQueues[nWorkerIdx].qnStreamIdxs.pop_front();
+                    }
+                }
+                for(size_t nOffset=1; nStreamIdx==SIZE_MAX && nOffset<nWorkers; ++nOffset) {
+                    WorkerQueue& oVictimQueue = voQueues[(nWorkerIdx+nOffset)%nWorkers];
+                    std::mutex_lock_guard oLock(oVictimQueue.oMutex);
+                    if(!oVictimQueue.qnStreamIdxs.empty()) {
+                        nStreamIdx = oVictimQueue.qnStreamIdxs.front();
+                        oVictimQueue.qnStreamIdxs.pop_front();
+                        ++nSteals;
+                    }
+                }
+                if(nStreamIdx==SIZE_MAX) {
+                    // all remaining streams are held by other workers, and streams are only ever requeued by the worker holding them,
+                    // so no work can reach this worker anymore
+                    return;
+                }
+                StreamInfo& oStream = voStreams[nStreamIdx];
+                BatchEntry& oEntry = voBatch[oStream.vnEntryIdxs[oStream.nNextEntry++]];
+                const double dLearningRate = oEntry.dLearningRate<0?oEntry.pAlgo->getDefaultLearningRate():oEntry.dLearningRate;
+                const auto nFrameStartTime = std::chrono::high_resolution_clock::now();
+                oEntry.pAlgo->apply(oEntry.oInput,oEntry.oFGMask,dLearningRate);
+                const auto nFrameEndTime = std::chrono::high_resolution_clock::now();
+                const double dLatency_ms = std::chrono::duration<double,std::milli>(nFrameEndTime-nFrameStartTime).count();
+                oStream.dTotLatency_ms += dLatency_ms;
+                oStream.oStats.dMaxLatency_ms = std::max(oStream.oStats.dMaxLatency_ms,dLatency_ms);
+                ++oStream.oStats.nFrames;
+                oStream.oStats.dCompletionTime_ms = std::chrono::duration<double,std::milli>(nFrameEndTime-nBatchStartTime).count();
+                if(oStream.nNextEntry<oStream.vnEntryIdxs.size()) {
+                    // requeue on this worker to keep the stream's model hot in its cache (others may still steal it)
+                    std::mutex_lock_guard oLock(voQueues[nWorkerIdx].oMutex);
+                    voQueues[nWorkerIdx].qnStreamIdxs.push_back(nStreamIdx);
+                }
+                --nRemainingFrames;
+            }
+        }
+        catch(...) {
+            bAbort = true;
+            throw;
+        }
+    };
+    std::vector<std::future<void>> voWorkerRes;
+    for(size_t nWorkerIdx=0; nWorkerIdx<nWorkers; ++nWorkerIdx)
+        voWorkerRes.emplace_back(oPool.queueTask(lWorker,nWorkerIdx));
+    for(std::future<void>& oRes : voWorkerRes)
+        oRes.wait(); // all workers must be done with the local state before any exception is propagated
+    for(std::future<void>& oRes : voWorkerRes)
+        oRes.get(); // will rethrow any exception caught in the worker
+    oBatchStats.dWallTime_ms = std::chrono::duration<double,std::milli>(std::chrono::high_resolution_clock::now()-nBatchStartTime).count();
+    oBatchStats.dThroughput_fps = oBatchStats.dWallTime_ms>0?(oBatchStats.nTotFrames*1000.0/oBatchStats.dWallTime_ms):0.0;
+    oBatchStats.nSteals = nSteals;
+    for(StreamInfo& oStream : voStreams) {
+        oStream.oStats.dMeanLatency_ms = oStream.dTotLatency_ms/std::max(oStream.oStats.nFrames,size_t(1));
+        oBatchStats.voStreams.push_back(oStream.oStats);
+    }
+    return oBatchStats;
+}
+
 IIBackgroundSubtractor::IIBackgroundSubtractor() :
         m_nROIBorderSize(0),
         m_nImgChannels(0),
@@ -65,7 +178,8 @@ IIBackgroundSubtractor::IIBackgroundSubtractor() :
         m_bInitialized(false),
         m_bModelInitialized(false),
         m_bAutoModelResetEnabled(true),
-        m_bUsingMovingCamera(false) {}
+        m_bUsingMovingCamera(false),
+        m_nRandomSeed(0) {}
 
 void IIBackgroundSubtractor::initialize_common(const cv::Mat& oInitImg, const cv::Mat& oROI) {
     CV_Assert(!oInitImg.empty() && oInitImg.cols>0 && oInitImg.rows>0);
@@ -112,6 +226,7 @@ void IIBackgroundSubtractor::initialize_common(const cv::Mat& oInitImg, const cv
     m_nFrameIdx = 0;
     m_nFramesSinceLastReset = 0;
     m_nModelResetCooldown = 0;
+    m_oRNG.seed(m_nRandomSeed);
     m_oLastFGMask.create(m_oImgSize,CV_8UC1);
     m_oLastFGMask = cv::Scalar_<uchar>(0);
     m_oLastColorFrame.create(m_oImgSize,CV_8UC((int)m_nImgChannels));
@@ -152,6 +267,247 @@ void IIBackgroundSubtractor::initialize_common(const cv::Mat& oInitImg, const cv
     }
 }
 
+BackgroundSampleModel::BackgroundSampleModel(eSampleModelLayout eLayout) :
+        m_eLayout(eLayout),
+        m_nChannels(0),
+        m_nSamples(0),
+        m_nPxBlockSize(0),
+        m_nColorSampleStep(0),
+        m_nColorPxStep(0),
+        m_nColorChStep(0),
+        m_nDescSampleStep(0),
+        m_nDescPxStep(0),
+        m_nDescChStep(0),
+        m_pColorData(nullptr),
+        m_pDescData(nullptr) {}
+
+void BackgroundSampleModel::initialize(const cv::Size& oImgSize, size_t nChannels, size_t nSamples) {
+    CV_Assert(oImgSize.area()>0 && nChannels>0 && nSamples>0);
+    m_oImgSize = oImgSize;
+    m_nChannels = nChannels;
+    m_nSamples = nSamples;
+    const size_t nPxCount = (size_t)m_oImgSize.area();
+    if(m_eLayout==eSampleModelLayout_Interleaved) {
+        // each px block contains all desc samples (channel by channel) followed by all color samples, padded to a full cache line
+        const size_t nRawBlockSize = m_nSamples*m_nChannels*(sizeof(ushort)+sizeof(uchar));
+        m_nPxBlockSize = ((nRawBlockSize+63)/64)*64;
+        m_vData.assign(m_nPxBlockSize*nPxCount,0);
+    }
+    else { //m_eLayout==eSampleModelLayout_Planar
+        // all color sample planes are followed by all desc sample planes (aligned on a cache line boundary)
+        const size_t nColorDataSize = ((m_nSamples*nPxCount*m_nChannels+63)/64)*64;
+        m_nPxBlockSize = 0;
+        m_vData.assign(nColorDataSize+m_nSamples*nPxCount*m_nChannels*sizeof(ushort),0);
+    }
+    updateSteps();
+}
+
+void BackgroundSampleModel::updateSteps() {
+    const size_t nPxCount = (size_t)m_oImgSize.area();
+    if(m_eLayout==eSampleModelLayout_Interleaved) {
+        static_assert(sizeof(ushort)==2,"bad assumption on desc sample size");
+        m_pDescData = (ushort*)m_vData.data();
+        m_pColorData = m_vData.data()+m_nSamples*m_nChannels*sizeof(ushort);
+        m_nDescSampleStep = m_nColorSampleStep = 1;
+        m_nDescChStep = m_nColorChStep = m_nSamples;
+        m_nDescPxStep = m_nPxBlockSize/sizeof(ushort);
+        m_nColorPxStep = m_nPxBlockSize;
+    }
+    else { //m_eLayout==eSampleModelLayout_Planar
+        m_pColorData = m_vData.data();
+        m_pDescData = (ushort*)(m_vData.data()+((m_nSamples*nPxCount*m_nChannels+63)/64)*64);
+        m_nDescSampleStep = m_nColorSampleStep = nPxCount*m_nChannels;
+        m_nDescPxStep = m_nColorPxStep = m_nChannels;
+        m_nDescChStep = m_nColorChStep = 1;
+    }
+}
+
+void BackgroundSampleModel::setLayout(eSampleModelLayout eLayout) {
+    if(eLayout==m_eLayout)
+        return;
+    if(empty()) {
+        m_eLayout = eLayout;
+        return;
+    }
+    const size_t nPxCount = (size_t)m_oImgSize.area();
+    std::aligned_vector<uchar,64> vOldData(std::move(m_vData));
+    const uchar* const pOldColorData = m_pColorData;
+    const ushort* const pOldDescData = m_pDescData;
+    const size_t nOldColorSampleStep=m_nColorSampleStep, nOldColorPxStep=m_nColorPxStep, nOldColorChStep=m_nColorChStep;
+    const size_t nOldDescSampleStep=m_nDescSampleStep, nOldDescPxStep=m_nDescPxStep, nOldDescChStep=m_nDescChStep;
+    m_eLayout = eLayout;
+    initialize(m_oImgSize,m_nChannels,m_nSamples);
+    for(size_t nPxIdx=0; nPxIdx<nPxCount; ++nPxIdx) {
+        for(size_t nSampleIdx=0; nSampleIdx<m_nSamples; ++nSampleIdx) {
+            for(size_t c=0; c<m_nChannels; ++c) {
+                getColor(nSampleIdx,nPxIdx,c) = pOldColorData[nSampleIdx*nOldColorSampleStep+nPxIdx*nOldColorPxStep+c*nOldColorChStep];
+                getDesc(nSampleIdx,nPxIdx,c) = pOldDescData[nSampleIdx*nOldDescSampleStep+nPxIdx*nOldDescPxStep+c*nOldDescChStep];
+            }
+        }
+    }
+}
+
+//! gathers pointers to all rows within [nRowIdx-nRadius,nRowIdx+nRadius] (out-of-image rows are skipped, as with OpenCV's default morph borders)
+template<typename TRowPtrFunc>
+static inline size_t gatherMorphRows(int nRowIdx, int nRadius, int nRows, TRowPtrFunc lRowPtr, const uchar** ppRows) {
+    size_t nRowCount = 0;
+    for(int nCurrRowIdx=std::max(nRowIdx-nRadius,0); nCurrRowIdx<=std::min(nRowIdx+nRadius,nRows-1); ++nCurrRowIdx)
+        ppRows[nRowCount++] = lRowPtr(nCurrRowIdx);
+    return nRowCount;
+}
+
+//! computes the per-column min (or max) of the given rows (vertical part of a separable rect erosion/dilation)
+template<bool bMax>
+static inline void reduceMorphRows(const uchar* const* ppRows, size_t nRowCount, int nCols, uchar* pDst) {
+    std::copy(ppRows[0],ppRows[0]+nCols,pDst);
+    for(size_t nRowIdx=1; nRowIdx<nRowCount; ++nRowIdx)
+        for(int nColIdx=0; nColIdx<nCols; ++nColIdx)
+            pDst[nColIdx] = bMax?std::max(pDst[nColIdx],ppRows[nRowIdx][nColIdx]):std::min(pDst[nColIdx],ppRows[nRowIdx][nColIdx]);
+}
+
+//! computes the min (or max) of each [x-nRadius,x+nRadius] window of a row (horizontal part of a separable rect erosion/dilation)
+template<bool bMax>
+static inline void filterMorphRow(const uchar* pSrc, int nCols, int nRadius, uchar* pDst) {
+    for(int nColIdx=0; nColIdx<nCols; ++nColIdx) {
+        const int nBeginIdx = std::max(nColIdx-nRadius,0), nEndIdx = std::min(nColIdx+nRadius+1,nCols);
+        uchar nVal = pSrc[nBeginIdx];
+        for(int nIdx=nBeginIdx+1; nIdx<nEndIdx; ++nIdx)
+            nVal = bMax?std::max(nVal,pSrc[nIdx]):std::min(nVal,pSrc[nIdx]);
+        pDst[nColIdx] = nVal;
+    }
+}
+
+void ForegroundMaskPostProcessor::initialize(const cv::Size& oImgSize) {
+    CV_Assert(oImgSize.area()>0);
+    m_oImgSize = oImgSize;
+    m_oFGMask_PreFlood.create(m_oImgSize,CV_8UC1);
+    m_oFGMask_PreFlood = cv::Scalar_<uchar>(0);
+    m_vDilatedRows.resize(size_t(m_oImgSize.width)*3);
+    m_vCombinedRow.resize(size_t(m_oImgSize.width));
+    m_vTempRow.resize(size_t(m_oImgSize.width));
+    m_vnRowRunOffsets.assign(size_t(m_oImgSize.height)+1,0);
+    m_voZeroRuns.clear();
+    m_vnRunParents.clear();
+}
+
+void ForegroundMaskPostProcessor::label_zero_runs(int nRowIdx) {
+    const uchar* pClosedRow = m_oFGMask_PreFlood.ptr<uchar>(nRowIdx);
+    const int nCols = m_oImgSize.width;
+    const size_t nPrevRowRunEnd = m_vnRowRunOffsets[nRowIdx];
+    size_t nPrevRowRunIdx = nRowIdx>0?m_vnRowRunOffsets[nRowIdx-1]:nPrevRowRunEnd;
+    for(int nColIdx=0; nColIdx<nCols;) {
+        if(pClosedRow[nColIdx]) {
+            ++nColIdx;
+            continue;
+        }
+        const int nRunBegin = nColIdx;
+        while(nColIdx<nCols && !pClosedRow[nColIdx])
+            ++nColIdx;
+        const size_t nRunIdx = m_voZeroRuns.size();
+        m_voZeroRuns.push_back(ZeroRun{nRunBegin,nColIdx});
+        m_vnRunParents.push_back(nRunIdx);
+        // 4-connectivity (as in cv::floodFill's default): runs of the previous row sharing at least one column are merged
+        while(nPrevRowRunIdx<nPrevRowRunEnd && m_voZeroRuns[nPrevRowRunIdx].nEnd<=nRunBegin)
+            ++nPrevRowRunIdx;
+        for(size_t nOverlapRunIdx=nPrevRowRunIdx; nOverlapRunIdx<nPrevRowRunEnd && m_voZeroRuns[nOverlapRunIdx].nBegin<nColIdx; ++nOverlapRunIdx) {
+            const size_t nRootA = find_root(nOverlapRunIdx), nRootB = find_root(nRunIdx);
+            if(nRootA!=nRootB)
+                m_vnRunParents[std::max(nRootA,nRootB)] = std::min(nRootA,nRootB);
+        }
+    }
+    m_vnRowRunOffsets[nRowIdx+1] = m_voZeroRuns.size();
+}
+
+size_t ForegroundMaskPostProcessor::find_root(size_t nRunIdx) {
+    while(m_vnRunParents[nRunIdx]!=nRunIdx) {
+        m_vnRunParents[nRunIdx] = m_vnRunParents[m_vnRunParents[nRunIdx]]; // path halving
+        nRunIdx = m_vnRunParents[nRunIdx];
+    }
+    return nRunIdx;
+}
+
+void ForegroundMaskPostProcessor::apply(const cv::Mat& oRawFGMask, int nMedianBlurKernelSize, cv::Mat& oLastRawFGMask, cv::Mat& oLastRawFGBlinkMask, cv::Mat& oBlinksFrame,
+                                        cv::Mat& oFGMask, cv::Mat& oFGMask_dilated, cv::Mat& oFGMask_dilated_inverted) {
+    CV_Assert(!m_oFGMask_PreFlood.empty() && nMedianBlurKernelSize>0 && (nMedianBlurKernelSize%2)==1 && nMedianBlurKernelSize<64);
+    CV_Assert(oRawFGMask.size()==m_oImgSize && oRawFGMask.type()==CV_8UC1);
+    CV_Assert(oLastRawFGMask.size()==m_oImgSize && oLastRawFGMask.type()==CV_8UC1);
+    CV_Assert(oLastRawFGBlinkMask.size()==m_oImgSize && oLastRawFGBlinkMask.type()==CV_8UC1);
+    CV_Assert(oBlinksFrame.size()==m_oImgSize && oBlinksFrame.type()==CV_8UC1);
+    CV_Assert(oFGMask_dilated_inverted.size()==m_oImgSize && oFGMask_dilated_inverted.type()==CV_8UC1);
+    CV_Assert(oFGMask.data!=oRawFGMask.data);
+    oFGMask.create(m_oImgSize,CV_8UC1);
+    oFGMask_dilated.create(m_oImgSize,CV_8UC1);
+    const int nRows = m_oImgSize.height, nCols = m_oImgSize.width;
+    std::array<const uchar*,7> apRows;
+    // pass #1: blink maps update, 3x3 closing (dilation of row y, then erosion of row y-1) & zero run labelling of the closed mask
+    m_voZeroRuns.clear();
+    m_vnRunParents.clear();
+    const auto lRawRowPtr = [&](int nRowIdx) {return oRawFGMask.ptr<uchar>(nRowIdx);};
+    const auto lDilatedRowPtr = [&](int nRowIdx) {return (const uchar*)&m_vDilatedRows[(nRowIdx%3)*nCols];};
+    for(int nRowIdx=0; nRowIdx<=nRows; ++nRowIdx) {
+        if(nRowIdx<nRows) {
+            const uchar* pRawRow = oRawFGMask.ptr<uchar>(nRowIdx);
+            uchar* pLastRawRow = oLastRawFGMask.ptr<uchar>(nRowIdx);
+            uchar* pLastRawBlinkRow = oLastRawFGBlinkMask.ptr<uchar>(nRowIdx);
+            uchar* pBlinksRow = oBlinksFrame.ptr<uchar>(nRowIdx);
+            for(int nColIdx=0; nColIdx<nCols; ++nColIdx) {
+                const uchar nCurrRawBlink = pRawRow[nColIdx]^pLastRawRow[nColIdx];
+                pBlinksRow[nColIdx] = nCurrRawBlink|pLastRawBlinkRow[nColIdx];
+                pLastRawBlinkRow[nColIdx] = nCurrRawBlink;
+                pLastRawRow[nColIdx] = pRawRow[nColIdx];
+            }
+            const size_t nRowCount = gatherMorphRows(nRowIdx,1,nRows,lRawRowPtr,apRows.data());
+            reduceMorphRows<true>(apRows.data(),nRowCount,nCols,m_vTempRow.data());
+            filterMorphRow<true>(m_vTempRow.data(),nCols,1,&m_vDilatedRows[(nRowIdx%3)*nCols]);
+        }
+        const int nClosedRowIdx = nRowIdx-1;
+        if(nClosedRowIdx>=0) {
+            const size_t nRowCount = gatherMorphRows(nClosedRowIdx,1,nRows,lDilatedRowPtr,apRows.data());
+            reduceMorphRows<false>(apRows.data(),nRowCount,nCols,m_vTempRow.data());
+            filterMorphRow<false>(m_vTempRow.data(),nCols,1,m_oFGMask_PreFlood.ptr<uchar>(nClosedRowIdx));
+            label_zero_runs(nClosedRowIdx);
+        }
+    }
+    // cv::floodFill from (0,0) only reaches the background component touching that pixel; if it is foreground, all zero runs are holes
+    const size_t nBorderRootIdx = m_oFGMask_PreFlood.at<uchar>(0,0)?SIZE_MAX:find_root(0);
+    // pass #2: combination of raw mask, holes & 7x7 eroded closed mask in row y, median blur up to row y-r, and 7x7 dilation up to row y-r-3
+    m_oMedianBlur.reset(m_oImgSize,nMedianBlurKernelSize);
+    const auto lClosedRowPtr = [&](int nRowIdx) {return (const uchar*)m_oFGMask_PreFlood.ptr<uchar>(nRowIdx);};
+    const auto lFGMaskRowPtr = [&](int nRowIdx) {return (const uchar*)oFGMask.ptr<uchar>(nRowIdx);};
+    int nMedianRowCount = 0, nDilatedRowCount = 0;
+    for(int nRowIdx=0; nRowIdx<nRows; ++nRowIdx) {
+        uchar* pCombinedRow = m_vCombinedRow.data();
+        const size_t nRowCount = gatherMorphRows(nRowIdx,3,nRows,lClosedRowPtr,apRows.data());
+        reduceMorphRows<false>(apRows.data(),nRowCount,nCols,m_vTempRow.data());
+        filterMorphRow<false>(m_vTempRow.data(),nCols,3,pCombinedRow);
+        const uchar* pRawRow = oRawFGMask.ptr<uchar>(nRowIdx);
+        for(int nColIdx=0; nColIdx<nCols; ++nColIdx)
+            pCombinedRow[nColIdx] |= pRawRow[nColIdx];
+        for(size_t nRunIdx=m_vnRowRunOffsets[nRowIdx]; nRunIdx<m_vnRowRunOffsets[nRowIdx+1]; ++nRunIdx)
+            if(find_root(nRunIdx)!=nBorderRootIdx)
+                std::fill(pCombinedRow+m_voZeroRuns[nRunIdx].nBegin,pCombinedRow+m_voZeroRuns[nRunIdx].nEnd,UCHAR_MAX);
+        m_oMedianBlur.pushRow(pCombinedRow);
+        while(nMedianRowCount<nRows && m_oMedianBlur.popRow(oFGMask.ptr<uchar>(nMedianRowCount)))
+            ++nMedianRowCount;
+        while(nDilatedRowCount<nRows && (nDilatedRowCount+3<nMedianRowCount || nMedianRowCount==nRows)) {
+            uchar* pDilatedRow = oFGMask_dilated.ptr<uchar>(nDilatedRowCount);
+            const size_t nWindowRowCount = gatherMorphRows(nDilatedRowCount,3,nRows,lFGMaskRowPtr,apRows.data());
+            reduceMorphRows<true>(apRows.data(),nWindowRowCount,nCols,m_vTempRow.data());
+            filterMorphRow<true>(m_vTempRow.data(),nCols,3,pDilatedRow);
+            uchar* pDilatedInvRow = oFGMask_dilated_inverted.ptr<uchar>(nDilatedRowCount);
+            uchar* pBlinksRow = oBlinksFrame.ptr<uchar>(nDilatedRowCount);
+            for(int nColIdx=0; nColIdx<nCols; ++nColIdx) {
+                // blinks are masked by both the previous and the new dilated masks
+                pBlinksRow[nColIdx] &= pDilatedInvRow[nColIdx];
+                pDilatedInvRow[nColIdx] = (uchar)~pDilatedRow[nColIdx];
+                pBlinksRow[nColIdx] &= pDilatedInvRow[nColIdx];
+            }
+            ++nDilatedRowCount;
+        }
+    }
+    CV_Assert(nMedianRowCount==nRows && nDilatedRowCount==nRows);
+}
+
 #if HAVE_GLSL
 
 IBackgroundSubtractor_GLSL::IBackgroundSubtractor_(size_t nLevels, size_t nComputeStages, size_t nExtraSSBOs, size_t nExtraACBOs,
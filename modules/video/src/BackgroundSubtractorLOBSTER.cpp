@@ -49,7 +49,7 @@ void BackgroundSubtractorLOBSTER_GLSL::refreshModel(float fSamplesRefreshFrac, b
     CV_Assert(m_bInitialized);
     CV_Assert(fSamplesRefreshFrac>0.0f && fSamplesRefreshFrac<=1.0f);
     const size_t nModelSamplesToRefresh = fSamplesRefreshFrac<1.0f?(size_t)(fSamplesRefreshFrac*m_nBGSamples):m_nBGSamples;
-    const size_t nRefreshSampleStartPos = fSamplesRefreshFrac<1.0f?rand()%m_nBGSamples:0;
+    const size_t nRefreshSampleStartPos = fSamplesRefreshFrac<1.0f?m_oRNG()%m_nBGSamples:0;
     if(!bForceFGUpdate)
         getLatestForegroundMask(m_oLastFGMask);
     glBindBuffer(GL_SHADER_STORAGE_BUFFER,getSSBOId(BackgroundSubtractorLOBSTER_::eLOBSTERStorageBuffer_BGModelBinding));
@@ -62,7 +62,7 @@ void BackgroundSubtractorLOBSTER_GLSL::refreshModel(float fSamplesRefreshFrac, b
             if(bForceFGUpdate || !m_oLastFGMask.data[nColOffset]) {
                 for(size_t nCurrModelSampleIdx=nRefreshSampleStartPos; nCurrModelSampleIdx<nRefreshSampleStartPos+nModelSamplesToRefresh; ++nCurrModelSampleIdx) {
                     int nSampleRowIdx, nSampleColIdx;
-                    cv::getRandSamplePosition_7x7_std2(nSampleColIdx,nSampleRowIdx,(int)nColIdx,(int)nRowIdx,(int)LBSP::PATCH_SIZE/2,m_oFrameSize);
+                    cv::getRandSamplePosition_7x7_std2(nSampleColIdx,nSampleRowIdx,(int)nColIdx,(int)nRowIdx,(int)LBSP::PATCH_SIZE/2,m_oFrameSize,m_oRNG);
                     const size_t nSamplePxIdx = nSampleColIdx + nSampleRowIdx*m_oFrameSize.width;
                     if(bForceFGUpdate || !m_oLastFGMask.data[nSamplePxIdx]) {
                         const size_t nCurrRealModelSampleIdx = nCurrModelSampleIdx%m_nBGSamples;
@@ -413,25 +413,25 @@ void BackgroundSubtractorLOBSTER::refreshModel(float fSamplesRefreshFrac, bool b
     CV_Assert(m_bInitialized);
     CV_Assert(fSamplesRefreshFrac>0.0f && fSamplesRefreshFrac<=1.0f);
     const size_t nModelSamplesToRefresh = fSamplesRefreshFrac<1.0f?(size_t)(fSamplesRefreshFrac*m_nBGSamples):m_nBGSamples;
-    const size_t nRefreshSampleStartPos = fSamplesRefreshFrac<1.0f?rand()%m_nBGSamples:0;
+    const size_t nRefreshSampleStartPos = fSamplesRefreshFrac<1.0f?m_oRNG()%m_nBGSamples:0;
     for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
         const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
         if(bForceFGUpdate || !m_oLastFGMask.data[nPxIter]) {
             for(size_t nCurrModelSampleIdx=nRefreshSampleStartPos; nCurrModelSampleIdx<nRefreshSampleStartPos+nModelSamplesToRefresh; ++nCurrModelSampleIdx) {
                 int nSampleImgCoord_Y, nSampleImgCoord_X;
-                cv::getRandSamplePosition_7x7_std2(nSampleImgCoord_X,nSampleImgCoord_Y,m_voPxInfoLUT[nPxIter].nImgCoord_X,m_voPxInfoLUT[nPxIter].nImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
+                cv::getRandSamplePosition_7x7_std2(nSampleImgCoord_X,nSampleImgCoord_Y,m_voPxInfoLUT[nPxIter].nImgCoord_X,m_voPxInfoLUT[nPxIter].nImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,m_oRNG);
                 const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
                 if(bForceFGUpdate || !m_oLastFGMask.data[nSamplePxIdx]) {
                     const size_t nCurrRealModelSampleIdx = nCurrModelSampleIdx%m_nBGSamples;
                     for(size_t c=0; c<m_nImgChannels; ++c) {
-                        m_voBGColorSamples[nCurrRealModelSampleIdx].data[nPxIter*m_nImgChannels+c] = m_oLastColorFrame.data[nSamplePxIdx*m_nImgChannels+c];
+                        m_oBGSamples.getColor(nCurrRealModelSampleIdx,nPxIter,c) = m_oLastColorFrame.data[nSamplePxIdx*m_nImgChannels+c];
                         if(m_nImgChannels==1)
                             LBSP::computeDescriptor<1>(m_oLastColorFrame,m_oLastColorFrame.data[nSamplePxIdx*m_nImgChannels+c],nSampleImgCoord_X,nSampleImgCoord_Y,0,m_anLBSPThreshold_8bitLUT[m_oLastColorFrame.data[nSamplePxIdx*m_nImgChannels+c]],*((ushort*)(m_oLastDescFrame.data+(nSamplePxIdx*m_nImgChannels+c)*2)));
                         else if(m_nImgChannels==3)
                             LBSP::computeDescriptor<3>(m_oLastColorFrame,m_oLastColorFrame.data[nSamplePxIdx*m_nImgChannels+c],nSampleImgCoord_X,nSampleImgCoord_Y,c,m_anLBSPThreshold_8bitLUT[m_oLastColorFrame.data[nSamplePxIdx*m_nImgChannels+c]],*((ushort*)(m_oLastDescFrame.data+(nSamplePxIdx*m_nImgChannels+c)*2)));
                         else //m_nImgChannels==4
                             LBSP::computeDescriptor<4>(m_oLastColorFrame,m_oLastColorFrame.data[nSamplePxIdx*m_nImgChannels+c],nSampleImgCoord_X,nSampleImgCoord_Y,c,m_anLBSPThreshold_8bitLUT[m_oLastColorFrame.data[nSamplePxIdx*m_nImgChannels+c]],*((ushort*)(m_oLastDescFrame.data+(nSamplePxIdx*m_nImgChannels+c)*2)));
-                        *((ushort*)(m_voBGDescSamples[nCurrRealModelSampleIdx].data+(nPxIter*m_nImgChannels+c)*2)) = *((ushort*)(m_oLastDescFrame.data+(nSamplePxIdx*m_nImgChannels+c)*2));
+                        m_oBGSamples.getDesc(nCurrRealModelSampleIdx,nPxIter,c) = *((ushort*)(m_oLastDescFrame.data+(nSamplePxIdx*m_nImgChannels+c)*2));
                     }
                 }
             }
@@ -443,14 +443,7 @@ void BackgroundSubtractorLOBSTER::initialize(const cv::Mat& oInitImg, const cv::
     lvDbgExceptionWatch;
     // == init
     IBackgroundSubtractorLBSP::initialize_common(oInitImg,oROI);
-    m_voBGColorSamples.resize(m_nBGSamples);
-    m_voBGDescSamples.resize(m_nBGSamples);
-    for(size_t s=0; s<m_nBGSamples; ++s) {
-        m_voBGColorSamples[s].create(m_oImgSize,CV_8UC((int)m_nImgChannels));
-        m_voBGColorSamples[s] = cv::Scalar_<uchar>::all(0);
-        m_voBGDescSamples[s].create(m_oImgSize,CV_16UC((int)m_nImgChannels));
-        m_voBGDescSamples[s] = cv::Scalar_<ushort>::all(0);
-    }
+    m_oBGSamples.initialize(m_oImgSize,m_nImgChannels,m_nBGSamples);
     m_bInitialized = true;
     refreshModel(1.0f,true);
     m_bModelInitialized = true;
@@ -471,7 +464,6 @@ void BackgroundSubtractorLOBSTER::apply(cv::InputArray _oInputImg, cv::OutputArr
     if(m_nImgChannels==1) {
         for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
             const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
-            const size_t nDescIter = nPxIter*2;
             const int nCurrImgCoord_X = m_voPxInfoLUT[nPxIter].nImgCoord_X;
             const int nCurrImgCoord_Y = m_voPxInfoLUT[nPxIter].nImgCoord_Y;
             const uchar nCurrColor = oInputImg.data[nPxIter];
@@ -479,13 +471,13 @@ void BackgroundSubtractorLOBSTER::apply(cv::InputArray _oInputImg, cv::OutputArr
             LBSP::computeDescriptor_lookup<1>(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,0,anLBSPLookupVals);
             size_t nGoodSamplesCount=0, nModelIdx=0;
             while(nGoodSamplesCount<m_nRequiredBGSamples && nModelIdx<m_nBGSamples) {
-                const uchar nBGColor = m_voBGColorSamples[nModelIdx].data[nPxIter];
+                const uchar nBGColor = m_oBGSamples.getColor(nModelIdx,nPxIter);
                 {
                     const size_t nColorDist = DistanceUtils::L1dist(nCurrColor,nBGColor);
                     if(nColorDist>m_nColorDistThreshold/2)
                         goto failedcheck1ch;
                     const ushort nCurrInputDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nBGColor,m_anLBSPThreshold_8bitLUT[nBGColor]);
-                    const size_t nDescDist = DistanceUtils::hdist(nCurrInputDesc,*((ushort*)(m_voBGDescSamples[nModelIdx].data+nDescIter)));
+                    const size_t nDescDist = DistanceUtils::hdist(nCurrInputDesc,m_oBGSamples.getDesc(nModelIdx,nPxIter));
                     if(nDescDist>m_nDescDistThreshold)
                         goto failedcheck1ch;
                     nGoodSamplesCount++;
@@ -496,19 +488,18 @@ void BackgroundSubtractorLOBSTER::apply(cv::InputArray _oInputImg, cv::OutputArr
             if(nGoodSamplesCount<m_nRequiredBGSamples)
                 oCurrFGMask.data[nPxIter] = UCHAR_MAX;
             else {
-                if((rand()%nLearningRate)==0) {
-                    const size_t nSampleModelIdx = rand()%m_nBGSamples;
-                    ushort& nRandInputDesc = *((ushort*)(m_voBGDescSamples[nSampleModelIdx].data+nDescIter));
-                    nRandInputDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
-                    m_voBGColorSamples[nSampleModelIdx].data[nPxIter] = nCurrColor;
+                if((m_oRNG()%nLearningRate)==0) {
+                    const size_t nSampleModelIdx = m_oRNG()%m_nBGSamples;
+                    m_oBGSamples.getDesc(nSampleModelIdx,nPxIter) = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
+                    m_oBGSamples.getColor(nSampleModelIdx,nPxIter) = nCurrColor;
                 }
-                if((rand()%nLearningRate)==0) {
+                if((m_oRNG()%nLearningRate)==0) {
                     int nSampleImgCoord_Y, nSampleImgCoord_X;
-                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                    const size_t nSampleModelIdx = rand()%m_nBGSamples;
-                    ushort& nRandInputDesc = m_voBGDescSamples[nSampleModelIdx].at<ushort>(nSampleImgCoord_Y,nSampleImgCoord_X);
-                    nRandInputDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
-                    m_voBGColorSamples[nSampleModelIdx].at<uchar>(nSampleImgCoord_Y,nSampleImgCoord_X) = nCurrColor;
+                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,m_oRNG);
+                    const size_t nSampleModelIdx = m_oRNG()%m_nBGSamples;
+                    const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
+                    m_oBGSamples.getDesc(nSampleModelIdx,nSamplePxIdx) = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
+                    m_oBGSamples.getColor(nSampleModelIdx,nSamplePxIdx) = nCurrColor;
                 }
             }
         }
@@ -518,29 +509,25 @@ void BackgroundSubtractorLOBSTER::apply(cv::InputArray _oInputImg, cv::OutputArr
         const size_t nCurrColorDistThreshold = m_nColorDistThreshold*3;
         const size_t nCurrSCDescDistThreshold = nCurrDescDistThreshold/2;
         const size_t nCurrSCColorDistThreshold = nCurrColorDistThreshold/2;
-        const size_t desc_row_step = m_voBGDescSamples[0].step.p[0];
-        const size_t img_row_step = m_voBGColorSamples[0].step.p[0];
         for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
             const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
             const int nCurrImgCoord_X = m_voPxInfoLUT[nPxIter].nImgCoord_X;
             const int nCurrImgCoord_Y = m_voPxInfoLUT[nPxIter].nImgCoord_Y;
             const size_t nPxIterRGB = nPxIter*3;
-            const size_t nDescIterRGB = nPxIterRGB*2;
             const uchar* const anCurrColor = oInputImg.data+nPxIterRGB;
             alignas(16) std::array<std::array<uchar,LBSP::DESC_SIZE_BITS>,3> aanLBSPLookupVals;
             LBSP::computeDescriptor_lookup(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,aanLBSPLookupVals);
             size_t nGoodSamplesCount=0, nModelIdx=0;
             while(nGoodSamplesCount<m_nRequiredBGSamples && nModelIdx<m_nBGSamples) {
-                const ushort* const anBGDesc = (ushort*)(m_voBGDescSamples[nModelIdx].data+nDescIterRGB);
-                const uchar* const anBGColor = m_voBGColorSamples[nModelIdx].data+nPxIterRGB;
                 size_t nTotColorDist = 0;
                 size_t nTotDescDist = 0;
                 for(size_t c=0;c<3; ++c) {
-                    const size_t nColorDist = DistanceUtils::L1dist(anCurrColor[c],anBGColor[c]);
+                    const uchar nBGColor = m_oBGSamples.getColor(nModelIdx,nPxIter,c);
+                    const size_t nColorDist = DistanceUtils::L1dist(anCurrColor[c],nBGColor);
                     if(nColorDist>nCurrSCColorDistThreshold)
                         goto failedcheck3ch;
-                    const ushort nCurrInputDesc = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anBGColor[c],m_anLBSPThreshold_8bitLUT[anBGColor[c]]);
-                    const size_t nDescDist = DistanceUtils::hdist(nCurrInputDesc,anBGDesc[c]);
+                    const ushort nCurrInputDesc = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],nBGColor,m_anLBSPThreshold_8bitLUT[nBGColor]);
+                    const size_t nDescDist = DistanceUtils::hdist(nCurrInputDesc,m_oBGSamples.getDesc(nModelIdx,nPxIter,c));
                     if(nDescDist>nCurrSCDescDistThreshold)
                         goto failedcheck3ch;
                     nTotColorDist += nColorDist;
@@ -554,28 +541,27 @@ void BackgroundSubtractorLOBSTER::apply(cv::InputArray _oInputImg, cv::OutputArr
             if(nGoodSamplesCount<m_nRequiredBGSamples)
                 oCurrFGMask.data[nPxIter] = UCHAR_MAX;
             else {
-                if((rand()%nLearningRate)==0) {
-                    const size_t nSampleModelIdx = rand()%m_nBGSamples;
-                    ushort* anRandInputDesc = ((ushort*)(m_voBGDescSamples[nSampleModelIdx].data+nDescIterRGB));
+                if((m_oRNG()%nLearningRate)==0) {
+                    const size_t nSampleModelIdx = m_oRNG()%m_nBGSamples;
                     for(size_t c=0; c<3; ++c) {
-                        *(m_voBGColorSamples[nSampleModelIdx].data+nPxIterRGB+c) = anCurrColor[c];
-                        anRandInputDesc[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
+                        m_oBGSamples.getColor(nSampleModelIdx,nPxIter,c) = anCurrColor[c];
+                        m_oBGSamples.getDesc(nSampleModelIdx,nPxIter,c) = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
                     }
                 }
-                if((rand()%nLearningRate)==0) {
+                if((m_oRNG()%nLearningRate)==0) {
                     int nSampleImgCoord_Y, nSampleImgCoord_X;
-                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                    const size_t nSampleModelIdx = rand()%m_nBGSamples;
-                    ushort* anRandInputDesc = ((ushort*)(m_voBGDescSamples[nSampleModelIdx].data + desc_row_step*nSampleImgCoord_Y + 6*nSampleImgCoord_X));
+                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,m_oRNG);
+                    const size_t nSampleModelIdx = m_oRNG()%m_nBGSamples;
+                    const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
                     for(size_t c=0; c<3; ++c) {
-                        *(m_voBGColorSamples[nSampleModelIdx].data+img_row_step*nSampleImgCoord_Y+3*nSampleImgCoord_X+c) = anCurrColor[c];
-                        anRandInputDesc[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
+                        m_oBGSamples.getColor(nSampleModelIdx,nSamplePxIdx,c) = anCurrColor[c];
+                        m_oBGSamples.getDesc(nSampleModelIdx,nSamplePxIdx,c) = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
                     }
                 }
             }
         }
     }
-    cv::medianBlur(oCurrFGMask,m_oLastFGMask,m_nDefaultMedianBlurKernelSize);
+    m_oMedianBlur.apply(oCurrFGMask,m_oLastFGMask,m_nDefaultMedianBlurKernelSize);
     m_oLastFGMask.copyTo(oCurrFGMask);
     oInputImg.copyTo(m_oLastColorFrame);
 }
@@ -584,17 +570,11 @@ void BackgroundSubtractorLOBSTER::getBackgroundImage(cv::OutputArray oBGImg) con
     lvDbgExceptionWatch;
     CV_Assert(m_bInitialized);
     cv::Mat oAvgBGImg = cv::Mat::zeros(m_oImgSize,CV_32FC((int)m_nImgChannels));
-    for(size_t s=0; s<m_nBGSamples; ++s) {
-        for(int y=0; y<m_oImgSize.height; ++y) {
-            for(int x=0; x<m_oImgSize.width; ++x) {
-                const size_t idx_nimg = m_voBGColorSamples[s].step.p[0]*y + m_voBGColorSamples[s].step.p[1]*x;
-                const size_t idx_flt32 = idx_nimg*4;
-                float* oAvgBgImgPtr = (float*)(oAvgBGImg.data+idx_flt32);
-                const uchar* const oBGImgPtr = m_voBGColorSamples[s].data+idx_nimg;
-                for(size_t c=0; c<m_nImgChannels; ++c)
-                    oAvgBgImgPtr[c] += ((float)oBGImgPtr[c])/m_nBGSamples;
-            }
-        }
+    for(size_t nPxIter=0; nPxIter<m_nTotPxCount; ++nPxIter) {
+        float* oAvgBgImgPtr = ((float*)oAvgBGImg.data)+nPxIter*m_nImgChannels;
+        for(size_t s=0; s<m_nBGSamples; ++s)
+            for(size_t c=0; c<m_nImgChannels; ++c)
+                oAvgBgImgPtr[c] += ((float)m_oBGSamples.getColor(s,nPxIter,c))/m_nBGSamples;
     }
     oAvgBGImg.convertTo(oBGImg,CV_8U);
 }
@@ -604,19 +584,17 @@ void BackgroundSubtractorLOBSTER::getBackgroundDescriptorsImage(cv::OutputArray
     lvDbgExceptionWatch;
     CV_Assert(m_bInitialized);
     cv::Mat oAvgBGDesc = cv::Mat::zeros(m_oImgSize,CV_32FC((int)m_nImgChannels));
-    for(size_t n=0; n<m_voBGDescSamples.size(); ++n) {
-        for(int y=0; y<m_oImgSize.height; ++y) {
-            for(int x=0; x<m_oImgSize.width; ++x) {
-                const size_t idx_ndesc = m_voBGDescSamples[n].step.p[0]*y + m_voBGDescSamples[n].step.p[1]*x;
-                const size_t idx_flt32 = idx_ndesc*2;
-                float* oAvgBgDescPtr = (float*)(oAvgBGDesc.data+idx_flt32);
-                const ushort* const oBGDescPtr = (ushort*)(m_voBGDescSamples[n].data+idx_ndesc);
-                for(size_t c=0; c<m_nImgChannels; ++c)
-                    oAvgBgDescPtr[c] += ((float)oBGDescPtr[c])/m_voBGDescSamples.size();
-            }
-        }
+    for(size_t nPxIter=0; nPxIter<m_nTotPxCount; ++nPxIter) {
+        float* oAvgBgDescPtr = ((float*)oAvgBGDesc.data)+nPxIter*m_nImgChannels;
+        for(size_t n=0; n<m_nBGSamples; ++n)
+            for(size_t c=0; c<m_nImgChannels; ++c)
+                oAvgBgDescPtr[c] += ((float)m_oBGSamples.getDesc(n,nPxIter,c))/m_nBGSamples;
     }
     oAvgBGDesc.convertTo(oBGDescImg,CV_16U);
 }
 
+void BackgroundSubtractorLOBSTER::setSampleModelLayout(eSampleModelLayout eLayout) {
+    m_oBGSamples.setLayout(eLayout);
+}
+
 template struct BackgroundSubtractorLOBSTER_<ParallelUtils::eNonParallel>;
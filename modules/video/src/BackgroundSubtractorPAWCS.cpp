@@ -56,6 +56,8 @@
 #define USE_FEEDBACK_ADJUSTMENTS 1
 // local define used to toggle the frame-level component to allow resets [on/off]
 #define USE_AUTO_MODEL_RESET 1
+// local define used to specify the frame interval between full (fresh weight) rank refreshes of each px's local dictionary tail
+#define LWORD_RANK_REFRESH_RATE (8)
 // local define used to specify the default frame size (320x240 = QVGA)
 #define DEFAULT_FRAME_SIZE cv::Size(320,240)
 // local define used to specify the default lword/gword update rate (16 = like vibe)
@@ -79,6 +81,8 @@
 #include <chrono>
 #endif //USE_INTERNAL_HRCS
 
+constexpr BackgroundSubtractorPAWCS::WordHandle BackgroundSubtractorPAWCS::s_nInvalidWordHandle;
+
 static const size_t s_nColorMaxDataRange_1ch = UCHAR_MAX;
 static const size_t s_nDescMaxDataRange_1ch = LBSP::DESC_SIZE_BITS;
 static const size_t s_nColorMaxDataRange_3ch = s_nColorMaxDataRange_1ch*3;
@@ -98,10 +102,9 @@ BackgroundSubtractorPAWCS::BackgroundSubtractorPAWCS_(size_t nDescDistThresholdO
         m_nMedianBlurKernelSize(m_nDefaultMedianBlurKernelSize),
         m_nDownSampledROIPxCount(0),
         m_nLocalWordWeightOffset(DEFAULT_LWORD_WEIGHT_OFFSET),
-        m_pLocalWordListIter_1ch(m_voLocalWordList_1ch.end()),
-        m_pLocalWordListIter_3ch(m_voLocalWordList_3ch.end()),
-        m_pGlobalWordListIter_1ch(m_voGlobalWordList_1ch.end()),
-        m_pGlobalWordListIter_3ch(m_voGlobalWordList_3ch.end()) {
+        m_nUsedGlobalWords(0),
+        m_nGlobalWordSpatioOccMapSize(0),
+        m_nTileRows(0) {
     CV_Assert(m_nMaxLocalWords>0 && m_nMaxGlobalWords>0);
 }
 
@@ -109,84 +112,189 @@ void BackgroundSubtractorPAWCS::refreshModel(size_t nBaseOccCount, float fOccDec
     // == refresh
     CV_Assert(m_bInitialized);
     CV_Assert(fOccDecrFrac>=0.0f && fOccDecrFrac<=1.0f);
-    if(m_nImgChannels==1) {
-        for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
-            const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
-            if(bForceFGUpdate || !m_oLastFGMask_dilated.data[nPxIter]) {
-                const size_t nLocalDictIdx = nModelIter*m_nCurrLocalWords;
-                const size_t nFloatIter = nPxIter*4;
-                uchar& bCurrRegionIsUnstable = m_oUnstableRegionMask.data[nPxIter];
-                const float fCurrDistThresholdFactor = *(float*)(m_oDistThresholdFrame.data+nFloatIter);
-                const size_t nCurrColorDistThreshold = (size_t)(sqrt(fCurrDistThresholdFactor)*m_nMinColorDistThreshold)/2;
-                const size_t nCurrDescDistThreshold = ((size_t)1<<((size_t)floor(fCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(bCurrRegionIsUnstable*UNSTAB_DESC_DIST_OFFSET);
-                // == refresh: local decr
-                if(fOccDecrFrac>0.0f) {
-                    for(size_t nLocalWordIdx=0; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
-                        LocalWord_1ch* pCurrLocalWord = (LocalWord_1ch*)m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx];
-                        if(pCurrLocalWord)
-                            pCurrLocalWord->nOccurrences -= (size_t)(fOccDecrFrac*pCurrLocalWord->nOccurrences);
+    const auto lTileRefresher = [&](TileInfo* pTile) {
+        if(m_nImgChannels==1) {
+            for(size_t nModelIter=pTile->nModelIterBegin; nModelIter<pTile->nModelIterEnd; ++nModelIter) {
+                const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
+                if(bForceFGUpdate || !m_oLastFGMask_dilated.data[nPxIter]) {
+                    const size_t nLocalDictIdx = nModelIter*m_nCurrLocalWords;
+                    const size_t nFloatIter = nPxIter*4;
+                    uchar& bCurrRegionIsUnstable = m_oUnstableRegionMask.data[nPxIter];
+                    const float fCurrDistThresholdFactor = *(float*)(m_oDistThresholdFrame.data+nFloatIter);
+                    const size_t nCurrColorDistThreshold = (size_t)(sqrt(fCurrDistThresholdFactor)*m_nMinColorDistThreshold)/2;
+                    const size_t nCurrDescDistThreshold = ((size_t)1<<((size_t)floor(fCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(bCurrRegionIsUnstable*UNSTAB_DESC_DIST_OFFSET);
+                    // == refresh: local decr
+                    if(fOccDecrFrac>0.0f) {
+                        for(size_t nLocalWordIdx=0; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
+                            LocalWord_1ch* pCurrLocalWord = GetWord(m_voLocalWordList_1ch,m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx]);
+                            if(pCurrLocalWord)
+                                pCurrLocalWord->nOccurrences -= (size_t)(fOccDecrFrac*pCurrLocalWord->nOccurrences);
+                        }
                     }
-                }
-                const size_t nCurrWordOccIncr = DEFAULT_LWORD_OCC_INCR;
-                const size_t nTotLocalSamplingIterCount = 7*7*2;
-                for(size_t nLocalSamplingIter=0; nLocalSamplingIter<nTotLocalSamplingIterCount; ++nLocalSamplingIter) {
-                    // == refresh: local resampling
-                    int nSampleImgCoord_Y, nSampleImgCoord_X;
-                    cv::getRandSamplePosition_7x7_std2(nSampleImgCoord_X,nSampleImgCoord_Y,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                    const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
-                    if(bForceFGUpdate || !m_oLastFGMask_dilated.data[nSamplePxIdx]) {
-                        const uchar nSampleColor = m_oLastColorFrame.data[nSamplePxIdx];
-                        const size_t nSampleDescIdx = nSamplePxIdx*2;
-                        const ushort nSampleIntraDesc = *((ushort*)(m_oLastDescFrame.data+nSampleDescIdx));
-                        bool bFoundUninitd = false;
-                        size_t nLocalWordIdx;
-                        for(nLocalWordIdx=0; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
-                            LocalWord_1ch* pCurrLocalWord = (LocalWord_1ch*)m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx];
-                            if(pCurrLocalWord
-                               && DistanceUtils::L1dist(nSampleColor,pCurrLocalWord->oFeature.anColor[0])<=nCurrColorDistThreshold
-                               && DistanceUtils::hdist(nSampleIntraDesc,pCurrLocalWord->oFeature.anDesc[0])<=nCurrDescDistThreshold) {
-                                pCurrLocalWord->nOccurrences += nCurrWordOccIncr;
-                                pCurrLocalWord->nLastOcc = m_nFrameIdx;
-                                break;
+                    // local words are bound to their px's dictionary range, so handles can be handed out without a shared counter
+                    size_t nUsedLocalWords = 0;
+                    while(nUsedLocalWords<m_nCurrLocalWords && m_vnLocalWordDict[nLocalDictIdx+nUsedLocalWords]!=s_nInvalidWordHandle)
+                        ++nUsedLocalWords;
+                    const size_t nCurrWordOccIncr = DEFAULT_LWORD_OCC_INCR;
+                    const size_t nTotLocalSamplingIterCount = 7*7*2;
+                    for(size_t nLocalSamplingIter=0; nLocalSamplingIter<nTotLocalSamplingIterCount; ++nLocalSamplingIter) {
+                        // == refresh: local resampling
+                        int nSampleImgCoord_Y, nSampleImgCoord_X;
+                        cv::getRandSamplePosition_7x7_std2(nSampleImgCoord_X,nSampleImgCoord_Y,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,pTile->oRNG);
+                        const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
+                        if(bForceFGUpdate || !m_oLastFGMask_dilated.data[nSamplePxIdx]) {
+                            const uchar nSampleColor = m_oLastColorFrame.data[nSamplePxIdx];
+                            const size_t nSampleDescIdx = nSamplePxIdx*2;
+                            const ushort nSampleIntraDesc = *((ushort*)(m_oLastDescFrame.data+nSampleDescIdx));
+                            bool bFoundUninitd = false;
+                            size_t nLocalWordIdx;
+                            for(nLocalWordIdx=0; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
+                                LocalWord_1ch* pCurrLocalWord = GetWord(m_voLocalWordList_1ch,m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx]);
+                                if(pCurrLocalWord
+                                   && DistanceUtils::L1dist(nSampleColor,pCurrLocalWord->oFeature.anColor[0])<=nCurrColorDistThreshold
+                                   && DistanceUtils::hdist(nSampleIntraDesc,pCurrLocalWord->oFeature.anDesc[0])<=nCurrDescDistThreshold) {
+                                    pCurrLocalWord->nOccurrences += nCurrWordOccIncr;
+                                    pCurrLocalWord->nLastOcc = m_nFrameIdx;
+                                    break;
+                                }
+                                else if(!pCurrLocalWord)
+                                    bFoundUninitd = true;
+                            }
+                            if(nLocalWordIdx==m_nCurrLocalWords) {
+                                nLocalWordIdx = m_nCurrLocalWords-1;
+                                const WordHandle nCurrLocalWordHandle = bFoundUninitd?(WordHandle)(nLocalDictIdx+nUsedLocalWords++):m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx];
+                                LocalWord_1ch& oCurrLocalWord = m_voLocalWordList_1ch[nCurrLocalWordHandle];
+                                oCurrLocalWord.oFeature.anColor[0] = nSampleColor;
+                                oCurrLocalWord.oFeature.anDesc[0] = nSampleIntraDesc;
+                                oCurrLocalWord.nOccurrences = nBaseOccCount;
+                                oCurrLocalWord.nFirstOcc = m_nFrameIdx;
+                                oCurrLocalWord.nLastOcc = m_nFrameIdx;
+                                m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx] = nCurrLocalWordHandle;
+                            }
+                            const float fCurrLocalWordWeight = GetLocalWordWeight(*GetWord(m_voLocalWordList_1ch,m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx]),m_nFrameIdx,m_nLocalWordWeightOffset);
+                            while(nLocalWordIdx>0 && (m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]==s_nInvalidWordHandle || fCurrLocalWordWeight>GetLocalWordWeight(*GetWord(m_voLocalWordList_1ch,m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]),m_nFrameIdx,m_nLocalWordWeightOffset))) {
+                                std::swap(m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]);
+                                --nLocalWordIdx;
                             }
-                            else if(!pCurrLocalWord)
-                                bFoundUninitd = true;
-                        }
-                        if(nLocalWordIdx==m_nCurrLocalWords) {
-                            nLocalWordIdx = m_nCurrLocalWords-1;
-                            LocalWord_1ch& oCurrLocalWord = bFoundUninitd?*m_pLocalWordListIter_1ch++:*(LocalWord_1ch*)m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx];
-                            oCurrLocalWord.oFeature.anColor[0] = nSampleColor;
-                            oCurrLocalWord.oFeature.anDesc[0] = nSampleIntraDesc;
-                            oCurrLocalWord.nOccurrences = nBaseOccCount;
-                            oCurrLocalWord.nFirstOcc = m_nFrameIdx;
-                            oCurrLocalWord.nLastOcc = m_nFrameIdx;
-                            m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx] = &oCurrLocalWord;
                         }
-                        while(nLocalWordIdx>0 && (!m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx-1] || GetLocalWordWeight(*m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_nFrameIdx,m_nLocalWordWeightOffset)>GetLocalWordWeight(*m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx-1],m_nFrameIdx,m_nLocalWordWeightOffset))) {
-                            std::swap(m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]);
-                            --nLocalWordIdx;
+                    }
+                    CV_Assert(m_vnLocalWordDict[nLocalDictIdx]!=s_nInvalidWordHandle);
+                    for(size_t nLocalWordIdx=1; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
+                        // == refresh: local random resampling
+                        if(m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx]==s_nInvalidWordHandle) {
+                            const size_t nRandLocalWordIdx = (pTile->oRNG()%nLocalWordIdx);
+                            const LocalWord_1ch& oRefLocalWord = *GetWord(m_voLocalWordList_1ch,m_vnLocalWordDict[nLocalDictIdx+nRandLocalWordIdx]);
+                            const int nRandColorOffset = (pTile->oRNG()%(nCurrColorDistThreshold+1))-(int)nCurrColorDistThreshold/2;
+                            const WordHandle nNewLocalWordHandle = (WordHandle)(nLocalDictIdx+nUsedLocalWords++);
+                            LocalWord_1ch& oCurrNewLocalWord = m_voLocalWordList_1ch[nNewLocalWordHandle];
+                            oCurrNewLocalWord.oFeature.anColor[0] = cv::saturate_cast<uchar>((int)oRefLocalWord.oFeature.anColor[0]+nRandColorOffset);
+                            oCurrNewLocalWord.oFeature.anDesc[0] = oRefLocalWord.oFeature.anDesc[0];
+                            oCurrNewLocalWord.nOccurrences = std::max((size_t)(oRefLocalWord.nOccurrences*((float)(m_nCurrLocalWords-nLocalWordIdx)/m_nCurrLocalWords)),(size_t)1);
+                            oCurrNewLocalWord.nFirstOcc = m_nFrameIdx;
+                            oCurrNewLocalWord.nLastOcc = m_nFrameIdx;
+                            m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx] = nNewLocalWordHandle;
                         }
                     }
                 }
-                CV_Assert(m_vpLocalWordDict[nLocalDictIdx]);
-                for(size_t nLocalWordIdx=1; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
-                    // == refresh: local random resampling
-                    if(!(LocalWord_1ch*)m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx]) {
-                        const size_t nRandLocalWordIdx = (rand()%nLocalWordIdx);
-                        const LocalWord_1ch& oRefLocalWord = *(LocalWord_1ch*)m_vpLocalWordDict[nLocalDictIdx+nRandLocalWordIdx];
-                        const int nRandColorOffset = (rand()%(nCurrColorDistThreshold+1))-(int)nCurrColorDistThreshold/2;
-                        LocalWord_1ch& oCurrNewLocalWord = *m_pLocalWordListIter_1ch++;
-                        oCurrNewLocalWord.oFeature.anColor[0] = cv::saturate_cast<uchar>((int)oRefLocalWord.oFeature.anColor[0]+nRandColorOffset);
-                        oCurrNewLocalWord.oFeature.anDesc[0] = oRefLocalWord.oFeature.anDesc[0];
-                        oCurrNewLocalWord.nOccurrences = std::max((size_t)(oRefLocalWord.nOccurrences*((float)(m_nCurrLocalWords-nLocalWordIdx)/m_nCurrLocalWords)),(size_t)1);
-                        oCurrNewLocalWord.nFirstOcc = m_nFrameIdx;
-                        oCurrNewLocalWord.nLastOcc = m_nFrameIdx;
-                        m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx] = &oCurrNewLocalWord;
+            }
+        }
+        else { //m_nImgChannels==3
+            for(size_t nModelIter=pTile->nModelIterBegin; nModelIter<pTile->nModelIterEnd; ++nModelIter) {
+                const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
+                if(bForceFGUpdate || !m_oLastFGMask_dilated.data[nPxIter]) {
+                    const size_t nLocalDictIdx = nModelIter*m_nCurrLocalWords;
+                    const size_t nFloatIter = nPxIter*4;
+                    uchar& bCurrRegionIsUnstable = m_oUnstableRegionMask.data[nPxIter];
+                    const float fCurrDistThresholdFactor = *(float*)(m_oDistThresholdFrame.data+nFloatIter);
+                    const size_t nCurrTotColorDistThreshold = (size_t)(sqrt(fCurrDistThresholdFactor)*m_nMinColorDistThreshold)*3;
+                    const size_t nCurrTotDescDistThreshold = (((size_t)1<<((size_t)floor(fCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(bCurrRegionIsUnstable*UNSTAB_DESC_DIST_OFFSET))*3;
+                    // == refresh: local decr
+                    if(fOccDecrFrac>0.0f) {
+                        for(size_t nLocalWordIdx=0; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
+                            LocalWord_3ch* pCurrLocalWord = GetWord(m_voLocalWordList_3ch,m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx]);
+                            if(pCurrLocalWord)
+                                pCurrLocalWord->nOccurrences -= (size_t)(fOccDecrFrac*pCurrLocalWord->nOccurrences);
+                        }
+                    }
+                    // local words are bound to their px's dictionary range, so handles can be handed out without a shared counter
+                    size_t nUsedLocalWords = 0;
+                    while(nUsedLocalWords<m_nCurrLocalWords && m_vnLocalWordDict[nLocalDictIdx+nUsedLocalWords]!=s_nInvalidWordHandle)
+                        ++nUsedLocalWords;
+                    const size_t nCurrWordOccIncr = DEFAULT_LWORD_OCC_INCR;
+                    const size_t nTotLocalSamplingIterCount = 7*7*2;
+                    for(size_t nLocalSamplingIter=0; nLocalSamplingIter<nTotLocalSamplingIterCount; ++nLocalSamplingIter) {
+                        // == refresh: local resampling
+                        int nSampleImgCoord_Y, nSampleImgCoord_X;
+                        cv::getRandSamplePosition_7x7_std2(nSampleImgCoord_X,nSampleImgCoord_Y,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,pTile->oRNG);
+                        const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
+                        if(bForceFGUpdate || !m_oLastFGMask_dilated.data[nSamplePxIdx]) {
+                            const size_t nSamplePxRGBIdx = nSamplePxIdx*3;
+                            const size_t nSampleDescRGBIdx = nSamplePxRGBIdx*2;
+                            const uchar* const anSampleColor = m_oLastColorFrame.data+nSamplePxRGBIdx;
+                            const ushort* const anSampleIntraDesc = ((ushort*)(m_oLastDescFrame.data+nSampleDescRGBIdx));
+                            bool bFoundUninitd = false;
+                            size_t nLocalWordIdx;
+                            for(nLocalWordIdx=0; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
+                                LocalWord_3ch* pCurrLocalWord = GetWord(m_voLocalWordList_3ch,m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx]);
+                                if(pCurrLocalWord
+                                   && DistanceUtils::cmixdist(anSampleColor,pCurrLocalWord->oFeature.anColor)<=nCurrTotColorDistThreshold
+                                   && DistanceUtils::hdist(anSampleIntraDesc,pCurrLocalWord->oFeature.anDesc)<=nCurrTotDescDistThreshold) {
+                                    pCurrLocalWord->nOccurrences += nCurrWordOccIncr;
+                                    pCurrLocalWord->nLastOcc = m_nFrameIdx;
+                                    break;
+                                }
+                                else if(!pCurrLocalWord)
+                                    bFoundUninitd = true;
+                            }
+                            if(nLocalWordIdx==m_nCurrLocalWords) {
+                                nLocalWordIdx = m_nCurrLocalWords-1;
+                                const WordHandle nCurrLocalWordHandle = bFoundUninitd?(WordHandle)(nLocalDictIdx+nUsedLocalWords++):m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx];
+                                LocalWord_3ch& oCurrLocalWord = m_voLocalWordList_3ch[nCurrLocalWordHandle];
+                                for(size_t c=0; c<3; ++c) {
+                                    oCurrLocalWord.oFeature.anColor[c] = anSampleColor[c];
+                                    oCurrLocalWord.oFeature.anDesc[c] = anSampleIntraDesc[c];
+                                }
+                                oCurrLocalWord.nOccurrences = nBaseOccCount;
+                                oCurrLocalWord.nFirstOcc = m_nFrameIdx;
+                                oCurrLocalWord.nLastOcc = m_nFrameIdx;
+                                m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx] = nCurrLocalWordHandle;
+                            }
+                            const float fCurrLocalWordWeight = GetLocalWordWeight(*GetWord(m_voLocalWordList_3ch,m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx]),m_nFrameIdx,m_nLocalWordWeightOffset);
+                            while(nLocalWordIdx>0 && (m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]==s_nInvalidWordHandle || fCurrLocalWordWeight>GetLocalWordWeight(*GetWord(m_voLocalWordList_3ch,m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]),m_nFrameIdx,m_nLocalWordWeightOffset))) {
+                                std::swap(m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]);
+                                --nLocalWordIdx;
+                            }
+                        }
+                    }
+                    CV_Assert(m_vnLocalWordDict[nLocalDictIdx]!=s_nInvalidWordHandle);
+                    for(size_t nLocalWordIdx=1; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
+                        // == refresh: local random resampling
+                        if(m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx]==s_nInvalidWordHandle) {
+                            const size_t nRandLocalWordIdx = (pTile->oRNG()%nLocalWordIdx);
+                            const LocalWord_3ch& oRefLocalWord = *GetWord(m_voLocalWordList_3ch,m_vnLocalWordDict[nLocalDictIdx+nRandLocalWordIdx]);
+                            const int nRandColorOffset = (pTile->oRNG()%(nCurrTotColorDistThreshold/3+1))-(int)(nCurrTotColorDistThreshold/6);
+                            const WordHandle nNewLocalWordHandle = (WordHandle)(nLocalDictIdx+nUsedLocalWords++);
+                            LocalWord_3ch& oCurrNewLocalWord = m_voLocalWordList_3ch[nNewLocalWordHandle];
+                            for(size_t c=0; c<3; ++c) {
+                                oCurrNewLocalWord.oFeature.anColor[c] = cv::saturate_cast<uchar>((int)oRefLocalWord.oFeature.anColor[c]+nRandColorOffset);
+                                oCurrNewLocalWord.oFeature.anDesc[c] = oRefLocalWord.oFeature.anDesc[c];
+                            }
+                            oCurrNewLocalWord.nOccurrences = std::max((size_t)(oRefLocalWord.nOccurrences*((float)(m_nCurrLocalWords-nLocalWordIdx)/m_nCurrLocalWords)),(size_t)1);
+                            oCurrNewLocalWord.nFirstOcc = m_nFrameIdx;
+                            oCurrNewLocalWord.nLastOcc = m_nFrameIdx;
+                            m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx] = nNewLocalWordHandle;
+                        }
                     }
                 }
             }
         }
-        CV_Assert(m_voLocalWordList_1ch.end()==m_pLocalWordListIter_1ch);
+        for(size_t nLocalDictIdx=pTile->nModelIterBegin*m_nCurrLocalWords; nLocalDictIdx<pTile->nModelIterEnd*m_nCurrLocalWords; ++nLocalDictIdx) {
+            // == refresh: local word weight cache
+            setCachedLocalWordWeight(nLocalDictIdx,GetLocalWordWeight(getLocalWordBase(m_vnLocalWordDict[nLocalDictIdx]),m_nFrameIdx,m_nLocalWordWeightOffset));
+        }
+    };
+    process_tiles(lTileRefresher,true);
+    if(m_nImgChannels==1) {
         cv::Mat oGlobalDictPresenceLookupMap(m_oImgSize,CV_8UC1,cv::Scalar_<uchar>(0));
         size_t nPxIterIncr = std::max(m_nTotPxCount/m_nCurrGlobalWords,(size_t)1);
         for(size_t nSamplingPasses=0; nSamplingPasses<GWORD_DEFAULT_NB_INIT_SAMPL_PASSES; ++nSamplingPasses) {
@@ -202,14 +310,14 @@ void BackgroundSubtractorPAWCS::refreshModel(size_t nBaseOccCount, float fOccDec
                         const float fCurrDistThresholdFactor = *(float*)(m_oDistThresholdFrame.data+nFloatIter);
                         const size_t nCurrColorDistThreshold = (size_t)(sqrt(fCurrDistThresholdFactor)*m_nMinColorDistThreshold)/2;
                         const size_t nCurrDescDistThreshold = ((size_t)1<<((size_t)floor(fCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(bCurrRegionIsUnstable*UNSTAB_DESC_DIST_OFFSET);
-                        CV_Assert(m_vpLocalWordDict[nLocalDictIdx]);
-                        const LocalWord_1ch& oRefBestLocalWord = *(LocalWord_1ch*)m_vpLocalWordDict[nLocalDictIdx];
+                        CV_Assert(m_vnLocalWordDict[nLocalDictIdx]!=s_nInvalidWordHandle);
+                        const LocalWord_1ch& oRefBestLocalWord = *GetWord(m_voLocalWordList_1ch,m_vnLocalWordDict[nLocalDictIdx]);
                         const float fRefBestLocalWordWeight = GetLocalWordWeight(oRefBestLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
                         const uchar nRefBestLocalWordDescBITS = (uchar)DistanceUtils::popcount(oRefBestLocalWord.oFeature.anDesc[0]);
                         bool bFoundUninitd = false;
                         size_t nGlobalWordIdx;
                         for(nGlobalWordIdx=0; nGlobalWordIdx<m_nCurrGlobalWords; ++nGlobalWordIdx) {
-                            GlobalWord_1ch* pCurrGlobalWord = (GlobalWord_1ch*)m_vpGlobalWordDict[nGlobalWordIdx];
+                            GlobalWord_1ch* pCurrGlobalWord = GetWord(m_voGlobalWordList_1ch,m_vnGlobalWordDict[nGlobalWordIdx]);
                             if(pCurrGlobalWord
                                && DistanceUtils::L1dist(pCurrGlobalWord->oFeature.anColor[0],oRefBestLocalWord.oFeature.anColor[0])<=nCurrColorDistThreshold
                                && DistanceUtils::L1dist(nRefBestLocalWordDescBITS,pCurrGlobalWord->nDescBITS)<=nCurrDescDistThreshold/GWORD_DESC_THRES_BITS_MATCH_FACTOR)
@@ -219,23 +327,23 @@ void BackgroundSubtractorPAWCS::refreshModel(size_t nBaseOccCount, float fOccDec
                         }
                         if(nGlobalWordIdx==m_nCurrGlobalWords) {
                             nGlobalWordIdx = m_nCurrGlobalWords-1;
-                            GlobalWord_1ch& oCurrGlobalWord = bFoundUninitd?*m_pGlobalWordListIter_1ch++:*(GlobalWord_1ch*)m_vpGlobalWordDict[nGlobalWordIdx];
+                            const WordHandle nCurrGlobalWordHandle = bFoundUninitd?(WordHandle)m_nUsedGlobalWords++:m_vnGlobalWordDict[nGlobalWordIdx];
+                            GlobalWord_1ch& oCurrGlobalWord = m_voGlobalWordList_1ch[nCurrGlobalWordHandle];
                             oCurrGlobalWord.oFeature.anColor[0] = oRefBestLocalWord.oFeature.anColor[0];
                             oCurrGlobalWord.oFeature.anDesc[0] = oRefBestLocalWord.oFeature.anDesc[0];
                             oCurrGlobalWord.nDescBITS = nRefBestLocalWordDescBITS;
-                            oCurrGlobalWord.oSpatioOccMap.create(m_oDownSampledFrameSize_GlobalWordLookup,CV_32FC1);
                             oCurrGlobalWord.oSpatioOccMap = cv::Scalar(0.0f);
                             oCurrGlobalWord.fLatestWeight = 0.0f;
-                            m_vpGlobalWordDict[nGlobalWordIdx] = &oCurrGlobalWord;
+                            m_vnGlobalWordDict[nGlobalWordIdx] = nCurrGlobalWordHandle;
                         }
-                        float& fCurrGlobalWordLocalWeight = *(float*)(m_vpGlobalWordDict[nGlobalWordIdx]->oSpatioOccMap.data+nGlobalWordMapLookupIdx);
+                        float& fCurrGlobalWordLocalWeight = getGlobalWordLocalWeight(m_vnGlobalWordDict[nGlobalWordIdx],nGlobalWordMapLookupIdx);
                         if(fCurrGlobalWordLocalWeight<fRefBestLocalWordWeight) {
-                            m_vpGlobalWordDict[nGlobalWordIdx]->fLatestWeight += fRefBestLocalWordWeight;
+                            m_voGlobalWordList_1ch[m_vnGlobalWordDict[nGlobalWordIdx]].fLatestWeight += fRefBestLocalWordWeight;
                             fCurrGlobalWordLocalWeight += fRefBestLocalWordWeight;
                         }
                         oGlobalDictPresenceLookupMap.data[nPxIter] = UCHAR_MAX;
-                        while(nGlobalWordIdx>0 && (!m_vpGlobalWordDict[nGlobalWordIdx-1] || m_vpGlobalWordDict[nGlobalWordIdx]->fLatestWeight>m_vpGlobalWordDict[nGlobalWordIdx-1]->fLatestWeight)) {
-                            std::swap(m_vpGlobalWordDict[nGlobalWordIdx],m_vpGlobalWordDict[nGlobalWordIdx-1]);
+                        while(nGlobalWordIdx>0 && (m_vnGlobalWordDict[nGlobalWordIdx-1]==s_nInvalidWordHandle || m_voGlobalWordList_1ch[m_vnGlobalWordDict[nGlobalWordIdx]].fLatestWeight>m_voGlobalWordList_1ch[m_vnGlobalWordDict[nGlobalWordIdx-1]].fLatestWeight)) {
+                            std::swap(m_vnGlobalWordDict[nGlobalWordIdx],m_vnGlobalWordDict[nGlobalWordIdx-1]);
                             --nGlobalWordIdx;
                         }
                     }
@@ -244,102 +352,20 @@ void BackgroundSubtractorPAWCS::refreshModel(size_t nBaseOccCount, float fOccDec
             nPxIterIncr = std::max(nPxIterIncr/3,(size_t)1);
         }
         for(size_t nGlobalWordIdx=0;nGlobalWordIdx<m_nCurrGlobalWords;++nGlobalWordIdx) {
-            if(!(GlobalWord_1ch*)m_vpGlobalWordDict[nGlobalWordIdx]) {
-                GlobalWord_1ch& oCurrNewGlobalWord = *m_pGlobalWordListIter_1ch++;
+            if(m_vnGlobalWordDict[nGlobalWordIdx]==s_nInvalidWordHandle) {
+                const WordHandle nNewGlobalWordHandle = (WordHandle)m_nUsedGlobalWords++;
+                GlobalWord_1ch& oCurrNewGlobalWord = m_voGlobalWordList_1ch[nNewGlobalWordHandle];
                 oCurrNewGlobalWord.oFeature.anColor[0] = 0;
                 oCurrNewGlobalWord.oFeature.anDesc[0] = 0;
                 oCurrNewGlobalWord.nDescBITS = 0;
-                oCurrNewGlobalWord.oSpatioOccMap.create(m_oDownSampledFrameSize_GlobalWordLookup,CV_32FC1);
                 oCurrNewGlobalWord.oSpatioOccMap = cv::Scalar(0.0f);
                 oCurrNewGlobalWord.fLatestWeight = 0.0f;
-                m_vpGlobalWordDict[nGlobalWordIdx] = &oCurrNewGlobalWord;
+                m_vnGlobalWordDict[nGlobalWordIdx] = nNewGlobalWordHandle;
             }
         }
-        CV_Assert(m_voGlobalWordList_1ch.end()==m_pGlobalWordListIter_1ch);
+        CV_Assert(m_voGlobalWordList_1ch.size()==m_nUsedGlobalWords);
     }
     else { //m_nImgChannels==3
-        for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
-            const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
-            if(bForceFGUpdate || !m_oLastFGMask_dilated.data[nPxIter]) {
-                const size_t nLocalDictIdx = nModelIter*m_nCurrLocalWords;
-                const size_t nFloatIter = nPxIter*4;
-                uchar& bCurrRegionIsUnstable = m_oUnstableRegionMask.data[nPxIter];
-                const float fCurrDistThresholdFactor = *(float*)(m_oDistThresholdFrame.data+nFloatIter);
-                const size_t nCurrTotColorDistThreshold = (size_t)(sqrt(fCurrDistThresholdFactor)*m_nMinColorDistThreshold)*3;
-                const size_t nCurrTotDescDistThreshold = (((size_t)1<<((size_t)floor(fCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(bCurrRegionIsUnstable*UNSTAB_DESC_DIST_OFFSET))*3;
-                // == refresh: local decr
-                if(fOccDecrFrac>0.0f) {
-                    for(size_t nLocalWordIdx=0; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
-                        LocalWord_3ch* pCurrLocalWord = (LocalWord_3ch*)m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx];
-                        if(pCurrLocalWord)
-                            pCurrLocalWord->nOccurrences -= (size_t)(fOccDecrFrac*pCurrLocalWord->nOccurrences);
-                    }
-                }
-                const size_t nCurrWordOccIncr = DEFAULT_LWORD_OCC_INCR;
-                const size_t nTotLocalSamplingIterCount = 7*7*2;
-                for(size_t nLocalSamplingIter=0; nLocalSamplingIter<nTotLocalSamplingIterCount; ++nLocalSamplingIter) {
-                    // == refresh: local resampling
-                    int nSampleImgCoord_Y, nSampleImgCoord_X;
-                    cv::getRandSamplePosition_7x7_std2(nSampleImgCoord_X,nSampleImgCoord_Y,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                    const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
-                    if(bForceFGUpdate || !m_oLastFGMask_dilated.data[nSamplePxIdx]) {
-                        const size_t nSamplePxRGBIdx = nSamplePxIdx*3;
-                        const size_t nSampleDescRGBIdx = nSamplePxRGBIdx*2;
-                        const uchar* const anSampleColor = m_oLastColorFrame.data+nSamplePxRGBIdx;
-                        const ushort* const anSampleIntraDesc = ((ushort*)(m_oLastDescFrame.data+nSampleDescRGBIdx));
-                        bool bFoundUninitd = false;
-                        size_t nLocalWordIdx;
-                        for(nLocalWordIdx=0; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
-                            LocalWord_3ch* pCurrLocalWord = (LocalWord_3ch*)m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx];
-                            if(pCurrLocalWord
-                               && DistanceUtils::cmixdist(anSampleColor,pCurrLocalWord->oFeature.anColor)<=nCurrTotColorDistThreshold
-                               && DistanceUtils::hdist(anSampleIntraDesc,pCurrLocalWord->oFeature.anDesc)<=nCurrTotDescDistThreshold) {
-                                pCurrLocalWord->nOccurrences += nCurrWordOccIncr;
-                                pCurrLocalWord->nLastOcc = m_nFrameIdx;
-                                break;
-                            }
-                            else if(!pCurrLocalWord)
-                                bFoundUninitd = true;
-                        }
-                        if(nLocalWordIdx==m_nCurrLocalWords) {
-                            nLocalWordIdx = m_nCurrLocalWords-1;
-                            LocalWord_3ch& oCurrLocalWord = bFoundUninitd?*m_pLocalWordListIter_3ch++:*(LocalWord_3ch*)m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx];
-                            for(size_t c=0; c<3; ++c) {
-                                oCurrLocalWord.oFeature.anColor[c] = anSampleColor[c];
-                                oCurrLocalWord.oFeature.anDesc[c] = anSampleIntraDesc[c];
-                            }
-                            oCurrLocalWord.nOccurrences = nBaseOccCount;
-                            oCurrLocalWord.nFirstOcc = m_nFrameIdx;
-                            oCurrLocalWord.nLastOcc = m_nFrameIdx;
-                            m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx] = &oCurrLocalWord;
-                        }
-                        while(nLocalWordIdx>0 && (!m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx-1] || GetLocalWordWeight(*m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_nFrameIdx,m_nLocalWordWeightOffset)>GetLocalWordWeight(*m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx-1],m_nFrameIdx,m_nLocalWordWeightOffset))) {
-                            std::swap(m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]);
-                            --nLocalWordIdx;
-                        }
-                    }
-                }
-                CV_Assert(m_vpLocalWordDict[nLocalDictIdx]);
-                for(size_t nLocalWordIdx=1; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
-                    // == refresh: local random resampling
-                    if(!(LocalWord_3ch*)m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx]) {
-                        const size_t nRandLocalWordIdx = (rand()%nLocalWordIdx);
-                        const LocalWord_3ch& oRefLocalWord = *(LocalWord_3ch*)m_vpLocalWordDict[nLocalDictIdx+nRandLocalWordIdx];
-                        const int nRandColorOffset = (rand()%(nCurrTotColorDistThreshold/3+1))-(int)(nCurrTotColorDistThreshold/6);
-                        LocalWord_3ch& oCurrNewLocalWord = *m_pLocalWordListIter_3ch++;
-                        for(size_t c=0; c<3; ++c) {
-                            oCurrNewLocalWord.oFeature.anColor[c] = cv::saturate_cast<uchar>((int)oRefLocalWord.oFeature.anColor[c]+nRandColorOffset);
-                            oCurrNewLocalWord.oFeature.anDesc[c] = oRefLocalWord.oFeature.anDesc[c];
-                        }
-                        oCurrNewLocalWord.nOccurrences = std::max((size_t)(oRefLocalWord.nOccurrences*((float)(m_nCurrLocalWords-nLocalWordIdx)/m_nCurrLocalWords)),(size_t)1);
-                        oCurrNewLocalWord.nFirstOcc = m_nFrameIdx;
-                        oCurrNewLocalWord.nLastOcc = m_nFrameIdx;
-                        m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx] = &oCurrNewLocalWord;
-                    }
-                }
-            }
-        }
-        CV_Assert(m_voLocalWordList_3ch.end()==m_pLocalWordListIter_3ch);
         cv::Mat oGlobalDictPresenceLookupMap(m_oImgSize,CV_8UC1,cv::Scalar_<uchar>(0));
         size_t nPxIterIncr = std::max(m_nTotPxCount/m_nCurrGlobalWords,(size_t)1);
         for(size_t nSamplingPasses=0; nSamplingPasses<GWORD_DEFAULT_NB_INIT_SAMPL_PASSES; ++nSamplingPasses) {
@@ -355,14 +381,14 @@ void BackgroundSubtractorPAWCS::refreshModel(size_t nBaseOccCount, float fOccDec
                         const float fCurrDistThresholdFactor = *(float*)(m_oDistThresholdFrame.data+nFloatIter);
                         const size_t nCurrTotColorDistThreshold = (size_t)(sqrt(fCurrDistThresholdFactor)*m_nMinColorDistThreshold)*3;
                         const size_t nCurrTotDescDistThreshold = (((size_t)1<<((size_t)floor(fCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(bCurrRegionIsUnstable*UNSTAB_DESC_DIST_OFFSET))*3;
-                        CV_Assert(m_vpLocalWordDict[nLocalDictIdx]);
-                        const LocalWord_3ch& oRefBestLocalWord = *(LocalWord_3ch*)m_vpLocalWordDict[nLocalDictIdx];
+                        CV_Assert(m_vnLocalWordDict[nLocalDictIdx]!=s_nInvalidWordHandle);
+                        const LocalWord_3ch& oRefBestLocalWord = *GetWord(m_voLocalWordList_3ch,m_vnLocalWordDict[nLocalDictIdx]);
                         const float fRefBestLocalWordWeight = GetLocalWordWeight(oRefBestLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
                         const uchar nRefBestLocalWordDescBITS = (uchar)DistanceUtils::popcount(oRefBestLocalWord.oFeature.anDesc);
                         bool bFoundUninitd = false;
                         size_t nGlobalWordIdx;
                         for(nGlobalWordIdx=0; nGlobalWordIdx<m_nCurrGlobalWords; ++nGlobalWordIdx) {
-                            GlobalWord_3ch* pCurrGlobalWord = (GlobalWord_3ch*)m_vpGlobalWordDict[nGlobalWordIdx];
+                            GlobalWord_3ch* pCurrGlobalWord = GetWord(m_voGlobalWordList_3ch,m_vnGlobalWordDict[nGlobalWordIdx]);
                             if(pCurrGlobalWord
                                && DistanceUtils::L1dist(nRefBestLocalWordDescBITS,pCurrGlobalWord->nDescBITS)<=nCurrTotDescDistThreshold/GWORD_DESC_THRES_BITS_MATCH_FACTOR
                                && DistanceUtils::cmixdist(oRefBestLocalWord.oFeature.anColor,pCurrGlobalWord->oFeature.anColor)<=nCurrTotColorDistThreshold)
@@ -372,25 +398,25 @@ void BackgroundSubtractorPAWCS::refreshModel(size_t nBaseOccCount, float fOccDec
                         }
                         if(nGlobalWordIdx==m_nCurrGlobalWords) {
                             nGlobalWordIdx = m_nCurrGlobalWords-1;
-                            GlobalWord_3ch& oCurrGlobalWord = bFoundUninitd?*m_pGlobalWordListIter_3ch++:*(GlobalWord_3ch*)m_vpGlobalWordDict[nGlobalWordIdx];
+                            const WordHandle nCurrGlobalWordHandle = bFoundUninitd?(WordHandle)m_nUsedGlobalWords++:m_vnGlobalWordDict[nGlobalWordIdx];
+                            GlobalWord_3ch& oCurrGlobalWord = m_voGlobalWordList_3ch[nCurrGlobalWordHandle];
                             for(size_t c=0; c<3; ++c) {
                                 oCurrGlobalWord.oFeature.anColor[c] = oRefBestLocalWord.oFeature.anColor[c];
                                 oCurrGlobalWord.oFeature.anDesc[c] = oRefBestLocalWord.oFeature.anDesc[c];
                             }
                             oCurrGlobalWord.nDescBITS = nRefBestLocalWordDescBITS;
-                            oCurrGlobalWord.oSpatioOccMap.create(m_oDownSampledFrameSize_GlobalWordLookup,CV_32FC1);
                             oCurrGlobalWord.oSpatioOccMap = cv::Scalar(0.0f);
                             oCurrGlobalWord.fLatestWeight = 0.0f;
-                            m_vpGlobalWordDict[nGlobalWordIdx] = &oCurrGlobalWord;
+                            m_vnGlobalWordDict[nGlobalWordIdx] = nCurrGlobalWordHandle;
                         }
-                        float& fCurrGlobalWordLocalWeight = *(float*)(m_vpGlobalWordDict[nGlobalWordIdx]->oSpatioOccMap.data+nGlobalWordMapLookupIdx);
+                        float& fCurrGlobalWordLocalWeight = getGlobalWordLocalWeight(m_vnGlobalWordDict[nGlobalWordIdx],nGlobalWordMapLookupIdx);
                         if(fCurrGlobalWordLocalWeight<fRefBestLocalWordWeight) {
-                            m_vpGlobalWordDict[nGlobalWordIdx]->fLatestWeight += fRefBestLocalWordWeight;
+                            m_voGlobalWordList_3ch[m_vnGlobalWordDict[nGlobalWordIdx]].fLatestWeight += fRefBestLocalWordWeight;
                             fCurrGlobalWordLocalWeight += fRefBestLocalWordWeight;
                         }
                         oGlobalDictPresenceLookupMap.data[nPxIter] = UCHAR_MAX;
-                        while(nGlobalWordIdx>0 && (!m_vpGlobalWordDict[nGlobalWordIdx-1] || m_vpGlobalWordDict[nGlobalWordIdx]->fLatestWeight>m_vpGlobalWordDict[nGlobalWordIdx-1]->fLatestWeight)) {
-                            std::swap(m_vpGlobalWordDict[nGlobalWordIdx],m_vpGlobalWordDict[nGlobalWordIdx-1]);
+                        while(nGlobalWordIdx>0 && (m_vnGlobalWordDict[nGlobalWordIdx-1]==s_nInvalidWordHandle || m_voGlobalWordList_3ch[m_vnGlobalWordDict[nGlobalWordIdx]].fLatestWeight>m_voGlobalWordList_3ch[m_vnGlobalWordDict[nGlobalWordIdx-1]].fLatestWeight)) {
+                            std::swap(m_vnGlobalWordDict[nGlobalWordIdx],m_vnGlobalWordDict[nGlobalWordIdx-1]);
                             --nGlobalWordIdx;
                         }
                     }
@@ -399,34 +425,22 @@ void BackgroundSubtractorPAWCS::refreshModel(size_t nBaseOccCount, float fOccDec
             nPxIterIncr = std::max(nPxIterIncr/3,(size_t)1);
         }
         for(size_t nGlobalWordIdx=0;nGlobalWordIdx<m_nCurrGlobalWords;++nGlobalWordIdx) {
-            if(!(GlobalWord_3ch*)m_vpGlobalWordDict[nGlobalWordIdx]) {
-                GlobalWord_3ch& oCurrNewGlobalWord = *m_pGlobalWordListIter_3ch++;
+            if(m_vnGlobalWordDict[nGlobalWordIdx]==s_nInvalidWordHandle) {
+                const WordHandle nNewGlobalWordHandle = (WordHandle)m_nUsedGlobalWords++;
+                GlobalWord_3ch& oCurrNewGlobalWord = m_voGlobalWordList_3ch[nNewGlobalWordHandle];
                 for(size_t c=0; c<3; ++c) {
                     oCurrNewGlobalWord.oFeature.anColor[c] = 0;
                     oCurrNewGlobalWord.oFeature.anDesc[c] = 0;
                 }
                 oCurrNewGlobalWord.nDescBITS = 0;
-                oCurrNewGlobalWord.oSpatioOccMap.create(m_oDownSampledFrameSize_GlobalWordLookup,CV_32FC1);
                 oCurrNewGlobalWord.oSpatioOccMap = cv::Scalar(0.0f);
                 oCurrNewGlobalWord.fLatestWeight = 0.0f;
-                m_vpGlobalWordDict[nGlobalWordIdx] = &oCurrNewGlobalWord;
+                m_vnGlobalWordDict[nGlobalWordIdx] = nNewGlobalWordHandle;
             }
         }
-        CV_Assert(m_voGlobalWordList_3ch.end()==m_pGlobalWordListIter_3ch);
-    }
-    for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
-        // == refresh: per-px global word sort
-        const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
-        const size_t nGlobalWordMapLookupIdx = m_voPxInfoLUT_PAWCS[nPxIter].nGlobalWordMapLookupIdx;
-        float fLastGlobalWordLocalWeight = *(float*)(m_voPxInfoLUT_PAWCS[nPxIter].vpGlobalDictSortLUT[0]->oSpatioOccMap.data+nGlobalWordMapLookupIdx);
-        for(size_t nGlobalWordLUTIdx=1; nGlobalWordLUTIdx<m_nCurrGlobalWords; ++nGlobalWordLUTIdx) {
-            const float fCurrGlobalWordLocalWeight = *(float*)(m_voPxInfoLUT_PAWCS[nPxIter].vpGlobalDictSortLUT[nGlobalWordLUTIdx]->oSpatioOccMap.data+nGlobalWordMapLookupIdx);
-            if(fCurrGlobalWordLocalWeight>fLastGlobalWordLocalWeight)
-                std::swap(m_voPxInfoLUT_PAWCS[nPxIter].vpGlobalDictSortLUT[nGlobalWordLUTIdx],m_voPxInfoLUT_PAWCS[nPxIter].vpGlobalDictSortLUT[nGlobalWordLUTIdx-1]);
-            else
-                fLastGlobalWordLocalWeight = fCurrGlobalWordLocalWeight;
-        }
+        CV_Assert(m_voGlobalWordList_3ch.size()==m_nUsedGlobalWords);
     }
+    process_tiles([&](TileInfo* pTile){sort_global_word_lut(*pTile);},true);
 }
 
 void BackgroundSubtractorPAWCS::initialize(const cv::Mat& oInitImg, const cv::Mat& oROI) {
@@ -434,13 +448,10 @@ void BackgroundSubtractorPAWCS::initialize(const cv::Mat& oInitImg, const cv::Ma
     IBackgroundSubtractorLBSP::initialize_common(oInitImg,oROI);
     m_bModelInitialized = false;
     m_voLocalWordList_1ch.clear();
-    m_pLocalWordListIter_1ch = m_voLocalWordList_1ch.end();
     m_voLocalWordList_3ch.clear();
-    m_pLocalWordListIter_3ch = m_voLocalWordList_3ch.end();
     m_voGlobalWordList_1ch.clear();
-    m_pGlobalWordListIter_1ch = m_voGlobalWordList_1ch.end();
     m_voGlobalWordList_3ch.clear();
-    m_pGlobalWordListIter_3ch = m_voGlobalWordList_3ch.end();
+    m_nUsedGlobalWords = 0;
     m_bUsingMovingCamera = false;
     m_oDownSampledFrameSize_MotionAnalysis = cv::Size(m_oImgSize.width/FRAMELEVEL_DOWNSAMPLE_RATIO,m_oImgSize.height/FRAMELEVEL_DOWNSAMPLE_RATIO);
     m_oDownSampledFrameSize_GlobalWordLookup = cv::Size(m_oImgSize.width/GWORD_LOOKUP_MAPS_DOWNSAMPLE_RATIO,m_oImgSize.height/GWORD_LOOKUP_MAPS_DOWNSAMPLE_RATIO);
@@ -502,61 +513,143 @@ void BackgroundSubtractorPAWCS::initialize(const cv::Mat& oInitImg, const cv::Ma
     m_oLastFGMask_dilated = cv::Scalar_<uchar>(0);
     m_oLastFGMask_dilated_inverted.create(m_oImgSize,CV_8UC1);
     m_oLastFGMask_dilated_inverted = cv::Scalar_<uchar>(0);
-    m_oFGMask_FloodedHoles.create(m_oImgSize,CV_8UC1);
-    m_oFGMask_FloodedHoles = cv::Scalar_<uchar>(0);
-    m_oFGMask_PreFlood.create(m_oImgSize,CV_8UC1);
-    m_oFGMask_PreFlood = cv::Scalar_<uchar>(0);
-    m_oCurrRawFGBlinkMask.create(m_oImgSize,CV_8UC1);
-    m_oCurrRawFGBlinkMask = cv::Scalar_<uchar>(0);
     m_oLastRawFGBlinkMask.create(m_oImgSize,CV_8UC1);
     m_oLastRawFGBlinkMask = cv::Scalar_<uchar>(0);
     m_oTempGlobalWordWeightDiffFactor.create(m_oDownSampledFrameSize_GlobalWordLookup,CV_32FC1);
     m_oTempGlobalWordWeightDiffFactor = cv::Scalar(-0.1f);
-    m_oMorphExStructElement = cv::getStructuringElement(cv::MORPH_RECT,cv::Size(3,3));
+    m_oPostProcessor.initialize(m_oImgSize);
     m_voPxInfoLUT_PAWCS.resize(m_nTotPxCount);
-    m_vpLocalWordDict.resize(m_nTotRelevantPxCount*m_nCurrLocalWords,nullptr);
-    m_vpGlobalWordDict.resize(m_nCurrGlobalWords,nullptr);
+    CV_Assert(m_nTotRelevantPxCount*m_nCurrLocalWords<(size_t)s_nInvalidWordHandle);
+    m_vnLocalWordDict.assign(m_nTotRelevantPxCount*m_nCurrLocalWords,s_nInvalidWordHandle);
+    m_vnGlobalWordDict.assign(m_nCurrGlobalWords,s_nInvalidWordHandle);
+    m_vfLocalWordWeightCache.resize(m_nTotRelevantPxCount*m_nCurrLocalWords);
+    m_vnLocalWordWeightCacheFrameIdx.assign(m_nTotRelevantPxCount*m_nCurrLocalWords,SIZE_MAX);
+    m_vnGlobalWordSortLUT.resize(m_nTotRelevantPxCount*m_nCurrGlobalWords);
+    m_nGlobalWordSpatioOccMapSize = (size_t)m_oDownSampledFrameSize_GlobalWordLookup.area()*sizeof(float);
+    m_oGlobalWordSpatioOccMaps.create(m_oDownSampledFrameSize_GlobalWordLookup.height*(int)m_nCurrGlobalWords,m_oDownSampledFrameSize_GlobalWordLookup.width,CV_32FC1);
+    m_oGlobalWordSpatioOccMaps = cv::Scalar(0.0f);
     if(m_nImgChannels==1) {
         m_voLocalWordList_1ch.resize(m_nTotRelevantPxCount*m_nCurrLocalWords);
-        m_pLocalWordListIter_1ch = m_voLocalWordList_1ch.begin();
         m_voGlobalWordList_1ch.resize(m_nCurrGlobalWords);
-        m_pGlobalWordListIter_1ch = m_voGlobalWordList_1ch.begin();
-        for(size_t nPxIter=0, nModelIter=0; nPxIter<m_nTotPxCount; ++nPxIter) {
-            if(m_oROI.data[nPxIter]) {
-                m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y = (int)nPxIter/m_oImgSize.width;
-                m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X = (int)nPxIter%m_oImgSize.width;
-                m_voPxInfoLUT_PAWCS[nPxIter].nModelIdx = nModelIter;
-                m_voPxInfoLUT_PAWCS[nPxIter].nGlobalWordMapLookupIdx = (size_t)((m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y/GWORD_LOOKUP_MAPS_DOWNSAMPLE_RATIO)*m_oDownSampledFrameSize_GlobalWordLookup.width+(m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X/GWORD_LOOKUP_MAPS_DOWNSAMPLE_RATIO))*4;
-                m_voPxInfoLUT_PAWCS[nPxIter].vpGlobalDictSortLUT.resize(m_nCurrGlobalWords);
-                for(size_t nGlobalWordIdxIter=0; nGlobalWordIdxIter<m_nCurrGlobalWords; ++nGlobalWordIdxIter)
-                    m_voPxInfoLUT_PAWCS[nPxIter].vpGlobalDictSortLUT[nGlobalWordIdxIter] = &m_voGlobalWordList_1ch[nGlobalWordIdxIter];
-                ++nModelIter;
-            }
-        }
+        for(size_t nGlobalWordIdx=0; nGlobalWordIdx<m_nCurrGlobalWords; ++nGlobalWordIdx)
+            m_voGlobalWordList_1ch[nGlobalWordIdx].oSpatioOccMap = cv::Mat(m_oDownSampledFrameSize_GlobalWordLookup,CV_32FC1,m_oGlobalWordSpatioOccMaps.data+nGlobalWordIdx*m_nGlobalWordSpatioOccMapSize);
     }
     else { //m_nImgChannels==3
         m_voLocalWordList_3ch.resize(m_nTotRelevantPxCount*m_nCurrLocalWords);
-        m_pLocalWordListIter_3ch = m_voLocalWordList_3ch.begin();
         m_voGlobalWordList_3ch.resize(m_nCurrGlobalWords);
-        m_pGlobalWordListIter_3ch = m_voGlobalWordList_3ch.begin();
-        for(size_t nPxIter=0, nModelIter=0; nPxIter<m_nTotPxCount; ++nPxIter) {
-            if(m_oROI.data[nPxIter]) {
-                m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y = (int)nPxIter/m_oImgSize.width;
-                m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X = (int)nPxIter%m_oImgSize.width;
-                m_voPxInfoLUT_PAWCS[nPxIter].nModelIdx = nModelIter;
-                m_voPxInfoLUT_PAWCS[nPxIter].nGlobalWordMapLookupIdx = (size_t)((m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y/GWORD_LOOKUP_MAPS_DOWNSAMPLE_RATIO)*m_oDownSampledFrameSize_GlobalWordLookup.width+(m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X/GWORD_LOOKUP_MAPS_DOWNSAMPLE_RATIO))*4;
-                m_voPxInfoLUT_PAWCS[nPxIter].vpGlobalDictSortLUT.resize(m_nCurrGlobalWords);
-                for(size_t nGlobalWordIdxIter=0; nGlobalWordIdxIter<m_nCurrGlobalWords; ++nGlobalWordIdxIter)
-                    m_voPxInfoLUT_PAWCS[nPxIter].vpGlobalDictSortLUT[nGlobalWordIdxIter] = &m_voGlobalWordList_3ch[nGlobalWordIdxIter];
-                ++nModelIter;
-            }
+        for(size_t nGlobalWordIdx=0; nGlobalWordIdx<m_nCurrGlobalWords; ++nGlobalWordIdx)
+            m_voGlobalWordList_3ch[nGlobalWordIdx].oSpatioOccMap = cv::Mat(m_oDownSampledFrameSize_GlobalWordLookup,CV_32FC1,m_oGlobalWordSpatioOccMaps.data+nGlobalWordIdx*m_nGlobalWordSpatioOccMapSize);
+    }
+    for(size_t nPxIter=0, nModelIter=0; nPxIter<m_nTotPxCount; ++nPxIter) {
+        if(m_oROI.data[nPxIter]) {
+            m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y = (int)nPxIter/m_oImgSize.width;
+            m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X = (int)nPxIter%m_oImgSize.width;
+            m_voPxInfoLUT_PAWCS[nPxIter].nModelIdx = nModelIter;
+            m_voPxInfoLUT_PAWCS[nPxIter].nGlobalWordMapLookupIdx = (size_t)((m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y/GWORD_LOOKUP_MAPS_DOWNSAMPLE_RATIO)*m_oDownSampledFrameSize_GlobalWordLookup.width+(m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X/GWORD_LOOKUP_MAPS_DOWNSAMPLE_RATIO))*4;
+            for(size_t nGlobalWordIdxIter=0; nGlobalWordIdxIter<m_nCurrGlobalWords; ++nGlobalWordIdxIter)
+                m_vnGlobalWordSortLUT[nModelIter*m_nCurrGlobalWords+nGlobalWordIdxIter] = (WordHandle)nGlobalWordIdxIter;
+            ++nModelIter;
         }
     }
+    initialize_tiles();
     m_bInitialized = true;
     refreshModel(1,0);
     m_bModelInitialized = true;
 }
 
+void BackgroundSubtractorPAWCS::initialize_tiles() {
+    const int nTileRows = (m_nTileRows==0 || m_nTileRows>(size_t)m_oImgSize.height)?m_oImgSize.height:(int)m_nTileRows;
+    const size_t nTileCount = (size_t)((m_oImgSize.height+nTileRows-1)/nTileRows);
+    m_voTiles.resize(nTileCount);
+    size_t nModelIter = 0;
+    for(size_t nTileIdx=0; nTileIdx<nTileCount; ++nTileIdx) {
+        TileInfo& oTile = m_voTiles[nTileIdx];
+        oTile.nRowBegin = (int)nTileIdx*nTileRows;
+        oTile.nRowEnd = std::min(oTile.nRowBegin+nTileRows,m_oImgSize.height);
+        oTile.nModelIterBegin = nModelIter;
+        while(nModelIter<m_nTotRelevantPxCount && m_voPxInfoLUT_PAWCS[m_vnPxIdxLUT[nModelIter]].nImgCoord_Y<oTile.nRowEnd)
+            ++nModelIter;
+        oTile.nModelIterEnd = nModelIter;
+        oTile.nFlatRegionCount = 0;
+        oTile.oRNG.seed(CxxUtils::FastRNG::getSubSeed(m_nRandomSeed,nTileIdx));
+        oTile.voDeferredNeighborUpdates.clear();
+        oTile.voDeferredGlobalWordUpdates.clear();
+        if(nTileCount>1) // neighbor updates can reach at most (PATCH_SIZE/2) rows away from the tile borders
+            oTile.voDeferredNeighborUpdates.reserve((LBSP::PATCH_SIZE/2)*2*(size_t)m_oImgSize.width);
+    }
+    CV_Assert(nModelIter==m_nTotRelevantPxCount);
+}
+
+void BackgroundSubtractorPAWCS::setParallelTiling(size_t nTileRows, size_t nWorkers) {
+    CV_Assert(nWorkers>0);
+    m_nTileRows = nTileRows;
+    if(nWorkers==1)
+        m_pWorkerPool.reset();
+    else if(!m_pWorkerPool || m_pWorkerPool->getWorkerCount()!=nWorkers)
+        m_pWorkerPool = std::make_unique<PlatformUtils::DynamicWorkerPool>(nWorkers);
+    if(m_bInitialized)
+        initialize_tiles();
+}
+
+void BackgroundSubtractorPAWCS::process_tiles(const std::function<void(TileInfo*)>& lTileProcessor, bool bAllowWorkers) {
+    if(bAllowWorkers && m_pWorkerPool && m_voTiles.size()>1) {
+        std::vector<std::future<void>> voTileTasks;
+        voTileTasks.reserve(m_voTiles.size());
+        for(TileInfo& oTile : m_voTiles)
+            voTileTasks.push_back(m_pWorkerPool->queueTask(lTileProcessor,&oTile));
+        for(std::future<void>& oTileTask : voTileTasks)
+            oTileTask.get(); // will rethrow any exception caught in the worker
+    }
+    else {
+        for(TileInfo& oTile : m_voTiles)
+            lTileProcessor(&oTile);
+    }
+}
+
+void BackgroundSubtractorPAWCS::update_global_word(const GlobalWordUpdate& oUpdate) {
+    WordHandle nGlobalWordHandle = oUpdate.nGlobalWordHandle;
+    if(nGlobalWordHandle==s_nInvalidWordHandle) {
+        // no match in the source px lookup order; recycle the weakest word of the dictionary
+        nGlobalWordHandle = m_vnGlobalWordDict[m_nCurrGlobalWords-1];
+        if(m_nImgChannels==1) {
+            GlobalWord_1ch& oNewGlobalWord = m_voGlobalWordList_1ch[nGlobalWordHandle];
+            oNewGlobalWord.oFeature.anColor[0] = oUpdate.anColor[0];
+            oNewGlobalWord.oFeature.anDesc[0] = oUpdate.anDesc[0];
+        }
+        else { //m_nImgChannels==3
+            GlobalWord_3ch& oNewGlobalWord = m_voGlobalWordList_3ch[nGlobalWordHandle];
+            oNewGlobalWord.oFeature.anColor = oUpdate.anColor;
+            oNewGlobalWord.oFeature.anDesc = oUpdate.anDesc;
+        }
+        GlobalWordBase& oNewGlobalWord = getGlobalWordBase(nGlobalWordHandle);
+        oNewGlobalWord.nDescBITS = oUpdate.nDescBITS;
+        oNewGlobalWord.oSpatioOccMap = cv::Scalar(0.0f);
+        oNewGlobalWord.fLatestWeight = 0.0f;
+    }
+    float& fCurrGlobalWordLocalWeight = getGlobalWordLocalWeight(nGlobalWordHandle,oUpdate.nGlobalWordMapLookupIdx);
+    if(fCurrGlobalWordLocalWeight<oUpdate.fWeight) {
+        getGlobalWordBase(nGlobalWordHandle).fLatestWeight += oUpdate.fWeight;
+        fCurrGlobalWordLocalWeight += oUpdate.fWeight;
+    }
+}
+
+void BackgroundSubtractorPAWCS::sort_global_word_lut(const TileInfo& oTile) {
+    for(size_t nModelIter=oTile.nModelIterBegin; nModelIter<oTile.nModelIterEnd; ++nModelIter) {
+        // == refresh: per-px global word sort
+        const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
+        const size_t nGlobalWordMapLookupIdx = m_voPxInfoLUT_PAWCS[nPxIter].nGlobalWordMapLookupIdx;
+        const size_t nGlobalSortLUTIdx = nModelIter*m_nCurrGlobalWords;
+        float fLastGlobalWordLocalWeight = getGlobalWordLocalWeight(m_vnGlobalWordSortLUT[nGlobalSortLUTIdx],nGlobalWordMapLookupIdx);
+        for(size_t nGlobalWordLUTIdx=1; nGlobalWordLUTIdx<m_nCurrGlobalWords; ++nGlobalWordLUTIdx) {
+            const float fCurrGlobalWordLocalWeight = getGlobalWordLocalWeight(m_vnGlobalWordSortLUT[nGlobalSortLUTIdx+nGlobalWordLUTIdx],nGlobalWordMapLookupIdx);
+            if(fCurrGlobalWordLocalWeight>fLastGlobalWordLocalWeight)
+                std::swap(m_vnGlobalWordSortLUT[nGlobalSortLUTIdx+nGlobalWordLUTIdx],m_vnGlobalWordSortLUT[nGlobalSortLUTIdx+nGlobalWordLUTIdx-1]);
+            else
+                fLastGlobalWordLocalWeight = fCurrGlobalWordLocalWeight;
+        }
+    }
+}
+
 void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fgmask, double learningRateOverride) {
     // == process
     CV_Assert(m_bInitialized && m_bModelInitialized);
@@ -572,7 +665,8 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
     const float fRollAvgFactor_LT = 1.0f/std::min(m_nFrameIdx,nCurrSamplesForMovingAvg_LT);
     const float fRollAvgFactor_ST = 1.0f/std::min(m_nFrameIdx,nCurrSamplesForMovingAvg_ST);
     const size_t nCurrGlobalWordUpdateRate = bBootstrapping?DEFAULT_RESAMPLING_RATE/2:DEFAULT_RESAMPLING_RATE;
-    size_t nFlatRegionCount = 0;
+    const bool bDeferGlobalWordUpdates = m_voTiles.size()>1;
+    m_pCurrDescFrame = m_pDescCache?m_pDescCache->get(oInputImg,m_nFrameIdx,m_anLBSPThreshold_8bitLUT):nullptr;
 #if DISPLAY_PAWCS_DEBUG_INFO
     std::vector<std::string> vsWordModList(m_nTotRelevantPxCount*m_nCurrLocalWords);
     std::array<uchar,3> anDBGColor = {0,0,0};
@@ -606,697 +700,759 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
     std::chrono::high_resolution_clock::time_point post_lastKP = std::chrono::high_resolution_clock::now();
     std::chrono::high_resolution_clock::time_point pre_gword_calcs;
 #endif //USE_INTERNAL_HRCS
-    if(m_nImgChannels==1) {
+    const auto lNeighborUpdate_1ch = [&](const NeighborModelUpdate& oUpdate, CxxUtils::FastRNG& oRNG) {
+        const size_t nNeighborLocalDictIdx = m_voPxInfoLUT_PAWCS[oUpdate.nDstPxIdx].nModelIdx*m_nCurrLocalWords;
+        size_t nNeighborLocalWordIdx = 0;
+        float fNeighborPotentialLocalWordsWeightSum = 0.0f;
+        while(nNeighborLocalWordIdx<m_nCurrLocalWords && fNeighborPotentialLocalWordsWeightSum<oUpdate.fLocalWordsWeightSumThreshold) {
+            LocalWord_1ch oNeighborLocalWord = *GetWord(m_voLocalWordList_1ch,m_vnLocalWordDict[nNeighborLocalDictIdx+nNeighborLocalWordIdx]);
+            const size_t nNeighborColorDist = DistanceUtils::L1dist(oUpdate.anColor[0],oNeighborLocalWord.oFeature.anColor[0]);
+            const size_t nNeighborIntraDescDist = DistanceUtils::hdist(oUpdate.anIntraDesc[0],oNeighborLocalWord.oFeature.anDesc[0]);
+            const bool bNeighborRegionIsFlat = DistanceUtils::popcount(oNeighborLocalWord.oFeature.anDesc[0])<FLAT_REGION_BIT_COUNT;
+            const size_t nNeighborWordOccIncr = bNeighborRegionIsFlat?oUpdate.nWordOccIncr*2:oUpdate.nWordOccIncr;
+            if(nNeighborColorDist<=oUpdate.nColorDistThreshold && nNeighborIntraDescDist<=oUpdate.nDescDistThreshold) {
+                const float fNeighborLocalWordWeight = GetLocalWordWeight(oNeighborLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
+                fNeighborPotentialLocalWordsWeightSum += fNeighborLocalWordWeight;
+                oNeighborLocalWord.nLastOcc = m_nFrameIdx;
+                if(fNeighborLocalWordWeight<DEFAULT_LWORD_MAX_WEIGHT)
+                    oNeighborLocalWord.nOccurrences += nNeighborWordOccIncr;
+#if DISPLAY_PAWCS_DEBUG_INFO
+                vsWordModList[nNeighborLocalDictIdx+nNeighborLocalWordIdx] += "MATCHED(NEIGHBOR) ";
+#endif //DISPLAY_PAWCS_DEBUG_INFO
+            }
+            else if(!oCurrFGMask.data[oUpdate.nDstPxIdx] && oUpdate.bSrcRegionIsFlat && (bBootstrapping || (oRNG()%oUpdate.nLocalWordUpdateRate)==0)) {
+                const size_t nSampleDescIdx = oUpdate.nDstPxIdx*2;
+                ushort& nNeighborLastIntraDesc = *((ushort*)(m_oLastDescFrame.data+nSampleDescIdx));
+                const size_t nNeighborLastIntraDescDist = DistanceUtils::hdist(oUpdate.anIntraDesc[0],nNeighborLastIntraDesc);
+                if(nNeighborColorDist<=oUpdate.nColorDistThreshold && nNeighborLastIntraDescDist<=oUpdate.nDescDistThreshold/2) {
+                    const float fNeighborLocalWordWeight = GetLocalWordWeight(oNeighborLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
+                    fNeighborPotentialLocalWordsWeightSum += fNeighborLocalWordWeight;
+                    oNeighborLocalWord.nLastOcc = m_nFrameIdx;
+                    if(fNeighborLocalWordWeight<DEFAULT_LWORD_MAX_WEIGHT)
+                        oNeighborLocalWord.nOccurrences += nNeighborWordOccIncr;
+                    oNeighborLocalWord.oFeature.anDesc[0] = oUpdate.anIntraDesc[0];
+#if DISPLAY_PAWCS_DEBUG_INFO
+                    vsWordModList[nNeighborLocalDictIdx+nNeighborLocalWordIdx] += "UPDATED1(NEIGHBOR) ";
+#endif //DISPLAY_PAWCS_DEBUG_INFO
+                }
+            }
+            ++nNeighborLocalWordIdx;
+        }
+        if(fNeighborPotentialLocalWordsWeightSum<DEFAULT_LWORD_INIT_WEIGHT) {
+            nNeighborLocalWordIdx = m_nCurrLocalWords-1;
+            LocalWord_1ch& oNeighborLocalWord = *GetWord(m_voLocalWordList_1ch,m_vnLocalWordDict[nNeighborLocalDictIdx+nNeighborLocalWordIdx]);
+            oNeighborLocalWord.oFeature.anColor[0] = oUpdate.anColor[0];
+            oNeighborLocalWord.oFeature.anDesc[0] = oUpdate.anIntraDesc[0];
+            oNeighborLocalWord.nOccurrences = oUpdate.nWordOccIncr;
+            oNeighborLocalWord.nFirstOcc = m_nFrameIdx;
+            oNeighborLocalWord.nLastOcc = m_nFrameIdx;
+            setCachedLocalWordWeight(nNeighborLocalDictIdx+nNeighborLocalWordIdx,GetLocalWordWeight(oNeighborLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset));
+#if DISPLAY_PAWCS_DEBUG_INFO
+            vsWordModList[nNeighborLocalDictIdx+nNeighborLocalWordIdx] += "NEW(NEIGHBOR) ";
+#endif //DISPLAY_PAWCS_DEBUG_INFO
+        }
+    };
+    const auto lNeighborUpdate_3ch = [&](const NeighborModelUpdate& oUpdate, CxxUtils::FastRNG& oRNG) {
+        const size_t nNeighborLocalDictIdx = m_voPxInfoLUT_PAWCS[oUpdate.nDstPxIdx].nModelIdx*m_nCurrLocalWords;
+        size_t nNeighborLocalWordIdx = 0;
+        float fNeighborPotentialLocalWordsWeightSum = 0.0f;
+        while(nNeighborLocalWordIdx<m_nCurrLocalWords && fNeighborPotentialLocalWordsWeightSum<oUpdate.fLocalWordsWeightSumThreshold) {
+            LocalWord_3ch& oNeighborLocalWord = *GetWord(m_voLocalWordList_3ch,m_vnLocalWordDict[nNeighborLocalDictIdx+nNeighborLocalWordIdx]);
+            const size_t nNeighborTotColorL1Dist = DistanceUtils::L1dist(oUpdate.anColor,oNeighborLocalWord.oFeature.anColor);
+            const size_t nNeighborColorDistortion = DistanceUtils::cdist(oUpdate.anColor,oNeighborLocalWord.oFeature.anColor);
+            const size_t nNeighborTotColorMixDist = DistanceUtils::cmixdist(nNeighborTotColorL1Dist,nNeighborColorDistortion);
+            const size_t nNeighborTotIntraDescDist = DistanceUtils::hdist(oUpdate.anIntraDesc,oNeighborLocalWord.oFeature.anDesc);
+            const bool bNeighborRegionIsFlat = DistanceUtils::popcount(oNeighborLocalWord.oFeature.anDesc)<FLAT_REGION_BIT_COUNT*2;
+            const size_t nNeighborWordOccIncr = bNeighborRegionIsFlat?oUpdate.nWordOccIncr*2:oUpdate.nWordOccIncr;
+            if(nNeighborTotColorMixDist<=oUpdate.nColorDistThreshold && nNeighborTotIntraDescDist<=oUpdate.nDescDistThreshold) {
+                const float fNeighborLocalWordWeight = GetLocalWordWeight(oNeighborLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
+                fNeighborPotentialLocalWordsWeightSum += fNeighborLocalWordWeight;
+                oNeighborLocalWord.nLastOcc = m_nFrameIdx;
+                if(fNeighborLocalWordWeight<DEFAULT_LWORD_MAX_WEIGHT)
+                    oNeighborLocalWord.nOccurrences += nNeighborWordOccIncr;
+                invalidateCachedLocalWordWeight(nNeighborLocalDictIdx+nNeighborLocalWordIdx);
+#if DISPLAY_PAWCS_DEBUG_INFO
+                vsWordModList[nNeighborLocalDictIdx+nNeighborLocalWordIdx] += "MATCHED(NEIGHBOR) ";
+#endif //DISPLAY_PAWCS_DEBUG_INFO
+            }
+            else if(!oCurrFGMask.data[oUpdate.nDstPxIdx] && oUpdate.bSrcRegionIsFlat && (bBootstrapping || (oRNG()%oUpdate.nLocalWordUpdateRate)==0)) {
+                const size_t nSamplePxRGBIdx = oUpdate.nDstPxIdx*3;
+                const size_t nSampleDescRGBIdx = nSamplePxRGBIdx*2;
+                ushort* anNeighborLastIntraDesc = ((ushort*)(m_oLastDescFrame.data+nSampleDescRGBIdx));
+                const size_t nNeighborTotLastIntraDescDist = DistanceUtils::hdist(oUpdate.anIntraDesc,anNeighborLastIntraDesc);
+                if(nNeighborTotColorMixDist<=oUpdate.nColorDistThreshold && nNeighborTotLastIntraDescDist<=oUpdate.nDescDistThreshold/2) {
+                    const float fNeighborLocalWordWeight = GetLocalWordWeight(oNeighborLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
+                    fNeighborPotentialLocalWordsWeightSum += fNeighborLocalWordWeight;
+                    oNeighborLocalWord.nLastOcc = m_nFrameIdx;
+                    if(fNeighborLocalWordWeight<DEFAULT_LWORD_MAX_WEIGHT)
+                        oNeighborLocalWord.nOccurrences += nNeighborWordOccIncr;
+                    invalidateCachedLocalWordWeight(nNeighborLocalDictIdx+nNeighborLocalWordIdx);
+                    for(size_t c=0; c<3; ++c)
+                        oNeighborLocalWord.oFeature.anDesc[c] = oUpdate.anIntraDesc[c];
+#if DISPLAY_PAWCS_DEBUG_INFO
+                    vsWordModList[nNeighborLocalDictIdx+nNeighborLocalWordIdx] += "UPDATED1(NEIGHBOR) ";
+#endif //DISPLAY_PAWCS_DEBUG_INFO
+                }
+                else {
+                    const bool bNeighborLastRegionIsFlat = DistanceUtils::popcount<3>(anNeighborLastIntraDesc)<FLAT_REGION_BIT_COUNT*2;
+                    if(bNeighborLastRegionIsFlat && oUpdate.bSrcRegionIsFlat &&
+                        nNeighborTotLastIntraDescDist+nNeighborTotIntraDescDist<=oUpdate.nDescDistThreshold &&
+                        nNeighborColorDistortion<=oUpdate.nColorDistThreshold/4) {
+                            const float fNeighborLocalWordWeight = GetLocalWordWeight(oNeighborLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
+                            fNeighborPotentialLocalWordsWeightSum += fNeighborLocalWordWeight;
+                            oNeighborLocalWord.nLastOcc = m_nFrameIdx;
+                            if(fNeighborLocalWordWeight<DEFAULT_LWORD_MAX_WEIGHT)
+                                oNeighborLocalWord.nOccurrences += nNeighborWordOccIncr;
+                            invalidateCachedLocalWordWeight(nNeighborLocalDictIdx+nNeighborLocalWordIdx);
+                            for(size_t c=0; c<3; ++c)
+                                oNeighborLocalWord.oFeature.anColor[c] = oUpdate.anColor[c];
+#if DISPLAY_PAWCS_DEBUG_INFO
+                            vsWordModList[nNeighborLocalDictIdx+nNeighborLocalWordIdx] += "UPDATED2(NEIGHBOR) ";
+#endif //DISPLAY_PAWCS_DEBUG_INFO
+                    }
+                }
+            }
+            ++nNeighborLocalWordIdx;
+        }
+        if(fNeighborPotentialLocalWordsWeightSum<DEFAULT_LWORD_INIT_WEIGHT) {
+            nNeighborLocalWordIdx = m_nCurrLocalWords-1;
+            LocalWord_3ch& oNeighborLocalWord = *GetWord(m_voLocalWordList_3ch,m_vnLocalWordDict[nNeighborLocalDictIdx+nNeighborLocalWordIdx]);
+            for(size_t c=0; c<3; ++c) {
+                oNeighborLocalWord.oFeature.anColor[c] = oUpdate.anColor[c];
+                oNeighborLocalWord.oFeature.anDesc[c] = oUpdate.anIntraDesc[c];
+            }
+            oNeighborLocalWord.nOccurrences = oUpdate.nWordOccIncr;
+            oNeighborLocalWord.nFirstOcc = m_nFrameIdx;
+            oNeighborLocalWord.nLastOcc = m_nFrameIdx;
+            setCachedLocalWordWeight(nNeighborLocalDictIdx+nNeighborLocalWordIdx,GetLocalWordWeight(oNeighborLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset));
+#if DISPLAY_PAWCS_DEBUG_INFO
+            vsWordModList[nNeighborLocalDictIdx+nNeighborLocalWordIdx] += "NEW(NEIGHBOR) ";
+#endif //DISPLAY_PAWCS_DEBUG_INFO
+        }
+    };
+    const auto lTileProcessor = [&](TileInfo* pTile) {
+        TileInfo& oTile = *pTile;
+        oTile.nFlatRegionCount = 0;
+        oTile.voDeferredNeighborUpdates.clear();
+        oTile.voDeferredGlobalWordUpdates.clear();
+        if(m_nImgChannels==1) {
 #if USE_INTERNAL_HRCS
-        std::chrono::high_resolution_clock::time_point pre_loop = std::chrono::high_resolution_clock::now();
+            std::chrono::high_resolution_clock::time_point pre_loop = std::chrono::high_resolution_clock::now();
 #endif //USE_INTERNAL_HRCS
-        for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
+            for(size_t nModelIter=oTile.nModelIterBegin; nModelIter<oTile.nModelIterEnd; ++nModelIter) {
 #if USE_INTERNAL_HRCS
-            std::chrono::high_resolution_clock::time_point pre_currKP = std::chrono::high_resolution_clock::now();
-            fInterKPsTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(pre_currKP-post_lastKP).count())/1000000;
-            std::chrono::high_resolution_clock::time_point pre_prep = std::chrono::high_resolution_clock::now();
+                std::chrono::high_resolution_clock::time_point pre_currKP = std::chrono::high_resolution_clock::now();
+                fInterKPsTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(pre_currKP-post_lastKP).count())/1000000;
+                std::chrono::high_resolution_clock::time_point pre_prep = std::chrono::high_resolution_clock::now();
 #endif //USE_INTERNAL_HRCS
-            const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
-            const size_t nDescIter = nPxIter*2;
-            const size_t nFloatIter = nPxIter*4;
-            const size_t nLocalDictIdx = nModelIter*m_nCurrLocalWords;
-            const size_t nGlobalWordMapLookupIdx = m_voPxInfoLUT_PAWCS[nPxIter].nGlobalWordMapLookupIdx;
-            const uchar nCurrColor = oInputImg.data[nPxIter];
-            uchar& nLastColor = m_oLastColorFrame.data[nPxIter];
-            ushort& nLastIntraDesc = *((ushort*)(m_oLastDescFrame.data+nDescIter));
-            size_t nMinColorDist = s_nColorMaxDataRange_1ch;
-            size_t nMinDescDist = s_nDescMaxDataRange_1ch;
-            float& fCurrMeanRawSegmRes_LT = *(float*)(m_oMeanRawSegmResFrame_LT.data+nFloatIter);
-            float& fCurrMeanRawSegmRes_ST = *(float*)(m_oMeanRawSegmResFrame_ST.data+nFloatIter);
-            float& fCurrMeanFinalSegmRes_LT = *(float*)(m_oMeanFinalSegmResFrame_LT.data+nFloatIter);
-            float& fCurrMeanFinalSegmRes_ST = *(float*)(m_oMeanFinalSegmResFrame_ST.data+nFloatIter);
-            float& fCurrDistThresholdFactor = *(float*)(m_oDistThresholdFrame.data+nFloatIter);
+                const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
+                const size_t nDescIter = nPxIter*2;
+                const size_t nFloatIter = nPxIter*4;
+                const size_t nLocalDictIdx = nModelIter*m_nCurrLocalWords;
+                const size_t nGlobalWordMapLookupIdx = m_voPxInfoLUT_PAWCS[nPxIter].nGlobalWordMapLookupIdx;
+                const uchar nCurrColor = oInputImg.data[nPxIter];
+                uchar& nLastColor = m_oLastColorFrame.data[nPxIter];
+                ushort& nLastIntraDesc = *((ushort*)(m_oLastDescFrame.data+nDescIter));
+                size_t nMinColorDist = s_nColorMaxDataRange_1ch;
+                size_t nMinDescDist = s_nDescMaxDataRange_1ch;
+                float& fCurrMeanRawSegmRes_LT = *(float*)(m_oMeanRawSegmResFrame_LT.data+nFloatIter);
+                float& fCurrMeanRawSegmRes_ST = *(float*)(m_oMeanRawSegmResFrame_ST.data+nFloatIter);
+                float& fCurrMeanFinalSegmRes_LT = *(float*)(m_oMeanFinalSegmResFrame_LT.data+nFloatIter);
+                float& fCurrMeanFinalSegmRes_ST = *(float*)(m_oMeanFinalSegmResFrame_ST.data+nFloatIter);
+                float& fCurrDistThresholdFactor = *(float*)(m_oDistThresholdFrame.data+nFloatIter);
 #if USE_FEEDBACK_ADJUSTMENTS
-            float& fCurrDistThresholdVariationFactor = *(float*)(m_oDistThresholdVariationFrame.data+nFloatIter);
-            float& fCurrLearningRate = *(float*)(m_oUpdateRateFrame.data+nFloatIter);
-            float& fCurrMeanMinDist_LT = *(float*)(m_oMeanMinDistFrame_LT.data+nFloatIter);
-            float& fCurrMeanMinDist_ST = *(float*)(m_oMeanMinDistFrame_ST.data+nFloatIter);
+                float& fCurrDistThresholdVariationFactor = *(float*)(m_oDistThresholdVariationFrame.data+nFloatIter);
+                float& fCurrLearningRate = *(float*)(m_oUpdateRateFrame.data+nFloatIter);
+                float& fCurrMeanMinDist_LT = *(float*)(m_oMeanMinDistFrame_LT.data+nFloatIter);
+                float& fCurrMeanMinDist_ST = *(float*)(m_oMeanMinDistFrame_ST.data+nFloatIter);
 #endif //USE_FEEDBACK_ADJUSTMENTS
-            const float fBestLocalWordWeight = GetLocalWordWeight(*m_vpLocalWordDict[nLocalDictIdx],m_nFrameIdx,m_nLocalWordWeightOffset);
-            const float fLocalWordsWeightSumThreshold = fBestLocalWordWeight/(fCurrDistThresholdFactor*2);
-            uchar& bCurrRegionIsUnstable = m_oUnstableRegionMask.data[nPxIter];
-            uchar& nCurrRegionIllumUpdtVal = m_oIllumUpdtRegionMask.data[nPxIter];
-            uchar& nCurrRegionSegmVal = oCurrFGMask.data[nPxIter];
-            const bool bCurrRegionIsROIBorder = m_oROI.data[nPxIter]<UCHAR_MAX;
+                const float fBestLocalWordWeight = GetLocalWordWeight(*GetWord(m_voLocalWordList_1ch,m_vnLocalWordDict[nLocalDictIdx]),m_nFrameIdx,m_nLocalWordWeightOffset);
+                const float fLocalWordsWeightSumThreshold = fBestLocalWordWeight/(fCurrDistThresholdFactor*2);
+                uchar& bCurrRegionIsUnstable = m_oUnstableRegionMask.data[nPxIter];
+                uchar& nCurrRegionIllumUpdtVal = m_oIllumUpdtRegionMask.data[nPxIter];
+                uchar& nCurrRegionSegmVal = oCurrFGMask.data[nPxIter];
+                const bool bCurrRegionIsROIBorder = m_oROI.data[nPxIter]<UCHAR_MAX;
 #if DISPLAY_PAWCS_DEBUG_INFO
-            oDBGWeightThresholds.at<float>(m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X) = fLocalWordsWeightSumThreshold;
+                oDBGWeightThresholds.at<float>(m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X) = fLocalWordsWeightSumThreshold;
 #endif //DISPLAY_PAWCS_DEBUG_INFO
-            const int nCurrImgCoord_X = m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X;
-            const int nCurrImgCoord_Y = m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y;
-            alignas(16) std::array<uchar,LBSP::DESC_SIZE_BITS> anLBSPLookupVals;
-            LBSP::computeDescriptor_lookup<1>(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,0,anLBSPLookupVals);
-            const ushort nCurrIntraDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
-            const uchar nCurrIntraDescBITS = (uchar)DistanceUtils::popcount(nCurrIntraDesc);
-            const bool bCurrRegionIsFlat = nCurrIntraDescBITS<FLAT_REGION_BIT_COUNT;
-            if(bCurrRegionIsFlat)
-                ++nFlatRegionCount;
-            const size_t nCurrWordOccIncr = (DEFAULT_LWORD_OCC_INCR+m_nModelResetCooldown)<<int(bCurrRegionIsFlat||bBootstrapping);
+                const int nCurrImgCoord_X = m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X;
+                const int nCurrImgCoord_Y = m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y;
+                alignas(16) std::array<uchar,LBSP::DESC_SIZE_BITS> anLBSPLookupVals;
+                LBSP::computeDescriptor_lookup<1>(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,0,anLBSPLookupVals);
+                const ushort nCurrIntraDesc = m_pCurrDescFrame?((const ushort*)m_pCurrDescFrame->data)[nPxIter]:LBSP::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
+                const uchar nCurrIntraDescBITS = (uchar)DistanceUtils::popcount(nCurrIntraDesc);
+                const bool bCurrRegionIsFlat = nCurrIntraDescBITS<FLAT_REGION_BIT_COUNT;
+                if(bCurrRegionIsFlat)
+                    ++oTile.nFlatRegionCount;
+                const size_t nCurrWordOccIncr = (DEFAULT_LWORD_OCC_INCR+m_nModelResetCooldown)<<int(bCurrRegionIsFlat||bBootstrapping);
 #if USE_FEEDBACK_ADJUSTMENTS
-            const size_t nCurrLocalWordUpdateRate = learningRateOverride>0?(size_t)ceil(learningRateOverride):bCurrRegionIsFlat?(size_t)ceil(fCurrLearningRate+FEEDBACK_T_LOWER)/2:(size_t)ceil(fCurrLearningRate);
+                const size_t nCurrLocalWordUpdateRate = learningRateOverride>0?(size_t)ceil(learningRateOverride):bCurrRegionIsFlat?(size_t)ceil(fCurrLearningRate+FEEDBACK_T_LOWER)/2:(size_t)ceil(fCurrLearningRate);
 #else //(!USE_FEEDBACK_ADJUSTMENTS)
-            const size_t nCurrLocalWordUpdateRate = learningRateOverride>0?(size_t)ceil(learningRateOverride):(size_t)DEFAULT_RESAMPLING_RATE;
+                const size_t nCurrLocalWordUpdateRate = learningRateOverride>0?(size_t)ceil(learningRateOverride):(size_t)DEFAULT_RESAMPLING_RATE;
 #endif //(!USE_FEEDBACK_ADJUSTMENTS)
-            const size_t nCurrColorDistThreshold = (size_t)(sqrt(fCurrDistThresholdFactor)*m_nMinColorDistThreshold)/2;
-            const size_t nCurrDescDistThreshold = ((size_t)1<<((size_t)floor(fCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(bCurrRegionIsUnstable*UNSTAB_DESC_DIST_OFFSET);
-            size_t nLocalWordIdx = 0;
-            float fPotentialLocalWordsWeightSum = 0.0f;
-            float fLastLocalWordWeight = FLT_MAX;
+                const size_t nCurrColorDistThreshold = (size_t)(sqrt(fCurrDistThresholdFactor)*m_nMinColorDistThreshold)/2;
+                const size_t nCurrDescDistThreshold = ((size_t)1<<((size_t)floor(fCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(bCurrRegionIsUnstable*UNSTAB_DESC_DIST_OFFSET);
+                size_t nLocalWordIdx = 0;
+                float fPotentialLocalWordsWeightSum = 0.0f;
+                float fLastLocalWordWeight = FLT_MAX;
 #if USE_INTERNAL_HRCS
-            std::chrono::high_resolution_clock::time_point post_prep = std::chrono::high_resolution_clock::now();
-            fPrepTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_prep-pre_prep).count())/1000000;
+                std::chrono::high_resolution_clock::time_point post_prep = std::chrono::high_resolution_clock::now();
+                fPrepTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_prep-pre_prep).count())/1000000;
 #endif //USE_INTERNAL_HRCS
-            while(nLocalWordIdx<m_nCurrLocalWords && fPotentialLocalWordsWeightSum<fLocalWordsWeightSumThreshold) {
-                LocalWord_1ch& oCurrLocalWord = (LocalWord_1ch&)*m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx];
-                const float fCurrLocalWordWeight = GetLocalWordWeight(oCurrLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
-                {
-                    const size_t nColorDist = DistanceUtils::L1dist(nCurrColor,oCurrLocalWord.oFeature.anColor[0]);
-                    const size_t nIntraDescDist = DistanceUtils::hdist(nCurrIntraDesc,oCurrLocalWord.oFeature.anDesc[0]);
-                    const ushort nCurrInterDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,oCurrLocalWord.oFeature.anColor[0],m_anLBSPThreshold_8bitLUT[oCurrLocalWord.oFeature.anColor[0]]);
-                    const size_t nInterDescDist = DistanceUtils::hdist(nCurrInterDesc,oCurrLocalWord.oFeature.anDesc[0]);
-                    const size_t nDescDist = (nIntraDescDist+nInterDescDist)/2;
-                    if( (!bCurrRegionIsUnstable || bCurrRegionIsFlat || bCurrRegionIsROIBorder)
-                            && nColorDist<=nCurrColorDistThreshold
-                            && nColorDist>=nCurrColorDistThreshold/2
-                            && nIntraDescDist<=nCurrDescDistThreshold/2
-                            && (rand()%(nCurrRegionIllumUpdtVal?(nCurrLocalWordUpdateRate/2+1):nCurrLocalWordUpdateRate))==0) {
-                        // == illum updt
-                        oCurrLocalWord.oFeature.anColor[0] = nCurrColor;
-                        oCurrLocalWord.oFeature.anDesc[0] = nCurrIntraDesc;
-                        m_oIllumUpdtRegionMask.data[nPxIter-1] = 1&m_oROI.data[nPxIter-1];
-                        m_oIllumUpdtRegionMask.data[nPxIter+1] = 1&m_oROI.data[nPxIter+1];
-                        m_oIllumUpdtRegionMask.data[nPxIter] = 2;
+                while(nLocalWordIdx<m_nCurrLocalWords && fPotentialLocalWordsWeightSum<fLocalWordsWeightSumThreshold) {
+                    LocalWord_1ch& oCurrLocalWord = *GetWord(m_voLocalWordList_1ch,m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx]);
+                    const float fCurrLocalWordWeight = nLocalWordIdx?GetLocalWordWeight(oCurrLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset):fBestLocalWordWeight;
+                    setCachedLocalWordWeight(nLocalDictIdx+nLocalWordIdx,fCurrLocalWordWeight);
+                    {
+                        const size_t nColorDist = DistanceUtils::L1dist(nCurrColor,oCurrLocalWord.oFeature.anColor[0]);
+                        const size_t nIntraDescDist = DistanceUtils::hdist(nCurrIntraDesc,oCurrLocalWord.oFeature.anDesc[0]);
+                        const ushort nCurrInterDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,oCurrLocalWord.oFeature.anColor[0],m_anLBSPThreshold_8bitLUT[oCurrLocalWord.oFeature.anColor[0]]);
+                        const size_t nInterDescDist = DistanceUtils::hdist(nCurrInterDesc,oCurrLocalWord.oFeature.anDesc[0]);
+                        const size_t nDescDist = (nIntraDescDist+nInterDescDist)/2;
+                        if( (!bCurrRegionIsUnstable || bCurrRegionIsFlat || bCurrRegionIsROIBorder)
+                                && nColorDist<=nCurrColorDistThreshold
+                                && nColorDist>=nCurrColorDistThreshold/2
+                                && nIntraDescDist<=nCurrDescDistThreshold/2
+                                && (oTile.oRNG()%(nCurrRegionIllumUpdtVal?(nCurrLocalWordUpdateRate/2+1):nCurrLocalWordUpdateRate))==0) {
+                            // == illum updt
+                            oCurrLocalWord.oFeature.anColor[0] = nCurrColor;
+                            oCurrLocalWord.oFeature.anDesc[0] = nCurrIntraDesc;
+                            m_oIllumUpdtRegionMask.data[nPxIter-1] = 1&m_oROI.data[nPxIter-1];
+                            m_oIllumUpdtRegionMask.data[nPxIter+1] = 1&m_oROI.data[nPxIter+1];
+                            m_oIllumUpdtRegionMask.data[nPxIter] = 2;
 #if DISPLAY_PAWCS_DEBUG_INFO
-                        vsWordModList[nLocalDictIdx+nLocalWordIdx] += "UPDATED ";
+                            vsWordModList[nLocalDictIdx+nLocalWordIdx] += "UPDATED ";
 #endif //DISPLAY_PAWCS_DEBUG_INFO
+                        }
+                        if(nDescDist<=nCurrDescDistThreshold && nColorDist<=nCurrColorDistThreshold) {
+                            fPotentialLocalWordsWeightSum += fCurrLocalWordWeight;
+                            oCurrLocalWord.nLastOcc = m_nFrameIdx;
+                            if((!m_oLastFGMask.data[nPxIter] || m_bUsingMovingCamera) && fCurrLocalWordWeight<DEFAULT_LWORD_MAX_WEIGHT)
+                                oCurrLocalWord.nOccurrences += nCurrWordOccIncr;
+                            nMinColorDist = std::min(nMinColorDist,nColorDist);
+                            nMinDescDist = std::min(nMinDescDist,nDescDist);
+#if DISPLAY_PAWCS_DEBUG_INFO
+                            vsWordModList[nLocalDictIdx+nLocalWordIdx] += "MATCHED ";
+#endif //DISPLAY_PAWCS_DEBUG_INFO
+                        }
                     }
-                    if(nDescDist<=nCurrDescDistThreshold && nColorDist<=nCurrColorDistThreshold) {
-                        fPotentialLocalWordsWeightSum += fCurrLocalWordWeight;
-                        oCurrLocalWord.nLastOcc = m_nFrameIdx;
-                        if((!m_oLastFGMask.data[nPxIter] || m_bUsingMovingCamera) && fCurrLocalWordWeight<DEFAULT_LWORD_MAX_WEIGHT)
-                            oCurrLocalWord.nOccurrences += nCurrWordOccIncr;
-                        nMinColorDist = std::min(nMinColorDist,nColorDist);
-                        nMinDescDist = std::min(nMinDescDist,nDescDist);
+                    if(fCurrLocalWordWeight>fLastLocalWordWeight) {
+                        std::swap(m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]);
+                        swapCachedLocalWordWeights(nLocalDictIdx+nLocalWordIdx,nLocalDictIdx+nLocalWordIdx-1);
 #if DISPLAY_PAWCS_DEBUG_INFO
-                        vsWordModList[nLocalDictIdx+nLocalWordIdx] += "MATCHED ";
+                        std::swap(vsWordModList[nLocalDictIdx+nLocalWordIdx],vsWordModList[nLocalDictIdx+nLocalWordIdx-1]);
 #endif //DISPLAY_PAWCS_DEBUG_INFO
                     }
+                    else
+                        fLastLocalWordWeight = fCurrLocalWordWeight;
+                    ++nLocalWordIdx;
                 }
-                if(fCurrLocalWordWeight>fLastLocalWordWeight) {
-                    std::swap(m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]);
+                if(((m_nFrameIdx+nModelIter)%LWORD_RANK_REFRESH_RATE)==0) {
+                    // full rank refresh of the unscanned dict tail (staggered across px)
+                    while(nLocalWordIdx<m_nCurrLocalWords) {
+                        const float fCurrLocalWordWeight = GetLocalWordWeight(*GetWord(m_voLocalWordList_1ch,m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx]),m_nFrameIdx,m_nLocalWordWeightOffset);
+                        setCachedLocalWordWeight(nLocalDictIdx+nLocalWordIdx,fCurrLocalWordWeight);
+                        if(fCurrLocalWordWeight>fLastLocalWordWeight) {
+                            std::swap(m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]);
+                            swapCachedLocalWordWeights(nLocalDictIdx+nLocalWordIdx,nLocalDictIdx+nLocalWordIdx-1);
 #if DISPLAY_PAWCS_DEBUG_INFO
-                    std::swap(vsWordModList[nLocalDictIdx+nLocalWordIdx],vsWordModList[nLocalDictIdx+nLocalWordIdx-1]);
+                            std::swap(vsWordModList[nLocalDictIdx+nLocalWordIdx],vsWordModList[nLocalDictIdx+nLocalWordIdx-1]);
 #endif //DISPLAY_PAWCS_DEBUG_INFO
+                        }
+                        else
+                            fLastLocalWordWeight = fCurrLocalWordWeight;
+                        ++nLocalWordIdx;
+                    }
                 }
-                else
-                    fLastLocalWordWeight = fCurrLocalWordWeight;
-                ++nLocalWordIdx;
-            }
-            while(nLocalWordIdx<m_nCurrLocalWords) {
-                const float fCurrLocalWordWeight = GetLocalWordWeight(*m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_nFrameIdx,m_nLocalWordWeightOffset);
-                if(fCurrLocalWordWeight>fLastLocalWordWeight) {
-                    std::swap(m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]);
+                else if(nLocalWordIdx<m_nCurrLocalWords && getCachedLocalWordWeight(nLocalDictIdx+nLocalWordIdx)>fLastLocalWordWeight) {
+                    // between refreshes, the tail keeps its last order; only the scan boundary is ranked (using its cached weight, if computed this frame)
+                    std::swap(m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]);
+                    swapCachedLocalWordWeights(nLocalDictIdx+nLocalWordIdx,nLocalDictIdx+nLocalWordIdx-1);
 #if DISPLAY_PAWCS_DEBUG_INFO
                     std::swap(vsWordModList[nLocalDictIdx+nLocalWordIdx],vsWordModList[nLocalDictIdx+nLocalWordIdx-1]);
 #endif //DISPLAY_PAWCS_DEBUG_INFO
                 }
-                else
-                    fLastLocalWordWeight = fCurrLocalWordWeight;
-                ++nLocalWordIdx;
-            }
 #if USE_INTERNAL_HRCS
-            std::chrono::high_resolution_clock::time_point post_ldictscan = std::chrono::high_resolution_clock::now();
-            fLDictScanTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_ldictscan-post_prep).count())/1000000;
+                std::chrono::high_resolution_clock::time_point post_ldictscan = std::chrono::high_resolution_clock::now();
+                fLDictScanTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_ldictscan-post_prep).count())/1000000;
 #endif //USE_INTERNAL_HRCS
-            if(fPotentialLocalWordsWeightSum>=fLocalWordsWeightSumThreshold || bCurrRegionIsROIBorder) {
-                // == background
+                if(fPotentialLocalWordsWeightSum>=fLocalWordsWeightSumThreshold || bCurrRegionIsROIBorder) {
+                    // == background
 #if USE_FEEDBACK_ADJUSTMENTS
-                const float fNormalizedMinDist = std::max((float)nMinColorDist/s_nColorMaxDataRange_1ch,(float)nMinDescDist/s_nDescMaxDataRange_1ch);
-                fCurrMeanMinDist_LT = fCurrMeanMinDist_LT*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
-                fCurrMeanMinDist_ST = fCurrMeanMinDist_ST*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
+                    const float fNormalizedMinDist = std::max((float)nMinColorDist/s_nColorMaxDataRange_1ch,(float)nMinDescDist/s_nDescMaxDataRange_1ch);
+                    fCurrMeanMinDist_LT = fCurrMeanMinDist_LT*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
+                    fCurrMeanMinDist_ST = fCurrMeanMinDist_ST*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
 #endif //USE_FEEDBACK_ADJUSTMENTS
-                fCurrMeanRawSegmRes_LT = fCurrMeanRawSegmRes_LT*(1.0f-fRollAvgFactor_LT);
-                fCurrMeanRawSegmRes_ST = fCurrMeanRawSegmRes_ST*(1.0f-fRollAvgFactor_ST);
-                if((rand()%nCurrLocalWordUpdateRate)==0) {
-                    size_t nGlobalWordLUTIdx;
-                    GlobalWord_1ch* pCurrGlobalWord = nullptr;
-                    for(nGlobalWordLUTIdx=0; nGlobalWordLUTIdx<m_nCurrGlobalWords; ++nGlobalWordLUTIdx) {
-                        pCurrGlobalWord = (GlobalWord_1ch*)m_voPxInfoLUT_PAWCS[nPxIter].vpGlobalDictSortLUT[nGlobalWordLUTIdx];
-                        if(DistanceUtils::L1dist(pCurrGlobalWord->oFeature.anColor[0],nCurrColor)<=nCurrColorDistThreshold &&
-                           DistanceUtils::L1dist(nCurrIntraDescBITS,pCurrGlobalWord->nDescBITS)<=nCurrDescDistThreshold/GWORD_DESC_THRES_BITS_MATCH_FACTOR)
-                            break;
-                    }
-                    if(nGlobalWordLUTIdx!=m_nCurrGlobalWords || (rand()%(nCurrLocalWordUpdateRate*2))==0) {
-                        if(nGlobalWordLUTIdx==m_nCurrGlobalWords) {
-                            pCurrGlobalWord = (GlobalWord_1ch*)m_vpGlobalWordDict[m_nCurrGlobalWords-1];
-                            pCurrGlobalWord->oFeature.anColor[0] = nCurrColor;
-                            pCurrGlobalWord->oFeature.anDesc[0] = nCurrIntraDesc;
-                            pCurrGlobalWord->nDescBITS = nCurrIntraDescBITS;
-                            pCurrGlobalWord->oSpatioOccMap = cv::Scalar(0.0f);
-                            pCurrGlobalWord->fLatestWeight = 0.0f;
+                    fCurrMeanRawSegmRes_LT = fCurrMeanRawSegmRes_LT*(1.0f-fRollAvgFactor_LT);
+                    fCurrMeanRawSegmRes_ST = fCurrMeanRawSegmRes_ST*(1.0f-fRollAvgFactor_ST);
+                    if((oTile.oRNG()%nCurrLocalWordUpdateRate)==0) {
+                        WordHandle nMatchedGlobalWordHandle = s_nInvalidWordHandle;
+                        for(size_t nGlobalWordLUTIdx=0; nGlobalWordLUTIdx<m_nCurrGlobalWords; ++nGlobalWordLUTIdx) {
+                            const WordHandle nCurrGlobalWordHandle = m_vnGlobalWordSortLUT[nModelIter*m_nCurrGlobalWords+nGlobalWordLUTIdx];
+                            const GlobalWord_1ch& oCurrGlobalWord = m_voGlobalWordList_1ch[nCurrGlobalWordHandle];
+                            if(DistanceUtils::L1dist(oCurrGlobalWord.oFeature.anColor[0],nCurrColor)<=nCurrColorDistThreshold &&
+                               DistanceUtils::L1dist(nCurrIntraDescBITS,oCurrGlobalWord.nDescBITS)<=nCurrDescDistThreshold/GWORD_DESC_THRES_BITS_MATCH_FACTOR) {
+                                nMatchedGlobalWordHandle = nCurrGlobalWordHandle;
+                                break;
+                            }
                         }
-                        float& fCurrGlobalWordLocalWeight = *(float*)(pCurrGlobalWord->oSpatioOccMap.data+nGlobalWordMapLookupIdx);
-                        if(fCurrGlobalWordLocalWeight<fPotentialLocalWordsWeightSum) {
-                            pCurrGlobalWord->fLatestWeight += fPotentialLocalWordsWeightSum;
-                            fCurrGlobalWordLocalWeight += fPotentialLocalWordsWeightSum;
+                        if(nMatchedGlobalWordHandle!=s_nInvalidWordHandle || (oTile.oRNG()%(nCurrLocalWordUpdateRate*2))==0) {
+                            const GlobalWordUpdate oUpdate = {nMatchedGlobalWordHandle,nGlobalWordMapLookupIdx,fPotentialLocalWordsWeightSum,{nCurrColor,0,0},{nCurrIntraDesc,0,0},nCurrIntraDescBITS};
+                            if(bDeferGlobalWordUpdates)
+                                oTile.voDeferredGlobalWordUpdates.push_back(oUpdate);
+                            else
+                                update_global_word(oUpdate);
                         }
                     }
                 }
-            }
-            else {
-                // == foreground
+                else {
+                    // == foreground
 #if USE_FEEDBACK_ADJUSTMENTS
-                const float fNormalizedMinDist = std::max(std::max((float)nMinColorDist/s_nColorMaxDataRange_1ch,(float)nMinDescDist/s_nDescMaxDataRange_1ch),(fLocalWordsWeightSumThreshold-fPotentialLocalWordsWeightSum)/fLocalWordsWeightSumThreshold);
-                fCurrMeanMinDist_LT = fCurrMeanMinDist_LT*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
-                fCurrMeanMinDist_ST = fCurrMeanMinDist_ST*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
+                    const float fNormalizedMinDist = std::max(std::max((float)nMinColorDist/s_nColorMaxDataRange_1ch,(float)nMinDescDist/s_nDescMaxDataRange_1ch),(fLocalWordsWeightSumThreshold-fPotentialLocalWordsWeightSum)/fLocalWordsWeightSumThreshold);
+                    fCurrMeanMinDist_LT = fCurrMeanMinDist_LT*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
+                    fCurrMeanMinDist_ST = fCurrMeanMinDist_ST*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
 #endif //USE_FEEDBACK_ADJUSTMENTS
-                fCurrMeanRawSegmRes_LT = fCurrMeanRawSegmRes_LT*(1.0f-fRollAvgFactor_LT) + fRollAvgFactor_LT;
-                fCurrMeanRawSegmRes_ST = fCurrMeanRawSegmRes_ST*(1.0f-fRollAvgFactor_ST) + fRollAvgFactor_ST;
-                if(bCurrRegionIsFlat || (rand()%nCurrLocalWordUpdateRate)==0) {
-                    size_t nGlobalWordLUTIdx;
-                    GlobalWord_1ch* pCurrGlobalWord = nullptr;
-                    for(nGlobalWordLUTIdx=0; nGlobalWordLUTIdx<m_nCurrGlobalWords; ++nGlobalWordLUTIdx) {
-                        pCurrGlobalWord = (GlobalWord_1ch*)m_voPxInfoLUT_PAWCS[nPxIter].vpGlobalDictSortLUT[nGlobalWordLUTIdx];
-                        if(DistanceUtils::L1dist(pCurrGlobalWord->oFeature.anColor[0],nCurrColor)<=nCurrColorDistThreshold &&
-                           DistanceUtils::L1dist(nCurrIntraDescBITS,pCurrGlobalWord->nDescBITS)<=nCurrDescDistThreshold/GWORD_DESC_THRES_BITS_MATCH_FACTOR)
-                            break;
-                    }
-                    if(nGlobalWordLUTIdx==m_nCurrGlobalWords)
-                        nCurrRegionSegmVal = UCHAR_MAX;
-                    else {
-                        const float fGlobalWordLocalizedWeight = *(float*)(pCurrGlobalWord->oSpatioOccMap.data+nGlobalWordMapLookupIdx);
-                        if(fPotentialLocalWordsWeightSum+fGlobalWordLocalizedWeight/(bCurrRegionIsFlat?2:4)<fLocalWordsWeightSumThreshold)
+                    fCurrMeanRawSegmRes_LT = fCurrMeanRawSegmRes_LT*(1.0f-fRollAvgFactor_LT) + fRollAvgFactor_LT;
+                    fCurrMeanRawSegmRes_ST = fCurrMeanRawSegmRes_ST*(1.0f-fRollAvgFactor_ST) + fRollAvgFactor_ST;
+                    if(bCurrRegionIsFlat || (oTile.oRNG()%nCurrLocalWordUpdateRate)==0) {
+                        size_t nGlobalWordLUTIdx;
+                        GlobalWord_1ch* pCurrGlobalWord = nullptr;
+                        for(nGlobalWordLUTIdx=0; nGlobalWordLUTIdx<m_nCurrGlobalWords; ++nGlobalWordLUTIdx) {
+                            pCurrGlobalWord = &m_voGlobalWordList_1ch[m_vnGlobalWordSortLUT[nModelIter*m_nCurrGlobalWords+nGlobalWordLUTIdx]];
+                            if(DistanceUtils::L1dist(pCurrGlobalWord->oFeature.anColor[0],nCurrColor)<=nCurrColorDistThreshold &&
+                               DistanceUtils::L1dist(nCurrIntraDescBITS,pCurrGlobalWord->nDescBITS)<=nCurrDescDistThreshold/GWORD_DESC_THRES_BITS_MATCH_FACTOR)
+                                break;
+                        }
+                        if(nGlobalWordLUTIdx==m_nCurrGlobalWords)
                             nCurrRegionSegmVal = UCHAR_MAX;
-                    }
+                        else {
+                            const float fGlobalWordLocalizedWeight = *(float*)(pCurrGlobalWord->oSpatioOccMap.data+nGlobalWordMapLookupIdx);
+                            if(fPotentialLocalWordsWeightSum+fGlobalWordLocalizedWeight/(bCurrRegionIsFlat?2:4)<fLocalWordsWeightSumThreshold)
+                                nCurrRegionSegmVal = UCHAR_MAX;
+                        }
 #if DISPLAY_PAWCS_DEBUG_INFO
-                    if(!nCurrRegionSegmVal && m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y==oDbgPt.y && m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X==oDbgPt.x) {
-                        bDBGMaskModifiedByGDict = true;
-                        pDBGGlobalWordModifier = pCurrGlobalWord;
-                        fDBGGlobalWordModifierLocalWeight = *(float*)(pCurrGlobalWord->oSpatioOccMap.data+nGlobalWordMapLookupIdx);
-                    }
+                        if(!nCurrRegionSegmVal && m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y==oDbgPt.y && m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X==oDbgPt.x) {
+                            bDBGMaskModifiedByGDict = true;
+                            pDBGGlobalWordModifier = pCurrGlobalWord;
+                            fDBGGlobalWordModifierLocalWeight = *(float*)(pCurrGlobalWord->oSpatioOccMap.data+nGlobalWordMapLookupIdx);
+                        }
 #endif //DISPLAY_PAWCS_DEBUG_INFO
-                }
-                else
-                    nCurrRegionSegmVal = UCHAR_MAX;
-                if(fPotentialLocalWordsWeightSum<DEFAULT_LWORD_INIT_WEIGHT) {
-                    const size_t nNewLocalWordIdx = m_nCurrLocalWords-1;
-                    LocalWord_1ch& oNewLocalWord = (LocalWord_1ch&)*m_vpLocalWordDict[nLocalDictIdx+nNewLocalWordIdx];
-                    oNewLocalWord.oFeature.anColor[0] = nCurrColor;
-                    oNewLocalWord.oFeature.anDesc[0] = nCurrIntraDesc;
-                    oNewLocalWord.nOccurrences = nCurrWordOccIncr;
-                    oNewLocalWord.nFirstOcc = m_nFrameIdx;
-                    oNewLocalWord.nLastOcc = m_nFrameIdx;
+                    }
+                    else
+                        nCurrRegionSegmVal = UCHAR_MAX;
+                    if(fPotentialLocalWordsWeightSum<DEFAULT_LWORD_INIT_WEIGHT) {
+                        const size_t nNewLocalWordIdx = m_nCurrLocalWords-1;
+                        LocalWord_1ch& oNewLocalWord = *GetWord(m_voLocalWordList_1ch,m_vnLocalWordDict[nLocalDictIdx+nNewLocalWordIdx]);
+                        oNewLocalWord.oFeature.anColor[0] = nCurrColor;
+                        oNewLocalWord.oFeature.anDesc[0] = nCurrIntraDesc;
+                        oNewLocalWord.nOccurrences = nCurrWordOccIncr;
+                        oNewLocalWord.nFirstOcc = m_nFrameIdx;
+                        oNewLocalWord.nLastOcc = m_nFrameIdx;
+                        setCachedLocalWordWeight(nLocalDictIdx+nNewLocalWordIdx,GetLocalWordWeight(oNewLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset));
 #if DISPLAY_PAWCS_DEBUG_INFO
-                    vsWordModList[nLocalDictIdx+nNewLocalWordIdx] += "NEW ";
+                        vsWordModList[nLocalDictIdx+nNewLocalWordIdx] += "NEW ";
 #endif //DISPLAY_PAWCS_DEBUG_INFO
+                    }
                 }
-            }
 #if USE_INTERNAL_HRCS
-            std::chrono::high_resolution_clock::time_point post_rawdecision = std::chrono::high_resolution_clock::now();
-            if(nCurrRegionSegmVal)
-                fFGRawTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_rawdecision-post_ldictscan).count())/1000000;
-            else
-                fBGRawTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_rawdecision-post_ldictscan).count())/1000000;
-#endif //USE_INTERNAL_HRCS
-            // == neighb updt
-            if((!nCurrRegionSegmVal && (rand()%nCurrLocalWordUpdateRate)==0) || bCurrRegionIsROIBorder || m_bUsingMovingCamera) {
-            //if((!nCurrRegionSegmVal && (rand()%(nCurrRegionIllumUpdtVal?(nCurrLocalWordUpdateRate/2+1):nCurrLocalWordUpdateRate))==0) || bCurrRegionIsROIBorder) {
-                int nSampleImgCoord_Y, nSampleImgCoord_X;
-                if(bCurrRegionIsFlat || bCurrRegionIsROIBorder || m_bUsingMovingCamera)
-                    cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
+                std::chrono::high_resolution_clock::time_point post_rawdecision = std::chrono::high_resolution_clock::now();
+                if(nCurrRegionSegmVal)
+                    fFGRawTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_rawdecision-post_ldictscan).count())/1000000;
                 else
-                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
-                if(m_oROI.data[nSamplePxIdx]) {
-                    const size_t nNeighborLocalDictIdx = m_voPxInfoLUT_PAWCS[nSamplePxIdx].nModelIdx*m_nCurrLocalWords;
-                    size_t nNeighborLocalWordIdx = 0;
-                    float fNeighborPotentialLocalWordsWeightSum = 0.0f;
-                    while(nNeighborLocalWordIdx<m_nCurrLocalWords && fNeighborPotentialLocalWordsWeightSum<fLocalWordsWeightSumThreshold) {
-                        LocalWord_1ch oNeighborLocalWord = (LocalWord_1ch&)*m_vpLocalWordDict[nNeighborLocalDictIdx+nNeighborLocalWordIdx];
-                        const size_t nNeighborColorDist = DistanceUtils::L1dist(nCurrColor,oNeighborLocalWord.oFeature.anColor[0]);
-                        const size_t nNeighborIntraDescDist = DistanceUtils::hdist(nCurrIntraDesc,oNeighborLocalWord.oFeature.anDesc[0]);
-                        const bool bNeighborRegionIsFlat = DistanceUtils::popcount(oNeighborLocalWord.oFeature.anDesc[0])<FLAT_REGION_BIT_COUNT;
-                        const size_t nNeighborWordOccIncr = bNeighborRegionIsFlat?nCurrWordOccIncr*2:nCurrWordOccIncr;
-                        if(nNeighborColorDist<=nCurrColorDistThreshold && nNeighborIntraDescDist<=nCurrDescDistThreshold) {
-                            const float fNeighborLocalWordWeight = GetLocalWordWeight(oNeighborLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
-                            fNeighborPotentialLocalWordsWeightSum += fNeighborLocalWordWeight;
-                            oNeighborLocalWord.nLastOcc = m_nFrameIdx;
-                            if(fNeighborLocalWordWeight<DEFAULT_LWORD_MAX_WEIGHT)
-                                oNeighborLocalWord.nOccurrences += nNeighborWordOccIncr;
-#if DISPLAY_PAWCS_DEBUG_INFO
-                            vsWordModList[nNeighborLocalDictIdx+nNeighborLocalWordIdx] += "MATCHED(NEIGHBOR) ";
-#endif //DISPLAY_PAWCS_DEBUG_INFO
-                        }
-                        else if(!oCurrFGMask.data[nSamplePxIdx] && bCurrRegionIsFlat && (bBootstrapping || (rand()%nCurrLocalWordUpdateRate)==0)) {
-                            const size_t nSampleDescIdx = nSamplePxIdx*2;
-                            ushort& nNeighborLastIntraDesc = *((ushort*)(m_oLastDescFrame.data+nSampleDescIdx));
-                            const size_t nNeighborLastIntraDescDist = DistanceUtils::hdist(nCurrIntraDesc,nNeighborLastIntraDesc);
-                            if(nNeighborColorDist<=nCurrColorDistThreshold && nNeighborLastIntraDescDist<=nCurrDescDistThreshold/2) {
-                                const float fNeighborLocalWordWeight = GetLocalWordWeight(oNeighborLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
-                                fNeighborPotentialLocalWordsWeightSum += fNeighborLocalWordWeight;
-                                oNeighborLocalWord.nLastOcc = m_nFrameIdx;
-                                if(fNeighborLocalWordWeight<DEFAULT_LWORD_MAX_WEIGHT)
-                                    oNeighborLocalWord.nOccurrences += nNeighborWordOccIncr;
-                                oNeighborLocalWord.oFeature.anDesc[0] = nCurrIntraDesc;
-#if DISPLAY_PAWCS_DEBUG_INFO
-                                vsWordModList[nNeighborLocalDictIdx+nNeighborLocalWordIdx] += "UPDATED1(NEIGHBOR) ";
-#endif //DISPLAY_PAWCS_DEBUG_INFO
-                            }
-                        }
-                        ++nNeighborLocalWordIdx;
-                    }
-                    if(fNeighborPotentialLocalWordsWeightSum<DEFAULT_LWORD_INIT_WEIGHT) {
-                        nNeighborLocalWordIdx = m_nCurrLocalWords-1;
-                        LocalWord_1ch& oNeighborLocalWord = (LocalWord_1ch&)*m_vpLocalWordDict[nNeighborLocalDictIdx+nNeighborLocalWordIdx];
-                        oNeighborLocalWord.oFeature.anColor[0] = nCurrColor;
-                        oNeighborLocalWord.oFeature.anDesc[0] = nCurrIntraDesc;
-                        oNeighborLocalWord.nOccurrences = nCurrWordOccIncr;
-                        oNeighborLocalWord.nFirstOcc = m_nFrameIdx;
-                        oNeighborLocalWord.nLastOcc = m_nFrameIdx;
-#if DISPLAY_PAWCS_DEBUG_INFO
-                        vsWordModList[nNeighborLocalDictIdx+nNeighborLocalWordIdx] += "NEW(NEIGHBOR) ";
-#endif //DISPLAY_PAWCS_DEBUG_INFO
+                    fBGRawTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_rawdecision-post_ldictscan).count())/1000000;
+#endif //USE_INTERNAL_HRCS
+                // == neighb updt
+                if((!nCurrRegionSegmVal && (oTile.oRNG()%nCurrLocalWordUpdateRate)==0) || bCurrRegionIsROIBorder || m_bUsingMovingCamera) {
+                //if((!nCurrRegionSegmVal && (oTile.oRNG()%(nCurrRegionIllumUpdtVal?(nCurrLocalWordUpdateRate/2+1):nCurrLocalWordUpdateRate))==0) || bCurrRegionIsROIBorder) {
+                    int nSampleImgCoord_Y, nSampleImgCoord_X;
+                    if(bCurrRegionIsFlat || bCurrRegionIsROIBorder || m_bUsingMovingCamera)
+                        cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,oTile.oRNG);
+                    else
+                        cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,oTile.oRNG);
+                    const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
+                    if(m_oROI.data[nSamplePxIdx]) {
+                        const NeighborModelUpdate oUpdate = {nSamplePxIdx,{nCurrColor,0,0},{nCurrIntraDesc,0,0},nCurrColorDistThreshold,nCurrDescDistThreshold,fLocalWordsWeightSumThreshold,nCurrWordOccIncr,nCurrLocalWordUpdateRate,bCurrRegionIsFlat};
+                        if(nSampleImgCoord_Y>=oTile.nRowBegin && nSampleImgCoord_Y<oTile.nRowEnd)
+                            lNeighborUpdate_1ch(oUpdate,oTile.oRNG);
+                        else // target px is owned by another tile; its update will be applied once all tiles are processed
+                            oTile.voDeferredNeighborUpdates.push_back(oUpdate);
                     }
                 }
-            }
 #if USE_INTERNAL_HRCS
-            std::chrono::high_resolution_clock::time_point post_neighbupdt = std::chrono::high_resolution_clock::now();
-            fNeighbUpdtTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_neighbupdt-post_rawdecision).count())/1000000;
+                std::chrono::high_resolution_clock::time_point post_neighbupdt = std::chrono::high_resolution_clock::now();
+                fNeighbUpdtTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_neighbupdt-post_rawdecision).count())/1000000;
 #endif //USE_INTERNAL_HRCS
-            if(nCurrRegionIllumUpdtVal)
-                nCurrRegionIllumUpdtVal -= 1;
-            // == feedback adj
-            bCurrRegionIsUnstable = fCurrDistThresholdFactor>UNSTABLE_REG_RDIST_MIN || (fCurrMeanRawSegmRes_LT-fCurrMeanFinalSegmRes_LT)>UNSTABLE_REG_RATIO_MIN || (fCurrMeanRawSegmRes_ST-fCurrMeanFinalSegmRes_ST)>UNSTABLE_REG_RATIO_MIN;
+                if(nCurrRegionIllumUpdtVal)
+                    nCurrRegionIllumUpdtVal -= 1;
+                // == feedback adj
+                bCurrRegionIsUnstable = fCurrDistThresholdFactor>UNSTABLE_REG_RDIST_MIN || (fCurrMeanRawSegmRes_LT-fCurrMeanFinalSegmRes_LT)>UNSTABLE_REG_RATIO_MIN || (fCurrMeanRawSegmRes_ST-fCurrMeanFinalSegmRes_ST)>UNSTABLE_REG_RATIO_MIN;
 #if USE_FEEDBACK_ADJUSTMENTS
-            if(m_oLastFGMask.data[nPxIter] || (std::min(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST)<UNSTABLE_REG_RATIO_MIN && nCurrRegionSegmVal))
-                fCurrLearningRate = std::min(fCurrLearningRate+FEEDBACK_T_INCR/(std::max(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST)*fCurrDistThresholdVariationFactor),FEEDBACK_T_UPPER);
-            else
-                fCurrLearningRate = std::max(fCurrLearningRate-FEEDBACK_T_DECR*fCurrDistThresholdVariationFactor/std::max(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST),FEEDBACK_T_LOWER);
-            if(std::max(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST)>UNSTABLE_REG_RATIO_MIN && m_oBlinksFrame.data[nPxIter])
-                (fCurrDistThresholdVariationFactor) += bBootstrapping?FEEDBACK_V_INCR*2:FEEDBACK_V_INCR;
-            else
-                fCurrDistThresholdVariationFactor = std::max(fCurrDistThresholdVariationFactor-FEEDBACK_V_DECR*((bBootstrapping||bCurrRegionIsFlat)?2:m_oLastFGMask.data[nPxIter]?0.5f:1),FEEDBACK_V_DECR);
-            if(fCurrDistThresholdFactor<std::pow(1.0f+std::min(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST)*2,2))
-                fCurrDistThresholdFactor += FEEDBACK_R_VAR*(fCurrDistThresholdVariationFactor-FEEDBACK_V_DECR);
-            else
-                fCurrDistThresholdFactor = std::max(fCurrDistThresholdFactor-FEEDBACK_R_VAR/fCurrDistThresholdVariationFactor,1.0f);
+                if(m_oLastFGMask.data[nPxIter] || (std::min(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST)<UNSTABLE_REG_RATIO_MIN && nCurrRegionSegmVal))
+                    fCurrLearningRate = std::min(fCurrLearningRate+FEEDBACK_T_INCR/(std::max(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST)*fCurrDistThresholdVariationFactor),FEEDBACK_T_UPPER);
+                else
+                    fCurrLearningRate = std::max(fCurrLearningRate-FEEDBACK_T_DECR*fCurrDistThresholdVariationFactor/std::max(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST),FEEDBACK_T_LOWER);
+                if(std::max(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST)>UNSTABLE_REG_RATIO_MIN && m_oBlinksFrame.data[nPxIter])
+                    (fCurrDistThresholdVariationFactor) += bBootstrapping?FEEDBACK_V_INCR*2:FEEDBACK_V_INCR;
+                else
+                    fCurrDistThresholdVariationFactor = std::max(fCurrDistThresholdVariationFactor-FEEDBACK_V_DECR*((bBootstrapping||bCurrRegionIsFlat)?2:m_oLastFGMask.data[nPxIter]?0.5f:1),FEEDBACK_V_DECR);
+                if(fCurrDistThresholdFactor<std::pow(1.0f+std::min(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST)*2,2))
+                    fCurrDistThresholdFactor += FEEDBACK_R_VAR*(fCurrDistThresholdVariationFactor-FEEDBACK_V_DECR);
+                else
+                    fCurrDistThresholdFactor = std::max(fCurrDistThresholdFactor-FEEDBACK_R_VAR/fCurrDistThresholdVariationFactor,1.0f);
 #endif //USE_FEEDBACK_ADJUSTMENTS
-            nLastIntraDesc = nCurrIntraDesc;
-            nLastColor = nCurrColor;
+                nLastIntraDesc = nCurrIntraDesc;
+                nLastColor = nCurrColor;
 #if USE_INTERNAL_HRCS
-            std::chrono::high_resolution_clock::time_point post_varupdt = std::chrono::high_resolution_clock::now();
-            fVarUpdtTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_varupdt-post_neighbupdt).count())/1000000;
-            post_lastKP = std::chrono::high_resolution_clock::now();
-            fIntraKPsTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_lastKP-pre_currKP).count())/1000000;
+                std::chrono::high_resolution_clock::time_point post_varupdt = std::chrono::high_resolution_clock::now();
+                fVarUpdtTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_varupdt-post_neighbupdt).count())/1000000;
+                post_lastKP = std::chrono::high_resolution_clock::now();
+                fIntraKPsTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_lastKP-pre_currKP).count())/1000000;
 #endif //USE_INTERNAL_HRCS
 #if DISPLAY_PAWCS_DEBUG_INFO
-            if(m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y==oDbgPt.y && m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X==oDbgPt.x) {
-                for(size_t c=0; c<3; ++c) {
-                    anDBGColor[c] = nCurrColor;
-                    anDBGIntraDesc[c] = nCurrIntraDesc;
+                if(m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y==oDbgPt.y && m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X==oDbgPt.x) {
+                    for(size_t c=0; c<3; ++c) {
+                        anDBGColor[c] = nCurrColor;
+                        anDBGIntraDesc[c] = nCurrIntraDesc;
+                    }
+                    fDBGLocalWordsWeightSumThreshold = fLocalWordsWeightSumThreshold;
+                    bDBGMaskResult = (nCurrRegionSegmVal==UCHAR_MAX);
+                    nLocalDictDBGIdx = nLocalDictIdx;
+                    nDBGWordOccIncr = std::max(nDBGWordOccIncr,nCurrWordOccIncr);
                 }
-                fDBGLocalWordsWeightSumThreshold = fLocalWordsWeightSumThreshold;
-                bDBGMaskResult = (nCurrRegionSegmVal==UCHAR_MAX);
-                nLocalDictDBGIdx = nLocalDictIdx;
-                nDBGWordOccIncr = std::max(nDBGWordOccIncr,nCurrWordOccIncr);
-            }
 #endif //DISPLAY_PAWCS_DEBUG_INFO
-        }
+            }
 #if USE_INTERNAL_HRCS
-        std::chrono::high_resolution_clock::time_point post_loop = std::chrono::high_resolution_clock::now();
-        fInterKPsTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_loop-post_lastKP).count())/1000000;
-        fTotalKPsTime_MS = (float)(std::chrono::duration_cast<std::chrono::microseconds>(post_loop-pre_loop).count())/1000;
-        pre_gword_calcs = std::chrono::high_resolution_clock::now();
+            std::chrono::high_resolution_clock::time_point post_loop = std::chrono::high_resolution_clock::now();
+            fInterKPsTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_loop-post_lastKP).count())/1000000;
+            fTotalKPsTime_MS = (float)(std::chrono::duration_cast<std::chrono::microseconds>(post_loop-pre_loop).count())/1000;
+            pre_gword_calcs = std::chrono::high_resolution_clock::now();
 #endif //USE_INTERNAL_HRCS
-    }
-    else { //m_nImgChannels==3
+        }
+        else { //m_nImgChannels==3
 #if USE_INTERNAL_HRCS
-        std::chrono::high_resolution_clock::time_point pre_loop = std::chrono::high_resolution_clock::now();
+            std::chrono::high_resolution_clock::time_point pre_loop = std::chrono::high_resolution_clock::now();
 #endif //USE_INTERNAL_HRCS
-        for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
+            for(size_t nModelIter=oTile.nModelIterBegin; nModelIter<oTile.nModelIterEnd; ++nModelIter) {
 #if USE_INTERNAL_HRCS
-            std::chrono::high_resolution_clock::time_point pre_currKP = std::chrono::high_resolution_clock::now();
-            fInterKPsTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(pre_currKP-post_lastKP).count())/1000000;
-            std::chrono::high_resolution_clock::time_point pre_prep = std::chrono::high_resolution_clock::now();
+                std::chrono::high_resolution_clock::time_point pre_currKP = std::chrono::high_resolution_clock::now();
+                fInterKPsTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(pre_currKP-post_lastKP).count())/1000000;
+                std::chrono::high_resolution_clock::time_point pre_prep = std::chrono::high_resolution_clock::now();
 #endif //USE_INTERNAL_HRCS
-            const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
-            const size_t nPxRGBIter = nPxIter*3;
-            const size_t nDescRGBIter = nPxRGBIter*2;
-            const size_t nFloatIter = nPxIter*4;
-            const size_t nLocalDictIdx = nModelIter*m_nCurrLocalWords;
-            const size_t nGlobalWordMapLookupIdx = m_voPxInfoLUT_PAWCS[nPxIter].nGlobalWordMapLookupIdx;
-            const uchar* const anCurrColor = oInputImg.data+nPxRGBIter;
-            uchar* anLastColor = m_oLastColorFrame.data+nPxRGBIter;
-            ushort* anLastIntraDesc = ((ushort*)(m_oLastDescFrame.data+nDescRGBIter));
-            size_t nMinTotColorDist = s_nColorMaxDataRange_3ch;
-            size_t nMinTotDescDist = s_nDescMaxDataRange_3ch;
-            float& fCurrMeanRawSegmRes_LT = *(float*)(m_oMeanRawSegmResFrame_LT.data+nFloatIter);
-            float& fCurrMeanRawSegmRes_ST = *(float*)(m_oMeanRawSegmResFrame_ST.data+nFloatIter);
-            float& fCurrMeanFinalSegmRes_LT = *(float*)(m_oMeanFinalSegmResFrame_LT.data+nFloatIter);
-            float& fCurrMeanFinalSegmRes_ST = *(float*)(m_oMeanFinalSegmResFrame_ST.data+nFloatIter);
-            float& fCurrDistThresholdFactor = *(float*)(m_oDistThresholdFrame.data+nFloatIter);
+                const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
+                const size_t nPxRGBIter = nPxIter*3;
+                const size_t nDescRGBIter = nPxRGBIter*2;
+                const size_t nFloatIter = nPxIter*4;
+                const size_t nLocalDictIdx = nModelIter*m_nCurrLocalWords;
+                const size_t nGlobalWordMapLookupIdx = m_voPxInfoLUT_PAWCS[nPxIter].nGlobalWordMapLookupIdx;
+                const uchar* const anCurrColor = oInputImg.data+nPxRGBIter;
+                uchar* anLastColor = m_oLastColorFrame.data+nPxRGBIter;
+                ushort* anLastIntraDesc = ((ushort*)(m_oLastDescFrame.data+nDescRGBIter));
+                size_t nMinTotColorDist = s_nColorMaxDataRange_3ch;
+                size_t nMinTotDescDist = s_nDescMaxDataRange_3ch;
+                float& fCurrMeanRawSegmRes_LT = *(float*)(m_oMeanRawSegmResFrame_LT.data+nFloatIter);
+                float& fCurrMeanRawSegmRes_ST = *(float*)(m_oMeanRawSegmResFrame_ST.data+nFloatIter);
+                float& fCurrMeanFinalSegmRes_LT = *(float*)(m_oMeanFinalSegmResFrame_LT.data+nFloatIter);
+                float& fCurrMeanFinalSegmRes_ST = *(float*)(m_oMeanFinalSegmResFrame_ST.data+nFloatIter);
+                float& fCurrDistThresholdFactor = *(float*)(m_oDistThresholdFrame.data+nFloatIter);
 #if USE_FEEDBACK_ADJUSTMENTS
-            float& fCurrDistThresholdVariationFactor = *(float*)(m_oDistThresholdVariationFrame.data+nFloatIter);
-            float& fCurrLearningRate = *(float*)(m_oUpdateRateFrame.data+nFloatIter);
-            float& fCurrMeanMinDist_LT = *(float*)(m_oMeanMinDistFrame_LT.data+nFloatIter);
-            float& fCurrMeanMinDist_ST = *(float*)(m_oMeanMinDistFrame_ST.data+nFloatIter);
+                float& fCurrDistThresholdVariationFactor = *(float*)(m_oDistThresholdVariationFrame.data+nFloatIter);
+                float& fCurrLearningRate = *(float*)(m_oUpdateRateFrame.data+nFloatIter);
+                float& fCurrMeanMinDist_LT = *(float*)(m_oMeanMinDistFrame_LT.data+nFloatIter);
+                float& fCurrMeanMinDist_ST = *(float*)(m_oMeanMinDistFrame_ST.data+nFloatIter);
 #endif //USE_FEEDBACK_ADJUSTMENTS
-            const float fBestLocalWordWeight = GetLocalWordWeight(*m_vpLocalWordDict[nLocalDictIdx],m_nFrameIdx,m_nLocalWordWeightOffset);
-            const float fLocalWordsWeightSumThreshold = fBestLocalWordWeight/(fCurrDistThresholdFactor*2);
-            uchar& bCurrRegionIsUnstable = m_oUnstableRegionMask.data[nPxIter];
-            uchar& nCurrRegionIllumUpdtVal = m_oIllumUpdtRegionMask.data[nPxIter];
-            uchar& nCurrRegionSegmVal = oCurrFGMask.data[nPxIter];
-            const bool bCurrRegionIsROIBorder = m_oROI.data[nPxIter]<UCHAR_MAX;
+                const float fBestLocalWordWeight = GetLocalWordWeight(*GetWord(m_voLocalWordList_3ch,m_vnLocalWordDict[nLocalDictIdx]),m_nFrameIdx,m_nLocalWordWeightOffset);
+                const float fLocalWordsWeightSumThreshold = fBestLocalWordWeight/(fCurrDistThresholdFactor*2);
+                uchar& bCurrRegionIsUnstable = m_oUnstableRegionMask.data[nPxIter];
+                uchar& nCurrRegionIllumUpdtVal = m_oIllumUpdtRegionMask.data[nPxIter];
+                uchar& nCurrRegionSegmVal = oCurrFGMask.data[nPxIter];
+                const bool bCurrRegionIsROIBorder = m_oROI.data[nPxIter]<UCHAR_MAX;
 #if DISPLAY_PAWCS_DEBUG_INFO
-            oDBGWeightThresholds.at<float>(m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X) = fLocalWordsWeightSumThreshold;
+                oDBGWeightThresholds.at<float>(m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X) = fLocalWordsWeightSumThreshold;
 #endif //DISPLAY_PAWCS_DEBUG_INFO
-            const int nCurrImgCoord_X = m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X;
-            const int nCurrImgCoord_Y = m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y;
-            alignas(16) std::array<std::array<uchar,LBSP::DESC_SIZE_BITS>,3> aanLBSPLookupVals;
-            LBSP::computeDescriptor_lookup(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,aanLBSPLookupVals);
-            std::array<ushort,3> anCurrIntraDesc;
-            for(size_t c=0; c<3; ++c)
-                anCurrIntraDesc[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
-            const uchar nCurrIntraDescBITS = (uchar)DistanceUtils::popcount(anCurrIntraDesc);
-            const bool bCurrRegionIsFlat = nCurrIntraDescBITS<FLAT_REGION_BIT_COUNT*2;
-            if(bCurrRegionIsFlat)
-                ++nFlatRegionCount;
-            const size_t nCurrWordOccIncr = (DEFAULT_LWORD_OCC_INCR+m_nModelResetCooldown)<<int(bCurrRegionIsFlat||bBootstrapping);
+                const int nCurrImgCoord_X = m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X;
+                const int nCurrImgCoord_Y = m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y;
+                alignas(16) std::array<std::array<uchar,LBSP::DESC_SIZE_BITS>,3> aanLBSPLookupVals;
+                LBSP::computeDescriptor_lookup(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,aanLBSPLookupVals);
+                std::array<ushort,3> anCurrIntraDesc;
+                for(size_t c=0; c<3; ++c)
+                    anCurrIntraDesc[c] = m_pCurrDescFrame?((const ushort*)m_pCurrDescFrame->data)[nPxRGBIter+c]:LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
+                const uchar nCurrIntraDescBITS = (uchar)DistanceUtils::popcount(anCurrIntraDesc);
+                const bool bCurrRegionIsFlat = nCurrIntraDescBITS<FLAT_REGION_BIT_COUNT*2;
+                if(bCurrRegionIsFlat)
+                    ++oTile.nFlatRegionCount;
+                const size_t nCurrWordOccIncr = (DEFAULT_LWORD_OCC_INCR+m_nModelResetCooldown)<<int(bCurrRegionIsFlat||bBootstrapping);
 #if USE_FEEDBACK_ADJUSTMENTS
-            const size_t nCurrLocalWordUpdateRate = learningRateOverride>0?(size_t)ceil(learningRateOverride):bCurrRegionIsFlat?(size_t)ceil(fCurrLearningRate+FEEDBACK_T_LOWER)/2:(size_t)ceil(fCurrLearningRate);
+                const size_t nCurrLocalWordUpdateRate = learningRateOverride>0?(size_t)ceil(learningRateOverride):bCurrRegionIsFlat?(size_t)ceil(fCurrLearningRate+FEEDBACK_T_LOWER)/2:(size_t)ceil(fCurrLearningRate);
 #else //(!USE_FEEDBACK_ADJUSTMENTS)
-            const size_t nCurrLocalWordUpdateRate = learningRateOverride>0?(size_t)ceil(learningRateOverride):(size_t)DEFAULT_RESAMPLING_RATE;
+                const size_t nCurrLocalWordUpdateRate = learningRateOverride>0?(size_t)ceil(learningRateOverride):(size_t)DEFAULT_RESAMPLING_RATE;
 #endif //(!USE_FEEDBACK_ADJUSTMENTS)
-            const size_t nCurrTotColorDistThreshold = (size_t)(sqrt(fCurrDistThresholdFactor)*m_nMinColorDistThreshold)*3;
-            const size_t nCurrTotDescDistThreshold = (((size_t)1<<((size_t)floor(fCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(bCurrRegionIsUnstable*UNSTAB_DESC_DIST_OFFSET))*3;
-            size_t nLocalWordIdx = 0;
-            float fPotentialLocalWordsWeightSum = 0.0f;
-            float fLastLocalWordWeight = FLT_MAX;
+                const size_t nCurrTotColorDistThreshold = (size_t)(sqrt(fCurrDistThresholdFactor)*m_nMinColorDistThreshold)*3;
+                const size_t nCurrTotDescDistThreshold = (((size_t)1<<((size_t)floor(fCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(bCurrRegionIsUnstable*UNSTAB_DESC_DIST_OFFSET))*3;
+                size_t nLocalWordIdx = 0;
+                float fPotentialLocalWordsWeightSum = 0.0f;
+                float fLastLocalWordWeight = FLT_MAX;
 #if USE_INTERNAL_HRCS
-            std::chrono::high_resolution_clock::time_point post_prep = std::chrono::high_resolution_clock::now();
-            fPrepTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_prep-pre_prep).count())/1000000;
+                std::chrono::high_resolution_clock::time_point post_prep = std::chrono::high_resolution_clock::now();
+                fPrepTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_prep-pre_prep).count())/1000000;
 #endif //USE_INTERNAL_HRCS
-            while(nLocalWordIdx<m_nCurrLocalWords && fPotentialLocalWordsWeightSum<fLocalWordsWeightSumThreshold) {
-                LocalWord_3ch& oCurrLocalWord = (LocalWord_3ch&)*m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx];
-                const float fCurrLocalWordWeight = GetLocalWordWeight(oCurrLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
-                {
-                    const size_t nTotColorL1Dist = DistanceUtils::L1dist(anCurrColor,oCurrLocalWord.oFeature.anColor);
-                    const size_t nColorDistortion = DistanceUtils::cdist(anCurrColor,oCurrLocalWord.oFeature.anColor);
-                    const size_t nTotColorMixDist = DistanceUtils::cmixdist(nTotColorL1Dist,nColorDistortion);
-                    const size_t nTotIntraDescDist = DistanceUtils::hdist(anCurrIntraDesc,oCurrLocalWord.oFeature.anDesc);
-                    std::array<ushort,3> anCurrInterDesc;
-                    for(size_t c=0; c<3; ++c)
-                        anCurrInterDesc[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],oCurrLocalWord.oFeature.anColor[c],m_anLBSPThreshold_8bitLUT[oCurrLocalWord.oFeature.anColor[c]]);
-                    const size_t nTotInterDescDist = DistanceUtils::hdist(anCurrInterDesc,oCurrLocalWord.oFeature.anDesc);
-                    const size_t nTotDescDist = (nTotIntraDescDist+nTotInterDescDist)/2;
-                    if( (!bCurrRegionIsUnstable || bCurrRegionIsFlat || bCurrRegionIsROIBorder)
-                            && nTotColorMixDist<=nCurrTotColorDistThreshold
-                            && nTotColorL1Dist>=nCurrTotColorDistThreshold/2
-                            && nTotIntraDescDist<=nCurrTotDescDistThreshold/2
-                            && (rand()%(nCurrRegionIllumUpdtVal?(nCurrLocalWordUpdateRate/2+1):nCurrLocalWordUpdateRate))==0) {
-                        // == illum updt
-                        for(size_t c=0; c<3; ++c) {
-                            oCurrLocalWord.oFeature.anColor[c] = anCurrColor[c];
-                            oCurrLocalWord.oFeature.anDesc[c] = anCurrIntraDesc[c];
+                while(nLocalWordIdx<m_nCurrLocalWords && fPotentialLocalWordsWeightSum<fLocalWordsWeightSumThreshold) {
+                    LocalWord_3ch& oCurrLocalWord = *GetWord(m_voLocalWordList_3ch,m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx]);
+                    const float fCurrLocalWordWeight = nLocalWordIdx?GetLocalWordWeight(oCurrLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset):fBestLocalWordWeight;
+                    setCachedLocalWordWeight(nLocalDictIdx+nLocalWordIdx,fCurrLocalWordWeight);
+                    {
+                        const size_t nTotColorL1Dist = DistanceUtils::L1dist(anCurrColor,oCurrLocalWord.oFeature.anColor);
+                        const size_t nColorDistortion = DistanceUtils::cdist(anCurrColor,oCurrLocalWord.oFeature.anColor);
+                        const size_t nTotColorMixDist = DistanceUtils::cmixdist(nTotColorL1Dist,nColorDistortion);
+                        const size_t nTotIntraDescDist = DistanceUtils::hdist(anCurrIntraDesc,oCurrLocalWord.oFeature.anDesc);
+                        std::array<ushort,3> anCurrInterDesc;
+                        for(size_t c=0; c<3; ++c)
+                            anCurrInterDesc[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],oCurrLocalWord.oFeature.anColor[c],m_anLBSPThreshold_8bitLUT[oCurrLocalWord.oFeature.anColor[c]]);
+                        const size_t nTotInterDescDist = DistanceUtils::hdist(anCurrInterDesc,oCurrLocalWord.oFeature.anDesc);
+                        const size_t nTotDescDist = (nTotIntraDescDist+nTotInterDescDist)/2;
+                        if( (!bCurrRegionIsUnstable || bCurrRegionIsFlat || bCurrRegionIsROIBorder)
+                                && nTotColorMixDist<=nCurrTotColorDistThreshold
+                                && nTotColorL1Dist>=nCurrTotColorDistThreshold/2
+                                && nTotIntraDescDist<=nCurrTotDescDistThreshold/2
+                                && (oTile.oRNG()%(nCurrRegionIllumUpdtVal?(nCurrLocalWordUpdateRate/2+1):nCurrLocalWordUpdateRate))==0) {
+                            // == illum updt
+                            for(size_t c=0; c<3; ++c) {
+                                oCurrLocalWord.oFeature.anColor[c] = anCurrColor[c];
+                                oCurrLocalWord.oFeature.anDesc[c] = anCurrIntraDesc[c];
+                            }
+                            m_oIllumUpdtRegionMask.data[nPxIter-1] = 1&m_oROI.data[nPxIter-1];
+                            m_oIllumUpdtRegionMask.data[nPxIter+1] = 1&m_oROI.data[nPxIter+1];
+                            m_oIllumUpdtRegionMask.data[nPxIter] = 2;
+#if DISPLAY_PAWCS_DEBUG_INFO
+                            vsWordModList[nLocalDictIdx+nLocalWordIdx] += "UPDATED ";
+#endif //DISPLAY_PAWCS_DEBUG_INFO
                         }
-                        m_oIllumUpdtRegionMask.data[nPxIter-1] = 1&m_oROI.data[nPxIter-1];
-                        m_oIllumUpdtRegionMask.data[nPxIter+1] = 1&m_oROI.data[nPxIter+1];
-                        m_oIllumUpdtRegionMask.data[nPxIter] = 2;
+                        if(nTotDescDist<=nCurrTotDescDistThreshold && nTotColorMixDist<=nCurrTotColorDistThreshold) {
+                            fPotentialLocalWordsWeightSum += fCurrLocalWordWeight;
+                            oCurrLocalWord.nLastOcc = m_nFrameIdx;
+                            if((!m_oLastFGMask.data[nPxIter] || m_bUsingMovingCamera) && fCurrLocalWordWeight<DEFAULT_LWORD_MAX_WEIGHT)
+                                oCurrLocalWord.nOccurrences += nCurrWordOccIncr;
+                            nMinTotColorDist = std::min(nMinTotColorDist,nTotColorMixDist);
+                            nMinTotDescDist = std::min(nMinTotDescDist,nTotDescDist);
 #if DISPLAY_PAWCS_DEBUG_INFO
-                        vsWordModList[nLocalDictIdx+nLocalWordIdx] += "UPDATED ";
+                            vsWordModList[nLocalDictIdx+nLocalWordIdx] += "MATCHED ";
 #endif //DISPLAY_PAWCS_DEBUG_INFO
+                        }
                     }
-                    if(nTotDescDist<=nCurrTotDescDistThreshold && nTotColorMixDist<=nCurrTotColorDistThreshold) {
-                        fPotentialLocalWordsWeightSum += fCurrLocalWordWeight;
-                        oCurrLocalWord.nLastOcc = m_nFrameIdx;
-                        if((!m_oLastFGMask.data[nPxIter] || m_bUsingMovingCamera) && fCurrLocalWordWeight<DEFAULT_LWORD_MAX_WEIGHT)
-                            oCurrLocalWord.nOccurrences += nCurrWordOccIncr;
-                        nMinTotColorDist = std::min(nMinTotColorDist,nTotColorMixDist);
-                        nMinTotDescDist = std::min(nMinTotDescDist,nTotDescDist);
+                    if(fCurrLocalWordWeight>fLastLocalWordWeight) {
+                        std::swap(m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]);
+                        swapCachedLocalWordWeights(nLocalDictIdx+nLocalWordIdx,nLocalDictIdx+nLocalWordIdx-1);
 #if DISPLAY_PAWCS_DEBUG_INFO
-                        vsWordModList[nLocalDictIdx+nLocalWordIdx] += "MATCHED ";
+                        std::swap(vsWordModList[nLocalDictIdx+nLocalWordIdx],vsWordModList[nLocalDictIdx+nLocalWordIdx-1]);
 #endif //DISPLAY_PAWCS_DEBUG_INFO
                     }
+                    else
+                        fLastLocalWordWeight = fCurrLocalWordWeight;
+                    ++nLocalWordIdx;
                 }
-                if(fCurrLocalWordWeight>fLastLocalWordWeight) {
-                    std::swap(m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]);
+                if(((m_nFrameIdx+nModelIter)%LWORD_RANK_REFRESH_RATE)==0) {
+                    // full rank refresh of the unscanned dict tail (staggered across px)
+                    while(nLocalWordIdx<m_nCurrLocalWords) {
+                        const float fCurrLocalWordWeight = GetLocalWordWeight(*GetWord(m_voLocalWordList_3ch,m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx]),m_nFrameIdx,m_nLocalWordWeightOffset);
+                        setCachedLocalWordWeight(nLocalDictIdx+nLocalWordIdx,fCurrLocalWordWeight);
+                        if(fCurrLocalWordWeight>fLastLocalWordWeight) {
+                            std::swap(m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]);
+                            swapCachedLocalWordWeights(nLocalDictIdx+nLocalWordIdx,nLocalDictIdx+nLocalWordIdx-1);
 #if DISPLAY_PAWCS_DEBUG_INFO
-                    std::swap(vsWordModList[nLocalDictIdx+nLocalWordIdx],vsWordModList[nLocalDictIdx+nLocalWordIdx-1]);
+                            std::swap(vsWordModList[nLocalDictIdx+nLocalWordIdx],vsWordModList[nLocalDictIdx+nLocalWordIdx-1]);
 #endif //DISPLAY_PAWCS_DEBUG_INFO
+                        }
+                        else
+                            fLastLocalWordWeight = fCurrLocalWordWeight;
+                        ++nLocalWordIdx;
+                    }
                 }
-                else
-                    fLastLocalWordWeight = fCurrLocalWordWeight;
-                ++nLocalWordIdx;
-            }
-            while(nLocalWordIdx<m_nCurrLocalWords) {
-                const float fCurrLocalWordWeight = GetLocalWordWeight(*m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_nFrameIdx,m_nLocalWordWeightOffset);
-                if(fCurrLocalWordWeight>fLastLocalWordWeight) {
-                    std::swap(m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]);
+                else if(nLocalWordIdx<m_nCurrLocalWords && getCachedLocalWordWeight(nLocalDictIdx+nLocalWordIdx)>fLastLocalWordWeight) {
+                    // between refreshes, the tail keeps its last order; only the scan boundary is ranked (using its cached weight, if computed this frame)
+                    std::swap(m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx],m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx-1]);
+                    swapCachedLocalWordWeights(nLocalDictIdx+nLocalWordIdx,nLocalDictIdx+nLocalWordIdx-1);
 #if DISPLAY_PAWCS_DEBUG_INFO
                     std::swap(vsWordModList[nLocalDictIdx+nLocalWordIdx],vsWordModList[nLocalDictIdx+nLocalWordIdx-1]);
 #endif //DISPLAY_PAWCS_DEBUG_INFO
                 }
-                else
-                    fLastLocalWordWeight = fCurrLocalWordWeight;
-                ++nLocalWordIdx;
-            }
 #if USE_INTERNAL_HRCS
-            std::chrono::high_resolution_clock::time_point post_ldictscan = std::chrono::high_resolution_clock::now();
-            fLDictScanTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_ldictscan-post_prep).count())/1000000;
+                std::chrono::high_resolution_clock::time_point post_ldictscan = std::chrono::high_resolution_clock::now();
+                fLDictScanTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_ldictscan-post_prep).count())/1000000;
 #endif //USE_INTERNAL_HRCS
-            if(fPotentialLocalWordsWeightSum>=fLocalWordsWeightSumThreshold || bCurrRegionIsROIBorder) {
-                // == background
+                if(fPotentialLocalWordsWeightSum>=fLocalWordsWeightSumThreshold || bCurrRegionIsROIBorder) {
+                    // == background
 #if USE_FEEDBACK_ADJUSTMENTS
-                const float fNormalizedMinDist = std::max((float)nMinTotColorDist/s_nColorMaxDataRange_3ch,(float)nMinTotDescDist/s_nDescMaxDataRange_3ch);
-                fCurrMeanMinDist_LT = fCurrMeanMinDist_LT*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
-                fCurrMeanMinDist_ST = fCurrMeanMinDist_ST*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
+                    const float fNormalizedMinDist = std::max((float)nMinTotColorDist/s_nColorMaxDataRange_3ch,(float)nMinTotDescDist/s_nDescMaxDataRange_3ch);
+                    fCurrMeanMinDist_LT = fCurrMeanMinDist_LT*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
+                    fCurrMeanMinDist_ST = fCurrMeanMinDist_ST*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
 #endif //USE_FEEDBACK_ADJUSTMENTS
-                fCurrMeanRawSegmRes_LT = fCurrMeanRawSegmRes_LT*(1.0f-fRollAvgFactor_LT);
-                fCurrMeanRawSegmRes_ST = fCurrMeanRawSegmRes_ST*(1.0f-fRollAvgFactor_ST);
-                if((rand()%nCurrLocalWordUpdateRate)==0) {
-                    size_t nGlobalWordLUTIdx;
-                    GlobalWord_3ch* pCurrGlobalWord = nullptr;
-                    for(nGlobalWordLUTIdx=0; nGlobalWordLUTIdx<m_nCurrGlobalWords; ++nGlobalWordLUTIdx) {
-                        pCurrGlobalWord = (GlobalWord_3ch*)m_voPxInfoLUT_PAWCS[nPxIter].vpGlobalDictSortLUT[nGlobalWordLUTIdx];
-                        if(DistanceUtils::L1dist(nCurrIntraDescBITS,pCurrGlobalWord->nDescBITS)<=nCurrTotDescDistThreshold/GWORD_DESC_THRES_BITS_MATCH_FACTOR &&
-                           DistanceUtils::cmixdist(anCurrColor,pCurrGlobalWord->oFeature.anColor)<=nCurrTotColorDistThreshold)
-                            break;
-                    }
-                    if(nGlobalWordLUTIdx!=m_nCurrGlobalWords || (rand()%(nCurrLocalWordUpdateRate*2))==0) {
-                        if(nGlobalWordLUTIdx==m_nCurrGlobalWords) {
-                            pCurrGlobalWord = (GlobalWord_3ch*)m_vpGlobalWordDict[m_nCurrGlobalWords-1];
-                            for(size_t c=0; c<3; ++c) {
-                                pCurrGlobalWord->oFeature.anColor[c] = anCurrColor[c];
-                                pCurrGlobalWord->oFeature.anDesc[c] = anCurrIntraDesc[c];
+                    fCurrMeanRawSegmRes_LT = fCurrMeanRawSegmRes_LT*(1.0f-fRollAvgFactor_LT);
+                    fCurrMeanRawSegmRes_ST = fCurrMeanRawSegmRes_ST*(1.0f-fRollAvgFactor_ST);
+                    if((oTile.oRNG()%nCurrLocalWordUpdateRate)==0) {
+                        WordHandle nMatchedGlobalWordHandle = s_nInvalidWordHandle;
+                        for(size_t nGlobalWordLUTIdx=0; nGlobalWordLUTIdx<m_nCurrGlobalWords; ++nGlobalWordLUTIdx) {
+                            const WordHandle nCurrGlobalWordHandle = m_vnGlobalWordSortLUT[nModelIter*m_nCurrGlobalWords+nGlobalWordLUTIdx];
+                            const GlobalWord_3ch& oCurrGlobalWord = m_voGlobalWordList_3ch[nCurrGlobalWordHandle];
+                            if(DistanceUtils::L1dist(nCurrIntraDescBITS,oCurrGlobalWord.nDescBITS)<=nCurrTotDescDistThreshold/GWORD_DESC_THRES_BITS_MATCH_FACTOR &&
+                               DistanceUtils::cmixdist(anCurrColor,oCurrGlobalWord.oFeature.anColor)<=nCurrTotColorDistThreshold) {
+                                nMatchedGlobalWordHandle = nCurrGlobalWordHandle;
+                                break;
                             }
-                            pCurrGlobalWord->nDescBITS = nCurrIntraDescBITS;
-                            pCurrGlobalWord->oSpatioOccMap = cv::Scalar(0.0f);
-                            pCurrGlobalWord->fLatestWeight = 0.0f;
                         }
-                        float& fCurrGlobalWordLocalWeight = *(float*)(pCurrGlobalWord->oSpatioOccMap.data+nGlobalWordMapLookupIdx);
-                        if(fCurrGlobalWordLocalWeight<fPotentialLocalWordsWeightSum) {
-                            pCurrGlobalWord->fLatestWeight += fPotentialLocalWordsWeightSum;
-                            fCurrGlobalWordLocalWeight += fPotentialLocalWordsWeightSum;
+                        if(nMatchedGlobalWordHandle!=s_nInvalidWordHandle || (oTile.oRNG()%(nCurrLocalWordUpdateRate*2))==0) {
+                            const GlobalWordUpdate oUpdate = {nMatchedGlobalWordHandle,nGlobalWordMapLookupIdx,fPotentialLocalWordsWeightSum,{anCurrColor[0],anCurrColor[1],anCurrColor[2]},anCurrIntraDesc,nCurrIntraDescBITS};
+                            if(bDeferGlobalWordUpdates)
+                                oTile.voDeferredGlobalWordUpdates.push_back(oUpdate);
+                            else
+                                update_global_word(oUpdate);
                         }
                     }
                 }
-            }
-            else {
-                // == foreground
+                else {
+                    // == foreground
 #if USE_FEEDBACK_ADJUSTMENTS
-                const float fNormalizedMinDist = std::max(std::max((float)nMinTotColorDist/s_nColorMaxDataRange_3ch,(float)nMinTotDescDist/s_nDescMaxDataRange_3ch),(fLocalWordsWeightSumThreshold-fPotentialLocalWordsWeightSum)/fLocalWordsWeightSumThreshold);
-                fCurrMeanMinDist_LT = fCurrMeanMinDist_LT*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
-                fCurrMeanMinDist_ST = fCurrMeanMinDist_ST*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
+                    const float fNormalizedMinDist = std::max(std::max((float)nMinTotColorDist/s_nColorMaxDataRange_3ch,(float)nMinTotDescDist/s_nDescMaxDataRange_3ch),(fLocalWordsWeightSumThreshold-fPotentialLocalWordsWeightSum)/fLocalWordsWeightSumThreshold);
+                    fCurrMeanMinDist_LT = fCurrMeanMinDist_LT*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
+                    fCurrMeanMinDist_ST = fCurrMeanMinDist_ST*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
 #endif //USE_FEEDBACK_ADJUSTMENTS
-                fCurrMeanRawSegmRes_LT = fCurrMeanRawSegmRes_LT*(1.0f-fRollAvgFactor_LT) + fRollAvgFactor_LT;
-                fCurrMeanRawSegmRes_ST = fCurrMeanRawSegmRes_ST*(1.0f-fRollAvgFactor_ST) + fRollAvgFactor_ST;
-                if(bCurrRegionIsFlat || (rand()%nCurrLocalWordUpdateRate)==0) {
-                    size_t nGlobalWordLUTIdx;
-                    GlobalWord_3ch* pCurrGlobalWord = nullptr;
-                    for(nGlobalWordLUTIdx=0; nGlobalWordLUTIdx<m_nCurrGlobalWords; ++nGlobalWordLUTIdx) {
-                        pCurrGlobalWord = (GlobalWord_3ch*)m_voPxInfoLUT_PAWCS[nPxIter].vpGlobalDictSortLUT[nGlobalWordLUTIdx];
-                        if(DistanceUtils::L1dist(nCurrIntraDescBITS,pCurrGlobalWord->nDescBITS)<=nCurrTotDescDistThreshold/GWORD_DESC_THRES_BITS_MATCH_FACTOR &&
-                           DistanceUtils::cmixdist(anCurrColor,pCurrGlobalWord->oFeature.anColor)<=nCurrTotColorDistThreshold)
-                            break;
-                    }
-                    if(nGlobalWordLUTIdx==m_nCurrGlobalWords)
-                        nCurrRegionSegmVal = UCHAR_MAX;
-                    else {
-                        const float fGlobalWordLocalizedWeight = *(float*)(pCurrGlobalWord->oSpatioOccMap.data+nGlobalWordMapLookupIdx);
-                        if(fPotentialLocalWordsWeightSum+fGlobalWordLocalizedWeight/(bCurrRegionIsFlat?2:4)<fLocalWordsWeightSumThreshold)
+                    fCurrMeanRawSegmRes_LT = fCurrMeanRawSegmRes_LT*(1.0f-fRollAvgFactor_LT) + fRollAvgFactor_LT;
+                    fCurrMeanRawSegmRes_ST = fCurrMeanRawSegmRes_ST*(1.0f-fRollAvgFactor_ST) + fRollAvgFactor_ST;
+                    if(bCurrRegionIsFlat || (oTile.oRNG()%nCurrLocalWordUpdateRate)==0) {
+                        size_t nGlobalWordLUTIdx;
+                        GlobalWord_3ch* pCurrGlobalWord = nullptr;
+                        for(nGlobalWordLUTIdx=0; nGlobalWordLUTIdx<m_nCurrGlobalWords; ++nGlobalWordLUTIdx) {
+                            pCurrGlobalWord = &m_voGlobalWordList_3ch[m_vnGlobalWordSortLUT[nModelIter*m_nCurrGlobalWords+nGlobalWordLUTIdx]];
+                            if(DistanceUtils::L1dist(nCurrIntraDescBITS,pCurrGlobalWord->nDescBITS)<=nCurrTotDescDistThreshold/GWORD_DESC_THRES_BITS_MATCH_FACTOR &&
+                               DistanceUtils::cmixdist(anCurrColor,pCurrGlobalWord->oFeature.anColor)<=nCurrTotColorDistThreshold)
+                                break;
+                        }
+                        if(nGlobalWordLUTIdx==m_nCurrGlobalWords)
                             nCurrRegionSegmVal = UCHAR_MAX;
-                    }
-#if DISPLAY_PAWCS_DEBUG_INFO
-                    if(!nCurrRegionSegmVal && m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y==oDbgPt.y && m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X==oDbgPt.x) {
-                        bDBGMaskModifiedByGDict = true;
-                        pDBGGlobalWordModifier = pCurrGlobalWord;
-                        fDBGGlobalWordModifierLocalWeight = *(float*)(pCurrGlobalWord->oSpatioOccMap.data+nGlobalWordMapLookupIdx);
-                    }
-#endif //DISPLAY_PAWCS_DEBUG_INFO
-                }
-                else
-                    nCurrRegionSegmVal = UCHAR_MAX;
-                if(fPotentialLocalWordsWeightSum<DEFAULT_LWORD_INIT_WEIGHT) {
-                    const size_t nNewLocalWordIdx = m_nCurrLocalWords-1;
-                    LocalWord_3ch* pNewLocalWord = (LocalWord_3ch*)m_vpLocalWordDict[nLocalDictIdx+nNewLocalWordIdx];
-                    for(size_t c=0; c<3; ++c) {
-                        pNewLocalWord->oFeature.anColor[c] = anCurrColor[c];
-                        pNewLocalWord->oFeature.anDesc[c] = anCurrIntraDesc[c];
-                    }
-                    pNewLocalWord->nOccurrences = nCurrWordOccIncr;
-                    pNewLocalWord->nFirstOcc = m_nFrameIdx;
-                    pNewLocalWord->nLastOcc = m_nFrameIdx;
-#if DISPLAY_PAWCS_DEBUG_INFO
-                    vsWordModList[nLocalDictIdx+nNewLocalWordIdx] += "NEW ";
-#endif //DISPLAY_PAWCS_DEBUG_INFO
-                }
-            }
-#if USE_INTERNAL_HRCS
-            std::chrono::high_resolution_clock::time_point post_rawdecision = std::chrono::high_resolution_clock::now();
-            if(nCurrRegionSegmVal)
-                fFGRawTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_rawdecision-post_ldictscan).count())/1000000;
-            else
-                fBGRawTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_rawdecision-post_ldictscan).count())/1000000;
-#endif //USE_INTERNAL_HRCS
-            // == neighb updt
-            if((!nCurrRegionSegmVal && (rand()%nCurrLocalWordUpdateRate)==0) || bCurrRegionIsROIBorder || m_bUsingMovingCamera) {
-            //if((!nCurrRegionSegmVal && (rand()%(nCurrRegionIllumUpdtVal?(nCurrLocalWordUpdateRate/2+1):nCurrLocalWordUpdateRate))==0) || bCurrRegionIsROIBorder) {
-                int nSampleImgCoord_Y, nSampleImgCoord_X;
-                if(bCurrRegionIsFlat || bCurrRegionIsROIBorder || m_bUsingMovingCamera)
-                    cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                else
-                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
-                if(m_oROI.data[nSamplePxIdx]) {
-                    const size_t nNeighborLocalDictIdx = m_voPxInfoLUT_PAWCS[nSamplePxIdx].nModelIdx*m_nCurrLocalWords;
-                    size_t nNeighborLocalWordIdx = 0;
-                    float fNeighborPotentialLocalWordsWeightSum = 0.0f;
-                    while(nNeighborLocalWordIdx<m_nCurrLocalWords && fNeighborPotentialLocalWordsWeightSum<fLocalWordsWeightSumThreshold) {
-                        LocalWord_3ch& oNeighborLocalWord = (LocalWord_3ch&)*m_vpLocalWordDict[nNeighborLocalDictIdx+nNeighborLocalWordIdx];
-                        const size_t nNeighborTotColorL1Dist = DistanceUtils::L1dist(anCurrColor,oNeighborLocalWord.oFeature.anColor);
-                        const size_t nNeighborColorDistortion = DistanceUtils::cdist(anCurrColor,oNeighborLocalWord.oFeature.anColor);
-                        const size_t nNeighborTotColorMixDist = DistanceUtils::cmixdist(nNeighborTotColorL1Dist,nNeighborColorDistortion);
-                        const size_t nNeighborTotIntraDescDist = DistanceUtils::hdist(anCurrIntraDesc,oNeighborLocalWord.oFeature.anDesc);
-                        const bool bNeighborRegionIsFlat = DistanceUtils::popcount(oNeighborLocalWord.oFeature.anDesc)<FLAT_REGION_BIT_COUNT*2;
-                        const size_t nNeighborWordOccIncr = bNeighborRegionIsFlat?nCurrWordOccIncr*2:nCurrWordOccIncr;
-                        if(nNeighborTotColorMixDist<=nCurrTotColorDistThreshold && nNeighborTotIntraDescDist<=nCurrTotDescDistThreshold) {
-                            const float fNeighborLocalWordWeight = GetLocalWordWeight(oNeighborLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
-                            fNeighborPotentialLocalWordsWeightSum += fNeighborLocalWordWeight;
-                            oNeighborLocalWord.nLastOcc = m_nFrameIdx;
-                            if(fNeighborLocalWordWeight<DEFAULT_LWORD_MAX_WEIGHT)
-                                oNeighborLocalWord.nOccurrences += nNeighborWordOccIncr;
-#if DISPLAY_PAWCS_DEBUG_INFO
-                            vsWordModList[nNeighborLocalDictIdx+nNeighborLocalWordIdx] += "MATCHED(NEIGHBOR) ";
-#endif //DISPLAY_PAWCS_DEBUG_INFO
+                        else {
+                            const float fGlobalWordLocalizedWeight = *(float*)(pCurrGlobalWord->oSpatioOccMap.data+nGlobalWordMapLookupIdx);
+                            if(fPotentialLocalWordsWeightSum+fGlobalWordLocalizedWeight/(bCurrRegionIsFlat?2:4)<fLocalWordsWeightSumThreshold)
+                                nCurrRegionSegmVal = UCHAR_MAX;
                         }
-                        else if(!oCurrFGMask.data[nSamplePxIdx] && bCurrRegionIsFlat && (bBootstrapping || (rand()%nCurrLocalWordUpdateRate)==0)) {
-                            const size_t nSamplePxRGBIdx = nSamplePxIdx*3;
-                            const size_t nSampleDescRGBIdx = nSamplePxRGBIdx*2;
-                            ushort* anNeighborLastIntraDesc = ((ushort*)(m_oLastDescFrame.data+nSampleDescRGBIdx));
-                            const size_t nNeighborTotLastIntraDescDist = DistanceUtils::hdist(anCurrIntraDesc,anNeighborLastIntraDesc);
-                            if(nNeighborTotColorMixDist<=nCurrTotColorDistThreshold && nNeighborTotLastIntraDescDist<=nCurrTotDescDistThreshold/2) {
-                                const float fNeighborLocalWordWeight = GetLocalWordWeight(oNeighborLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
-                                fNeighborPotentialLocalWordsWeightSum += fNeighborLocalWordWeight;
-                                oNeighborLocalWord.nLastOcc = m_nFrameIdx;
-                                if(fNeighborLocalWordWeight<DEFAULT_LWORD_MAX_WEIGHT)
-                                    oNeighborLocalWord.nOccurrences += nNeighborWordOccIncr;
-                                for(size_t c=0; c<3; ++c)
-                                    oNeighborLocalWord.oFeature.anDesc[c] = anCurrIntraDesc[c];
-#if DISPLAY_PAWCS_DEBUG_INFO
-                                vsWordModList[nNeighborLocalDictIdx+nNeighborLocalWordIdx] += "UPDATED1(NEIGHBOR) ";
-#endif //DISPLAY_PAWCS_DEBUG_INFO
-                            }
-                            else {
-                                const bool bNeighborLastRegionIsFlat = DistanceUtils::popcount<3>(anNeighborLastIntraDesc)<FLAT_REGION_BIT_COUNT*2;
-                                if(bNeighborLastRegionIsFlat && bCurrRegionIsFlat &&
-                                    nNeighborTotLastIntraDescDist+nNeighborTotIntraDescDist<=nCurrTotDescDistThreshold &&
-                                    nNeighborColorDistortion<=nCurrTotColorDistThreshold/4) {
-                                        const float fNeighborLocalWordWeight = GetLocalWordWeight(oNeighborLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
-                                        fNeighborPotentialLocalWordsWeightSum += fNeighborLocalWordWeight;
-                                        oNeighborLocalWord.nLastOcc = m_nFrameIdx;
-                                        if(fNeighborLocalWordWeight<DEFAULT_LWORD_MAX_WEIGHT)
-                                            oNeighborLocalWord.nOccurrences += nNeighborWordOccIncr;
-                                        for(size_t c=0; c<3; ++c)
-                                            oNeighborLocalWord.oFeature.anColor[c] = anCurrColor[c];
 #if DISPLAY_PAWCS_DEBUG_INFO
-                                        vsWordModList[nNeighborLocalDictIdx+nNeighborLocalWordIdx] += "UPDATED2(NEIGHBOR) ";
-#endif //DISPLAY_PAWCS_DEBUG_INFO
-                                }
-                            }
+                        if(!nCurrRegionSegmVal && m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y==oDbgPt.y && m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X==oDbgPt.x) {
+                            bDBGMaskModifiedByGDict = true;
+                            pDBGGlobalWordModifier = pCurrGlobalWord;
+                            fDBGGlobalWordModifierLocalWeight = *(float*)(pCurrGlobalWord->oSpatioOccMap.data+nGlobalWordMapLookupIdx);
                         }
-                        ++nNeighborLocalWordIdx;
+#endif //DISPLAY_PAWCS_DEBUG_INFO
                     }
-                    if(fNeighborPotentialLocalWordsWeightSum<DEFAULT_LWORD_INIT_WEIGHT) {
-                        nNeighborLocalWordIdx = m_nCurrLocalWords-1;
-                        LocalWord_3ch& oNeighborLocalWord = (LocalWord_3ch&)*m_vpLocalWordDict[nNeighborLocalDictIdx+nNeighborLocalWordIdx];
+                    else
+                        nCurrRegionSegmVal = UCHAR_MAX;
+                    if(fPotentialLocalWordsWeightSum<DEFAULT_LWORD_INIT_WEIGHT) {
+                        const size_t nNewLocalWordIdx = m_nCurrLocalWords-1;
+                        LocalWord_3ch* pNewLocalWord = GetWord(m_voLocalWordList_3ch,m_vnLocalWordDict[nLocalDictIdx+nNewLocalWordIdx]);
                         for(size_t c=0; c<3; ++c) {
-                            oNeighborLocalWord.oFeature.anColor[c] = anCurrColor[c];
-                            oNeighborLocalWord.oFeature.anDesc[c] = anCurrIntraDesc[c];
+                            pNewLocalWord->oFeature.anColor[c] = anCurrColor[c];
+                            pNewLocalWord->oFeature.anDesc[c] = anCurrIntraDesc[c];
                         }
-                        oNeighborLocalWord.nOccurrences = nCurrWordOccIncr;
-                        oNeighborLocalWord.nFirstOcc = m_nFrameIdx;
-                        oNeighborLocalWord.nLastOcc = m_nFrameIdx;
+                        pNewLocalWord->nOccurrences = nCurrWordOccIncr;
+                        pNewLocalWord->nFirstOcc = m_nFrameIdx;
+                        pNewLocalWord->nLastOcc = m_nFrameIdx;
+                        setCachedLocalWordWeight(nLocalDictIdx+nNewLocalWordIdx,GetLocalWordWeight(*pNewLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset));
 #if DISPLAY_PAWCS_DEBUG_INFO
-                        vsWordModList[nNeighborLocalDictIdx+nNeighborLocalWordIdx] += "NEW(NEIGHBOR) ";
+                        vsWordModList[nLocalDictIdx+nNewLocalWordIdx] += "NEW ";
 #endif //DISPLAY_PAWCS_DEBUG_INFO
                     }
                 }
-            }
 #if USE_INTERNAL_HRCS
-            std::chrono::high_resolution_clock::time_point post_neighbupdt = std::chrono::high_resolution_clock::now();
-            fNeighbUpdtTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_neighbupdt-post_rawdecision).count())/1000000;
+                std::chrono::high_resolution_clock::time_point post_rawdecision = std::chrono::high_resolution_clock::now();
+                if(nCurrRegionSegmVal)
+                    fFGRawTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_rawdecision-post_ldictscan).count())/1000000;
+                else
+                    fBGRawTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_rawdecision-post_ldictscan).count())/1000000;
+#endif //USE_INTERNAL_HRCS
+                // == neighb updt
+                if((!nCurrRegionSegmVal && (oTile.oRNG()%nCurrLocalWordUpdateRate)==0) || bCurrRegionIsROIBorder || m_bUsingMovingCamera) {
+                //if((!nCurrRegionSegmVal && (oTile.oRNG()%(nCurrRegionIllumUpdtVal?(nCurrLocalWordUpdateRate/2+1):nCurrLocalWordUpdateRate))==0) || bCurrRegionIsROIBorder) {
+                    int nSampleImgCoord_Y, nSampleImgCoord_X;
+                    if(bCurrRegionIsFlat || bCurrRegionIsROIBorder || m_bUsingMovingCamera)
+                        cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,oTile.oRNG);
+                    else
+                        cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,oTile.oRNG);
+                    const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
+                    if(m_oROI.data[nSamplePxIdx]) {
+                        const NeighborModelUpdate oUpdate = {nSamplePxIdx,{anCurrColor[0],anCurrColor[1],anCurrColor[2]},anCurrIntraDesc,nCurrTotColorDistThreshold,nCurrTotDescDistThreshold,fLocalWordsWeightSumThreshold,nCurrWordOccIncr,nCurrLocalWordUpdateRate,bCurrRegionIsFlat};
+                        if(nSampleImgCoord_Y>=oTile.nRowBegin && nSampleImgCoord_Y<oTile.nRowEnd)
+                            lNeighborUpdate_3ch(oUpdate,oTile.oRNG);
+                        else // target px is owned by another tile; its update will be applied once all tiles are processed
+                            oTile.voDeferredNeighborUpdates.push_back(oUpdate);
+                    }
+                }
+#if USE_INTERNAL_HRCS
+                std::chrono::high_resolution_clock::time_point post_neighbupdt = std::chrono::high_resolution_clock::now();
+                fNeighbUpdtTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_neighbupdt-post_rawdecision).count())/1000000;
 #endif //USE_INTERNAL_HRCS
-            if(nCurrRegionIllumUpdtVal)
-                nCurrRegionIllumUpdtVal -= 1;
-            // == feedback adj
-            bCurrRegionIsUnstable = fCurrDistThresholdFactor>UNSTABLE_REG_RDIST_MIN || (fCurrMeanRawSegmRes_LT-fCurrMeanFinalSegmRes_LT)>UNSTABLE_REG_RATIO_MIN || (fCurrMeanRawSegmRes_ST-fCurrMeanFinalSegmRes_ST)>UNSTABLE_REG_RATIO_MIN;
+                if(nCurrRegionIllumUpdtVal)
+                    nCurrRegionIllumUpdtVal -= 1;
+                // == feedback adj
+                bCurrRegionIsUnstable = fCurrDistThresholdFactor>UNSTABLE_REG_RDIST_MIN || (fCurrMeanRawSegmRes_LT-fCurrMeanFinalSegmRes_LT)>UNSTABLE_REG_RATIO_MIN || (fCurrMeanRawSegmRes_ST-fCurrMeanFinalSegmRes_ST)>UNSTABLE_REG_RATIO_MIN;
 #if USE_FEEDBACK_ADJUSTMENTS
-            if(m_oLastFGMask.data[nPxIter] || (std::min(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST)<UNSTABLE_REG_RATIO_MIN && nCurrRegionSegmVal))
-                fCurrLearningRate = std::min(fCurrLearningRate+FEEDBACK_T_INCR/(std::max(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST)*fCurrDistThresholdVariationFactor),FEEDBACK_T_UPPER);
-            else
-                fCurrLearningRate = std::max(fCurrLearningRate-FEEDBACK_T_DECR*fCurrDistThresholdVariationFactor/std::max(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST),FEEDBACK_T_LOWER);
-            if(std::max(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST)>UNSTABLE_REG_RATIO_MIN && m_oBlinksFrame.data[nPxIter])
-                (fCurrDistThresholdVariationFactor) += bBootstrapping?FEEDBACK_V_INCR*2:FEEDBACK_V_INCR;
-            else
-                fCurrDistThresholdVariationFactor = std::max(fCurrDistThresholdVariationFactor-FEEDBACK_V_DECR*((bBootstrapping||bCurrRegionIsFlat)?2:m_oLastFGMask.data[nPxIter]?0.5f:1),FEEDBACK_V_DECR);
-            if(fCurrDistThresholdFactor<std::pow(1.0f+std::min(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST)*2,2))
-                fCurrDistThresholdFactor += FEEDBACK_R_VAR*(fCurrDistThresholdVariationFactor-FEEDBACK_V_DECR);
-            else
-                fCurrDistThresholdFactor = std::max(fCurrDistThresholdFactor-FEEDBACK_R_VAR/fCurrDistThresholdVariationFactor,1.0f);
+                if(m_oLastFGMask.data[nPxIter] || (std::min(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST)<UNSTABLE_REG_RATIO_MIN && nCurrRegionSegmVal))
+                    fCurrLearningRate = std::min(fCurrLearningRate+FEEDBACK_T_INCR/(std::max(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST)*fCurrDistThresholdVariationFactor),FEEDBACK_T_UPPER);
+                else
+                    fCurrLearningRate = std::max(fCurrLearningRate-FEEDBACK_T_DECR*fCurrDistThresholdVariationFactor/std::max(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST),FEEDBACK_T_LOWER);
+                if(std::max(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST)>UNSTABLE_REG_RATIO_MIN && m_oBlinksFrame.data[nPxIter])
+                    (fCurrDistThresholdVariationFactor) += bBootstrapping?FEEDBACK_V_INCR*2:FEEDBACK_V_INCR;
+                else
+                    fCurrDistThresholdVariationFactor = std::max(fCurrDistThresholdVariationFactor-FEEDBACK_V_DECR*((bBootstrapping||bCurrRegionIsFlat)?2:m_oLastFGMask.data[nPxIter]?0.5f:1),FEEDBACK_V_DECR);
+                if(fCurrDistThresholdFactor<std::pow(1.0f+std::min(fCurrMeanMinDist_LT,fCurrMeanMinDist_ST)*2,2))
+                    fCurrDistThresholdFactor += FEEDBACK_R_VAR*(fCurrDistThresholdVariationFactor-FEEDBACK_V_DECR);
+                else
+                    fCurrDistThresholdFactor = std::max(fCurrDistThresholdFactor-FEEDBACK_R_VAR/fCurrDistThresholdVariationFactor,1.0f);
 #endif //USE_FEEDBACK_ADJUSTMENTS
-            for(size_t c=0; c<3; ++c) {
-                anLastIntraDesc[c] = anCurrIntraDesc[c];
-                anLastColor[c] = anCurrColor[c];
-            }
+                for(size_t c=0; c<3; ++c) {
+                    anLastIntraDesc[c] = anCurrIntraDesc[c];
+                    anLastColor[c] = anCurrColor[c];
+                }
 #if USE_INTERNAL_HRCS
-            std::chrono::high_resolution_clock::time_point post_varupdt = std::chrono::high_resolution_clock::now();
-            fVarUpdtTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_varupdt-post_neighbupdt).count())/1000000;
-            post_lastKP = std::chrono::high_resolution_clock::now();
-            fIntraKPsTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_lastKP-pre_currKP).count())/1000000;
+                std::chrono::high_resolution_clock::time_point post_varupdt = std::chrono::high_resolution_clock::now();
+                fVarUpdtTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_varupdt-post_neighbupdt).count())/1000000;
+                post_lastKP = std::chrono::high_resolution_clock::now();
+                fIntraKPsTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_lastKP-pre_currKP).count())/1000000;
 #endif //USE_INTERNAL_HRCS
 #if DISPLAY_PAWCS_DEBUG_INFO
-            if(m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y==oDbgPt.y && m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X==oDbgPt.x) {
-                for(size_t c=0; c<3; ++c) {
-                    anDBGColor[c] = anCurrColor[c];
-                    anDBGIntraDesc[c] = anCurrIntraDesc[c];
+                if(m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y==oDbgPt.y && m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X==oDbgPt.x) {
+                    for(size_t c=0; c<3; ++c) {
+                        anDBGColor[c] = anCurrColor[c];
+                        anDBGIntraDesc[c] = anCurrIntraDesc[c];
+                    }
+                    fDBGLocalWordsWeightSumThreshold = fLocalWordsWeightSumThreshold;
+                    bDBGMaskResult = (nCurrRegionSegmVal==UCHAR_MAX);
+                    nLocalDictDBGIdx = nLocalDictIdx;
+                    nDBGWordOccIncr = std::max(nDBGWordOccIncr,nCurrWordOccIncr);
                 }
-                fDBGLocalWordsWeightSumThreshold = fLocalWordsWeightSumThreshold;
-                bDBGMaskResult = (nCurrRegionSegmVal==UCHAR_MAX);
-                nLocalDictDBGIdx = nLocalDictIdx;
-                nDBGWordOccIncr = std::max(nDBGWordOccIncr,nCurrWordOccIncr);
-            }
 #endif //DISPLAY_PAWCS_DEBUG_INFO
-        }
+            }
 #if USE_INTERNAL_HRCS
-        std::chrono::high_resolution_clock::time_point post_loop = std::chrono::high_resolution_clock::now();
-        fInterKPsTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_loop-post_lastKP).count())/1000000;
-        fTotalKPsTime_MS = (float)(std::chrono::duration_cast<std::chrono::microseconds>(post_loop-pre_loop).count())/1000;
-        pre_gword_calcs = std::chrono::high_resolution_clock::now();
+            std::chrono::high_resolution_clock::time_point post_loop = std::chrono::high_resolution_clock::now();
+            fInterKPsTimeSum_MS += (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(post_loop-post_lastKP).count())/1000000;
+            fTotalKPsTime_MS = (float)(std::chrono::duration_cast<std::chrono::microseconds>(post_loop-pre_loop).count())/1000;
+            pre_gword_calcs = std::chrono::high_resolution_clock::now();
 #endif //USE_INTERNAL_HRCS
+        }
+    };
+#if (DISPLAY_PAWCS_DEBUG_INFO || USE_INTERNAL_HRCS)
+    process_tiles(lTileProcessor,false); // debug/timing accumulators are shared by all tiles
+#else //!(DISPLAY_PAWCS_DEBUG_INFO || USE_INTERNAL_HRCS)
+    process_tiles(lTileProcessor,true);
+#endif //!(DISPLAY_PAWCS_DEBUG_INFO || USE_INTERNAL_HRCS)
+    m_pCurrDescFrame.reset();
+    // note: deferred updates are applied in a fixed (tile) order here, so results do not depend on tile scheduling
+    size_t nFlatRegionCount = 0;
+    for(const TileInfo& oTile : m_voTiles) {
+        for(const GlobalWordUpdate& oUpdate : oTile.voDeferredGlobalWordUpdates)
+            update_global_word(oUpdate);
+        for(const NeighborModelUpdate& oUpdate : oTile.voDeferredNeighborUpdates) {
+            if(m_nImgChannels==1)
+                lNeighborUpdate_1ch(oUpdate,m_oRNG);
+            else //m_nImgChannels==3
+                lNeighborUpdate_3ch(oUpdate,m_oRNG);
+        }
+        nFlatRegionCount += oTile.nFlatRegionCount;
     }
     const bool bRecalcGlobalWords = !(m_nFrameIdx%(nCurrGlobalWordUpdateRate<<5));
     const bool bUpdateGlobalWords = !(m_nFrameIdx%(nCurrGlobalWordUpdateRate));
@@ -1304,35 +1460,24 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
     if(bUpdateGlobalWords)
         cv::resize(m_oLastFGMask_dilated_inverted,oLastFGMask_dilated_inverted_downscaled,m_oDownSampledFrameSize_GlobalWordLookup,0,0,cv::INTER_NEAREST);
     for(size_t nGlobalWordIdx=0; nGlobalWordIdx<m_nCurrGlobalWords; ++nGlobalWordIdx) {
-        if(bRecalcGlobalWords && m_vpGlobalWordDict[nGlobalWordIdx]->fLatestWeight>0.0f) {
-            m_vpGlobalWordDict[nGlobalWordIdx]->fLatestWeight = GetGlobalWordWeight(*m_vpGlobalWordDict[nGlobalWordIdx]);
-            if(m_vpGlobalWordDict[nGlobalWordIdx]->fLatestWeight<1.0f) {
-                m_vpGlobalWordDict[nGlobalWordIdx]->fLatestWeight = 0.0f;
-                m_vpGlobalWordDict[nGlobalWordIdx]->oSpatioOccMap = cv::Scalar(0.0f);
+        GlobalWordBase& oCurrGlobalWord = getGlobalWordBase(m_vnGlobalWordDict[nGlobalWordIdx]);
+        if(bRecalcGlobalWords && oCurrGlobalWord.fLatestWeight>0.0f) {
+            oCurrGlobalWord.fLatestWeight = GetGlobalWordWeight(oCurrGlobalWord);
+            if(oCurrGlobalWord.fLatestWeight<1.0f) {
+                oCurrGlobalWord.fLatestWeight = 0.0f;
+                oCurrGlobalWord.oSpatioOccMap = cv::Scalar(0.0f);
             }
         }
-        if(bUpdateGlobalWords && m_vpGlobalWordDict[nGlobalWordIdx]->fLatestWeight>0.0f) {
-            cv::accumulateProduct(m_vpGlobalWordDict[nGlobalWordIdx]->oSpatioOccMap,m_oTempGlobalWordWeightDiffFactor,m_vpGlobalWordDict[nGlobalWordIdx]->oSpatioOccMap,oLastFGMask_dilated_inverted_downscaled);
-            m_vpGlobalWordDict[nGlobalWordIdx]->fLatestWeight *= 0.9f;
-            cv::blur(m_vpGlobalWordDict[nGlobalWordIdx]->oSpatioOccMap,m_vpGlobalWordDict[nGlobalWordIdx]->oSpatioOccMap,cv::Size(3,3),cv::Point(-1,-1),cv::BORDER_REPLICATE);
-        }
-        if(nGlobalWordIdx>0 && m_vpGlobalWordDict[nGlobalWordIdx]->fLatestWeight>m_vpGlobalWordDict[nGlobalWordIdx-1]->fLatestWeight)
-            std::swap(m_vpGlobalWordDict[nGlobalWordIdx],m_vpGlobalWordDict[nGlobalWordIdx-1]);
-    }
-    if(bUpdateGlobalWords) {
-        for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
-            const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
-            const size_t nGlobalWordMapLookupIdx = m_voPxInfoLUT_PAWCS[nPxIter].nGlobalWordMapLookupIdx;
-            float fLastGlobalWordLocalWeight = *(float*)(m_voPxInfoLUT_PAWCS[nPxIter].vpGlobalDictSortLUT[0]->oSpatioOccMap.data+nGlobalWordMapLookupIdx);
-            for(size_t nGlobalWordLUTIdx=1; nGlobalWordLUTIdx<m_nCurrGlobalWords; ++nGlobalWordLUTIdx) {
-                const float fCurrGlobalWordLocalWeight = *(float*)(m_voPxInfoLUT_PAWCS[nPxIter].vpGlobalDictSortLUT[nGlobalWordLUTIdx]->oSpatioOccMap.data+nGlobalWordMapLookupIdx);
-                if(fCurrGlobalWordLocalWeight>fLastGlobalWordLocalWeight)
-                    std::swap(m_voPxInfoLUT_PAWCS[nPxIter].vpGlobalDictSortLUT[nGlobalWordLUTIdx],m_voPxInfoLUT_PAWCS[nPxIter].vpGlobalDictSortLUT[nGlobalWordLUTIdx-1]);
-                else
-                    fLastGlobalWordLocalWeight = fCurrGlobalWordLocalWeight;
-            }
+        if(bUpdateGlobalWords && oCurrGlobalWord.fLatestWeight>0.0f) {
+            cv::accumulateProduct(oCurrGlobalWord.oSpatioOccMap,m_oTempGlobalWordWeightDiffFactor,oCurrGlobalWord.oSpatioOccMap,oLastFGMask_dilated_inverted_downscaled);
+            oCurrGlobalWord.fLatestWeight *= 0.9f;
+            cv::blur(oCurrGlobalWord.oSpatioOccMap,oCurrGlobalWord.oSpatioOccMap,cv::Size(3,3),cv::Point(-1,-1),cv::BORDER_REPLICATE);
         }
+        if(nGlobalWordIdx>0 && oCurrGlobalWord.fLatestWeight>getGlobalWordBase(m_vnGlobalWordDict[nGlobalWordIdx-1]).fLatestWeight)
+            std::swap(m_vnGlobalWordDict[nGlobalWordIdx],m_vnGlobalWordDict[nGlobalWordIdx-1]);
     }
+    if(bUpdateGlobalWords)
+        process_tiles([&](TileInfo* pTile){sort_global_word_lut(*pTile);},true);
 #if USE_INTERNAL_HRCS
     std::chrono::high_resolution_clock::time_point post_gword_calcs = std::chrono::high_resolution_clock::now();
     std::cout << "t=" << m_nFrameIdx << " : ";
@@ -1352,7 +1497,7 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
         cv::Point dbgpt(oDbgPt.x,oDbgPt.y);
         cv::Mat oGlobalWordsCoverageMap(m_oDownSampledFrameSize_GlobalWordLookup,CV_32FC1,cv::Scalar(0.0f));
         for(size_t nDBGWordIdx=0; nDBGWordIdx<m_nCurrGlobalWords; ++nDBGWordIdx)
-            cv::max(oGlobalWordsCoverageMap,m_vpGlobalWordDict[nDBGWordIdx]->oSpatioOccMap,oGlobalWordsCoverageMap);
+            cv::max(oGlobalWordsCoverageMap,getGlobalWordBase(m_vnGlobalWordDict[nDBGWordIdx]).oSpatioOccMap,oGlobalWordsCoverageMap);
         cv::resize(oGlobalWordsCoverageMap,oGlobalWordsCoverageMap,DEFAULT_FRAME_SIZE,0,0,cv::INTER_NEAREST);
         cv::imshow("oGlobalWordsCoverageMap",oGlobalWordsCoverageMap);
         printf("\nDBG[%2d,%2d] : \n",oDbgPt.x,oDbgPt.y);
@@ -1374,11 +1519,11 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
         printf("DBG_LDICT : (%lu occincr per match)\n",nDBGWordOccIncr);
         for(size_t nDBGWordIdx=0; nDBGWordIdx<m_nCurrLocalWords; ++nDBGWordIdx) {
             if(m_nImgChannels==1) {
-                LocalWord_1ch* pDBGLocalWord = (LocalWord_1ch*)m_vpLocalWordDict[nLocalDictDBGIdx+nDBGWordIdx];
+                LocalWord_1ch* pDBGLocalWord = GetWord(m_voLocalWordList_1ch,m_vnLocalWordDict[nLocalDictDBGIdx+nDBGWordIdx]);
                 printf("\t [%02lu] : weight=[%02.03f], nColor=[%03d], nDescBITS=[%02lu]  %s\n",nDBGWordIdx,GetLocalWordWeight(*pDBGLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset),(int)pDBGLocalWord->oFeature.anColor[0],DistanceUtils::popcount(pDBGLocalWord->oFeature.anDesc[0]),vsWordModList[nLocalDictDBGIdx+nDBGWordIdx].c_str());
             }
             else { //m_nImgChannels==3
-                LocalWord_3ch* pDBGLocalWord = (LocalWord_3ch*)m_vpLocalWordDict[nLocalDictDBGIdx+nDBGWordIdx];
+                LocalWord_3ch* pDBGLocalWord = GetWord(m_voLocalWordList_3ch,m_vnLocalWordDict[nLocalDictDBGIdx+nDBGWordIdx]);
                 printf("\t [%02lu] : weight=[%02.03f], anColor=[%03d,%03d,%03d], anDescBITS=[%02lu,%02lu,%02lu]  %s\n",nDBGWordIdx,GetLocalWordWeight(*pDBGLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset),(int)pDBGLocalWord->oFeature.anColor[0],(int)pDBGLocalWord->oFeature.anColor[1],(int)pDBGLocalWord->oFeature.anColor[2],DistanceUtils::popcount(pDBGLocalWord->oFeature.anDesc[0]),DistanceUtils::popcount(pDBGLocalWord->oFeature.anDesc[1]),DistanceUtils::popcount(pDBGLocalWord->oFeature.anDesc[2]),vsWordModList[nLocalDictDBGIdx+nDBGWordIdx].c_str());
             }
         }
@@ -1441,22 +1586,7 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
         cv::imshow("m_oIllumUpdtRegionMask",oIllumUpdtRegionMaskNormalized);
     }
 #endif //DISPLAY_PAWCS_DEBUG_INFO
-    cv::bitwise_xor(oCurrFGMask,m_oLastRawFGMask,m_oCurrRawFGBlinkMask);
-    cv::bitwise_or(m_oCurrRawFGBlinkMask,m_oLastRawFGBlinkMask,m_oBlinksFrame);
-    m_oCurrRawFGBlinkMask.copyTo(m_oLastRawFGBlinkMask);
-    oCurrFGMask.copyTo(m_oLastRawFGMask);
-    cv::morphologyEx(oCurrFGMask,m_oFGMask_PreFlood,cv::MORPH_CLOSE,m_oMorphExStructElement);
-    m_oFGMask_PreFlood.copyTo(m_oFGMask_FloodedHoles);
-    cv::floodFill(m_oFGMask_FloodedHoles,cv::Point(0,0),UCHAR_MAX);
-    cv::bitwise_not(m_oFGMask_FloodedHoles,m_oFGMask_FloodedHoles);
-    cv::erode(m_oFGMask_PreFlood,m_oFGMask_PreFlood,cv::Mat(),cv::Point(-1,-1),3);
-    cv::bitwise_or(oCurrFGMask,m_oFGMask_FloodedHoles,oCurrFGMask);
-    cv::bitwise_or(oCurrFGMask,m_oFGMask_PreFlood,oCurrFGMask);
-    cv::medianBlur(oCurrFGMask,m_oLastFGMask,m_nMedianBlurKernelSize);
-    cv::dilate(m_oLastFGMask,m_oLastFGMask_dilated,cv::Mat(),cv::Point(-1,-1),3);
-    cv::bitwise_and(m_oBlinksFrame,m_oLastFGMask_dilated_inverted,m_oBlinksFrame);
-    cv::bitwise_not(m_oLastFGMask_dilated,m_oLastFGMask_dilated_inverted);
-    cv::bitwise_and(m_oBlinksFrame,m_oLastFGMask_dilated_inverted,m_oBlinksFrame);
+    m_oPostProcessor.apply(oCurrFGMask,m_nMedianBlurKernelSize,m_oLastRawFGMask,m_oLastRawFGBlinkMask,m_oBlinksFrame,m_oLastFGMask,m_oLastFGMask_dilated,m_oLastFGMask_dilated_inverted);
     m_oLastFGMask.copyTo(oCurrFGMask);
     cv::addWeighted(m_oMeanFinalSegmResFrame_LT,(1.0f-fRollAvgFactor_LT),m_oLastFGMask,(1.0/UCHAR_MAX)*fRollAvgFactor_LT,0,m_oMeanFinalSegmResFrame_LT,CV_32F);
     cv::addWeighted(m_oMeanFinalSegmResFrame_ST,(1.0f-fRollAvgFactor_ST),m_oLastFGMask,(1.0/UCHAR_MAX)*fRollAvgFactor_ST,0,m_oMeanFinalSegmResFrame_ST,CV_32F);
@@ -1535,7 +1665,7 @@ void BackgroundSubtractorPAWCS::getBackgroundImage(cv::OutputArray backgroundIma
             float fTotWeight = 0.0f;
             float fTotColor = 0.0f;
             for(size_t nLocalWordIdx=0; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
-                const LocalWord_1ch& oCurrLocalWord = (LocalWord_1ch&)*m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx];
+                const LocalWord_1ch& oCurrLocalWord = *GetWord(m_voLocalWordList_1ch,m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx]);
                 float fCurrWeight = GetLocalWordWeight(oCurrLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
                 fTotColor += (float)oCurrLocalWord.oFeature.anColor[0]*fCurrWeight;
                 fTotWeight += fCurrWeight;
@@ -1546,7 +1676,7 @@ void BackgroundSubtractorPAWCS::getBackgroundImage(cv::OutputArray backgroundIma
             float fTotWeight = 0.0f;
             std::array<float,3> fTotColor = {0.0f,0.0f,0.0f};
             for(size_t nLocalWordIdx=0; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
-                const LocalWord_3ch& oCurrLocalWord = (LocalWord_3ch&)*m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx];
+                const LocalWord_3ch& oCurrLocalWord = *GetWord(m_voLocalWordList_3ch,m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx]);
                 float fCurrWeight = GetLocalWordWeight(oCurrLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
                 for(size_t c=0; c<3; ++c)
                     fTotColor[c] += (float)oCurrLocalWord.oFeature.anColor[c]*fCurrWeight;
@@ -1571,7 +1701,7 @@ void BackgroundSubtractorPAWCS::getBackgroundDescriptorsImage(cv::OutputArray ba
             float fTotWeight = 0.0f;
             float fTotDesc = 0.0f;
             for(size_t nLocalWordIdx=0; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
-                const LocalWord_1ch& oCurrLocalWord = (LocalWord_1ch&)*m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx];
+                const LocalWord_1ch& oCurrLocalWord = *GetWord(m_voLocalWordList_1ch,m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx]);
                 float fCurrWeight = GetLocalWordWeight(oCurrLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
                 fTotDesc += (float)oCurrLocalWord.oFeature.anDesc[0]*fCurrWeight;
                 fTotWeight += fCurrWeight;
@@ -1582,7 +1712,7 @@ void BackgroundSubtractorPAWCS::getBackgroundDescriptorsImage(cv::OutputArray ba
             float fTotWeight = 0.0f;
             std::array<float,3> fTotDesc = {0.0f,0.0f,0.0f};
             for(size_t nLocalWordIdx=0; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
-                const LocalWord_3ch& oCurrLocalWord = (LocalWord_3ch&)*m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx];
+                const LocalWord_3ch& oCurrLocalWord = *GetWord(m_voLocalWordList_3ch,m_vnLocalWordDict[nLocalDictIdx+nLocalWordIdx]);
                 float fCurrWeight = GetLocalWordWeight(oCurrLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
                 for(size_t c=0; c<3; ++c)
                     fTotDesc[c] += (float)oCurrLocalWord.oFeature.anDesc[c]*fCurrWeight;
@@ -1594,6 +1724,14 @@ void BackgroundSubtractorPAWCS::getBackgroundDescriptorsImage(cv::OutputArray ba
     oAvgBGDescImg.convertTo(backgroundDescImage,CV_16U);
 }
 
+size_t BackgroundSubtractorPAWCS::getWordArenaSize() const {
+    return m_voLocalWordList_1ch.capacity()*sizeof(LocalWord_1ch)+m_voLocalWordList_3ch.capacity()*sizeof(LocalWord_3ch)+
+           m_voGlobalWordList_1ch.capacity()*sizeof(GlobalWord_1ch)+m_voGlobalWordList_3ch.capacity()*sizeof(GlobalWord_3ch)+
+           m_oGlobalWordSpatioOccMaps.total()*m_oGlobalWordSpatioOccMaps.elemSize()+
+           (m_vnLocalWordDict.capacity()+m_vnGlobalWordDict.capacity()+m_vnGlobalWordSortLUT.capacity())*sizeof(WordHandle)+
+           m_vfLocalWordWeightCache.capacity()*sizeof(float)+m_vnLocalWordWeightCacheFrameIdx.capacity()*sizeof(size_t);
+}
+
 float BackgroundSubtractorPAWCS::GetLocalWordWeight(const LocalWordBase& w, size_t nCurrFrame, size_t nOffset) {
     return (float)(w.nOccurrences)/((w.nLastOcc-w.nFirstOcc)+(nCurrFrame-w.nLastOcc)*2+nOffset);
 }
@@ -27,13 +27,18 @@ BackgroundSubtractorPBAS::BackgroundSubtractorPBAS(size_t nInitColorDistThreshol
         m_nDefaultColorDistThreshold(nInitColorDistThreshold),
         m_fDefaultUpdateRate(fInitUpdateRate),
         m_fFormerMeanGradDist(20),
-        m_bInitialized(false) {
+        m_bInitialized(false),
+        m_nRandomSeed(0) {
     CV_Assert(m_nRequiredBGSamples<=m_nBGSamples);
     CV_Assert(m_fDefaultUpdateRate>0 && m_fDefaultUpdateRate<=UCHAR_MAX);
 }
 
 BackgroundSubtractorPBAS::~BackgroundSubtractorPBAS() {}
 
+void BackgroundSubtractorPBAS::setRandomSeed(uint64_t nSeed) {
+    m_nRandomSeed = nSeed;
+}
+
 void BackgroundSubtractorPBAS::getBackgroundImage(cv::OutputArray backgroundImage) const {
     CV_Assert(m_bInitialized);
     cv::Mat oAvgBGImg = cv::Mat::zeros(m_oImgSize,CV_32FC(m_voBGImg[0].channels()));
@@ -63,6 +68,7 @@ void BackgroundSubtractorPBAS_1ch::initialize(const cv::Mat& oInitImg) {
     CV_Assert(oInitImg.isContinuous());
     CV_Assert(oInitImg.type()==CV_8UC1);
     m_oImgSize = oInitImg.size();
+    m_oRNG.seed(m_nRandomSeed);
     m_oDistThresholdFrame.create(m_oImgSize,CV_32FC1);
     m_oDistThresholdFrame = cv::Scalar(1.0f);
 #if BGSPBAS_USE_R2_ACCELERATION
@@ -97,7 +103,7 @@ void BackgroundSubtractorPBAS_1ch::initialize(const cv::Mat& oInitImg) {
         for(int y=0; y<m_oImgSize.height; ++y) {
             for(int x=0; x<m_oImgSize.width; ++x) {
                 int x_sample,y_sample;
-                cv::getRandSamplePosition_7x7_std2(x_sample,y_sample,x,y,0,m_oImgSize);
+                cv::getRandSamplePosition_7x7_std2(x_sample,y_sample,x,y,0,m_oImgSize,m_oRNG);
                 m_voBGImg[s].at<uchar>(y,x) = oInitImg.at<uchar>(y_sample,x_sample);
                 m_voBGGrad[s].at<uchar>(y,x) = oBlurredInitImg_AbsGrad.at<uchar>(y_sample,x_sample);
             }
@@ -172,15 +178,15 @@ void BackgroundSubtractorPBAS_1ch::apply(cv::InputArray _image, cv::OutputArray
             }
             else {
                 const size_t nLearningRate = learningRateOverride>0?(size_t)ceil(learningRateOverride):(size_t)ceil((*pfCurrLearningRate));
-                if((rand()%nLearningRate)==0) {
-                    const size_t s_rand = rand()%m_nBGSamples;
+                if((m_oRNG()%nLearningRate)==0) {
+                    const size_t s_rand = m_oRNG()%m_nBGSamples;
                     m_voBGImg[s_rand].data[idx_uchar] = oInputImg.data[idx_uchar];
                     m_voBGGrad[s_rand].data[idx_uchar] = oBlurredInputImg_AbsGrad.data[idx_uchar];
                 }
-                if((rand()%nLearningRate)==0) {
+                if((m_oRNG()%nLearningRate)==0) {
                     int x_rand,y_rand;
-                    cv::getRandNeighborPosition_3x3(x_rand,y_rand,x,y,0,m_oImgSize);
-                    const size_t s_rand = rand()%m_nBGSamples;
+                    cv::getRandNeighborPosition_3x3(x_rand,y_rand,x,y,0,m_oImgSize,m_oRNG);
+                    const size_t s_rand = m_oRNG()%m_nBGSamples;
 #if BGSPBAS_USE_SELF_DIFFUSION
                     m_voBGImg[s_rand].at<uchar>(y_rand,x_rand) = oInputImg.at<uchar>(y_rand,x_rand);
                     m_voBGGrad[s_rand].at<uchar>(y_rand,x_rand) = oBlurredInputImg_AbsGrad.at<uchar>(y_rand,x_rand);
@@ -282,6 +288,7 @@ void BackgroundSubtractorPBAS_3ch::initialize(const cv::Mat& oInitImg) {
     else
         cv::cvtColor(oInitImg,oInitImgRGB,cv::COLOR_GRAY2BGR);
     m_oImgSize = oInitImgRGB.size();
+    m_oRNG.seed(m_nRandomSeed);
     m_oDistThresholdFrame.create(m_oImgSize,CV_32FC1);
     m_oDistThresholdFrame = cv::Scalar(1.0f);
 #if BGSPBAS_USE_R2_ACCELERATION
@@ -316,7 +323,7 @@ void BackgroundSubtractorPBAS_3ch::initialize(const cv::Mat& oInitImg) {
         for(int y=0; y<m_oImgSize.height; ++y) {
             for(int x=0; x<m_oImgSize.width; ++x) {
                 int x_sample,y_sample;
-                cv::getRandSamplePosition_7x7_std2(x_sample,y_sample,x,y,0,m_oImgSize);
+                cv::getRandSamplePosition_7x7_std2(x_sample,y_sample,x,y,0,m_oImgSize,m_oRNG);
                 m_voBGImg[s].at<cv::Vec3b>(y,x) = oInitImgRGB.at<cv::Vec3b>(y_sample,x_sample);
                 m_voBGGrad[s].at<cv::Vec3b>(y,x) = oBlurredInitImg_AbsGrad.at<cv::Vec3b>(y_sample,x_sample);
             }
@@ -400,15 +407,15 @@ void BackgroundSubtractorPBAS_3ch::apply(cv::InputArray _image, cv::OutputArray
             }
             else {
                 const size_t nLearningRate = learningRateOverride>0?(size_t)ceil(learningRateOverride):(size_t)ceil((*pfCurrLearningRate));
-                if((rand()%nLearningRate)==0) {
-                    const size_t s_rand = rand()%m_nBGSamples;
+                if((m_oRNG()%nLearningRate)==0) {
+                    const size_t s_rand = m_oRNG()%m_nBGSamples;
                     m_voBGImg[s_rand].at<cv::Vec3b>(y,x) = oInputImgRGB.at<cv::Vec3b>(y,x);
                     m_voBGGrad[s_rand].at<cv::Vec3b>(y,x) = oBlurredInputImg_AbsGrad.at<cv::Vec3b>(y,x);
                 }
-                if((rand()%nLearningRate)==0) {
+                if((m_oRNG()%nLearningRate)==0) {
                     int x_rand,y_rand;
-                    cv::getRandNeighborPosition_3x3(x_rand,y_rand,x,y,0,m_oImgSize);
-                    const size_t s_rand = rand()%m_nBGSamples;
+                    cv::getRandNeighborPosition_3x3(x_rand,y_rand,x,y,0,m_oImgSize,m_oRNG);
+                    const size_t s_rand = m_oRNG()%m_nBGSamples;
 #if BGSPBAS_USE_SELF_DIFFUSION
                     m_voBGImg[s_rand].at<cv::Vec3b>(y_rand,x_rand) = oInputImgRGB.at<cv::Vec3b>(y_rand,x_rand);
                     m_voBGGrad[s_rand].at<cv::Vec3b>(y_rand,x_rand) = oBlurredInputImg_AbsGrad.at<cv::Vec3b>(y_rand,x_rand);
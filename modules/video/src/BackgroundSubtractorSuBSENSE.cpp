@@ -59,6 +59,124 @@ static const size_t s_nDescMaxDataRange_1ch = LBSP::DESC_SIZE_BITS;
 static const size_t s_nColorMaxDataRange_3ch = s_nColorMaxDataRange_1ch*3;
 static const size_t s_nDescMaxDataRange_3ch = s_nDescMaxDataRange_1ch*3;
 
+// local define used to compile the AVX2 sample matcher (selected at runtime, see ParallelUtils::getSIMDLevel)
+#if HAVE_SIMD_DISPATCH
+#define USE_AVX2_SAMPLE_MATCHER 1
+#define AVX2_TARGET_ATTRIB SIMD_TARGET_ATTRIB("avx2")
+#else //(!HAVE_SIMD_DISPATCH)
+#define USE_AVX2_SAMPLE_MATCHER 0
+#endif //(!HAVE_SIMD_DISPATCH)
+
+static bool isAVX2SampleMatcherSupported() {
+#if USE_AVX2_SAMPLE_MATCHER
+    static const bool s_bSupported = ParallelUtils::getSIMDLevel()>=ParallelUtils::eSIMD_AVX2;
+#else //(!USE_AVX2_SAMPLE_MATCHER)
+    static const bool s_bSupported = false;
+#endif //(!USE_AVX2_SAMPLE_MATCHER)
+    return s_bSupported;
+}
+
+#if USE_AVX2_SAMPLE_MATCHER
+
+// returns the bit count of each of the 16 packed 16-bit values (nibble lookup, no popcnt needed)
+AVX2_TARGET_ATTRIB static inline __m256i popcount_16ui_AVX2(const __m256i& _anVals) {
+    const __m256i _anNibbleLUT = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+    const __m256i _anLowNibbleMask = _mm256_set1_epi8(0x0F);
+    const __m256i _anByteCounts = _mm256_add_epi8(_mm256_shuffle_epi8(_anNibbleLUT,_mm256_and_si256(_anVals,_anLowNibbleMask)),
+                                                  _mm256_shuffle_epi8(_anNibbleLUT,_mm256_and_si256(_mm256_srli_epi16(_anVals,4),_anLowNibbleMask)));
+    return _mm256_add_epi16(_mm256_and_si256(_anByteCounts,_mm256_set1_epi16(0x00FF)),_mm256_srli_epi16(_anByteCounts,8));
+}
+
+// matches the current pixel against its background samples 16 at a time (same results as the scalar loops in apply_internal_*)
+// note: the 'SC' thresholds are checked for each channel, and the 'Tot' thresholds for the sum of all channels; returns the number of samples scanned
+template<size_t nChannels>
+AVX2_TARGET_ATTRIB static size_t matchSamples_AVX2(const BackgroundSampleModel& oModel, size_t nPxIter, size_t nRequiredBGSamples,
+                                                   const uchar* anCurrColor, const ushort* anCurrIntraDesc, const uchar* aanLBSPLookupVals, const uchar* anLBSPThresholdLUT,
+                                                   size_t nSCColorDistThreshold, size_t nSCDescDistThreshold, size_t nTotColorDistThreshold, size_t nTotDescDistThreshold,
+                                                   size_t& nGoodSamplesCount, size_t& nMinTotDescDist, size_t& nMinTotSumDist) {
+    static_assert(nChannels==1 || nChannels==3,"matcher only supports 1-ch and 3-ch models");
+    static_assert(LBSP::DESC_SIZE_BITS==16,"matcher expects 16-bit LBSP descriptors");
+    CV_DbgAssert(oModel.getChannelCount()==nChannels);
+    const size_t nBGSamples = oModel.getSampleCount();
+    const size_t nColorSampleStep = oModel.getColorSampleStep();
+    const size_t nDescSampleStep = oModel.getDescSampleStep();
+    const bool bContiguousSamples = nColorSampleStep==1 && nDescSampleStep==1;
+    const __m256i _anLaneIdxs = _mm256_setr_epi16(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+    const __m256i _anMaxColorDist = _mm256_set1_epi16((short)s_nColorMaxDataRange_1ch);
+    const __m256i _anDescToColorScale = _mm256_set1_epi16((short)(s_nColorMaxDataRange_1ch/s_nDescMaxDataRange_1ch));
+    const __m256i _anSCColorDistThreshold = _mm256_set1_epi16((short)std::min(nSCColorDistThreshold,(size_t)SHRT_MAX));
+    const __m256i _anSCDescDistThreshold = _mm256_set1_epi16((short)std::min(nSCDescDistThreshold,(size_t)SHRT_MAX));
+    const __m256i _anTotColorDistThreshold = _mm256_set1_epi16((short)std::min(nTotColorDistThreshold,(size_t)SHRT_MAX));
+    const __m256i _anTotDescDistThreshold = _mm256_set1_epi16((short)std::min(nTotDescDistThreshold,(size_t)SHRT_MAX));
+    alignas(32) std::array<uchar,16> anBGColorBuffer{};
+    alignas(32) std::array<ushort,16> anBGDescBuffer{};
+    alignas(32) std::array<ushort,16> anLBSPThresholds;
+    alignas(32) std::array<ushort,16> anTotDescDists, anTotSumDists;
+    size_t nSampleIdx = 0;
+    while(nGoodSamplesCount<nRequiredBGSamples && nSampleIdx<nBGSamples) {
+        const size_t nValidLanes = std::min(nBGSamples-nSampleIdx,size_t(16));
+        __m256i _abMatches = _mm256_cmpgt_epi16(_mm256_set1_epi16((short)nValidLanes),_anLaneIdxs);
+        __m256i _anTotDescDist = _mm256_setzero_si256();
+        __m256i _anTotSumDist = _mm256_setzero_si256();
+        for(size_t c=0; c<nChannels; ++c) {
+            const uchar* anBGColors = oModel.getColorPtr(nPxIter,c)+nSampleIdx*nColorSampleStep;
+            const ushort* anBGDescs = oModel.getDescPtr(nPxIter,c)+nSampleIdx*nDescSampleStep;
+            if(!bContiguousSamples || nValidLanes<16) {
+                for(size_t n=0; n<nValidLanes; ++n) {
+                    anBGColorBuffer[n] = anBGColors[n*nColorSampleStep];
+                    anBGDescBuffer[n] = anBGDescs[n*nDescSampleStep];
+                }
+                anBGColors = anBGColorBuffer.data();
+                anBGDescs = anBGDescBuffer.data();
+            }
+            for(size_t n=0; n<16; ++n)
+                anLBSPThresholds[n] = anLBSPThresholdLUT[anBGColors[n]];
+            const __m256i _anBGColors = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)anBGColors));
+            const __m256i _anBGDescs = _mm256_loadu_si256((const __m256i*)anBGDescs);
+            const __m256i _anLBSPThresholds = _mm256_load_si256((const __m256i*)anLBSPThresholds.data());
+            const __m256i _anColorDist = _mm256_abs_epi16(_mm256_sub_epi16(_mm256_set1_epi16((short)anCurrColor[c]),_anBGColors));
+            const __m256i _anIntraDescDist = popcount_16ui_AVX2(_mm256_xor_si256(_mm256_set1_epi16((short)anCurrIntraDesc[c]),_anBGDescs));
+            // inter-descriptors: current LBSP lookup values thresholded w/ each sample's color as reference (see LBSP::computeDescriptor_threshold)
+            const uchar* anLBSPLookupVals = aanLBSPLookupVals+c*LBSP::DESC_SIZE_BITS;
+            __m256i _anCurrInterDescs = _mm256_setzero_si256();
+            for(size_t n=0; n<LBSP::DESC_SIZE_BITS; ++n) {
+                const __m256i _anLookupDist = _mm256_abs_epi16(_mm256_sub_epi16(_mm256_set1_epi16((short)anLBSPLookupVals[n]),_anBGColors));
+                _anCurrInterDescs = _mm256_or_si256(_anCurrInterDescs,_mm256_and_si256(_mm256_cmpgt_epi16(_anLookupDist,_anLBSPThresholds),_mm256_set1_epi16((short)(1<<n))));
+            }
+            const __m256i _anInterDescDist = popcount_16ui_AVX2(_mm256_xor_si256(_anCurrInterDescs,_anBGDescs));
+            const __m256i _anDescDist = _mm256_srli_epi16(_mm256_add_epi16(_anIntraDescDist,_anInterDescDist),1);
+            const __m256i _anScaledDescDist = _mm256_mullo_epi16((nChannels==1)?_mm256_srli_epi16(_anDescDist,2):_mm256_srli_epi16(_anDescDist,1),_anDescToColorScale);
+            const __m256i _anSumDist = _mm256_min_epi16(_mm256_add_epi16(_anScaledDescDist,_anColorDist),_anMaxColorDist);
+            _abMatches = _mm256_andnot_si256(_mm256_cmpgt_epi16(_anColorDist,_anSCColorDistThreshold),_abMatches);
+            _abMatches = _mm256_andnot_si256(_mm256_cmpgt_epi16(_anDescDist,_anSCDescDistThreshold),_abMatches);
+            _abMatches = _mm256_andnot_si256(_mm256_cmpgt_epi16(_anSumDist,_anSCColorDistThreshold),_abMatches);
+            _anTotDescDist = _mm256_add_epi16(_anTotDescDist,_anDescDist);
+            _anTotSumDist = _mm256_add_epi16(_anTotSumDist,_anSumDist);
+        }
+        _abMatches = _mm256_andnot_si256(_mm256_cmpgt_epi16(_anTotDescDist,_anTotDescDistThreshold),_abMatches);
+        _abMatches = _mm256_andnot_si256(_mm256_cmpgt_epi16(_anTotSumDist,_anTotColorDistThreshold),_abMatches);
+        const uint nMatchMask = (uint)_mm256_movemask_epi8(_abMatches);
+        if(nMatchMask) {
+            _mm256_store_si256((__m256i*)anTotDescDists.data(),_anTotDescDist);
+            _mm256_store_si256((__m256i*)anTotSumDists.data(),_anTotSumDist);
+            // matches are consumed in sample order to mimic the early exit of the scalar loops
+            for(size_t n=0; n<nValidLanes && nGoodSamplesCount<nRequiredBGSamples; ++n) {
+                if(nMatchMask&(1u<<(n*2))) {
+                    if(nMinTotDescDist>anTotDescDists[n])
+                        nMinTotDescDist = anTotDescDists[n];
+                    if(nMinTotSumDist>anTotSumDists[n])
+                        nMinTotSumDist = anTotSumDists[n];
+                    ++nGoodSamplesCount;
+                }
+            }
+        }
+        nSampleIdx += nValidLanes;
+    }
+    return nSampleIdx;
+}
+
+#endif //USE_AVX2_SAMPLE_MATCHER
+
 BackgroundSubtractorSuBSENSE::BackgroundSubtractorSuBSENSE_(size_t nDescDistThresholdOffset, size_t nMinColorDistThreshold, size_t nBGSamples,
                                                             size_t nRequiredBGSamples, size_t nSamplesForMovingAvgs, float fRelLBSPThreshold) :
         IBackgroundSubtractorLBSP(fRelLBSPThreshold),
@@ -72,7 +190,9 @@ BackgroundSubtractorSuBSENSE::BackgroundSubtractorSuBSENSE_(size_t nDescDistThre
         m_fCurrLearningRateLowerCap(FEEDBACK_T_LOWER),
         m_fCurrLearningRateUpperCap(FEEDBACK_T_UPPER),
         m_nMedianBlurKernelSize(m_nDefaultMedianBlurKernelSize),
-        m_bUse3x3Spread(true) {
+        m_bUse3x3Spread(true),
+        m_nTileRows(0),
+        m_bUsingVectorizedMatcher(isAVX2SampleMatcherSupported()) {
     CV_Assert(m_nBGSamples>0 && m_nRequiredBGSamples<=m_nBGSamples);
     CV_Assert(m_nMinColorDistThreshold>=STAB_COLOR_DIST_OFFSET);
 }
@@ -80,23 +200,23 @@ BackgroundSubtractorSuBSENSE::BackgroundSubtractorSuBSENSE_(size_t nDescDistThre
 void BackgroundSubtractorSuBSENSE::refreshModel(float fSamplesRefreshFrac, bool bForceFGUpdate) {
     // == refresh
     CV_Assert(m_bInitialized);
-    CV_Assert(!m_voBGColorSamples.empty() && !m_voBGColorSamples[0].empty());
+    CV_Assert(!m_oBGSamples.empty());
     CV_Assert(fSamplesRefreshFrac>0.0f && fSamplesRefreshFrac<=1.0f);
     const size_t nModelSamplesToRefresh = fSamplesRefreshFrac<1.0f?(size_t)(fSamplesRefreshFrac*m_nBGSamples):m_nBGSamples;
-    const size_t nRefreshSampleStartPos = fSamplesRefreshFrac<1.0f?rand()%m_nBGSamples:0;
-    const size_t nChannels = m_voBGColorSamples[0].channels();
+    const size_t nRefreshSampleStartPos = fSamplesRefreshFrac<1.0f?m_oRNG()%m_nBGSamples:0;
+    const size_t nChannels = m_oBGSamples.getChannelCount();
     for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
         const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
         if(bForceFGUpdate || !m_oLastFGMask.data[nPxIter]) {
             for(size_t nCurrModelSampleIdx=nRefreshSampleStartPos; nCurrModelSampleIdx<nRefreshSampleStartPos+nModelSamplesToRefresh; ++nCurrModelSampleIdx) {
                 int nSampleImgCoord_Y, nSampleImgCoord_X;
-                cv::getRandSamplePosition_7x7_std2(nSampleImgCoord_X,nSampleImgCoord_Y,m_voPxInfoLUT[nPxIter].nImgCoord_X,m_voPxInfoLUT[nPxIter].nImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
+                cv::getRandSamplePosition_7x7_std2(nSampleImgCoord_X,nSampleImgCoord_Y,m_voPxInfoLUT[nPxIter].nImgCoord_X,m_voPxInfoLUT[nPxIter].nImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,m_oRNG);
                 const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
                 if(bForceFGUpdate || !m_oLastFGMask.data[nSamplePxIdx]) {
                     const size_t nCurrRealModelSampleIdx = nCurrModelSampleIdx%m_nBGSamples;
                     for(size_t c=0; c<nChannels; ++c) {
-                        m_voBGColorSamples[nCurrRealModelSampleIdx].data[nPxIter*nChannels+c] = m_oLastColorFrame.data[nSamplePxIdx*nChannels+c];
-                        *((ushort*)(m_voBGDescSamples[nCurrRealModelSampleIdx].data+(nPxIter*nChannels+c)*2)) = *((ushort*)(m_oLastDescFrame.data+(nSamplePxIdx*nChannels+c)*2));
+                        m_oBGSamples.getColor(nCurrRealModelSampleIdx,nPxIter,c) = m_oLastColorFrame.data[nSamplePxIdx*nChannels+c];
+                        m_oBGSamples.getDesc(nCurrRealModelSampleIdx,nPxIter,c) = *((ushort*)(m_oLastDescFrame.data+(nSamplePxIdx*nChannels+c)*2));
                     }
                 }
             }
@@ -163,323 +283,420 @@ void BackgroundSubtractorSuBSENSE::initialize(const cv::Mat& oInitImg, const cv:
     m_oLastFGMask_dilated = cv::Scalar_<uchar>(0);
     m_oLastFGMask_dilated_inverted.create(m_oImgSize,CV_8UC1);
     m_oLastFGMask_dilated_inverted = cv::Scalar_<uchar>(0);
-    m_oFGMask_FloodedHoles.create(m_oImgSize,CV_8UC1);
-    m_oFGMask_FloodedHoles = cv::Scalar_<uchar>(0);
-    m_oFGMask_PreFlood.create(m_oImgSize,CV_8UC1);
-    m_oFGMask_PreFlood = cv::Scalar_<uchar>(0);
-    m_oCurrRawFGBlinkMask.create(m_oImgSize,CV_8UC1);
-    m_oCurrRawFGBlinkMask = cv::Scalar_<uchar>(0);
     m_oLastRawFGBlinkMask.create(m_oImgSize,CV_8UC1);
     m_oLastRawFGBlinkMask = cv::Scalar_<uchar>(0);
-    m_oMorphExStructElement = cv::getStructuringElement(cv::MORPH_RECT,cv::Size(3,3));
-    m_voBGColorSamples.resize(m_nBGSamples);
-    m_voBGDescSamples.resize(m_nBGSamples);
-    for(size_t s=0; s<m_nBGSamples; ++s) {
-        m_voBGColorSamples[s].create(m_oImgSize,CV_8UC((int)m_nImgChannels));
-        m_voBGColorSamples[s] = cv::Scalar_<uchar>::all(0);
-        m_voBGDescSamples[s].create(m_oImgSize,CV_16UC((int)m_nImgChannels));
-        m_voBGDescSamples[s] = cv::Scalar_<ushort>::all(0);
-    }
+    m_oPostProcessor.initialize(m_oImgSize);
+    m_oBGSamples.initialize(m_oImgSize,m_nImgChannels,m_nBGSamples);
+    initialize_tiles();
     m_bInitialized = true;
     refreshModel(1.0f);
     m_bModelInitialized = true;
 }
 
-void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray _fgmask, double learningRateOverride) {
-    // == process
-    CV_Assert(m_bInitialized && m_bModelInitialized);
-    cv::Mat oInputImg = _image.getMat();
-    CV_Assert(oInputImg.type()==m_nImgType && oInputImg.size()==m_oImgSize);
-    CV_Assert(oInputImg.isContinuous());
-    _fgmask.create(m_oImgSize,CV_8UC1);
-    cv::Mat oCurrFGMask = _fgmask.getMat();
-    memset(oCurrFGMask.data,0,oCurrFGMask.cols*oCurrFGMask.rows);
-    size_t nNonZeroDescCount = 0;
-    const float fRollAvgFactor_LT = 1.0f/std::min(++m_nFrameIdx,m_nSamplesForMovingAvgs);
-    const float fRollAvgFactor_ST = 1.0f/std::min(m_nFrameIdx,m_nSamplesForMovingAvgs/4);
-    if(m_nImgChannels==1) {
-        for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
-            const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
-            const size_t nDescIter = nPxIter*2;
-            const size_t nFloatIter = nPxIter*4;
-            const int nCurrImgCoord_X = m_voPxInfoLUT[nPxIter].nImgCoord_X;
-            const int nCurrImgCoord_Y = m_voPxInfoLUT[nPxIter].nImgCoord_Y;
-            const uchar nCurrColor = oInputImg.data[nPxIter];
-            size_t nMinDescDist = s_nDescMaxDataRange_1ch;
-            size_t nMinSumDist = s_nColorMaxDataRange_1ch;
-            float* pfCurrDistThresholdFactor = (float*)(m_oDistThresholdFrame.data+nFloatIter);
-            float* pfCurrVariationFactor = (float*)(m_oVariationModulatorFrame.data+nFloatIter);
-            float* pfCurrLearningRate = ((float*)(m_oUpdateRateFrame.data+nFloatIter));
-            float* pfCurrMeanLastDist = ((float*)(m_oMeanLastDistFrame.data+nFloatIter));
-            float* pfCurrMeanMinDist_LT = ((float*)(m_oMeanMinDistFrame_LT.data+nFloatIter));
-            float* pfCurrMeanMinDist_ST = ((float*)(m_oMeanMinDistFrame_ST.data+nFloatIter));
-            float* pfCurrMeanRawSegmRes_LT = ((float*)(m_oMeanRawSegmResFrame_LT.data+nFloatIter));
-            float* pfCurrMeanRawSegmRes_ST = ((float*)(m_oMeanRawSegmResFrame_ST.data+nFloatIter));
-            float* pfCurrMeanFinalSegmRes_LT = ((float*)(m_oMeanFinalSegmResFrame_LT.data+nFloatIter));
-            float* pfCurrMeanFinalSegmRes_ST = ((float*)(m_oMeanFinalSegmResFrame_ST.data+nFloatIter));
-            ushort& nLastIntraDesc = *((ushort*)(m_oLastDescFrame.data+nDescIter));
-            uchar& nLastColor = m_oLastColorFrame.data[nPxIter];
-            const size_t nCurrColorDistThreshold = (size_t)(((*pfCurrDistThresholdFactor)*m_nMinColorDistThreshold)-((!m_oUnstableRegionMask.data[nPxIter])*STAB_COLOR_DIST_OFFSET))/2;
-            const size_t nCurrDescDistThreshold = ((size_t)1<<((size_t)floor(*pfCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(m_oUnstableRegionMask.data[nPxIter]*UNSTAB_DESC_DIST_OFFSET);
-            alignas(16) std::array<uchar,LBSP::DESC_SIZE_BITS> anLBSPLookupVals;
-            LBSP::computeDescriptor_lookup<1>(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,0,anLBSPLookupVals);
-            const ushort nCurrIntraDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
-            m_oUnstableRegionMask.data[nPxIter] = ((*pfCurrDistThresholdFactor)>UNSTABLE_REG_RDIST_MIN || (*pfCurrMeanRawSegmRes_LT-*pfCurrMeanFinalSegmRes_LT)>UNSTABLE_REG_RATIO_MIN || (*pfCurrMeanRawSegmRes_ST-*pfCurrMeanFinalSegmRes_ST)>UNSTABLE_REG_RATIO_MIN)?1:0;
-            size_t nGoodSamplesCount=0, nSampleIdx=0;
-            while(nGoodSamplesCount<m_nRequiredBGSamples && nSampleIdx<m_nBGSamples) {
-                const uchar& nBGColor = m_voBGColorSamples[nSampleIdx].data[nPxIter];
-                {
-                    const size_t nColorDist = DistanceUtils::L1dist(nCurrColor,nBGColor);
-                    if(nColorDist>nCurrColorDistThreshold)
-                        goto failedcheck1ch;
-                    const ushort& nBGIntraDesc = *((ushort*)(m_voBGDescSamples[nSampleIdx].data+nDescIter));
-                    const size_t nIntraDescDist = DistanceUtils::hdist(nCurrIntraDesc,nBGIntraDesc);
-                    const ushort nCurrInterDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nBGColor,m_anLBSPThreshold_8bitLUT[nBGColor]);
-                    const size_t nInterDescDist = DistanceUtils::hdist(nCurrInterDesc,nBGIntraDesc);
-                    const size_t nDescDist = (nIntraDescDist+nInterDescDist)/2;
-                    if(nDescDist>nCurrDescDistThreshold)
-                        goto failedcheck1ch;
-                    const size_t nSumDist = std::min((nDescDist/4)*(s_nColorMaxDataRange_1ch/s_nDescMaxDataRange_1ch)+nColorDist,s_nColorMaxDataRange_1ch);
-                    if(nSumDist>nCurrColorDistThreshold)
-                        goto failedcheck1ch;
-                    if(nMinDescDist>nDescDist)
-                        nMinDescDist = nDescDist;
-                    if(nMinSumDist>nSumDist)
-                        nMinSumDist = nSumDist;
-                    nGoodSamplesCount++;
-                }
-                failedcheck1ch:
-                nSampleIdx++;
+void BackgroundSubtractorSuBSENSE::initialize_tiles() {
+    const int nTileRows = (m_nTileRows==0 || m_nTileRows>(size_t)m_oImgSize.height)?m_oImgSize.height:(int)m_nTileRows;
+    const size_t nTileCount = (size_t)((m_oImgSize.height+nTileRows-1)/nTileRows);
+    m_voTiles.resize(nTileCount);
+    size_t nModelIter = 0;
+    for(size_t nTileIdx=0; nTileIdx<nTileCount; ++nTileIdx) {
+        TileInfo& oTile = m_voTiles[nTileIdx];
+        oTile.nRowBegin = (int)nTileIdx*nTileRows;
+        oTile.nRowEnd = std::min(oTile.nRowBegin+nTileRows,m_oImgSize.height);
+        oTile.nModelIterBegin = nModelIter;
+        while(nModelIter<m_nTotRelevantPxCount && m_voPxInfoLUT[m_vnPxIdxLUT[nModelIter]].nImgCoord_Y<oTile.nRowEnd)
+            ++nModelIter;
+        oTile.nModelIterEnd = nModelIter;
+        oTile.nNonZeroDescCount = 0;
+        oTile.oRNG.seed(CxxUtils::FastRNG::getSubSeed(m_nRandomSeed,nTileIdx));
+        oTile.voDeferredUpdates.clear();
+        if(nTileCount>1) // spread updates can reach at most (PATCH_SIZE/2) rows away from the tile borders
+            oTile.voDeferredUpdates.reserve((LBSP::PATCH_SIZE/2)*2*(size_t)m_oImgSize.width);
+    }
+    CV_Assert(nModelIter==m_nTotRelevantPxCount);
+}
+
+void BackgroundSubtractorSuBSENSE::setSampleModelLayout(eSampleModelLayout eLayout) {
+    m_oBGSamples.setLayout(eLayout);
+}
+
+void BackgroundSubtractorSuBSENSE::setParallelTiling(size_t nTileRows, size_t nWorkers) {
+    CV_Assert(nWorkers>0);
+    m_nTileRows = nTileRows;
+    if(nWorkers==1)
+        m_pWorkerPool.reset();
+    else if(!m_pWorkerPool || m_pWorkerPool->getWorkerCount()!=nWorkers)
+        m_pWorkerPool = std::make_unique<PlatformUtils::DynamicWorkerPool>(nWorkers);
+    if(m_bInitialized)
+        initialize_tiles();
+}
+
+void BackgroundSubtractorSuBSENSE::setVectorizedMatching(bool bEnabled) {
+    m_bUsingVectorizedMatcher = bEnabled && isAVX2SampleMatcherSupported();
+}
+
+void BackgroundSubtractorSuBSENSE::apply_internal_1ch(const cv::Mat& oInputImg, cv::Mat& oCurrFGMask, TileInfo& oTile, double learningRateOverride, float fRollAvgFactor_LT, float fRollAvgFactor_ST) {
+    for(size_t nModelIter=oTile.nModelIterBegin; nModelIter<oTile.nModelIterEnd; ++nModelIter) {
+        const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
+        const size_t nDescIter = nPxIter*2;
+        const size_t nFloatIter = nPxIter*4;
+        const int nCurrImgCoord_X = m_voPxInfoLUT[nPxIter].nImgCoord_X;
+        const int nCurrImgCoord_Y = m_voPxInfoLUT[nPxIter].nImgCoord_Y;
+        const uchar nCurrColor = oInputImg.data[nPxIter];
+        size_t nMinDescDist = s_nDescMaxDataRange_1ch;
+        size_t nMinSumDist = s_nColorMaxDataRange_1ch;
+        float* pfCurrDistThresholdFactor = (float*)(m_oDistThresholdFrame.data+nFloatIter);
+        float* pfCurrVariationFactor = (float*)(m_oVariationModulatorFrame.data+nFloatIter);
+        float* pfCurrLearningRate = ((float*)(m_oUpdateRateFrame.data+nFloatIter));
+        float* pfCurrMeanLastDist = ((float*)(m_oMeanLastDistFrame.data+nFloatIter));
+        float* pfCurrMeanMinDist_LT = ((float*)(m_oMeanMinDistFrame_LT.data+nFloatIter));
+        float* pfCurrMeanMinDist_ST = ((float*)(m_oMeanMinDistFrame_ST.data+nFloatIter));
+        float* pfCurrMeanRawSegmRes_LT = ((float*)(m_oMeanRawSegmResFrame_LT.data+nFloatIter));
+        float* pfCurrMeanRawSegmRes_ST = ((float*)(m_oMeanRawSegmResFrame_ST.data+nFloatIter));
+        float* pfCurrMeanFinalSegmRes_LT = ((float*)(m_oMeanFinalSegmResFrame_LT.data+nFloatIter));
+        float* pfCurrMeanFinalSegmRes_ST = ((float*)(m_oMeanFinalSegmResFrame_ST.data+nFloatIter));
+        ushort& nLastIntraDesc = *((ushort*)(m_oLastDescFrame.data+nDescIter));
+        uchar& nLastColor = m_oLastColorFrame.data[nPxIter];
+        const size_t nCurrColorDistThreshold = (size_t)(((*pfCurrDistThresholdFactor)*m_nMinColorDistThreshold)-((!m_oUnstableRegionMask.data[nPxIter])*STAB_COLOR_DIST_OFFSET))/2;
+        const size_t nCurrDescDistThreshold = ((size_t)1<<((size_t)floor(*pfCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(m_oUnstableRegionMask.data[nPxIter]*UNSTAB_DESC_DIST_OFFSET);
+        alignas(16) std::array<uchar,LBSP::DESC_SIZE_BITS> anLBSPLookupVals;
+        LBSP::computeDescriptor_lookup<1>(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,0,anLBSPLookupVals);
+        const ushort nCurrIntraDesc = m_pCurrDescFrame?((const ushort*)m_pCurrDescFrame->data)[nPxIter]:LBSP::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
+        m_oUnstableRegionMask.data[nPxIter] = ((*pfCurrDistThresholdFactor)>UNSTABLE_REG_RDIST_MIN || (*pfCurrMeanRawSegmRes_LT-*pfCurrMeanFinalSegmRes_LT)>UNSTABLE_REG_RATIO_MIN || (*pfCurrMeanRawSegmRes_ST-*pfCurrMeanFinalSegmRes_ST)>UNSTABLE_REG_RATIO_MIN)?1:0;
+        size_t nGoodSamplesCount=0, nSampleIdx=0;
+#if USE_AVX2_SAMPLE_MATCHER
+        if(m_bUsingVectorizedMatcher)
+            nSampleIdx = matchSamples_AVX2<1>(m_oBGSamples,nPxIter,m_nRequiredBGSamples,&nCurrColor,&nCurrIntraDesc,anLBSPLookupVals.data(),m_anLBSPThreshold_8bitLUT.data(),
+                                              nCurrColorDistThreshold,nCurrDescDistThreshold,nCurrColorDistThreshold,nCurrDescDistThreshold,
+                                              nGoodSamplesCount,nMinDescDist,nMinSumDist);
+#endif //USE_AVX2_SAMPLE_MATCHER
+        while(nGoodSamplesCount<m_nRequiredBGSamples && nSampleIdx<m_nBGSamples) {
+            const uchar nBGColor = m_oBGSamples.getColor(nSampleIdx,nPxIter);
+            {
+                const size_t nColorDist = DistanceUtils::L1dist(nCurrColor,nBGColor);
+                if(nColorDist>nCurrColorDistThreshold)
+                    goto failedcheck1ch;
+                const ushort nBGIntraDesc = m_oBGSamples.getDesc(nSampleIdx,nPxIter);
+                const size_t nIntraDescDist = DistanceUtils::hdist(nCurrIntraDesc,nBGIntraDesc);
+                const ushort nCurrInterDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nBGColor,m_anLBSPThreshold_8bitLUT[nBGColor]);
+                const size_t nInterDescDist = DistanceUtils::hdist(nCurrInterDesc,nBGIntraDesc);
+                const size_t nDescDist = (nIntraDescDist+nInterDescDist)/2;
+                if(nDescDist>nCurrDescDistThreshold)
+                    goto failedcheck1ch;
+                const size_t nSumDist = std::min((nDescDist/4)*(s_nColorMaxDataRange_1ch/s_nDescMaxDataRange_1ch)+nColorDist,s_nColorMaxDataRange_1ch);
+                if(nSumDist>nCurrColorDistThreshold)
+                    goto failedcheck1ch;
+                if(nMinDescDist>nDescDist)
+                    nMinDescDist = nDescDist;
+                if(nMinSumDist>nSumDist)
+                    nMinSumDist = nSumDist;
+                nGoodSamplesCount++;
             }
-            const float fNormalizedLastDist = ((float)DistanceUtils::L1dist(nLastColor,nCurrColor)/s_nColorMaxDataRange_1ch+(float)DistanceUtils::hdist(nLastIntraDesc,nCurrIntraDesc)/s_nDescMaxDataRange_1ch)/2;
-            *pfCurrMeanLastDist = (*pfCurrMeanLastDist)*(1.0f-fRollAvgFactor_ST) + fNormalizedLastDist*fRollAvgFactor_ST;
-            if(nGoodSamplesCount<m_nRequiredBGSamples) {
-                // == foreground
-                const float fNormalizedMinDist = std::min(1.0f,((float)nMinSumDist/s_nColorMaxDataRange_1ch+(float)nMinDescDist/s_nDescMaxDataRange_1ch)/2 + (float)(m_nRequiredBGSamples-nGoodSamplesCount)/m_nRequiredBGSamples);
-                *pfCurrMeanMinDist_LT = (*pfCurrMeanMinDist_LT)*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
-                *pfCurrMeanMinDist_ST = (*pfCurrMeanMinDist_ST)*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
-                *pfCurrMeanRawSegmRes_LT = (*pfCurrMeanRawSegmRes_LT)*(1.0f-fRollAvgFactor_LT) + fRollAvgFactor_LT;
-                *pfCurrMeanRawSegmRes_ST = (*pfCurrMeanRawSegmRes_ST)*(1.0f-fRollAvgFactor_ST) + fRollAvgFactor_ST;
-                oCurrFGMask.data[nPxIter] = UCHAR_MAX;
-                if(m_nModelResetCooldown && (rand()%(size_t)FEEDBACK_T_LOWER)==0) {
-                    const size_t s_rand = rand()%m_nBGSamples;
-                    *((ushort*)(m_voBGDescSamples[s_rand].data+nDescIter)) = nCurrIntraDesc;
-                    m_voBGColorSamples[s_rand].data[nPxIter] = nCurrColor;
-                }
+            failedcheck1ch:
+            nSampleIdx++;
+        }
+        const float fNormalizedLastDist = ((float)DistanceUtils::L1dist(nLastColor,nCurrColor)/s_nColorMaxDataRange_1ch+(float)DistanceUtils::hdist(nLastIntraDesc,nCurrIntraDesc)/s_nDescMaxDataRange_1ch)/2;
+        *pfCurrMeanLastDist = (*pfCurrMeanLastDist)*(1.0f-fRollAvgFactor_ST) + fNormalizedLastDist*fRollAvgFactor_ST;
+        if(nGoodSamplesCount<m_nRequiredBGSamples) {
+            // == foreground
+            const float fNormalizedMinDist = std::min(1.0f,((float)nMinSumDist/s_nColorMaxDataRange_1ch+(float)nMinDescDist/s_nDescMaxDataRange_1ch)/2 + (float)(m_nRequiredBGSamples-nGoodSamplesCount)/m_nRequiredBGSamples);
+            *pfCurrMeanMinDist_LT = (*pfCurrMeanMinDist_LT)*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
+            *pfCurrMeanMinDist_ST = (*pfCurrMeanMinDist_ST)*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
+            *pfCurrMeanRawSegmRes_LT = (*pfCurrMeanRawSegmRes_LT)*(1.0f-fRollAvgFactor_LT) + fRollAvgFactor_LT;
+            *pfCurrMeanRawSegmRes_ST = (*pfCurrMeanRawSegmRes_ST)*(1.0f-fRollAvgFactor_ST) + fRollAvgFactor_ST;
+            oCurrFGMask.data[nPxIter] = UCHAR_MAX;
+            if(m_nModelResetCooldown && (oTile.oRNG()%(size_t)FEEDBACK_T_LOWER)==0) {
+                const size_t s_rand = oTile.oRNG()%m_nBGSamples;
+                m_oBGSamples.getDesc(s_rand,nPxIter) = nCurrIntraDesc;
+                m_oBGSamples.getColor(s_rand,nPxIter) = nCurrColor;
+            }
+        }
+        else {
+            // == background
+            const float fNormalizedMinDist = ((float)nMinSumDist/s_nColorMaxDataRange_1ch+(float)nMinDescDist/s_nDescMaxDataRange_1ch)/2;
+            *pfCurrMeanMinDist_LT = (*pfCurrMeanMinDist_LT)*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
+            *pfCurrMeanMinDist_ST = (*pfCurrMeanMinDist_ST)*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
+            *pfCurrMeanRawSegmRes_LT = (*pfCurrMeanRawSegmRes_LT)*(1.0f-fRollAvgFactor_LT);
+            *pfCurrMeanRawSegmRes_ST = (*pfCurrMeanRawSegmRes_ST)*(1.0f-fRollAvgFactor_ST);
+            const size_t nLearningRate = learningRateOverride>0?(size_t)ceil(learningRateOverride):(size_t)ceil(*pfCurrLearningRate);
+            if((oTile.oRNG()%nLearningRate)==0) {
+                const size_t s_rand = oTile.oRNG()%m_nBGSamples;
+                m_oBGSamples.getDesc(s_rand,nPxIter) = nCurrIntraDesc;
+                m_oBGSamples.getColor(s_rand,nPxIter) = nCurrColor;
+            }
+            int nSampleImgCoord_Y, nSampleImgCoord_X;
+            const bool bCurrUsing3x3Spread = m_bUse3x3Spread && !m_oUnstableRegionMask.data[nPxIter];
+            if(bCurrUsing3x3Spread)
+                cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,oTile.oRNG);
+            else
+                cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,oTile.oRNG);
+            const size_t n_rand = oTile.oRNG();
+            const size_t idx_rand_uchar = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
+            const bool bRandUpdate = (n_rand%(bCurrUsing3x3Spread?nLearningRate:(nLearningRate/2+1)))==0;
+            const bool bRandGhostUpdate = (n_rand%((size_t)m_fCurrLearningRateLowerCap))==0;
+            if(nSampleImgCoord_Y<oTile.nRowBegin || nSampleImgCoord_Y>=oTile.nRowEnd) {
+                if(bRandUpdate || bRandGhostUpdate)
+                    oTile.voDeferredUpdates.push_back({nPxIter,idx_rand_uchar,oTile.oRNG()%m_nBGSamples,!bRandUpdate});
             }
             else {
-                // == background
-                const float fNormalizedMinDist = ((float)nMinSumDist/s_nColorMaxDataRange_1ch+(float)nMinDescDist/s_nDescMaxDataRange_1ch)/2;
-                *pfCurrMeanMinDist_LT = (*pfCurrMeanMinDist_LT)*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
-                *pfCurrMeanMinDist_ST = (*pfCurrMeanMinDist_ST)*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
-                *pfCurrMeanRawSegmRes_LT = (*pfCurrMeanRawSegmRes_LT)*(1.0f-fRollAvgFactor_LT);
-                *pfCurrMeanRawSegmRes_ST = (*pfCurrMeanRawSegmRes_ST)*(1.0f-fRollAvgFactor_ST);
-                const size_t nLearningRate = learningRateOverride>0?(size_t)ceil(learningRateOverride):(size_t)ceil(*pfCurrLearningRate);
-                if((rand()%nLearningRate)==0) {
-                    const size_t s_rand = rand()%m_nBGSamples;
-                    *((ushort*)(m_voBGDescSamples[s_rand].data+nDescIter)) = nCurrIntraDesc;
-                    m_voBGColorSamples[s_rand].data[nPxIter] = nCurrColor;
-                }
-                int nSampleImgCoord_Y, nSampleImgCoord_X;
-                const bool bCurrUsing3x3Spread = m_bUse3x3Spread && !m_oUnstableRegionMask.data[nPxIter];
-                if(bCurrUsing3x3Spread)
-                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                else
-                    cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                const size_t n_rand = rand();
-                const size_t idx_rand_uchar = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
                 const size_t idx_rand_flt32 = idx_rand_uchar*4;
                 const float fRandMeanLastDist = *((float*)(m_oMeanLastDistFrame.data+idx_rand_flt32));
                 const float fRandMeanRawSegmRes = *((float*)(m_oMeanRawSegmResFrame_ST.data+idx_rand_flt32));
-                if((n_rand%(bCurrUsing3x3Spread?nLearningRate:(nLearningRate/2+1)))==0
-                    || (fRandMeanRawSegmRes>GHOSTDET_S_MIN && fRandMeanLastDist<GHOSTDET_D_MAX && (n_rand%((size_t)m_fCurrLearningRateLowerCap))==0)) {
-                    const size_t idx_rand_ushrt = idx_rand_uchar*2;
-                    const size_t s_rand = rand()%m_nBGSamples;
-                    *((ushort*)(m_voBGDescSamples[s_rand].data+idx_rand_ushrt)) = nCurrIntraDesc;
-                    m_voBGColorSamples[s_rand].data[idx_rand_uchar] = nCurrColor;
+                if(bRandUpdate || (fRandMeanRawSegmRes>GHOSTDET_S_MIN && fRandMeanLastDist<GHOSTDET_D_MAX && bRandGhostUpdate)) {
+                    const size_t s_rand = oTile.oRNG()%m_nBGSamples;
+                    m_oBGSamples.getDesc(s_rand,idx_rand_uchar) = nCurrIntraDesc;
+                    m_oBGSamples.getColor(s_rand,idx_rand_uchar) = nCurrColor;
                 }
             }
-            if(m_oLastFGMask.data[nPxIter] || (std::min(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)<UNSTABLE_REG_RATIO_MIN && oCurrFGMask.data[nPxIter])) {
-                if((*pfCurrLearningRate)<m_fCurrLearningRateUpperCap)
-                    *pfCurrLearningRate += FEEDBACK_T_INCR/(std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)*(*pfCurrVariationFactor));
-            }
-            else if((*pfCurrLearningRate)>m_fCurrLearningRateLowerCap)
-                *pfCurrLearningRate -= FEEDBACK_T_DECR*(*pfCurrVariationFactor)/std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST);
-            if((*pfCurrLearningRate)<m_fCurrLearningRateLowerCap)
-                *pfCurrLearningRate = m_fCurrLearningRateLowerCap;
-            else if((*pfCurrLearningRate)>m_fCurrLearningRateUpperCap)
-                *pfCurrLearningRate = m_fCurrLearningRateUpperCap;
-            if(std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)>UNSTABLE_REG_RATIO_MIN && m_oBlinksFrame.data[nPxIter])
-                (*pfCurrVariationFactor) += FEEDBACK_V_INCR;
-            else if((*pfCurrVariationFactor)>FEEDBACK_V_DECR) {
-                (*pfCurrVariationFactor) -= m_oLastFGMask.data[nPxIter]?FEEDBACK_V_DECR/4:m_oUnstableRegionMask.data[nPxIter]?FEEDBACK_V_DECR/2:FEEDBACK_V_DECR;
-                if((*pfCurrVariationFactor)<FEEDBACK_V_DECR)
-                    (*pfCurrVariationFactor) = FEEDBACK_V_DECR;
-            }
-            if((*pfCurrDistThresholdFactor)<std::pow(1.0f+std::min(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)*2,2))
-                (*pfCurrDistThresholdFactor) += FEEDBACK_R_VAR*(*pfCurrVariationFactor-FEEDBACK_V_DECR);
-            else {
-                (*pfCurrDistThresholdFactor) -= FEEDBACK_R_VAR/(*pfCurrVariationFactor);
-                if((*pfCurrDistThresholdFactor)<1.0f)
-                    (*pfCurrDistThresholdFactor) = 1.0f;
-            }
-            if(DistanceUtils::popcount(nCurrIntraDesc)>=2)
-                ++nNonZeroDescCount;
-            nLastIntraDesc = nCurrIntraDesc;
-            nLastColor = nCurrColor;
         }
+        if(m_oLastFGMask.data[nPxIter] || (std::min(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)<UNSTABLE_REG_RATIO_MIN && oCurrFGMask.data[nPxIter])) {
+            if((*pfCurrLearningRate)<m_fCurrLearningRateUpperCap)
+                *pfCurrLearningRate += FEEDBACK_T_INCR/(std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)*(*pfCurrVariationFactor));
+        }
+        else if((*pfCurrLearningRate)>m_fCurrLearningRateLowerCap)
+            *pfCurrLearningRate -= FEEDBACK_T_DECR*(*pfCurrVariationFactor)/std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST);
+        if((*pfCurrLearningRate)<m_fCurrLearningRateLowerCap)
+            *pfCurrLearningRate = m_fCurrLearningRateLowerCap;
+        else if((*pfCurrLearningRate)>m_fCurrLearningRateUpperCap)
+            *pfCurrLearningRate = m_fCurrLearningRateUpperCap;
+        if(std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)>UNSTABLE_REG_RATIO_MIN && m_oBlinksFrame.data[nPxIter])
+            (*pfCurrVariationFactor) += FEEDBACK_V_INCR;
+        else if((*pfCurrVariationFactor)>FEEDBACK_V_DECR) {
+            (*pfCurrVariationFactor) -= m_oLastFGMask.data[nPxIter]?FEEDBACK_V_DECR/4:m_oUnstableRegionMask.data[nPxIter]?FEEDBACK_V_DECR/2:FEEDBACK_V_DECR;
+            if((*pfCurrVariationFactor)<FEEDBACK_V_DECR)
+                (*pfCurrVariationFactor) = FEEDBACK_V_DECR;
+        }
+        if((*pfCurrDistThresholdFactor)<std::pow(1.0f+std::min(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)*2,2))
+            (*pfCurrDistThresholdFactor) += FEEDBACK_R_VAR*(*pfCurrVariationFactor-FEEDBACK_V_DECR);
+        else {
+            (*pfCurrDistThresholdFactor) -= FEEDBACK_R_VAR/(*pfCurrVariationFactor);
+            if((*pfCurrDistThresholdFactor)<1.0f)
+                (*pfCurrDistThresholdFactor) = 1.0f;
+        }
+        if(DistanceUtils::popcount(nCurrIntraDesc)>=2)
+            ++oTile.nNonZeroDescCount;
+        nLastIntraDesc = nCurrIntraDesc;
+        nLastColor = nCurrColor;
     }
-    else { //m_nImgChannels==3
-        for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
-            const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
-            const int nCurrImgCoord_X = m_voPxInfoLUT[nPxIter].nImgCoord_X;
-            const int nCurrImgCoord_Y = m_voPxInfoLUT[nPxIter].nImgCoord_Y;
-            const size_t nPxIterRGB = nPxIter*3;
-            const size_t nDescIterRGB = nPxIterRGB*2;
-            const size_t nFloatIter = nPxIter*4;
-            const uchar* const anCurrColor = oInputImg.data+nPxIterRGB;
-            size_t nMinTotDescDist=s_nDescMaxDataRange_3ch;
-            size_t nMinTotSumDist=s_nColorMaxDataRange_3ch;
-            float* pfCurrDistThresholdFactor = (float*)(m_oDistThresholdFrame.data+nFloatIter);
-            float* pfCurrVariationFactor = (float*)(m_oVariationModulatorFrame.data+nFloatIter);
-            float* pfCurrLearningRate = ((float*)(m_oUpdateRateFrame.data+nFloatIter));
-            float* pfCurrMeanLastDist = ((float*)(m_oMeanLastDistFrame.data+nFloatIter));
-            float* pfCurrMeanMinDist_LT = ((float*)(m_oMeanMinDistFrame_LT.data+nFloatIter));
-            float* pfCurrMeanMinDist_ST = ((float*)(m_oMeanMinDistFrame_ST.data+nFloatIter));
-            float* pfCurrMeanRawSegmRes_LT = ((float*)(m_oMeanRawSegmResFrame_LT.data+nFloatIter));
-            float* pfCurrMeanRawSegmRes_ST = ((float*)(m_oMeanRawSegmResFrame_ST.data+nFloatIter));
-            float* pfCurrMeanFinalSegmRes_LT = ((float*)(m_oMeanFinalSegmResFrame_LT.data+nFloatIter));
-            float* pfCurrMeanFinalSegmRes_ST = ((float*)(m_oMeanFinalSegmResFrame_ST.data+nFloatIter));
-            ushort* anLastIntraDesc = ((ushort*)(m_oLastDescFrame.data+nDescIterRGB));
-            uchar* anLastColor = m_oLastColorFrame.data+nPxIterRGB;
-            const size_t nCurrColorDistThreshold = (size_t)(((*pfCurrDistThresholdFactor)*m_nMinColorDistThreshold)-((!m_oUnstableRegionMask.data[nPxIter])*STAB_COLOR_DIST_OFFSET));
-            const size_t nCurrDescDistThreshold = ((size_t)1<<((size_t)floor(*pfCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(m_oUnstableRegionMask.data[nPxIter]*UNSTAB_DESC_DIST_OFFSET);
-            const size_t nCurrTotColorDistThreshold = nCurrColorDistThreshold*3;
-            const size_t nCurrTotDescDistThreshold = nCurrDescDistThreshold*3;
-            const size_t nCurrSCColorDistThreshold = nCurrTotColorDistThreshold/2;
-            alignas(16) std::array<std::array<uchar,LBSP::DESC_SIZE_BITS>,3> aanLBSPLookupVals;
-            LBSP::computeDescriptor_lookup(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,aanLBSPLookupVals);
-            std::array<ushort,3> anCurrIntraDesc;
-            for(size_t c=0; c<3; ++c)
-                anCurrIntraDesc[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
-            m_oUnstableRegionMask.data[nPxIter] = ((*pfCurrDistThresholdFactor)>UNSTABLE_REG_RDIST_MIN || (*pfCurrMeanRawSegmRes_LT-*pfCurrMeanFinalSegmRes_LT)>UNSTABLE_REG_RATIO_MIN || (*pfCurrMeanRawSegmRes_ST-*pfCurrMeanFinalSegmRes_ST)>UNSTABLE_REG_RATIO_MIN)?1:0;
-            size_t nGoodSamplesCount=0, nSampleIdx=0;
-            while(nGoodSamplesCount<m_nRequiredBGSamples && nSampleIdx<m_nBGSamples) {
-                const ushort* const anBGIntraDesc = (ushort*)(m_voBGDescSamples[nSampleIdx].data+nDescIterRGB);
-                const uchar* const anBGColor = m_voBGColorSamples[nSampleIdx].data+nPxIterRGB;
-                size_t nTotDescDist = 0;
-                size_t nTotSumDist = 0;
-                for(size_t c=0;c<3; ++c) {
-                    const size_t nColorDist = DistanceUtils::L1dist(anCurrColor[c],anBGColor[c]);
-                    if(nColorDist>nCurrSCColorDistThreshold)
-                        goto failedcheck3ch;
-                    const size_t nIntraDescDist = DistanceUtils::hdist(anCurrIntraDesc[c],anBGIntraDesc[c]);
-                    const ushort nCurrInterDesc = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anBGColor[c],m_anLBSPThreshold_8bitLUT[anBGColor[c]]);
-                    const size_t nInterDescDist = DistanceUtils::hdist(nCurrInterDesc,anBGIntraDesc[c]);
-                    const size_t nDescDist = (nIntraDescDist+nInterDescDist)/2;
-                    const size_t nSumDist = std::min((nDescDist/2)*(s_nColorMaxDataRange_1ch/s_nDescMaxDataRange_1ch)+nColorDist,s_nColorMaxDataRange_1ch);
-                    if(nSumDist>nCurrSCColorDistThreshold)
-                        goto failedcheck3ch;
-                    nTotDescDist += nDescDist;
-                    nTotSumDist += nSumDist;
-                }
-                if(nTotDescDist>nCurrTotDescDistThreshold || nTotSumDist>nCurrTotColorDistThreshold)
+}
+
+void BackgroundSubtractorSuBSENSE::apply_internal_3ch(const cv::Mat& oInputImg, cv::Mat& oCurrFGMask, TileInfo& oTile, double learningRateOverride, float fRollAvgFactor_LT, float fRollAvgFactor_ST) {
+    for(size_t nModelIter=oTile.nModelIterBegin; nModelIter<oTile.nModelIterEnd; ++nModelIter) {
+        const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
+        const int nCurrImgCoord_X = m_voPxInfoLUT[nPxIter].nImgCoord_X;
+        const int nCurrImgCoord_Y = m_voPxInfoLUT[nPxIter].nImgCoord_Y;
+        const size_t nPxIterRGB = nPxIter*3;
+        const size_t nDescIterRGB = nPxIterRGB*2;
+        const size_t nFloatIter = nPxIter*4;
+        const uchar* const anCurrColor = oInputImg.data+nPxIterRGB;
+        size_t nMinTotDescDist=s_nDescMaxDataRange_3ch;
+        size_t nMinTotSumDist=s_nColorMaxDataRange_3ch;
+        float* pfCurrDistThresholdFactor = (float*)(m_oDistThresholdFrame.data+nFloatIter);
+        float* pfCurrVariationFactor = (float*)(m_oVariationModulatorFrame.data+nFloatIter);
+        float* pfCurrLearningRate = ((float*)(m_oUpdateRateFrame.data+nFloatIter));
+        float* pfCurrMeanLastDist = ((float*)(m_oMeanLastDistFrame.data+nFloatIter));
+        float* pfCurrMeanMinDist_LT = ((float*)(m_oMeanMinDistFrame_LT.data+nFloatIter));
+        float* pfCurrMeanMinDist_ST = ((float*)(m_oMeanMinDistFrame_ST.data+nFloatIter));
+        float* pfCurrMeanRawSegmRes_LT = ((float*)(m_oMeanRawSegmResFrame_LT.data+nFloatIter));
+        float* pfCurrMeanRawSegmRes_ST = ((float*)(m_oMeanRawSegmResFrame_ST.data+nFloatIter));
+        float* pfCurrMeanFinalSegmRes_LT = ((float*)(m_oMeanFinalSegmResFrame_LT.data+nFloatIter));
+        float* pfCurrMeanFinalSegmRes_ST = ((float*)(m_oMeanFinalSegmResFrame_ST.data+nFloatIter));
+        ushort* anLastIntraDesc = ((ushort*)(m_oLastDescFrame.data+nDescIterRGB));
+        uchar* anLastColor = m_oLastColorFrame.data+nPxIterRGB;
+        const size_t nCurrColorDistThreshold = (size_t)(((*pfCurrDistThresholdFactor)*m_nMinColorDistThreshold)-((!m_oUnstableRegionMask.data[nPxIter])*STAB_COLOR_DIST_OFFSET));
+        const size_t nCurrDescDistThreshold = ((size_t)1<<((size_t)floor(*pfCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(m_oUnstableRegionMask.data[nPxIter]*UNSTAB_DESC_DIST_OFFSET);
+        const size_t nCurrTotColorDistThreshold = nCurrColorDistThreshold*3;
+        const size_t nCurrTotDescDistThreshold = nCurrDescDistThreshold*3;
+        const size_t nCurrSCColorDistThreshold = nCurrTotColorDistThreshold/2;
+        alignas(16) std::array<std::array<uchar,LBSP::DESC_SIZE_BITS>,3> aanLBSPLookupVals;
+        LBSP::computeDescriptor_lookup(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,aanLBSPLookupVals);
+        std::array<ushort,3> anCurrIntraDesc;
+        for(size_t c=0; c<3; ++c)
+            anCurrIntraDesc[c] = m_pCurrDescFrame?((const ushort*)m_pCurrDescFrame->data)[nPxIterRGB+c]:LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
+        m_oUnstableRegionMask.data[nPxIter] = ((*pfCurrDistThresholdFactor)>UNSTABLE_REG_RDIST_MIN || (*pfCurrMeanRawSegmRes_LT-*pfCurrMeanFinalSegmRes_LT)>UNSTABLE_REG_RATIO_MIN || (*pfCurrMeanRawSegmRes_ST-*pfCurrMeanFinalSegmRes_ST)>UNSTABLE_REG_RATIO_MIN)?1:0;
+        size_t nGoodSamplesCount=0, nSampleIdx=0;
+#if USE_AVX2_SAMPLE_MATCHER
+        if(m_bUsingVectorizedMatcher)
+            nSampleIdx = matchSamples_AVX2<3>(m_oBGSamples,nPxIter,m_nRequiredBGSamples,anCurrColor,anCurrIntraDesc.data(),aanLBSPLookupVals[0].data(),m_anLBSPThreshold_8bitLUT.data(),
+                                              nCurrSCColorDistThreshold,SIZE_MAX,nCurrTotColorDistThreshold,nCurrTotDescDistThreshold,
+                                              nGoodSamplesCount,nMinTotDescDist,nMinTotSumDist);
+#endif //USE_AVX2_SAMPLE_MATCHER
+        while(nGoodSamplesCount<m_nRequiredBGSamples && nSampleIdx<m_nBGSamples) {
+            size_t nTotDescDist = 0;
+            size_t nTotSumDist = 0;
+            for(size_t c=0;c<3; ++c) {
+                const uchar nBGColor = m_oBGSamples.getColor(nSampleIdx,nPxIter,c);
+                const ushort nBGIntraDesc = m_oBGSamples.getDesc(nSampleIdx,nPxIter,c);
+                const size_t nColorDist = DistanceUtils::L1dist(anCurrColor[c],nBGColor);
+                if(nColorDist>nCurrSCColorDistThreshold)
                     goto failedcheck3ch;
-                if(nMinTotDescDist>nTotDescDist)
-                    nMinTotDescDist = nTotDescDist;
-                if(nMinTotSumDist>nTotSumDist)
-                    nMinTotSumDist = nTotSumDist;
-                nGoodSamplesCount++;
-                failedcheck3ch:
-                nSampleIdx++;
+                const size_t nIntraDescDist = DistanceUtils::hdist(anCurrIntraDesc[c],nBGIntraDesc);
+                const ushort nCurrInterDesc = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],nBGColor,m_anLBSPThreshold_8bitLUT[nBGColor]);
+                const size_t nInterDescDist = DistanceUtils::hdist(nCurrInterDesc,nBGIntraDesc);
+                const size_t nDescDist = (nIntraDescDist+nInterDescDist)/2;
+                const size_t nSumDist = std::min((nDescDist/2)*(s_nColorMaxDataRange_1ch/s_nDescMaxDataRange_1ch)+nColorDist,s_nColorMaxDataRange_1ch);
+                if(nSumDist>nCurrSCColorDistThreshold)
+                    goto failedcheck3ch;
+                nTotDescDist += nDescDist;
+                nTotSumDist += nSumDist;
             }
-            const float fNormalizedLastDist = ((float)DistanceUtils::L1dist<3>(anLastColor,anCurrColor)/s_nColorMaxDataRange_3ch+(float)DistanceUtils::hdist<3>(anLastIntraDesc,anCurrIntraDesc)/s_nDescMaxDataRange_3ch)/2;
-            *pfCurrMeanLastDist = (*pfCurrMeanLastDist)*(1.0f-fRollAvgFactor_ST) + fNormalizedLastDist*fRollAvgFactor_ST;
-            if(nGoodSamplesCount<m_nRequiredBGSamples) {
-                // == foreground
-                const float fNormalizedMinDist = std::min(1.0f,((float)nMinTotSumDist/s_nColorMaxDataRange_3ch+(float)nMinTotDescDist/s_nDescMaxDataRange_3ch)/2 + (float)(m_nRequiredBGSamples-nGoodSamplesCount)/m_nRequiredBGSamples);
-                *pfCurrMeanMinDist_LT = (*pfCurrMeanMinDist_LT)*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
-                *pfCurrMeanMinDist_ST = (*pfCurrMeanMinDist_ST)*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
-                *pfCurrMeanRawSegmRes_LT = (*pfCurrMeanRawSegmRes_LT)*(1.0f-fRollAvgFactor_LT) + fRollAvgFactor_LT;
-                *pfCurrMeanRawSegmRes_ST = (*pfCurrMeanRawSegmRes_ST)*(1.0f-fRollAvgFactor_ST) + fRollAvgFactor_ST;
-                oCurrFGMask.data[nPxIter] = UCHAR_MAX;
-                if(m_nModelResetCooldown && (rand()%(size_t)FEEDBACK_T_LOWER)==0) {
-                    const size_t s_rand = rand()%m_nBGSamples;
-                    for(size_t c=0; c<3; ++c) {
-                        *((ushort*)(m_voBGDescSamples[s_rand].data+nDescIterRGB+2*c)) = anCurrIntraDesc[c];
-                        *(m_voBGColorSamples[s_rand].data+nPxIterRGB+c) = anCurrColor[c];
-                    }
+            if(nTotDescDist>nCurrTotDescDistThreshold || nTotSumDist>nCurrTotColorDistThreshold)
+                goto failedcheck3ch;
+            if(nMinTotDescDist>nTotDescDist)
+                nMinTotDescDist = nTotDescDist;
+            if(nMinTotSumDist>nTotSumDist)
+                nMinTotSumDist = nTotSumDist;
+            nGoodSamplesCount++;
+            failedcheck3ch:
+            nSampleIdx++;
+        }
+        const float fNormalizedLastDist = ((float)DistanceUtils::L1dist<3>(anLastColor,anCurrColor)/s_nColorMaxDataRange_3ch+(float)DistanceUtils::hdist<3>(anLastIntraDesc,anCurrIntraDesc)/s_nDescMaxDataRange_3ch)/2;
+        *pfCurrMeanLastDist = (*pfCurrMeanLastDist)*(1.0f-fRollAvgFactor_ST) + fNormalizedLastDist*fRollAvgFactor_ST;
+        if(nGoodSamplesCount<m_nRequiredBGSamples) {
+            // == foreground
+            const float fNormalizedMinDist = std::min(1.0f,((float)nMinTotSumDist/s_nColorMaxDataRange_3ch+(float)nMinTotDescDist/s_nDescMaxDataRange_3ch)/2 + (float)(m_nRequiredBGSamples-nGoodSamplesCount)/m_nRequiredBGSamples);
+            *pfCurrMeanMinDist_LT = (*pfCurrMeanMinDist_LT)*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
+            *pfCurrMeanMinDist_ST = (*pfCurrMeanMinDist_ST)*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
+            *pfCurrMeanRawSegmRes_LT = (*pfCurrMeanRawSegmRes_LT)*(1.0f-fRollAvgFactor_LT) + fRollAvgFactor_LT;
+            *pfCurrMeanRawSegmRes_ST = (*pfCurrMeanRawSegmRes_ST)*(1.0f-fRollAvgFactor_ST) + fRollAvgFactor_ST;
+            oCurrFGMask.data[nPxIter] = UCHAR_MAX;
+            if(m_nModelResetCooldown && (oTile.oRNG()%(size_t)FEEDBACK_T_LOWER)==0) {
+                const size_t s_rand = oTile.oRNG()%m_nBGSamples;
+                for(size_t c=0; c<3; ++c) {
+                    m_oBGSamples.getDesc(s_rand,nPxIter,c) = anCurrIntraDesc[c];
+                    m_oBGSamples.getColor(s_rand,nPxIter,c) = anCurrColor[c];
                 }
             }
-            else {
-                // == background
-                const float fNormalizedMinDist = ((float)nMinTotSumDist/s_nColorMaxDataRange_3ch+(float)nMinTotDescDist/s_nDescMaxDataRange_3ch)/2;
-                *pfCurrMeanMinDist_LT = (*pfCurrMeanMinDist_LT)*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
-                *pfCurrMeanMinDist_ST = (*pfCurrMeanMinDist_ST)*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
-                *pfCurrMeanRawSegmRes_LT = (*pfCurrMeanRawSegmRes_LT)*(1.0f-fRollAvgFactor_LT);
-                *pfCurrMeanRawSegmRes_ST = (*pfCurrMeanRawSegmRes_ST)*(1.0f-fRollAvgFactor_ST);
-                const size_t nLearningRate = learningRateOverride>0?(size_t)ceil(learningRateOverride):(size_t)ceil(*pfCurrLearningRate);
-                if((rand()%nLearningRate)==0) {
-                    const size_t s_rand = rand()%m_nBGSamples;
-                    for(size_t c=0; c<3; ++c) {
-                        *((ushort*)(m_voBGDescSamples[s_rand].data+nDescIterRGB+2*c)) = anCurrIntraDesc[c];
-                        *(m_voBGColorSamples[s_rand].data+nPxIterRGB+c) = anCurrColor[c];
-                    }
+        }
+        else {
+            // == background
+            const float fNormalizedMinDist = ((float)nMinTotSumDist/s_nColorMaxDataRange_3ch+(float)nMinTotDescDist/s_nDescMaxDataRange_3ch)/2;
+            *pfCurrMeanMinDist_LT = (*pfCurrMeanMinDist_LT)*(1.0f-fRollAvgFactor_LT) + fNormalizedMinDist*fRollAvgFactor_LT;
+            *pfCurrMeanMinDist_ST = (*pfCurrMeanMinDist_ST)*(1.0f-fRollAvgFactor_ST) + fNormalizedMinDist*fRollAvgFactor_ST;
+            *pfCurrMeanRawSegmRes_LT = (*pfCurrMeanRawSegmRes_LT)*(1.0f-fRollAvgFactor_LT);
+            *pfCurrMeanRawSegmRes_ST = (*pfCurrMeanRawSegmRes_ST)*(1.0f-fRollAvgFactor_ST);
+            const size_t nLearningRate = learningRateOverride>0?(size_t)ceil(learningRateOverride):(size_t)ceil(*pfCurrLearningRate);
+            if((oTile.oRNG()%nLearningRate)==0) {
+                const size_t s_rand = oTile.oRNG()%m_nBGSamples;
+                for(size_t c=0; c<3; ++c) {
+                    m_oBGSamples.getDesc(s_rand,nPxIter,c) = anCurrIntraDesc[c];
+                    m_oBGSamples.getColor(s_rand,nPxIter,c) = anCurrColor[c];
                 }
-                int nSampleImgCoord_Y, nSampleImgCoord_X;
-                const bool bCurrUsing3x3Spread = m_bUse3x3Spread && !m_oUnstableRegionMask.data[nPxIter];
-                if(bCurrUsing3x3Spread)
-                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                else
-                    cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
-                const size_t n_rand = rand();
-                const size_t idx_rand_uchar = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
+            }
+            int nSampleImgCoord_Y, nSampleImgCoord_X;
+            const bool bCurrUsing3x3Spread = m_bUse3x3Spread && !m_oUnstableRegionMask.data[nPxIter];
+            if(bCurrUsing3x3Spread)
+                cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,oTile.oRNG);
+            else
+                cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize,oTile.oRNG);
+            const size_t n_rand = oTile.oRNG();
+            const size_t idx_rand_uchar = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
+            const bool bRandUpdate = (n_rand%(bCurrUsing3x3Spread?nLearningRate:(nLearningRate/2+1)))==0;
+            const bool bRandGhostUpdate = (n_rand%((size_t)m_fCurrLearningRateLowerCap))==0;
+            if(nSampleImgCoord_Y<oTile.nRowBegin || nSampleImgCoord_Y>=oTile.nRowEnd) {
+                if(bRandUpdate || bRandGhostUpdate)
+                    oTile.voDeferredUpdates.push_back({nPxIter,idx_rand_uchar,oTile.oRNG()%m_nBGSamples,!bRandUpdate});
+            }
+            else {
                 const size_t idx_rand_flt32 = idx_rand_uchar*4;
                 const float fRandMeanLastDist = *((float*)(m_oMeanLastDistFrame.data+idx_rand_flt32));
                 const float fRandMeanRawSegmRes = *((float*)(m_oMeanRawSegmResFrame_ST.data+idx_rand_flt32));
-                if((n_rand%(bCurrUsing3x3Spread?nLearningRate:(nLearningRate/2+1)))==0
-                    || (fRandMeanRawSegmRes>GHOSTDET_S_MIN && fRandMeanLastDist<GHOSTDET_D_MAX && (n_rand%((size_t)m_fCurrLearningRateLowerCap))==0)) {
-                    const size_t idx_rand_uchar_rgb = idx_rand_uchar*3;
-                    const size_t idx_rand_ushrt_rgb = idx_rand_uchar_rgb*2;
-                    const size_t s_rand = rand()%m_nBGSamples;
+                if(bRandUpdate || (fRandMeanRawSegmRes>GHOSTDET_S_MIN && fRandMeanLastDist<GHOSTDET_D_MAX && bRandGhostUpdate)) {
+                    const size_t s_rand = oTile.oRNG()%m_nBGSamples;
                     for(size_t c=0; c<3; ++c) {
-                        *((ushort*)(m_voBGDescSamples[s_rand].data+idx_rand_ushrt_rgb+2*c)) = anCurrIntraDesc[c];
-                        *(m_voBGColorSamples[s_rand].data+idx_rand_uchar_rgb+c) = anCurrColor[c];
+                        m_oBGSamples.getDesc(s_rand,idx_rand_uchar,c) = anCurrIntraDesc[c];
+                        m_oBGSamples.getColor(s_rand,idx_rand_uchar,c) = anCurrColor[c];
                     }
                 }
             }
-            if(m_oLastFGMask.data[nPxIter] || (std::min(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)<UNSTABLE_REG_RATIO_MIN && oCurrFGMask.data[nPxIter])) {
-                if((*pfCurrLearningRate)<m_fCurrLearningRateUpperCap)
-                    *pfCurrLearningRate += FEEDBACK_T_INCR/(std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)*(*pfCurrVariationFactor));
-            }
-            else if((*pfCurrLearningRate)>m_fCurrLearningRateLowerCap)
-                *pfCurrLearningRate -= FEEDBACK_T_DECR*(*pfCurrVariationFactor)/std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST);
-            if((*pfCurrLearningRate)<m_fCurrLearningRateLowerCap)
-                *pfCurrLearningRate = m_fCurrLearningRateLowerCap;
-            else if((*pfCurrLearningRate)>m_fCurrLearningRateUpperCap)
-                *pfCurrLearningRate = m_fCurrLearningRateUpperCap;
-            if(std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)>UNSTABLE_REG_RATIO_MIN && m_oBlinksFrame.data[nPxIter])
-                (*pfCurrVariationFactor) += FEEDBACK_V_INCR;
-            else if((*pfCurrVariationFactor)>FEEDBACK_V_DECR) {
-                (*pfCurrVariationFactor) -= m_oLastFGMask.data[nPxIter]?FEEDBACK_V_DECR/4:m_oUnstableRegionMask.data[nPxIter]?FEEDBACK_V_DECR/2:FEEDBACK_V_DECR;
-                if((*pfCurrVariationFactor)<FEEDBACK_V_DECR)
-                    (*pfCurrVariationFactor) = FEEDBACK_V_DECR;
-            }
-            if((*pfCurrDistThresholdFactor)<std::pow(1.0f+std::min(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)*2,2))
-                (*pfCurrDistThresholdFactor) += FEEDBACK_R_VAR*(*pfCurrVariationFactor-FEEDBACK_V_DECR);
-            else {
-                (*pfCurrDistThresholdFactor) -= FEEDBACK_R_VAR/(*pfCurrVariationFactor);
-                if((*pfCurrDistThresholdFactor)<1.0f)
-                    (*pfCurrDistThresholdFactor) = 1.0f;
+        }
+        if(m_oLastFGMask.data[nPxIter] || (std::min(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)<UNSTABLE_REG_RATIO_MIN && oCurrFGMask.data[nPxIter])) {
+            if((*pfCurrLearningRate)<m_fCurrLearningRateUpperCap)
+                *pfCurrLearningRate += FEEDBACK_T_INCR/(std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)*(*pfCurrVariationFactor));
+        }
+        else if((*pfCurrLearningRate)>m_fCurrLearningRateLowerCap)
+            *pfCurrLearningRate -= FEEDBACK_T_DECR*(*pfCurrVariationFactor)/std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST);
+        if((*pfCurrLearningRate)<m_fCurrLearningRateLowerCap)
+            *pfCurrLearningRate = m_fCurrLearningRateLowerCap;
+        else if((*pfCurrLearningRate)>m_fCurrLearningRateUpperCap)
+            *pfCurrLearningRate = m_fCurrLearningRateUpperCap;
+        if(std::max(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)>UNSTABLE_REG_RATIO_MIN && m_oBlinksFrame.data[nPxIter])
+            (*pfCurrVariationFactor) += FEEDBACK_V_INCR;
+        else if((*pfCurrVariationFactor)>FEEDBACK_V_DECR) {
+            (*pfCurrVariationFactor) -= m_oLastFGMask.data[nPxIter]?FEEDBACK_V_DECR/4:m_oUnstableRegionMask.data[nPxIter]?FEEDBACK_V_DECR/2:FEEDBACK_V_DECR;
+            if((*pfCurrVariationFactor)<FEEDBACK_V_DECR)
+                (*pfCurrVariationFactor) = FEEDBACK_V_DECR;
+        }
+        if((*pfCurrDistThresholdFactor)<std::pow(1.0f+std::min(*pfCurrMeanMinDist_LT,*pfCurrMeanMinDist_ST)*2,2))
+            (*pfCurrDistThresholdFactor) += FEEDBACK_R_VAR*(*pfCurrVariationFactor-FEEDBACK_V_DECR);
+        else {
+            (*pfCurrDistThresholdFactor) -= FEEDBACK_R_VAR/(*pfCurrVariationFactor);
+            if((*pfCurrDistThresholdFactor)<1.0f)
+                (*pfCurrDistThresholdFactor) = 1.0f;
+        }
+        if(DistanceUtils::popcount<3>(anCurrIntraDesc)>=4)
+            ++oTile.nNonZeroDescCount;
+        for(size_t c=0; c<3; ++c) {
+            anLastIntraDesc[c] = anCurrIntraDesc[c];
+            anLastColor[c] = anCurrColor[c];
+        }
+    }
+}
+
+void BackgroundSubtractorSuBSENSE::apply_deferred_updates() {
+    // note: targets are owned by other tiles, but are also updated in a fixed order here, so results do not depend on tile scheduling
+    for(const TileInfo& oTile : m_voTiles) {
+        for(const DeferredNeighborUpdate& oUpdate : oTile.voDeferredUpdates) {
+            if(oUpdate.bGhostCheck) {
+                const float fRandMeanLastDist = ((float*)m_oMeanLastDistFrame.data)[oUpdate.nDstPxIdx];
+                const float fRandMeanRawSegmRes = ((float*)m_oMeanRawSegmResFrame_ST.data)[oUpdate.nDstPxIdx];
+                if(fRandMeanRawSegmRes<=GHOSTDET_S_MIN || fRandMeanLastDist>=GHOSTDET_D_MAX)
+                    continue;
             }
-            if(DistanceUtils::popcount<3>(anCurrIntraDesc)>=4)
-                ++nNonZeroDescCount;
-            for(size_t c=0; c<3; ++c) {
-                anLastIntraDesc[c] = anCurrIntraDesc[c];
-                anLastColor[c] = anCurrColor[c];
+            for(size_t c=0; c<m_nImgChannels; ++c) {
+                m_oBGSamples.getDesc(oUpdate.nSampleIdx,oUpdate.nDstPxIdx,c) = ((ushort*)m_oLastDescFrame.data)[oUpdate.nSrcPxIdx*m_nImgChannels+c];
+                m_oBGSamples.getColor(oUpdate.nSampleIdx,oUpdate.nDstPxIdx,c) = m_oLastColorFrame.data[oUpdate.nSrcPxIdx*m_nImgChannels+c];
             }
         }
     }
+}
+
+void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray _fgmask, double learningRateOverride) {
+    // == process
+    CV_Assert(m_bInitialized && m_bModelInitialized);
+    cv::Mat oInputImg = _image.getMat();
+    CV_Assert(oInputImg.type()==m_nImgType && oInputImg.size()==m_oImgSize);
+    CV_Assert(oInputImg.isContinuous());
+    _fgmask.create(m_oImgSize,CV_8UC1);
+    cv::Mat oCurrFGMask = _fgmask.getMat();
+    memset(oCurrFGMask.data,0,oCurrFGMask.cols*oCurrFGMask.rows);
+    const float fRollAvgFactor_LT = 1.0f/std::min(++m_nFrameIdx,m_nSamplesForMovingAvgs);
+    const float fRollAvgFactor_ST = 1.0f/std::min(m_nFrameIdx,m_nSamplesForMovingAvgs/4);
+    m_pCurrDescFrame = m_pDescCache?m_pDescCache->get(oInputImg,m_nFrameIdx,m_anLBSPThreshold_8bitLUT):nullptr;
+    const auto lTileProcessor = [&](TileInfo* pTile) {
+        pTile->nNonZeroDescCount = 0;
+        pTile->voDeferredUpdates.clear();
+        if(m_nImgChannels==1)
+            apply_internal_1ch(oInputImg,oCurrFGMask,*pTile,learningRateOverride,fRollAvgFactor_LT,fRollAvgFactor_ST);
+        else //m_nImgChannels==3
+            apply_internal_3ch(oInputImg,oCurrFGMask,*pTile,learningRateOverride,fRollAvgFactor_LT,fRollAvgFactor_ST);
+    };
+    if(m_pWorkerPool && m_voTiles.size()>1) {
+        std::vector<std::future<void>> voTileTasks;
+        voTileTasks.reserve(m_voTiles.size());
+        for(TileInfo& oTile : m_voTiles)
+            voTileTasks.push_back(m_pWorkerPool->queueTask(lTileProcessor,&oTile));
+        for(std::future<void>& oTileTask : voTileTasks)
+            oTileTask.get(); // will rethrow any exception caught in the worker
+    }
+    else {
+        for(TileInfo& oTile : m_voTiles)
+            lTileProcessor(&oTile);
+    }
+    m_pCurrDescFrame.reset();
+    apply_deferred_updates();
+    size_t nNonZeroDescCount = 0;
+    for(const TileInfo& oTile : m_voTiles)
+        nNonZeroDescCount += oTile.nNonZeroDescCount;
 #if DISPLAY_SUBSENSE_DEBUG_INFO
     cv::Point2i oDbgPt(-1,-1);
     if(m_pDisplayHelper) {
@@ -533,22 +750,7 @@ void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray
         std::cout << std::fixed << std::setprecision(5) << "      t(" << oDbgPt << ") = " << m_oUpdateRateFrame.at<float>(oDbgPt) << std::endl;
     }
 #endif //DISPLAY_SUBSENSE_DEBUG_INFO
-    cv::bitwise_xor(oCurrFGMask,m_oLastRawFGMask,m_oCurrRawFGBlinkMask);
-    cv::bitwise_or(m_oCurrRawFGBlinkMask,m_oLastRawFGBlinkMask,m_oBlinksFrame);
-    m_oCurrRawFGBlinkMask.copyTo(m_oLastRawFGBlinkMask);
-    oCurrFGMask.copyTo(m_oLastRawFGMask);
-    cv::morphologyEx(oCurrFGMask,m_oFGMask_PreFlood,cv::MORPH_CLOSE,m_oMorphExStructElement);
-    m_oFGMask_PreFlood.copyTo(m_oFGMask_FloodedHoles);
-    cv::floodFill(m_oFGMask_FloodedHoles,cv::Point(0,0),UCHAR_MAX);
-    cv::bitwise_not(m_oFGMask_FloodedHoles,m_oFGMask_FloodedHoles);
-    cv::erode(m_oFGMask_PreFlood,m_oFGMask_PreFlood,cv::Mat(),cv::Point(-1,-1),3);
-    cv::bitwise_or(oCurrFGMask,m_oFGMask_FloodedHoles,oCurrFGMask);
-    cv::bitwise_or(oCurrFGMask,m_oFGMask_PreFlood,oCurrFGMask);
-    cv::medianBlur(oCurrFGMask,m_oLastFGMask,m_nMedianBlurKernelSize);
-    cv::dilate(m_oLastFGMask,m_oLastFGMask_dilated,cv::Mat(),cv::Point(-1,-1),3);
-    cv::bitwise_and(m_oBlinksFrame,m_oLastFGMask_dilated_inverted,m_oBlinksFrame);
-    cv::bitwise_not(m_oLastFGMask_dilated,m_oLastFGMask_dilated_inverted);
-    cv::bitwise_and(m_oBlinksFrame,m_oLastFGMask_dilated_inverted,m_oBlinksFrame);
+    m_oPostProcessor.apply(oCurrFGMask,m_nMedianBlurKernelSize,m_oLastRawFGMask,m_oLastRawFGBlinkMask,m_oBlinksFrame,m_oLastFGMask,m_oLastFGMask_dilated,m_oLastFGMask_dilated_inverted);
     m_oLastFGMask.copyTo(oCurrFGMask);
     cv::addWeighted(m_oMeanFinalSegmResFrame_LT,(1.0f-fRollAvgFactor_LT),m_oLastFGMask,(1.0/UCHAR_MAX)*fRollAvgFactor_LT,0,m_oMeanFinalSegmResFrame_LT,CV_32F);
     cv::addWeighted(m_oMeanFinalSegmResFrame_ST,(1.0f-fRollAvgFactor_ST),m_oLastFGMask,(1.0/UCHAR_MAX)*fRollAvgFactor_ST,0,m_oMeanFinalSegmResFrame_ST,CV_32F);
@@ -614,17 +816,11 @@ void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray
 void BackgroundSubtractorSuBSENSE::getBackgroundImage(cv::OutputArray backgroundImage) const {
     CV_Assert(m_bInitialized);
     cv::Mat oAvgBGImg = cv::Mat::zeros(m_oImgSize,CV_32FC((int)m_nImgChannels));
-    for(size_t s=0; s<m_nBGSamples; ++s) {
-        for(int y=0; y<m_oImgSize.height; ++y) {
-            for(int x=0; x<m_oImgSize.width; ++x) {
-                const size_t idx_nimg = m_voBGColorSamples[s].step.p[0]*y + m_voBGColorSamples[s].step.p[1]*x;
-                const size_t nFloatIter = idx_nimg*4;
-                float* oAvgBgImgPtr = (float*)(oAvgBGImg.data+nFloatIter);
-                const uchar* const oBGImgPtr = m_voBGColorSamples[s].data+idx_nimg;
-                for(size_t c=0; c<m_nImgChannels; ++c)
-                    oAvgBgImgPtr[c] += ((float)oBGImgPtr[c])/m_nBGSamples;
-            }
-        }
+    for(size_t nPxIter=0; nPxIter<m_nTotPxCount; ++nPxIter) {
+        float* oAvgBgImgPtr = ((float*)oAvgBGImg.data)+nPxIter*m_nImgChannels;
+        for(size_t s=0; s<m_nBGSamples; ++s)
+            for(size_t c=0; c<m_nImgChannels; ++c)
+                oAvgBgImgPtr[c] += ((float)m_oBGSamples.getColor(s,nPxIter,c))/m_nBGSamples;
     }
     oAvgBGImg.convertTo(backgroundImage,CV_8U);
 }
@@ -633,17 +829,11 @@ void BackgroundSubtractorSuBSENSE::getBackgroundDescriptorsImage(cv::OutputArray
     static_assert(LBSP::DESC_SIZE==2,"bad assumptions in impl below");
     CV_Assert(m_bInitialized);
     cv::Mat oAvgBGDesc = cv::Mat::zeros(m_oImgSize,CV_32FC((int)m_nImgChannels));
-    for(size_t n=0; n<m_voBGDescSamples.size(); ++n) {
-        for(int y=0; y<m_oImgSize.height; ++y) {
-            for(int x=0; x<m_oImgSize.width; ++x) {
-                const size_t idx_ndesc = m_voBGDescSamples[n].step.p[0]*y + m_voBGDescSamples[n].step.p[1]*x;
-                const size_t nFloatIter = idx_ndesc*2;
-                float* oAvgBgDescPtr = (float*)(oAvgBGDesc.data+nFloatIter);
-                const ushort* const oBGDescPtr = (ushort*)(m_voBGDescSamples[n].data+idx_ndesc);
-                for(size_t c=0; c<m_nImgChannels; ++c)
-                    oAvgBgDescPtr[c] += ((float)oBGDescPtr[c])/m_voBGDescSamples.size();
-            }
-        }
+    for(size_t nPxIter=0; nPxIter<m_nTotPxCount; ++nPxIter) {
+        float* oAvgBgDescPtr = ((float*)oAvgBGDesc.data)+nPxIter*m_nImgChannels;
+        for(size_t n=0; n<m_nBGSamples; ++n)
+            for(size_t c=0; c<m_nImgChannels; ++c)
+                oAvgBgDescPtr[c] += ((float)m_oBGSamples.getDesc(n,nPxIter,c))/m_nBGSamples;
     }
     oAvgBGDesc.convertTo(backgroundDescImage,CV_16U);
 }
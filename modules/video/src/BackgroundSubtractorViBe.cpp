@@ -24,12 +24,17 @@ BackgroundSubtractorViBe::BackgroundSubtractorViBe(size_t nColorDistThreshold, s
         m_nRequiredBGSamples(nRequiredBGSamples),
         m_voBGImg(nBGSamples),
         m_nColorDistThreshold(nColorDistThreshold),
-        m_bInitialized(false) {
+        m_bInitialized(false),
+        m_nRandomSeed(0) {
     CV_Assert(m_nRequiredBGSamples<=m_nBGSamples);
 }
 
 BackgroundSubtractorViBe::~BackgroundSubtractorViBe() {}
 
+void BackgroundSubtractorViBe::setRandomSeed(uint64_t nSeed) {
+    m_nRandomSeed = nSeed;
+}
+
 void BackgroundSubtractorViBe::getBackgroundImage(cv::OutputArray backgroundImage) const {
     CV_Assert(m_bInitialized);
     cv::Mat oAvgBGImg = cv::Mat::zeros(m_oImgSize,CV_32FC(m_voBGImg[0].channels()));
@@ -58,6 +63,7 @@ void BackgroundSubtractorViBe_1ch::initialize(const cv::Mat& oInitImg) {
     CV_Assert(oInitImg.isContinuous());
     CV_Assert(oInitImg.type()==CV_8UC1);
     m_oImgSize = oInitImg.size();
+    m_oRNG.seed(m_nRandomSeed);
     CV_Assert(m_voBGImg.size()==(size_t)m_nBGSamples);
     for(size_t s=0; s<m_nBGSamples; s++) {
         m_voBGImg[s].create(m_oImgSize,CV_8UC1);
@@ -65,7 +71,7 @@ void BackgroundSubtractorViBe_1ch::initialize(const cv::Mat& oInitImg) {
         for(int y_orig=0; y_orig<m_oImgSize.height; y_orig++) {
             for(int x_orig=0; x_orig<m_oImgSize.width; x_orig++) {
                 int y_sample, x_sample;
-                cv::getRandSamplePosition_7x7_std2(x_sample,y_sample,x_orig,y_orig,0,m_oImgSize);
+                cv::getRandSamplePosition_7x7_std2(x_sample,y_sample,x_orig,y_orig,0,m_oImgSize,m_oRNG);
                 m_voBGImg[s].at<uchar>(y_orig,x_orig) = oInitImg.at<uchar>(y_sample,x_sample);
             }
         }
@@ -93,12 +99,12 @@ void BackgroundSubtractorViBe_1ch::apply(cv::InputArray _image, cv::OutputArray
             if(nGoodSamplesCount<m_nRequiredBGSamples)
                 oFGMask.at<uchar>(y,x) = UCHAR_MAX;
             else {
-                if((rand()%nLearningRate)==0)
-                    m_voBGImg[rand()%m_nBGSamples].at<uchar>(y,x)=oInputImg.at<uchar>(y,x);
-                if((rand()%nLearningRate)==0) {
+                if((m_oRNG()%nLearningRate)==0)
+                    m_voBGImg[m_oRNG()%m_nBGSamples].at<uchar>(y,x)=oInputImg.at<uchar>(y,x);
+                if((m_oRNG()%nLearningRate)==0) {
                     int x_rand,y_rand;
-                    cv::getRandNeighborPosition_3x3(x_rand,y_rand,x,y,0,m_oImgSize);
-                    m_voBGImg[rand()%m_nBGSamples].at<uchar>(y_rand,x_rand) = oInputImg.at<uchar>(y,x);
+                    cv::getRandNeighborPosition_3x3(x_rand,y_rand,x,y,0,m_oImgSize,m_oRNG);
+                    m_voBGImg[m_oRNG()%m_nBGSamples].at<uchar>(y_rand,x_rand) = oInputImg.at<uchar>(y,x);
                 }
             }
         }
@@ -120,6 +126,7 @@ void BackgroundSubtractorViBe_3ch::initialize(const cv::Mat& oInitImg) {
     else
         cv::cvtColor(oInitImg,oInitImgRGB,cv::COLOR_GRAY2BGR);
     m_oImgSize = oInitImgRGB.size();
+    m_oRNG.seed(m_nRandomSeed);
     CV_Assert(m_voBGImg.size()==(size_t)m_nBGSamples);
     int y_sample, x_sample;
     for(size_t s=0; s<m_nBGSamples; s++) {
@@ -127,7 +134,7 @@ void BackgroundSubtractorViBe_3ch::initialize(const cv::Mat& oInitImg) {
         m_voBGImg[s] = cv::Scalar(0,0,0);
         for(int y_orig=0; y_orig<m_oImgSize.height; y_orig++) {
             for(int x_orig=0; x_orig<m_oImgSize.width; x_orig++) {
-                cv::getRandSamplePosition_7x7_std2(x_sample,y_sample,x_orig,y_orig,0,m_oImgSize);
+                cv::getRandSamplePosition_7x7_std2(x_sample,y_sample,x_orig,y_orig,0,m_oImgSize,m_oRNG);
                 m_voBGImg[s].at<cv::Vec3b>(y_orig,x_orig) = oInitImgRGB.at<cv::Vec3b>(y_sample,x_sample);
             }
         }
@@ -177,12 +184,12 @@ void BackgroundSubtractorViBe_3ch::apply(cv::InputArray _image, cv::OutputArray
             if(nGoodSamplesCount<m_nRequiredBGSamples)
                 oFGMask.at<uchar>(y,x) = UCHAR_MAX;
             else {
-                if((rand()%nLearningRate)==0)
-                    m_voBGImg[rand()%m_nBGSamples].at<cv::Vec3b>(y,x)=oInputImgRGB.at<cv::Vec3b>(y,x);
-                if((rand()%nLearningRate)==0) {
+                if((m_oRNG()%nLearningRate)==0)
+                    m_voBGImg[m_oRNG()%m_nBGSamples].at<cv::Vec3b>(y,x)=oInputImgRGB.at<cv::Vec3b>(y,x);
+                if((m_oRNG()%nLearningRate)==0) {
                     int x_rand,y_rand;
-                    cv::getRandNeighborPosition_3x3(x_rand,y_rand,x,y,0,m_oImgSize);
-                    const size_t s_rand = rand()%m_nBGSamples;
+                    cv::getRandNeighborPosition_3x3(x_rand,y_rand,x,y,0,m_oImgSize,m_oRNG);
+                    const size_t s_rand = m_oRNG()%m_nBGSamples;
                     m_voBGImg[s_rand].at<cv::Vec3b>(y_rand,x_rand) = oInputImgRGB.at<cv::Vec3b>(y,x);
                 }
             }